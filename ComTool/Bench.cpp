@@ -0,0 +1,274 @@
+// Author    KMS - Martin Dubois, P. Eng.
+// Copyright (C) 2024 KMS
+// License   http://www.apache.org/licenses/LICENSE-2.0
+// Product   KMS-Tools
+// File      ComTool/Bench.cpp
+
+#include "Component.h"
+
+// ===== C++ ================================================================
+#include <algorithm>
+#include <chrono>
+
+// ===== Local ==============================================================
+#include "Clock.h"
+#include "PRBS.h"
+#include "Receiver.h"
+
+#include "Bench.h"
+
+using namespace KMS;
+
+// Constants
+// //////////////////////////////////////////////////////////////////////////
+
+const unsigned int Bench::CHUNK_DEFAULT_byte = 256;
+
+// Chunks written but not yet received
+#define IN_FLIGHT_QTY (4)
+
+#define POLL_PERIOD_us (100)
+
+// Static function declarations
+// //////////////////////////////////////////////////////////////////////////
+
+static uint64_t GetPercentile(const std::vector<uint64_t>& aSorted, unsigned int aPercent);
+
+// Public
+// //////////////////////////////////////////////////////////////////////////
+
+Bench::Bench(Com::Port* aPort, Receiver* aReceiver)
+    : mPort(aPort)
+    , mReceiver(aReceiver)
+    , mReceived_byte(0)
+    , mStop(false)
+    , mBitErrorCount(0)
+    , mByteErrorCount(0)
+    , mChecked_byte(0)
+    , mDuration_ns(0)
+    , mOrder(0)
+    , mSent_byte(0)
+    , mSize_byte(0)
+    , mSyncLossCount(0)
+{
+    assert(nullptr != aPort);
+}
+
+void Bench::Run(unsigned int aOrder, uint64_t aSize_byte, unsigned int aChunk_byte, unsigned int aTimeout_ms)
+{
+    KMS_EXCEPTION_ASSERT(0 < aChunk_byte, RESULT_INVALID_VALUE, "Invalid chunk size", aChunk_byte);
+
+    PRBS lChecker(aOrder);
+
+    mLatencies_ns.clear();
+    mSent.clear();
+
+    mOrder         = aOrder;
+    mReceived_byte = 0;
+    mSent_byte     = 0;
+    mSize_byte     = aSize_byte;
+    mStop          = false;
+
+    std::vector<uint8_t> lBuffer(aChunk_byte * IN_FLIGHT_QTY);
+
+    auto lStart_ns = Clock_GetTime_ns();
+    auto lLast_ns  = lStart_ns;
+
+    std::thread lWriter(&Bench::Writer, this, aOrder, aSize_byte, aChunk_byte);
+
+    try
+    {
+        while (mReceived_byte < aSize_byte)
+        {
+            uint64_t lTime_ns;
+
+            auto lSize_byte = Read(lBuffer.data(), static_cast<unsigned int>(lBuffer.size()), aTimeout_ms, &lTime_ns);
+            if (0 == lSize_byte)
+            {
+                break;
+            }
+
+            lChecker.Check(lBuffer.data(), lSize_byte);
+
+            uint64_t lReceived_byte = mReceived_byte + lSize_byte;
+
+            {
+                std::lock_guard<std::mutex> lLock(mSentMutex);
+
+                while ((!mSent.empty()) && (mSent.front().mEnd_byte <= lReceived_byte))
+                {
+                    auto lSent_ns = mSent.front().mTime_ns;
+
+                    mLatencies_ns.push_back((lSent_ns < lTime_ns) ? lTime_ns - lSent_ns : 0);
+
+                    mSent.pop_front();
+                }
+            }
+
+            mReceived_byte = lReceived_byte;
+
+            lLast_ns = lTime_ns;
+        }
+    }
+    catch (...)
+    {
+        mStop = true;
+        lWriter.join();
+        throw;
+    }
+
+    mStop = true;
+
+    lWriter.join();
+
+    std::sort(mLatencies_ns.begin(), mLatencies_ns.end());
+
+    mBitErrorCount  = lChecker.mBitErrorCount;
+    mByteErrorCount = lChecker.mByteErrorCount;
+    mChecked_byte   = lChecker.mByteCount;
+    mDuration_ns    = lLast_ns - lStart_ns;
+    mSyncLossCount  = lChecker.mSyncLossCount;
+}
+
+void Bench::Display(std::ostream& aOut) const
+{
+    uint64_t lReceived_byte = mReceived_byte;
+
+    char lLine[LINE_LENGTH];
+
+    sprintf_s(lLine SizeInfo(lLine), "Bench PRBS-%u : %llu / %llu bytes sent, %llu received",
+        mOrder,
+        static_cast<unsigned long long>(mSent_byte),
+        static_cast<unsigned long long>(mSize_byte),
+        static_cast<unsigned long long>(lReceived_byte));
+    aOut << lLine << "\n";
+
+    if (0 < mDuration_ns)
+    {
+        double lRate_Bps = lReceived_byte * 1000000000.0 / mDuration_ns;
+
+        sprintf_s(lLine SizeInfo(lLine), "    Throughput : %.1f kB/s (%.3f Mbit/s) in %.3f s",
+            lRate_Bps / 1000.0, lRate_Bps * 8.0 / 1000000.0, mDuration_ns / 1000000000.0);
+        aOut << lLine << "\n";
+    }
+
+    if (0 < mChecked_byte)
+    {
+        sprintf_s(lLine SizeInfo(lLine), "    Errors     : %llu bits (BER %.2e), %llu bytes (%.2e), %llu sync losses",
+            static_cast<unsigned long long>(mBitErrorCount ), static_cast<double>(mBitErrorCount ) / (mChecked_byte * 8),
+            static_cast<unsigned long long>(mByteErrorCount), static_cast<double>(mByteErrorCount) /  mChecked_byte,
+            static_cast<unsigned long long>(mSyncLossCount));
+        aOut << lLine << "\n";
+    }
+
+    if (!mLatencies_ns.empty())
+    {
+        sprintf_s(lLine SizeInfo(lLine), "    Latency    : p50 %llu us, p90 %llu us, p99 %llu us, max %llu us (%zu chunks)",
+            static_cast<unsigned long long>(GetPercentile(mLatencies_ns, 50) / 1000),
+            static_cast<unsigned long long>(GetPercentile(mLatencies_ns, 90) / 1000),
+            static_cast<unsigned long long>(GetPercentile(mLatencies_ns, 99) / 1000),
+            static_cast<unsigned long long>(mLatencies_ns.back()             / 1000),
+            mLatencies_ns.size());
+        aOut << lLine << "\n";
+    }
+}
+
+bool Bench::IsPassed() const
+{
+    return (mSize_byte <= mReceived_byte) && (0 == mBitErrorCount) && (0 == mSyncLossCount);
+}
+
+// Private
+// //////////////////////////////////////////////////////////////////////////
+
+unsigned int Bench::Read(void* aOut, unsigned int aOutSize_byte, unsigned int aTimeout_ms, uint64_t* aTime_ns)
+{
+    assert(nullptr != aTime_ns);
+
+    if ((nullptr != mReceiver) && mReceiver->IsRunning())
+    {
+        // Read_Begin limits the region to one received chunk, so aTime_ns
+        // is the time of the chunk holding the last byte returned.
+        unsigned int lSize_byte;
+
+        auto lData = mReceiver->Read_Begin(&lSize_byte, aTimeout_ms, aTime_ns);
+        if (0 < lSize_byte)
+        {
+            if (aOutSize_byte < lSize_byte)
+            {
+                lSize_byte = aOutSize_byte;
+            }
+
+            memcpy(aOut, lData, lSize_byte);
+
+            mReceiver->Read_End(lSize_byte);
+        }
+
+        return lSize_byte;
+    }
+
+    auto lEnd_ns = Clock_GetTime_ns() + static_cast<uint64_t>(aTimeout_ms) * 1000000;
+
+    for (;;)
+    {
+        auto lResult_byte = mPort->Read(aOut, aOutSize_byte, 0);
+
+        *aTime_ns = Clock_GetTime_ns();
+
+        if ((0 < lResult_byte) || (lEnd_ns <= *aTime_ns))
+        {
+            return lResult_byte;
+        }
+    }
+}
+
+// The writer waits for the reception of the oldest chunks, so the port
+// buffers never overflow and the latency does not include queuing.
+void Bench::Writer(unsigned int aOrder, uint64_t aSize_byte, unsigned int aChunk_byte)
+{
+    PRBS lGenerator(aOrder);
+
+    std::vector<uint8_t> lChunk(aChunk_byte);
+
+    while ((!mStop) && (mSent_byte < aSize_byte))
+    {
+        if (mSent_byte - mReceived_byte >= static_cast<uint64_t>(aChunk_byte) * IN_FLIGHT_QTY)
+        {
+            std::this_thread::sleep_for(std::chrono::microseconds(POLL_PERIOD_us));
+            continue;
+        }
+
+        auto lSize_byte = aChunk_byte;
+        if (aSize_byte - mSent_byte < lSize_byte)
+        {
+            lSize_byte = static_cast<unsigned int>(aSize_byte - mSent_byte);
+        }
+
+        lGenerator.Generate(lChunk.data(), lSize_byte);
+
+        {
+            std::lock_guard<std::mutex> lLock(mSentMutex);
+
+            mSent.push_back({ mSent_byte + lSize_byte, Clock_GetTime_ns() });
+        }
+
+        if (!mPort->Write(lChunk.data(), lSize_byte))
+        {
+            break;
+        }
+
+        mSent_byte += lSize_byte;
+    }
+}
+
+// Static functions
+// //////////////////////////////////////////////////////////////////////////
+
+uint64_t GetPercentile(const std::vector<uint64_t>& aSorted, unsigned int aPercent)
+{
+    assert(!aSorted.empty());
+
+    auto lIndex = (aSorted.size() - 1) * aPercent / 100;
+
+    return aSorted[lIndex];
+}
@@ -0,0 +1,80 @@
+// Author    KMS - Martin Dubois, P. Eng.
+// Copyright (C) 2024 KMS
+// License   http://www.apache.org/licenses/LICENSE-2.0
+// Product   KMS-Tools
+// File      ComTool/Bench.h
+
+#pragma once
+
+// ===== C++ ================================================================
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <vector>
+
+// ===== Import/Includes ====================================================
+#include <KMS/Com/Port.h>
+
+// ===== Local ==============================================================
+class Receiver;
+
+// Loopback benchmark. A thread writes a PRBS to the port while the calling
+// thread reads and checks it. The writer keeps at most a few chunks in
+// flight, so the time between writing a chunk and the port read that
+// returns its last byte is the round trip latency.
+class Bench
+{
+
+public:
+
+    static const unsigned int CHUNK_DEFAULT_byte;
+
+    // aReceiver  Used to read when it is running, may be nullptr
+    Bench(KMS::Com::Port* aPort, Receiver* aReceiver);
+
+    // aOrder       See PRBS
+    // aTimeout_ms  Stop when nothing is received for this time
+    void Run(unsigned int aOrder, uint64_t aSize_byte, unsigned int aChunk_byte, unsigned int aTimeout_ms);
+
+    void Display(std::ostream& aOut) const;
+
+    bool IsPassed() const;
+
+private:
+
+    NO_COPY(Bench);
+
+    struct Sent
+    {
+        uint64_t mEnd_byte;
+        uint64_t mTime_ns;
+    };
+
+    // The bytes returned come from one port read
+    // aTime_ns  Clock_GetTime_ns value just after the port read returned
+    //           them, the same definition on both paths
+    unsigned int Read(void* aOut, unsigned int aOutSize_byte, unsigned int aTimeout_ms, uint64_t* aTime_ns);
+
+    void Writer(unsigned int aOrder, uint64_t aSize_byte, unsigned int aChunk_byte);
+
+    KMS::Com::Port* mPort;
+    Receiver*       mReceiver;
+
+    std::atomic<uint64_t> mReceived_byte;
+    std::atomic<bool>     mStop;
+
+    std::deque<Sent> mSent;
+    std::mutex       mSentMutex;
+
+    // ===== Results ========================================================
+    uint64_t              mBitErrorCount;
+    uint64_t              mByteErrorCount;
+    uint64_t              mChecked_byte;
+    uint64_t              mDuration_ns;
+    std::vector<uint64_t> mLatencies_ns;
+    unsigned int          mOrder;
+    uint64_t              mSent_byte;
+    uint64_t              mSize_byte;
+    uint64_t              mSyncLossCount;
+
+};
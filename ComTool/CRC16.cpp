@@ -0,0 +1,139 @@
+// Author    KMS - Martin Dubois, P. Eng.
+// Copyright (C) 2024 KMS
+// License   http://www.apache.org/licenses/LICENSE-2.0
+// Product   KMS-Tools
+// File      ComTool/CRC16.cpp
+
+#include "Component.h"
+
+// ===== Local ==============================================================
+#include "CRC16.h"
+
+// Constants
+// //////////////////////////////////////////////////////////////////////////
+
+#define POLYNOMIAL        (0x8408)
+#define POLYNOMIAL_MODBUS (0xa001)
+
+#define SLICE_QTY (8)
+
+// Data types
+// //////////////////////////////////////////////////////////////////////////
+
+class Tables
+{
+
+public:
+
+    Tables(uint16_t aPolynomial);
+
+    uint16_t mTable[SLICE_QTY][256];
+
+};
+
+// Static variables
+// //////////////////////////////////////////////////////////////////////////
+
+static const Tables sTables       (POLYNOMIAL);
+static const Tables sTables_Modbus(POLYNOMIAL_MODBUS);
+
+// Static function declarations
+// //////////////////////////////////////////////////////////////////////////
+
+static uint16_t Compute(const Tables& aTables, uint16_t aCRC, const void* aIn, unsigned int aInSize_byte);
+
+// Functions
+// //////////////////////////////////////////////////////////////////////////
+
+uint16_t CRC16_Compute(uint16_t aCRC, const void* aIn, unsigned int aInSize_byte)
+{
+    return Compute(sTables, aCRC, aIn, aInSize_byte);
+}
+
+uint16_t CRC16_Compute_Bitwise(uint16_t aCRC, const void* aIn, unsigned int aInSize_byte)
+{
+    assert(nullptr != aIn);
+
+    auto lIn = static_cast<const uint8_t*>(aIn);
+
+    uint16_t lResult = aCRC;
+
+    for (unsigned int i = 0; i < aInSize_byte; i++)
+    {
+        uint8_t lByte = lIn[i];
+
+        lByte ^= lResult;
+        lByte ^= lByte << 4;
+
+        lResult = ((lByte << 8) | (0xff & (lResult >> 8))) ^ (lByte >> 4) ^ (lByte << 3);
+    }
+
+    return lResult;
+}
+
+uint16_t CRC16_Modbus_Compute(uint16_t aCRC, const void* aIn, unsigned int aInSize_byte)
+{
+    return Compute(sTables_Modbus, aCRC, aIn, aInSize_byte);
+}
+
+// Private
+// //////////////////////////////////////////////////////////////////////////
+
+Tables::Tables(uint16_t aPolynomial)
+{
+    for (unsigned int i = 0; i < 256; i++)
+    {
+        uint16_t lCRC = i;
+
+        for (unsigned int b = 0; b < 8; b++)
+        {
+            lCRC = (0 != (lCRC & 1)) ? ((lCRC >> 1) ^ aPolynomial) : (lCRC >> 1);
+        }
+
+        mTable[0][i] = lCRC;
+    }
+
+    for (unsigned int s = 1; s < SLICE_QTY; s++)
+    {
+        for (unsigned int i = 0; i < 256; i++)
+        {
+            mTable[s][i] = (mTable[s - 1][i] >> 8) ^ mTable[0][mTable[s - 1][i] & 0xff];
+        }
+    }
+}
+
+// Static functions
+// //////////////////////////////////////////////////////////////////////////
+
+uint16_t Compute(const Tables& aTables, uint16_t aCRC, const void* aIn, unsigned int aInSize_byte)
+{
+    assert(nullptr != aIn);
+
+    auto lIn = static_cast<const uint8_t*>(aIn);
+    auto lT  = aTables.mTable;
+
+    uint16_t     lResult    = aCRC;
+    unsigned int lSize_byte = aInSize_byte;
+
+    while (SLICE_QTY <= lSize_byte)
+    {
+        lResult ^= lIn[0] | (lIn[1] << 8);
+
+        lResult = lT[7][lResult & 0xff] ^ lT[6][lResult >> 8]
+                ^ lT[5][lIn[2]] ^ lT[4][lIn[3]] ^ lT[3][lIn[4]]
+                ^ lT[2][lIn[5]] ^ lT[1][lIn[6]] ^ lT[0][lIn[7]];
+
+        lIn        += SLICE_QTY;
+        lSize_byte -= SLICE_QTY;
+    }
+
+    while (0 < lSize_byte)
+    {
+        lResult = (lResult >> 8) ^ lT[0][(lResult ^ *lIn) & 0xff];
+
+        lIn++;
+        lSize_byte--;
+    }
+
+    return lResult;
+}
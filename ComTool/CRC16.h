@@ -0,0 +1,26 @@
+// Author    KMS - Martin Dubois, P. Eng.
+// Copyright (C) 2024 KMS
+// License   http://www.apache.org/licenses/LICENSE-2.0
+// Product   KMS-Tools
+// File      ComTool/CRC16.h
+
+#pragma once
+
+// CRC-16 used by FRAME_T (reflected polynomial 0x8408, initial value
+// 0xffff, no final xor)
+
+#define CRC16_INIT (0xffff)
+
+// CRC-16 used by Modbus RTU (reflected polynomial 0xa001, initial value
+// 0xffff, no final xor)
+
+#define CRC16_MODBUS_INIT (0xffff)
+
+// Slicing-by-8, 8 bytes per iteration
+extern uint16_t CRC16_Compute(uint16_t aCRC, const void* aIn, unsigned int aInSize_byte);
+
+// One bit at a time, used to validate the tables
+extern uint16_t CRC16_Compute_Bitwise(uint16_t aCRC, const void* aIn, unsigned int aInSize_byte);
+
+// Slicing-by-8, 8 bytes per iteration
+extern uint16_t CRC16_Modbus_Compute(uint16_t aCRC, const void* aIn, unsigned int aInSize_byte);
@@ -0,0 +1,117 @@
+// Author    KMS - Martin Dubois, P. Eng.
+// Copyright (C) 2024 KMS
+// License   http://www.apache.org/licenses/LICENSE-2.0
+// Product   KMS-Tools
+// File      ComTool/CaptureFile.h
+
+#pragma once
+
+// Binary capture file
+//
+//   FileHeader
+//   RecordHeader, Payload
+//   ...
+//   IndexEntry[FileTrailer::mIndexCount]
+//   FileTrailer
+//
+// The index and the trailer are only written when the capture is closed.
+// When they are missing, the reader rebuilds the index from the record
+// headers. All the values are little endian.
+//
+// The record times never decrease. The writer gives a record read before
+// the previous one the time of the previous one and sets FLAG_TIME_CLAMPED,
+// so its time is not an observed time.
+//
+// Compressed capture, the capture file cut in blocks
+//
+//   CompressedHeader
+//   BlockHeader, Data
+//   ...
+//
+// A block stored as is has mStoredSize_byte equal to mSize_byte. The other
+// blocks use the LZ4 block format.
+
+namespace CaptureFile
+{
+
+    static const char MAGIC_FILE [8] = { 'K', 'M', 'S', 'C', 'A', 'P', '0', '1' };
+    static const char MAGIC_INDEX[8] = { 'K', 'M', 'S', 'I', 'D', 'X', '0', '1' };
+
+    static const char MAGIC_COMPRESSED[8] = { 'K', 'M', 'S', 'C', 'P', 'Z', '0', '1' };
+
+    static const uint8_t DIRECTION_RECEIVE = 0;
+    static const uint8_t DIRECTION_SEND    = 1;
+
+    static const uint8_t FLAG_VERIFY_FAILED = 0x01;
+    static const uint8_t FLAG_VERIFY_PASSED = 0x02;
+    static const uint8_t FLAG_FRAME         = 0x04;
+    static const uint8_t FLAG_FRAME_ERROR   = 0x08;
+    static const uint8_t FLAG_MESSAGE       = 0x10;
+    static const uint8_t FLAG_MESSAGE_ERROR = 0x20;
+    static const uint8_t FLAG_TIME_CLAMPED  = 0x40;
+
+    typedef struct
+    {
+        char     mMagic[8];
+        uint32_t mHeaderSize_byte;
+        uint32_t mIndexPeriod_byte;
+
+        // Wall clock at the start of the capture, ns since 1970-01-01 UTC
+        uint64_t mStart_ns;
+    }
+    FileHeader;
+
+    typedef struct
+    {
+        // Monotonic time since the start of the capture, never smaller than
+        // the time of the previous record, see FLAG_TIME_CLAMPED
+        uint64_t mTime_ns;
+        uint32_t mSize_byte;
+        uint8_t  mDirection;
+        uint8_t  mFlags;
+
+        // Index of the session port, 0 for the main port
+        uint16_t mPort;
+    }
+    RecordHeader;
+
+    typedef struct
+    {
+        uint64_t mTime_ns;
+        uint64_t mOffset_byte;
+    }
+    IndexEntry;
+
+    typedef struct
+    {
+        uint64_t mIndexOffset_byte;
+        uint32_t mIndexCount;
+        uint32_t mReserved0;
+        char     mMagic[8];
+    }
+    FileTrailer;
+
+    typedef struct
+    {
+        char     mMagic[8];
+        uint32_t mBlockSize_byte;
+        uint32_t mReserved0;
+    }
+    CompressedHeader;
+
+    typedef struct
+    {
+        uint32_t mSize_byte;
+        uint32_t mStoredSize_byte;
+    }
+    BlockHeader;
+
+    static_assert(24 == sizeof(FileHeader  ), "Invalid FileHeader size");
+    static_assert(16 == sizeof(RecordHeader), "Invalid RecordHeader size");
+    static_assert(16 == sizeof(IndexEntry  ), "Invalid IndexEntry size");
+    static_assert(24 == sizeof(FileTrailer ), "Invalid FileTrailer size");
+
+    static_assert(16 == sizeof(CompressedHeader), "Invalid CompressedHeader size");
+    static_assert( 8 == sizeof(BlockHeader     ), "Invalid BlockHeader size");
+
+}
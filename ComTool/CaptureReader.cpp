@@ -0,0 +1,250 @@
+// Author    KMS - Martin Dubois, P. Eng.
+// Copyright (C) 2024 KMS
+// License   http://www.apache.org/licenses/LICENSE-2.0
+// Product   KMS-Tools
+// File      ComTool/CaptureReader.cpp
+
+#include "Component.h"
+
+// ===== C++ ================================================================
+#include <algorithm>
+
+// ===== Local ==============================================================
+#include "File.h"
+
+#include "CaptureReader.h"
+
+using namespace KMS;
+
+KMS_RESULT_STATIC(RESULT_CAPTURE_READ_FAILED);
+KMS_RESULT_STATIC(RESULT_INVALID_CAPTURE);
+
+// Constants
+// //////////////////////////////////////////////////////////////////////////
+
+#define FILE_BUFFER_SIZE_byte (1024 * 1024)
+
+// Static function declarations
+// //////////////////////////////////////////////////////////////////////////
+
+static uint64_t GetFileSize(FILE* aFile);
+
+static FILE* OpenFile(const char* aFileName);
+
+static void SeekFile(FILE* aFile, uint64_t aOffset_byte);
+
+// Public
+// //////////////////////////////////////////////////////////////////////////
+
+CaptureReader::CaptureReader(const char* aFileName) : mFile(OpenFile(aFileName)), mOffset_byte(0)
+{
+    try
+    {
+        Open(aFileName);
+    }
+    catch (...)
+    {
+        fclose(mFile);
+        throw;
+    }
+}
+
+CaptureReader::~CaptureReader()
+{
+    assert(nullptr != mFile);
+
+    fclose(mFile);
+}
+
+uint64_t CaptureReader::GetStart_ns() const { return mHeader.mStart_ns; }
+
+void CaptureReader::Seek(uint64_t aTime_ns)
+{
+    uint64_t lOffset_byte = mHeader.mHeaderSize_byte;
+
+    // Last entry with mTime_ns <= aTime_ns
+    auto lIt = std::upper_bound(mIndex.begin(), mIndex.end(), aTime_ns,
+        [](uint64_t aT, const CaptureFile::IndexEntry& aE) { return aT < aE.mTime_ns; });
+
+    if (mIndex.begin() != lIt)
+    {
+        lIt--;
+
+        lOffset_byte = lIt->mOffset_byte;
+    }
+
+    SeekFile(lOffset_byte);
+}
+
+const uint8_t* CaptureReader::Next(CaptureFile::RecordHeader* aHeader)
+{
+    assert(nullptr != aHeader);
+
+    if (mEnd_byte < mOffset_byte + sizeof(CaptureFile::RecordHeader))
+    {
+        return nullptr;
+    }
+
+    if (1 != fread(aHeader, sizeof(CaptureFile::RecordHeader), 1, mFile))
+    {
+        return nullptr;
+    }
+
+    mOffset_byte += sizeof(CaptureFile::RecordHeader);
+
+    // A record truncated by a crash ends the capture
+    if (mEnd_byte < mOffset_byte + aHeader->mSize_byte)
+    {
+        return nullptr;
+    }
+
+    if (mData.size() < aHeader->mSize_byte + 1)
+    {
+        mData.resize(aHeader->mSize_byte + 1);
+    }
+
+    auto lRet = fread(mData.data(), 1, aHeader->mSize_byte, mFile);
+    KMS_EXCEPTION_ASSERT(aHeader->mSize_byte == lRet, RESULT_CAPTURE_READ_FAILED, "Cannot read the capture file", "");
+
+    mOffset_byte += aHeader->mSize_byte;
+
+    mData[aHeader->mSize_byte] = '\0';
+
+    return mData.data();
+}
+
+// Private
+// //////////////////////////////////////////////////////////////////////////
+
+// Walk the record headers without reading the payloads.
+void CaptureReader::BuildIndex()
+{
+    uint64_t lIndexNext_byte = 0;
+    uint64_t lOffset_byte    = mHeader.mHeaderSize_byte;
+
+    mIndex.clear();
+
+    while (mEnd_byte >= lOffset_byte + sizeof(CaptureFile::RecordHeader))
+    {
+        CaptureFile::RecordHeader lHeader;
+
+        ::SeekFile(mFile, lOffset_byte);
+
+        if (1 != fread(&lHeader, sizeof(lHeader), 1, mFile))
+        {
+            break;
+        }
+
+        if (lIndexNext_byte <= lOffset_byte)
+        {
+            CaptureFile::IndexEntry lEntry;
+
+            lEntry.mOffset_byte = lOffset_byte;
+            lEntry.mTime_ns     = lHeader.mTime_ns;
+
+            mIndex.push_back(lEntry);
+
+            lIndexNext_byte = lOffset_byte + mHeader.mIndexPeriod_byte;
+        }
+
+        lOffset_byte += sizeof(lHeader) + lHeader.mSize_byte;
+    }
+}
+
+void CaptureReader::Open(const char* aFileName)
+{
+    mEnd_byte = GetFileSize(mFile);
+
+    ::SeekFile(mFile, 0);
+
+    auto lRet = fread(&mHeader, sizeof(mHeader), 1, mFile);
+    KMS_EXCEPTION_ASSERT(1 == lRet, RESULT_INVALID_CAPTURE, "The capture file is too short", aFileName);
+
+    KMS_EXCEPTION_ASSERT(0 == memcmp(CaptureFile::MAGIC_FILE, mHeader.mMagic, sizeof(mHeader.mMagic)), RESULT_INVALID_CAPTURE, "Not a capture file", aFileName);
+
+    CaptureFile::FileTrailer lTrailer;
+
+    if (sizeof(mHeader) + sizeof(lTrailer) <= mEnd_byte)
+    {
+        ::SeekFile(mFile, mEnd_byte - sizeof(lTrailer));
+
+        lRet = fread(&lTrailer, sizeof(lTrailer), 1, mFile);
+        KMS_EXCEPTION_ASSERT(1 == lRet, RESULT_CAPTURE_READ_FAILED, "Cannot read the capture file", aFileName);
+
+        uint64_t lIndexSize_byte = sizeof(CaptureFile::IndexEntry) * static_cast<uint64_t>(lTrailer.mIndexCount);
+
+        if ((0 == memcmp(CaptureFile::MAGIC_INDEX, lTrailer.mMagic, sizeof(lTrailer.mMagic)))
+            && (lTrailer.mIndexOffset_byte + lIndexSize_byte + sizeof(lTrailer) == mEnd_byte))
+        {
+            mEnd_byte = lTrailer.mIndexOffset_byte;
+
+            mIndex.resize(lTrailer.mIndexCount);
+
+            if (0 < lTrailer.mIndexCount)
+            {
+                ::SeekFile(mFile, lTrailer.mIndexOffset_byte);
+
+                lRet = fread(mIndex.data(), sizeof(CaptureFile::IndexEntry), lTrailer.mIndexCount, mFile);
+                KMS_EXCEPTION_ASSERT(lTrailer.mIndexCount == lRet, RESULT_CAPTURE_READ_FAILED, "Cannot read the capture index", aFileName);
+            }
+        }
+        else
+        {
+            BuildIndex();
+        }
+    }
+
+    SeekFile(mHeader.mHeaderSize_byte);
+}
+
+void CaptureReader::SeekFile(uint64_t aOffset_byte)
+{
+    ::SeekFile(mFile, aOffset_byte);
+
+    mOffset_byte = aOffset_byte;
+}
+
+// Static functions
+// //////////////////////////////////////////////////////////////////////////
+
+uint64_t GetFileSize(FILE* aFile)
+{
+    assert(nullptr != aFile);
+
+    #ifdef _KMS_WINDOWS_
+        auto lRet = _fseeki64(aFile, 0, SEEK_END);
+        KMS_EXCEPTION_ASSERT(0 == lRet, RESULT_CAPTURE_READ_FAILED, "Cannot seek in the capture file", "");
+
+        return _ftelli64(aFile);
+    #else
+        auto lRet = fseeko(aFile, 0, SEEK_END);
+        KMS_EXCEPTION_ASSERT(0 == lRet, RESULT_CAPTURE_READ_FAILED, "Cannot seek in the capture file", "");
+
+        return ftello(aFile);
+    #endif
+}
+
+FILE* OpenFile(const char* aFileName)
+{
+    assert(nullptr != aFileName);
+
+    auto lResult = File_Open(aFileName, "rb");
+    KMS_EXCEPTION_ASSERT(nullptr != lResult, RESULT_CAPTURE_READ_FAILED, "Cannot open the capture file", aFileName);
+
+    setvbuf(lResult, nullptr, _IOFBF, FILE_BUFFER_SIZE_byte);
+
+    return lResult;
+}
+
+void SeekFile(FILE* aFile, uint64_t aOffset_byte)
+{
+    assert(nullptr != aFile);
+
+    #ifdef _KMS_WINDOWS_
+        auto lRet = _fseeki64(aFile, aOffset_byte, SEEK_SET);
+    #else
+        auto lRet = fseeko(aFile, aOffset_byte, SEEK_SET);
+    #endif
+
+    KMS_EXCEPTION_ASSERT(0 == lRet, RESULT_CAPTURE_READ_FAILED, "Cannot seek in the capture file", "");
+}
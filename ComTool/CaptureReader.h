@@ -0,0 +1,58 @@
+// Author    KMS - Martin Dubois, P. Eng.
+// Copyright (C) 2024 KMS
+// License   http://www.apache.org/licenses/LICENSE-2.0
+// Product   KMS-Tools
+// File      ComTool/CaptureReader.h
+
+#pragma once
+
+// ===== C++ ================================================================
+#include <vector>
+
+// ===== Local ==============================================================
+#include "CaptureFile.h"
+
+class CaptureReader
+{
+
+public:
+
+    CaptureReader(const char* aFileName);
+
+    ~CaptureReader();
+
+    // Wall clock at the start of the capture, ns since 1970-01-01 UTC
+    uint64_t GetStart_ns() const;
+
+    // Position the reader on the last indexed record at or before aTime_ns.
+    // Next may then return some records older than aTime_ns. The search
+    // relies on the record times never decreasing, CaptureWriter::Write
+    // keeps them in order.
+    void Seek(uint64_t aTime_ns);
+
+    // Return the payload, or nullptr at the end of the capture. The pointer
+    // stays valid until the next call.
+    const uint8_t* Next(CaptureFile::RecordHeader* aHeader);
+
+private:
+
+    NO_COPY(CaptureReader);
+
+    void BuildIndex();
+
+    void Open(const char* aFileName);
+
+    void SeekFile(uint64_t aOffset_byte);
+
+    std::vector<uint8_t> mData;
+
+    FILE* mFile;
+
+    CaptureFile::FileHeader mHeader;
+
+    std::vector<CaptureFile::IndexEntry> mIndex;
+
+    uint64_t mEnd_byte;
+    uint64_t mOffset_byte;
+
+};
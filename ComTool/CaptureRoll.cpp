@@ -0,0 +1,450 @@
+// Author    KMS - Martin Dubois, P. Eng.
+// Copyright (C) 2024 KMS
+// License   http://www.apache.org/licenses/LICENSE-2.0
+// Product   KMS-Tools
+// File      ComTool/CaptureRoll.cpp
+
+#include "Component.h"
+
+// ===== C++ ================================================================
+#include <vector>
+
+// ===== Local ==============================================================
+#include "Clock.h"
+#include "File.h"
+#include "LZ.h"
+
+#include "CaptureRoll.h"
+
+using namespace KMS;
+
+KMS_RESULT_STATIC(RESULT_CAPTURE_READ_FAILED);
+KMS_RESULT_STATIC(RESULT_CAPTURE_WRITE_FAILED);
+KMS_RESULT_STATIC(RESULT_INVALID_CAPTURE);
+
+// Constants
+// //////////////////////////////////////////////////////////////////////////
+
+#define BLOCK_SIZE_byte (1024 * 1024)
+
+// The records keeping a segment
+#define ERROR_FLAGS (CaptureFile::FLAG_FRAME_ERROR | CaptureFile::FLAG_MESSAGE_ERROR | CaptureFile::FLAG_VERIFY_FAILED)
+
+const char* CaptureRoll::EXTENSION            = ".kmscap";
+const char* CaptureRoll::EXTENSION_COMPRESSED = ".kmscapz";
+
+// Public
+// //////////////////////////////////////////////////////////////////////////
+
+CaptureRoll::CaptureRoll()
+    : mError(false)
+    , mFile(nullptr)
+    , mIndex(0)
+    , mKeepNext(false)
+    , mRetention_byte(0)
+    , mSegment_byte(0)
+    , mSegment_ns(0)
+    , mSegmentStart_ns(0)
+    , mCompressed_byte(0)
+    , mDeletedCount(0)
+    , mFailureCount(0)
+    , mRaw_byte(0)
+    , mRunning(false)
+{}
+
+CaptureRoll::~CaptureRoll() { Close(); }
+
+bool CaptureRoll::IsOpen() const { return nullptr != mFile; }
+
+void CaptureRoll::Open(const char* aPrefix, uint64_t aSegment_byte, unsigned int aSegment_s, uint64_t aRetention_byte)
+{
+    assert(nullptr != aPrefix);
+
+    assert(nullptr == mFile);
+
+    mIndex          = 0;
+    mKeepNext       = false;
+    mPrefix         = aPrefix;
+    mRetention_byte = aRetention_byte;
+    mSegment_byte   = aSegment_byte;
+    mSegment_ns     = static_cast<uint64_t>(aSegment_s) * 1000000000;
+
+    mClosed.clear();
+
+    mCompressed_byte = 0;
+    mDeletedCount    = 0;
+    mFailureCount    = 0;
+    mRaw_byte        = 0;
+
+    OpenSegment();
+
+    mRunning = true;
+
+    mThread = std::thread(&CaptureRoll::Run, this);
+}
+
+void CaptureRoll::Close()
+{
+    if (nullptr != mFile)
+    {
+        CloseSegment();
+    }
+
+    {
+        std::lock_guard<std::mutex> lLock(mMutex);
+
+        mRunning = false;
+    }
+
+    mCondition.notify_all();
+
+    if (mThread.joinable())
+    {
+        mThread.join();
+    }
+}
+
+void CaptureRoll::Flush()
+{
+    if (nullptr != mFile)
+    {
+        mWriter.Flush();
+    }
+}
+
+void CaptureRoll::Write(uint64_t aClock_ns, uint8_t aDirection, uint8_t aFlags, const void* aIn, unsigned int aInSize_byte, uint16_t aPort)
+{
+    assert(nullptr != mFile);
+
+    if (((0 < mSegment_byte) && (mSegment_byte <= mWriter.GetSize_byte()))
+        || ((0 < mSegment_ns) && (mSegmentStart_ns < aClock_ns) && (mSegment_ns <= aClock_ns - mSegmentStart_ns)))
+    {
+        CloseSegment();
+        OpenSegment();
+    }
+
+    if (0 != (aFlags & ERROR_FLAGS))
+    {
+        mError = true;
+    }
+
+    mWriter.Write(mWriter.ToTime_ns(aClock_ns), aDirection, aFlags, aIn, aInSize_byte, aPort);
+}
+
+void CaptureRoll::Display(std::ostream& aOut) const
+{
+    std::lock_guard<std::mutex> lLock(mMutex);
+
+    unsigned int lKeepCount = 0;
+    uint64_t     lSize_byte = 0;
+
+    for (const auto& lS : mClosed)
+    {
+        if (lS.mKeep) { lKeepCount++; }
+
+        lSize_byte += lS.mSize_byte;
+    }
+
+    aOut << "Capture segments   : " << mIndex << " segments, " << mQueue.size() << " waiting\n";
+    aOut << "    On disk        : " << mClosed.size() << " segments, " << lSize_byte << " bytes, " << lKeepCount << " around errors\n";
+    aOut << "    Deleted        : " << mDeletedCount << " segments\n";
+
+    if (0 < mRaw_byte)
+    {
+        char lLine[LINE_LENGTH];
+
+        sprintf_s(lLine SizeInfo(lLine), "    Compression    : %llu bytes to %llu bytes, %.1f %%",
+            static_cast<unsigned long long>(mRaw_byte), static_cast<unsigned long long>(mCompressed_byte), 100.0 * mCompressed_byte / mRaw_byte);
+
+        aOut << lLine << "\n";
+    }
+
+    if (0 < mFailureCount)
+    {
+        aOut << "    Failures       : " << mFailureCount << " segments not compressed\n";
+    }
+}
+
+void CaptureRoll::Expand(const char* aIn, const char* aOut)
+{
+    assert(nullptr != aIn);
+    assert(nullptr != aOut);
+
+    auto lIn = File_Open(aIn, "rb");
+    KMS_EXCEPTION_ASSERT(nullptr != lIn, RESULT_CAPTURE_READ_FAILED, "Cannot open the capture segment", aIn);
+
+    auto lOut = File_Open(aOut, "wb");
+    if (nullptr == lOut)
+    {
+        fclose(lIn);
+        KMS_EXCEPTION(RESULT_CAPTURE_WRITE_FAILED, "Cannot create the capture file", aOut);
+    }
+
+    try
+    {
+        CaptureFile::CompressedHeader lHeader;
+
+        auto lRet = fread(&lHeader, sizeof(lHeader), 1, lIn);
+        KMS_EXCEPTION_ASSERT(1 == lRet, RESULT_INVALID_CAPTURE, "The capture segment is too short", aIn);
+
+        KMS_EXCEPTION_ASSERT(0 == memcmp(CaptureFile::MAGIC_COMPRESSED, lHeader.mMagic, sizeof(lHeader.mMagic)), RESULT_INVALID_CAPTURE, "Not a compressed capture segment", aIn);
+
+        std::vector<uint8_t> lPacked(lHeader.mBlockSize_byte);
+        std::vector<uint8_t> lRaw   (lHeader.mBlockSize_byte);
+
+        CaptureFile::BlockHeader lBlock;
+
+        while (1 == fread(&lBlock, sizeof(lBlock), 1, lIn))
+        {
+            KMS_EXCEPTION_ASSERT((lHeader.mBlockSize_byte >= lBlock.mSize_byte) && (lBlock.mSize_byte >= lBlock.mStoredSize_byte), RESULT_INVALID_CAPTURE, "Corrupted capture segment", aIn);
+
+            lRet = fread(lPacked.data(), 1, lBlock.mStoredSize_byte, lIn);
+            KMS_EXCEPTION_ASSERT(lBlock.mStoredSize_byte == lRet, RESULT_INVALID_CAPTURE, "The capture segment is truncated", aIn);
+
+            auto lData = lPacked.data();
+
+            if (lBlock.mStoredSize_byte < lBlock.mSize_byte)
+            {
+                auto lSize_byte = LZ_Decompress(lPacked.data(), lBlock.mStoredSize_byte, lRaw.data(), lBlock.mSize_byte);
+                KMS_EXCEPTION_ASSERT(lBlock.mSize_byte == lSize_byte, RESULT_INVALID_CAPTURE, "Corrupted capture segment", aIn);
+
+                lData = lRaw.data();
+            }
+
+            lRet = fwrite(lData, 1, lBlock.mSize_byte, lOut);
+            KMS_EXCEPTION_ASSERT(lBlock.mSize_byte == lRet, RESULT_CAPTURE_WRITE_FAILED, "Cannot write the capture file", aOut);
+        }
+    }
+    catch (...)
+    {
+        fclose(lIn);
+        fclose(lOut);
+        throw;
+    }
+
+    fclose(lIn);
+
+    auto lRet = fclose(lOut);
+    KMS_EXCEPTION_ASSERT(0 == lRet, RESULT_CAPTURE_WRITE_FAILED, "Cannot write the capture file", aOut);
+}
+
+// Private
+// //////////////////////////////////////////////////////////////////////////
+
+void CaptureRoll::CloseSegment()
+{
+    assert(nullptr != mFile);
+
+    mWriter.Close();
+
+    auto lRet = fclose(mFile);
+
+    mFile = nullptr;
+
+    Segment lSegment;
+
+    lSegment.mError     = mError;
+    lSegment.mFileName  = mFileName;
+    lSegment.mKeep      = mError || mKeepNext;
+    lSegment.mSize_byte = mWriter.GetSize_byte();
+
+    mKeepNext = mError;
+
+    {
+        std::lock_guard<std::mutex> lLock(mMutex);
+
+        mQueue.push_back(lSegment);
+    }
+
+    mCondition.notify_all();
+
+    KMS_EXCEPTION_ASSERT(0 == lRet, RESULT_CAPTURE_WRITE_FAILED, "Cannot write the capture segment", lSegment.mFileName.c_str());
+}
+
+void CaptureRoll::OpenSegment()
+{
+    assert(nullptr == mFile);
+
+    char lFileName[LINE_LENGTH];
+
+    sprintf_s(lFileName SizeInfo(lFileName), "%s_%06u%s", mPrefix.c_str(), mIndex, EXTENSION);
+
+    mFile = File_Open(lFileName, "wb");
+    KMS_EXCEPTION_ASSERT(nullptr != mFile, RESULT_CAPTURE_WRITE_FAILED, "Cannot create the capture segment", lFileName);
+
+    mError           = false;
+    mFileName        = lFileName;
+    mSegmentStart_ns = Clock_GetTime_ns();
+
+    mIndex++;
+
+    mWriter.Open(mFile);
+}
+
+// ===== Background thread ==================================================
+
+bool CaptureRoll::Compress(Segment* aSegment)
+{
+    assert(nullptr != aSegment);
+
+    auto lExtension_byte = strlen(EXTENSION);
+
+    assert(aSegment->mFileName.size() > lExtension_byte);
+
+    auto lOutName = aSegment->mFileName.substr(0, aSegment->mFileName.size() - lExtension_byte) + EXTENSION_COMPRESSED;
+
+    auto lIn = File_Open(aSegment->mFileName.c_str(), "rb");
+    if (nullptr == lIn)
+    {
+        return false;
+    }
+
+    auto lOut = File_Open(lOutName.c_str(), "wb");
+    if (nullptr == lOut)
+    {
+        fclose(lIn);
+        return false;
+    }
+
+    CaptureFile::CompressedHeader lHeader;
+
+    memset(&lHeader, 0, sizeof(lHeader));
+
+    memcpy(lHeader.mMagic, CaptureFile::MAGIC_COMPRESSED, sizeof(lHeader.mMagic));
+
+    lHeader.mBlockSize_byte = BLOCK_SIZE_byte;
+
+    auto lResult = (1 == fwrite(&lHeader, sizeof(lHeader), 1, lOut));
+
+    uint64_t lSize_byte = sizeof(lHeader);
+
+    std::vector<uint8_t> lPacked(BLOCK_SIZE_byte);
+    std::vector<uint8_t> lRaw   (BLOCK_SIZE_byte);
+
+    while (lResult)
+    {
+        auto lRaw_byte = static_cast<unsigned int>(fread(lRaw.data(), 1, BLOCK_SIZE_byte, lIn));
+        if (0 == lRaw_byte)
+        {
+            lResult = (0 == ferror(lIn));
+            break;
+        }
+
+        // Only keep the compressed block when it is smaller
+        auto lPacked_byte = LZ_Compress(lRaw.data(), lRaw_byte, lPacked.data(), lRaw_byte - 1);
+
+        CaptureFile::BlockHeader lBlock;
+
+        lBlock.mSize_byte       = lRaw_byte;
+        lBlock.mStoredSize_byte = (0 == lPacked_byte) ? lRaw_byte : lPacked_byte;
+
+        lResult = (1 == fwrite(&lBlock, sizeof(lBlock), 1, lOut))
+            && (lBlock.mStoredSize_byte == fwrite((0 == lPacked_byte) ? lRaw.data() : lPacked.data(), 1, lBlock.mStoredSize_byte, lOut));
+
+        lSize_byte += sizeof(lBlock) + lBlock.mStoredSize_byte;
+    }
+
+    fclose(lIn);
+
+    if (0 != fclose(lOut))
+    {
+        lResult = false;
+    }
+
+    if (lResult)
+    {
+        remove(aSegment->mFileName.c_str());
+
+        aSegment->mFileName  = lOutName;
+        aSegment->mSize_byte = lSize_byte;
+    }
+    else
+    {
+        remove(lOutName.c_str());
+    }
+
+    return lResult;
+}
+
+// mMutex must be locked
+void CaptureRoll::Retain()
+{
+    if (0 == mRetention_byte)
+    {
+        return;
+    }
+
+    uint64_t lTotal_byte = 0;
+
+    for (const auto& lS : mClosed)
+    {
+        if (!lS.mKeep) { lTotal_byte += lS.mSize_byte; }
+    }
+
+    // The newest segment stays, the next one may hold an error
+    auto lIt = mClosed.begin();
+
+    while ((mRetention_byte < lTotal_byte) && (mClosed.end() - 1 > lIt))
+    {
+        if (lIt->mKeep)
+        {
+            lIt++;
+            continue;
+        }
+
+        remove(lIt->mFileName.c_str());
+
+        lTotal_byte -= lIt->mSize_byte;
+
+        mDeletedCount++;
+
+        lIt = mClosed.erase(lIt);
+    }
+}
+
+void CaptureRoll::Run()
+{
+    std::unique_lock<std::mutex> lLock(mMutex);
+
+    for (;;)
+    {
+        mCondition.wait(lLock, [this] { return (!mQueue.empty()) || (!mRunning); });
+
+        // Close waits until the queue is empty
+        if (mQueue.empty())
+        {
+            break;
+        }
+
+        auto lSegment  = mQueue.front();
+        auto lRaw_byte = lSegment.mSize_byte;
+
+        mQueue.pop_front();
+
+        lLock.unlock();
+
+        auto lOK = Compress(&lSegment);
+
+        lLock.lock();
+
+        if (lOK)
+        {
+            mCompressed_byte += lSegment.mSize_byte;
+            mRaw_byte        += lRaw_byte;
+        }
+        else
+        {
+            mFailureCount++;
+        }
+
+        // The segment before an error is kept too
+        if (lSegment.mError && (!mClosed.empty()))
+        {
+            mClosed.back().mKeep = true;
+        }
+
+        mClosed.push_back(lSegment);
+
+        Retain();
+    }
+}
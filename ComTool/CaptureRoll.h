@@ -0,0 +1,122 @@
+// Author    KMS - Martin Dubois, P. Eng.
+// Copyright (C) 2024 KMS
+// License   http://www.apache.org/licenses/LICENSE-2.0
+// Product   KMS-Tools
+// File      ComTool/CaptureRoll.h
+
+#pragma once
+
+// ===== C++ ================================================================
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+
+// ===== Local ==============================================================
+#include "CaptureWriter.h"
+
+// Capture in segments of limited size or duration. Each segment is a
+// complete capture file. A background thread compresses the closed
+// segments, then deletes the oldest ones to respect the retention limit.
+// The segments holding a verify failure, a frame error or an incomplete
+// message are kept with the segment before and the segment after them, and
+// do not count in the limit.
+//
+// Write only appends to the current segment and queues the closed ones, it
+// never waits for the background thread.
+class CaptureRoll
+{
+
+public:
+
+    static const char* EXTENSION;
+    static const char* EXTENSION_COMPRESSED;
+
+    CaptureRoll();
+
+    ~CaptureRoll();
+
+    bool IsOpen() const;
+
+    // aPrefix          The segments are {Prefix}_{Index}.kmscap
+    // aSegment_byte    0 means no size limit
+    // aSegment_s       0 means no duration limit
+    // aRetention_byte  0 means no limit
+    void Open(const char* aPrefix, uint64_t aSegment_byte, unsigned int aSegment_s, uint64_t aRetention_byte);
+
+    // Close the current segment and wait until the background thread
+    // compressed all the segments
+    void Close();
+
+    void Flush();
+
+    // aClock_ns    Clock_GetTime_ns value of the data
+    // aDirection   CaptureFile::DIRECTION_...
+    // aFlags       CaptureFile::FLAG_...
+    // aPort        Index of the session port, 0 for the main port
+    void Write(uint64_t aClock_ns, uint8_t aDirection, uint8_t aFlags, const void* aIn, unsigned int aInSize_byte, uint16_t aPort = 0);
+
+    void Display(std::ostream& aOut) const;
+
+    // Decompress a segment into a capture file Export and Query read
+    static void Expand(const char* aIn, const char* aOut);
+
+private:
+
+    NO_COPY(CaptureRoll);
+
+    struct Segment
+    {
+        // The segment holds an error record
+        bool mError;
+
+        // Retention never deletes the segment
+        bool mKeep;
+
+        std::string mFileName;
+        uint64_t    mSize_byte;
+    };
+
+    void CloseSegment();
+
+    void OpenSegment();
+
+    // ===== Background thread ==============================================
+
+    // Return  false when the compression failed, the segment stays as is
+    bool Compress(Segment* aSegment);
+
+    void Retain();
+
+    void Run();
+
+    // ===== Command thread =================================================
+    bool          mError;
+    FILE*         mFile;
+    std::string   mFileName;
+    unsigned int  mIndex;
+    bool          mKeepNext;
+    std::string   mPrefix;
+    uint64_t      mRetention_byte;
+    uint64_t      mSegment_byte;
+    uint64_t      mSegment_ns;
+    uint64_t      mSegmentStart_ns;
+    CaptureWriter mWriter;
+
+    // ===== Shared, protected by mMutex ====================================
+
+    // The compressed segments, the oldest first
+    std::deque<Segment> mClosed;
+
+    std::condition_variable mCondition;
+    uint64_t                mCompressed_byte;
+    unsigned int            mDeletedCount;
+    unsigned int            mFailureCount;
+    mutable std::mutex      mMutex;
+    std::deque<Segment>     mQueue;
+    uint64_t                mRaw_byte;
+    bool                    mRunning;
+    std::thread             mThread;
+
+};
@@ -0,0 +1,211 @@
+// Author    KMS - Martin Dubois, P. Eng.
+// Copyright (C) 2024 KMS
+// License   http://www.apache.org/licenses/LICENSE-2.0
+// Product   KMS-Tools
+// File      ComTool/CaptureWriter.cpp
+
+#include "Component.h"
+
+// ===== Local ==============================================================
+#include "Clock.h"
+
+#include "CaptureWriter.h"
+
+using namespace KMS;
+
+KMS_RESULT_STATIC(RESULT_CAPTURE_WRITE_FAILED);
+
+// Constants
+// //////////////////////////////////////////////////////////////////////////
+
+const unsigned int CaptureWriter::BUFFER_SIZE_byte  = 1024 * 1024;
+const unsigned int CaptureWriter::INDEX_PERIOD_byte =   64 * 1024;
+
+// Public
+// //////////////////////////////////////////////////////////////////////////
+
+CaptureWriter::CaptureWriter()
+    : mBuffer(new uint8_t[BUFFER_SIZE_byte])
+    , mBufferSize_byte(0)
+    , mFile(nullptr)
+    , mIndexNext_byte(0)
+    , mOffset_byte(0)
+    , mLast_ns(0)
+    , mStart_ns(0)
+{}
+
+CaptureWriter::~CaptureWriter()
+{
+    Close();
+
+    assert(nullptr != mBuffer);
+
+    delete[] mBuffer;
+}
+
+bool CaptureWriter::IsOpen() const { return nullptr != mFile; }
+
+void CaptureWriter::Open(FILE* aFile, uint64_t aStart_ns)
+{
+    assert(nullptr != aFile);
+
+    assert(nullptr == mFile);
+
+    auto lNow_ns = Clock_GetTime_ns();
+
+    mFile     = aFile;
+    mStart_ns = ((0 == aStart_ns) || (lNow_ns < aStart_ns)) ? lNow_ns : aStart_ns;
+
+    mBufferSize_byte = 0;
+    mIndexNext_byte  = 0;
+    mLast_ns         = 0;
+    mOffset_byte     = 0;
+
+    mIndex.clear();
+
+    CaptureFile::FileHeader lHeader;
+
+    memset(&lHeader, 0, sizeof(lHeader));
+
+    memcpy(lHeader.mMagic, CaptureFile::MAGIC_FILE, sizeof(lHeader.mMagic));
+
+    lHeader.mHeaderSize_byte  = sizeof(lHeader);
+    lHeader.mIndexPeriod_byte = INDEX_PERIOD_byte;
+    lHeader.mStart_ns         = Clock_GetWall_ns() - (lNow_ns - mStart_ns);
+
+    Append(&lHeader, sizeof(lHeader));
+}
+
+void CaptureWriter::Close()
+{
+    if (nullptr != mFile)
+    {
+        CaptureFile::FileTrailer lTrailer;
+
+        memset(&lTrailer, 0, sizeof(lTrailer));
+
+        lTrailer.mIndexCount       = static_cast<uint32_t>(mIndex.size());
+        lTrailer.mIndexOffset_byte = mOffset_byte;
+
+        memcpy(lTrailer.mMagic, CaptureFile::MAGIC_INDEX, sizeof(lTrailer.mMagic));
+
+        if (!mIndex.empty())
+        {
+            Append(mIndex.data(), static_cast<unsigned int>(sizeof(CaptureFile::IndexEntry) * mIndex.size()));
+        }
+
+        Append(&lTrailer, sizeof(lTrailer));
+
+        Flush();
+
+        mFile = nullptr;
+    }
+}
+
+void CaptureWriter::Flush()
+{
+    assert(nullptr != mFile);
+
+    if (0 < mBufferSize_byte)
+    {
+        WriteFile(mBuffer, mBufferSize_byte);
+
+        mBufferSize_byte = 0;
+    }
+
+    fflush(mFile);
+}
+
+uint64_t CaptureWriter::GetSize_byte() const { return mOffset_byte; }
+
+uint64_t CaptureWriter::GetTime_ns() const { return ToTime_ns(Clock_GetTime_ns()); }
+
+uint64_t CaptureWriter::ToTime_ns(uint64_t aClock_ns) const
+{
+    return (mStart_ns < aClock_ns) ? aClock_ns - mStart_ns : 0;
+}
+
+void CaptureWriter::Write(uint8_t aDirection, uint8_t aFlags, const void* aIn, unsigned int aInSize_byte)
+{
+    Write(GetTime_ns(), aDirection, aFlags, aIn, aInSize_byte);
+}
+
+void CaptureWriter::Write(uint64_t aTime_ns, uint8_t aDirection, uint8_t aFlags, const void* aIn, unsigned int aInSize_byte, uint16_t aPort)
+{
+    assert(nullptr != aIn);
+
+    assert(nullptr != mFile);
+
+    if (mLast_ns > aTime_ns)
+    {
+        aFlags   |= CaptureFile::FLAG_TIME_CLAMPED;
+        aTime_ns  = mLast_ns;
+    }
+    else
+    {
+        mLast_ns = aTime_ns;
+    }
+
+    if (mIndexNext_byte <= mOffset_byte)
+    {
+        CaptureFile::IndexEntry lEntry;
+
+        lEntry.mOffset_byte = mOffset_byte;
+        lEntry.mTime_ns     = aTime_ns;
+
+        mIndex.push_back(lEntry);
+
+        mIndexNext_byte = mOffset_byte + INDEX_PERIOD_byte;
+    }
+
+    CaptureFile::RecordHeader lHeader;
+
+    lHeader.mDirection = aDirection;
+    lHeader.mFlags     = aFlags;
+    lHeader.mPort      = aPort;
+    lHeader.mSize_byte = aInSize_byte;
+    lHeader.mTime_ns   = aTime_ns;
+
+    Append(&lHeader, sizeof(lHeader));
+    Append(aIn, aInSize_byte);
+}
+
+// Private
+// //////////////////////////////////////////////////////////////////////////
+
+void CaptureWriter::Append(const void* aIn, unsigned int aInSize_byte)
+{
+    assert(nullptr != aIn);
+
+    if (BUFFER_SIZE_byte - mBufferSize_byte < aInSize_byte)
+    {
+        if (0 < mBufferSize_byte)
+        {
+            WriteFile(mBuffer, mBufferSize_byte);
+
+            mBufferSize_byte = 0;
+        }
+
+        if (BUFFER_SIZE_byte <= aInSize_byte)
+        {
+            // Large payloads go straight to the file
+            WriteFile(aIn, aInSize_byte);
+
+            mOffset_byte += aInSize_byte;
+            return;
+        }
+    }
+
+    memcpy(mBuffer + mBufferSize_byte, aIn, aInSize_byte);
+
+    mBufferSize_byte += aInSize_byte;
+    mOffset_byte     += aInSize_byte;
+}
+
+void CaptureWriter::WriteFile(const void* aIn, unsigned int aInSize_byte)
+{
+    assert(nullptr != mFile);
+
+    auto lRet = fwrite(aIn, 1, aInSize_byte, mFile);
+    KMS_EXCEPTION_ASSERT(aInSize_byte == lRet, RESULT_CAPTURE_WRITE_FAILED, "Cannot write the capture file", aInSize_byte);
+}
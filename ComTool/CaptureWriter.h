@@ -0,0 +1,86 @@
+// Author    KMS - Martin Dubois, P. Eng.
+// Copyright (C) 2024 KMS
+// License   http://www.apache.org/licenses/LICENSE-2.0
+// Product   KMS-Tools
+// File      ComTool/CaptureWriter.h
+
+#pragma once
+
+// ===== C++ ================================================================
+#include <vector>
+
+// ===== Local ==============================================================
+#include "CaptureFile.h"
+
+class CaptureWriter
+{
+
+public:
+
+    static const unsigned int BUFFER_SIZE_byte;
+    static const unsigned int INDEX_PERIOD_byte;
+
+    CaptureWriter();
+
+    ~CaptureWriter();
+
+    bool IsOpen() const;
+
+    // The caller keeps the ownership of aFile. Open writes the file header.
+    // aStart_ns  Clock_GetTime_ns value of the capture start, 0 for now. It
+    //            lets a capture begin with records kept in memory.
+    void Open(FILE* aFile, uint64_t aStart_ns = 0);
+
+    // Write the buffered records, the index and the trailer. The file is
+    // not closed.
+    void Close();
+
+    void Flush();
+
+    // The bytes written since Open, including the buffered ones
+    uint64_t GetSize_byte() const;
+
+    // Monotonic time since Open
+    uint64_t GetTime_ns() const;
+
+    // Convert a Clock_GetTime_ns value to the time since Open. The times
+    // before Open become 0.
+    uint64_t ToTime_ns(uint64_t aClock_ns) const;
+
+    // aDirection  CaptureFile::DIRECTION_...
+    // aFlags      CaptureFile::FLAG_...
+    void Write(uint8_t aDirection, uint8_t aFlags, const void* aIn, unsigned int aInSize_byte);
+
+    // The records of the different ports and receive paths do not reach
+    // the writer in the order of their read times. A record older than the
+    // previous one gets the time of the previous one and the
+    // CaptureFile::FLAG_TIME_CLAMPED flag, so the times in the file never
+    // decrease and the readers can stop or seek on them.
+    // aTime_ns  Time since Open
+    // aPort     Index of the session port, 0 for the main port
+    void Write(uint64_t aTime_ns, uint8_t aDirection, uint8_t aFlags, const void* aIn, unsigned int aInSize_byte, uint16_t aPort = 0);
+
+private:
+
+    NO_COPY(CaptureWriter);
+
+    void Append(const void* aIn, unsigned int aInSize_byte);
+
+    void WriteFile(const void* aIn, unsigned int aInSize_byte);
+
+    uint8_t*     mBuffer;
+    unsigned int mBufferSize_byte;
+
+    FILE* mFile;
+
+    std::vector<CaptureFile::IndexEntry> mIndex;
+
+    uint64_t mIndexNext_byte;
+    uint64_t mOffset_byte;
+
+    // Time of the last record
+    uint64_t mLast_ns;
+
+    uint64_t mStart_ns;
+
+};
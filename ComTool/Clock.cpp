@@ -0,0 +1,43 @@
+// Author    KMS - Martin Dubois, P. Eng.
+// Copyright (C) 2024 KMS
+// License   http://www.apache.org/licenses/LICENSE-2.0
+// Product   KMS-Tools
+// File      ComTool/Clock.cpp
+
+#include "Component.h"
+
+// ===== C++ ================================================================
+#include <chrono>
+
+// ===== Local ==============================================================
+#include "Clock.h"
+
+// Functions
+// //////////////////////////////////////////////////////////////////////////
+
+uint64_t Clock_GetTime_ns()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+uint64_t Clock_GetWall_ns()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+void Clock_WaitUntil(uint64_t aTime_ns)
+{
+    static const uint64_t SPIN_ns = 1000000;
+
+    auto lNow_ns = Clock_GetTime_ns();
+
+    if (lNow_ns + SPIN_ns < aTime_ns)
+    {
+        std::this_thread::sleep_for(std::chrono::nanoseconds(aTime_ns - lNow_ns - SPIN_ns));
+    }
+
+    while (Clock_GetTime_ns() < aTime_ns)
+    {
+        std::this_thread::yield();
+    }
+}
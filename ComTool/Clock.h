@@ -0,0 +1,20 @@
+// Author    KMS - Martin Dubois, P. Eng.
+// Copyright (C) 2024 KMS
+// License   http://www.apache.org/licenses/LICENSE-2.0
+// Product   KMS-Tools
+// File      ComTool/Clock.h
+
+#pragma once
+
+// Monotonic time in ns. It does not follow the wall clock adjustments, so
+// the differences between two values are always valid.
+extern uint64_t Clock_GetTime_ns();
+
+// Wall clock time in ns since 1970-01-01 00:00:00 UTC
+extern uint64_t Clock_GetWall_ns();
+
+// Return at aTime_ns (Clock_GetTime_ns value) or just after. The thread
+// sleeps until about 1 ms before, then spins, so the wake up does not
+// depend on the scheduler resolution. Return immediately when the time is
+// already passed.
+extern void Clock_WaitUntil(uint64_t aTime_ns);
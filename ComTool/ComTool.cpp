@@ -5,7 +5,11 @@
 // Product   KMS-Tools
 // File      ComTool/ComTool.cpp
 
-#include <KMS/Base.h>
+#include "Component.h"
+
+// ===== C++ ================================================================
+#include <memory>
+#include <vector>
 
 // ===== Includes ===========================================================
 #include <KMS/Banner.h>
@@ -14,31 +18,91 @@
 #include <KMS/CLI/Macros.h>
 #include <KMS/CLI/Tool.h>
 #include <KMS/Com/Port.h>
+#include <KMS/DI/Dictionary.h>
+#include <KMS/DI/String.h>
+#include <KMS/DI/UInt.h>
 #include <KMS/Main.h>
 
 // ===== Local ==============================================================
 #include "../Common/Version.h"
 
+#include "Bench.h"
+#include "CaptureReader.h"
+#include "CaptureRoll.h"
+#include "CaptureWriter.h"
+#include "Clock.h"
+#include "Decoder.h"
+#include "Deframer.h"
+#include "Delimiter.h"
+#include "Detector.h"
+#include "Formatter.h"
+#include "FrameT.h"
+#include "GapStats.h"
+#include "Generator.h"
+#include "Hex.h"
+#include "IDecoderListener.h"
+#include "IDetectTarget.h"
+#include "IFrameListener.h"
+#include "IMessageListener.h"
+#include "LatencyStats.h"
+#include "MappedFile.h"
+#include "Matcher.h"
+#include "Query.h"
+#include "Receiver.h"
+#include "Responder.h"
+#include "SelfTest.h"
+#include "Session.h"
+#include "Stats.h"
+#include "TimeFormatter.h"
+#include "Timer.h"
+#include "Trigger.h"
+
 using namespace KMS;
 
+KMS_RESULT_STATIC(RESULT_BENCH_FAILED);
+KMS_RESULT_STATIC(RESULT_SELF_TEST_FAILED);
+KMS_RESULT_STATIC(RESULT_EXPECT_TIMEOUT);
+
 // Configuration
 // //////////////////////////////////////////////////////////////////////////
 
 #define CONFIG_FILE ("ComTool.cfg")
 
+#define BENCH_ORDER_DEFAULT     (15)
+#define BENCH_SIZE_DEFAULT_byte (1024 * 1024)
+
+#define BENCHMARK_SIZE_DEFAULT_byte (256)
+#define BENCHMARK_TOTAL_DEFAULT_MiB (64)
+
+#define SEND_FILE_CHUNK_DEFAULT_byte (1024)
+
+#define AUTO_DETECT_WINDOW_DEFAULT_ms (250)
+
+// Verify failures per hour
+#define QUERY_INTERVAL_DEFAULT_s (3600)
+
 // Class
 // //////////////////////////////////////////////////////////////////////////
 
-class Tool final : public CLI::Tool
+class Tool final : public CLI::Tool, public IDecoderListener, public IDetectTarget, public IFrameListener, public IMessageListener
 {
 
 public:
 
-    static const char* DATA_FILE_DEFAULT;
+    static const uint32_t CAPTURE_TIMEOUT_DEFAULT_ms;
+    static const char*    DATA_FILE_DEFAULT;
+    static const uint32_t DATA_SEGMENT_SIZE_DEFAULT_MiB;
 
 private:
 
-    DI::File mDataFile;
+    DI::UInt<uint32_t> mCaptureTimeout_ms;
+    DI::File           mDataFile;
+    DI::UInt<uint32_t> mDataRetention_MiB;
+    DI::UInt<uint32_t> mDataSegmentSize_MiB;
+    DI::UInt<uint32_t> mDataSegmentTime_s;
+    DI::String         mDataSegments;
+    DI::Dictionary     mPorts;
+    DI::File           mSessionFile;
 
 public:
 
@@ -51,70 +115,277 @@ public:
 
     Tool();
 
+    ~Tool();
+
+    // Try each speed with no parity, then each speed with even parity and
+    // with odd parity, until the received data gives a confident match. The
+    // port keeps the best setting.
+    // aProbe       Sent after each change, may be nullptr
+    // aWindow_ms   Maximum receive time per setting
+    // Return       true when the match is confident
+    bool AutoDetect(const uint32_t* aSpeeds_bps, unsigned int aSpeedCount, const uint8_t* aProbe, unsigned int aProbeSize_byte, unsigned int aWindow_ms);
+
+    // Run the DISPLAY, DUMP and WRITE paths selected by aFlags on generated
+    // data and report the throughput of each.
+    void Benchmark(unsigned int aFlags, unsigned int aSize_byte, unsigned int aTotal_MiB);
+
+    // Forward the data between the main port and the session port in both
+    // directions. The receiver threads forward each chunk as soon as they
+    // read it; this thread only displays and writes the data.
+    void Bridge(Session::Channel* aChannel, unsigned int aFlags, unsigned int aDuration_ms);
+
+    // Display and write the decoded frames
+    // aCount  0 means until the receive timeout
+    void Decode(Decoder* aDecoder, unsigned int aCount = 0, unsigned int aFlags = 0);
+
+    // Scan the received data until one of the patterns matches. The bytes
+    // after the match stay available for the next command.
+    // aMatcher  Compiled patterns
+    // Return    The index of the matching pattern or Matcher::NO_MATCH
+    unsigned int Expect(Matcher* aMatcher, unsigned int aTimeout_ms, unsigned int aFlags = 0);
+
+    // aFrom_ms and aTo_ms are relative to the start of the capture
+    void Export(const char* aFileName, bool aHex, uint64_t aFrom_ms = 0, uint64_t aTo_ms = UINT64_MAX);
+
+    // Send the streams of the generator at their deadlines. A timer wakes
+    // this thread for each deadline.
+    // aCount        Total number of sends, 0 means no limit
+    // aDuration_ms  0 means no limit
+    void Generate(Generator* aGenerator, unsigned int aFlags, uint64_t aCount, unsigned int aDuration_ms);
+
+    // Scan a complete capture with one thread per processor
+    // aInterval_s  0 means no per interval counts
+    // aPattern     nullptr means no search
+    void Query(const char* aFileName, unsigned int aInterval_s, const uint8_t* aPattern = nullptr, unsigned int aPatternSize_byte = 0);
+
     void Receive(unsigned int aSize_byte = 0, unsigned int aFlags = 0);
 
     void ReceiveAndVerify(const void* aIn, unsigned int aInSize_byte, unsigned int aFlags = 0);
 
+    // aCount  0 means until the receive timeout
+    void ReceiveFrames(unsigned int aCount = 0, unsigned int aFlags = 0);
+
+    // Display and write one record per message
+    // aCount  0 means until the receive timeout
+    void ReceiveMessages(Delimiter* aDelimiter, unsigned int aCount = 0, unsigned int aFlags = 0);
+
     void ResetDataFile();
 
+    // Reply to the received data following the rules until the duration
+    // ends. The delay of a rule counts from the time the chunk holding the
+    // end of the pattern was read.
+    void Respond(Responder* aResponder, unsigned int aFlags, unsigned int aDuration_ms);
+
     void Send(const void* aIn, unsigned int aInSize_byte, unsigned int aFlags = 0);
 
+    // Send the file directly from its mapping, one chunk at a time
+    // aRate_Bps    0 means no rate limit. The FRAME_T bytes count.
+    // aDelay_us    Pause after each chunk
+    // aChunk_byte  Payload bytes per chunk, or per frame with FRAME_T
+    void SendFile(const char* aFileName, unsigned int aFlags, unsigned int aRate_Bps, unsigned int aDelay_us, unsigned int aChunk_byte);
+
     // ===== CLI::Tool ==============================================
     virtual void DisplayHelp(FILE* aOut) const;
     virtual int  ExecuteCommand(CLI::CommandLine* aCmd);
     virtual int  Run();
 
+    // ===== IDecoderListener =======================================
+    virtual void OnDecoded    (const uint8_t* aIn, unsigned int aInSize_byte, const char* aInfo);
+    virtual void OnDecodeError(const uint8_t* aIn, unsigned int aInSize_byte, const char* aReason);
+
+    // ===== IDetectTarget ==========================================
+    virtual void         OnDetectBegin(uint32_t aSpeed_bps, Com::Parity aParity);
+    virtual unsigned int OnDetectRead (uint8_t* aOut, unsigned int aOutSize_byte, unsigned int aTimeout_ms);
+    virtual void         OnDetectEnd  ();
+
+    // ===== IFrameListener =========================================
+    virtual void OnFrame     (const uint8_t* aIn, unsigned int aInSize_byte);
+    virtual void OnFrameError(const uint8_t* aIn, unsigned int aInSize_byte);
+
+    // ===== IMessageListener =======================================
+    virtual void OnMessage(const uint8_t* aIn, unsigned int aInSize_byte, uint64_t aTime_ns, bool aComplete);
+
 private:
 
     NO_COPY(Tool);
 
+    struct Segment
+    {
+        const void*  mData;
+        unsigned int mSize_byte;
+    };
+
+    int Cmd_AutoDetect            (CLI::CommandLine* aCmd);
+    int Cmd_Bench                 (CLI::CommandLine* aCmd);
+    int Cmd_Benchmark             (CLI::CommandLine* aCmd);
+    int Cmd_Bridge                (CLI::CommandLine* aCmd);
+    int Cmd_Capture               (CLI::CommandLine* aCmd);
+    int Cmd_Capture_Expand        (CLI::CommandLine* aCmd);
+    int Cmd_Capture_Start         (CLI::CommandLine* aCmd);
+    int Cmd_Capture_Stop          (CLI::CommandLine* aCmd);
     int Cmd_ClearDTR              (CLI::CommandLine* aCmd);
     int Cmd_ClearRTS              (CLI::CommandLine* aCmd);
     int Cmd_Connect               (CLI::CommandLine* aCmd);
+    int Cmd_Decode                (CLI::CommandLine* aCmd);
     int Cmd_Disconnect            (CLI::CommandLine* aCmd);
+    int Cmd_Expect                (CLI::CommandLine* aCmd);
+    int Cmd_Export                (CLI::CommandLine* aCmd);
+    int Cmd_Gaps                  (CLI::CommandLine* aCmd);
+    int Cmd_Generate              (CLI::CommandLine* aCmd);
+    int Cmd_Query                 (CLI::CommandLine* aCmd);
     int Cmd_Receive               (CLI::CommandLine* aCmd);
     int Cmd_ReceiveAndVerify      (CLI::CommandLine* aCmd);
     int Cmd_ReceiveAndVerify_ASCII(CLI::CommandLine* aCmd);
     int Cmd_ReceiveAndVerify_Hex  (CLI::CommandLine* aCmd);
+    int Cmd_ReceiveFrames         (CLI::CommandLine* aCmd);
+    int Cmd_ReceiveMessages       (CLI::CommandLine* aCmd);
+    int Cmd_Respond               (CLI::CommandLine* aCmd);
+    #ifdef _DEBUG
+        int Cmd_SelfTest          (CLI::CommandLine* aCmd);
+    #endif
     int Cmd_Send                  (CLI::CommandLine* aCmd);
     int Cmd_Send_ASCII            (CLI::CommandLine* aCmd);
     int Cmd_Send_Hex              (CLI::CommandLine* aCmd);
+    int Cmd_SendFile              (CLI::CommandLine* aCmd);
+    int Cmd_Session               (CLI::CommandLine* aCmd);
+    int Cmd_Session_Start         (CLI::CommandLine* aCmd);
+    int Cmd_Session_Stop          (CLI::CommandLine* aCmd);
     int Cmd_SetDTR                (CLI::CommandLine* aCmd);
     int Cmd_SetRTS                (CLI::CommandLine* aCmd);
     int Cmd_Status                (CLI::CommandLine* aCmd);
-
-    void DisplayDumpWrite(const void* aIn, unsigned int aInSize_byte, unsigned int aFlags, const char* aOp);
+    int Cmd_Trigger               (CLI::CommandLine* aCmd);
+    int Cmd_Trigger_Start         (CLI::CommandLine* aCmd);
+    int Cmd_Trigger_Stop          (CLI::CommandLine* aCmd);
+
+    // aTime_ns       Clock_GetTime_ns value of the data
+    // aDirection     CaptureFile::DIRECTION_...
+    // aCaptureFlags  CaptureFile::FLAG_...
+    void DisplayDumpWrite(const void* aIn, unsigned int aInSize_byte, unsigned int aFlags, const char* aOp, uint64_t aTime_ns, uint8_t aDirection, uint8_t aCaptureFlags = 0);
+
+    // The port the current command uses
+    GapStats * GetGaps();
+    Com::Port* GetPort();
+    Receiver * GetReceiver();
+
+    // The bytes Expect did not use come first
+    // aFlags       Com::Port::FLAG_READ_ALL
+    // aTimeout_ms  Limit of the wait on the receiver, CaptureTimeout by
+    //              default. Without receiver, the port read timeout applies.
+    // aTime_ns     Clock_GetTime_ns value taken when the data was read
+    unsigned int Read(void* aOut, unsigned int aOutSize_byte, unsigned int aFlags, uint64_t* aTime_ns);
+    unsigned int Read(void* aOut, unsigned int aOutSize_byte, unsigned int aFlags, unsigned int aTimeout_ms, uint64_t* aTime_ns);
+
+    // Receiver::Read_Begin on the receiver the current command uses
+    const uint8_t* Read_Begin(unsigned int* aSize_byte, unsigned int aTimeout_ms, uint64_t* aTime_ns);
 
     void ReceiveAndVerify_Hex(const char* aIn, unsigned int aFlags);
 
+    // A command using a port may start with the name of a session port,
+    // otherwise it uses the main port.
+    void SelectPort(CLI::CommandLine* aCmd);
+
     void Send_Hex(const char* aIn, unsigned int aFlags);
 
+    // Write to the port the current command uses
+    // aTime_ns  Clock_GetTime_ns value taken just before the write
+    void Write(const void* aIn, unsigned int aInSize_byte, uint64_t* aTime_ns);
+
+    // Write the segments with one port write
+    // aSize_byte  The number of bytes written
+    // Return      The bytes written, contiguous, valid until the next write
+    const uint8_t* Write(const Segment* aSegments, unsigned int aCount, unsigned int* aSize_byte, uint64_t* aTime_ns);
+
     Com::Port mPort;
 
     CLI::Macros mMacros;
 
+    // Received bytes Expect read from the port but did not use. They are
+    // dropped when a command uses another port.
+    uint8_t      mUnread[LINE_LENGTH];
+    unsigned int mUnreadSize_byte;
+    uint64_t     mUnreadTime_ns;
+
+    // Byte gaps are measured between received chunks, the bytes read
+    // together have no measurable gap.
+    GapStats mByteGaps;
+    GapStats mFrameGaps;
+
+    // The records of all the ports, Status and the statistics log read it
+    Stats mStats;
+
+    Receiver mReceiver;
+
+    CaptureRoll   mCaptureRoll;
+    CaptureWriter mCaptureWriter;
+
+    Trigger mTrigger;
+
+    Formatter mFormatter;
+
+    Deframer     mDeframer;
+    unsigned int mDeframerFlags;
+    uint64_t     mDeframerTime_ns;
+
+    unsigned int mDelimiterFlags;
+
+    TimeFormatter mTimeFormatter;
+
+    // KMS::Com::Port has no vectored write, the segments of a write meet
+    // here.
+    std::vector<uint8_t> mGather;
+
+    unsigned int mDecoderFlags;
+    uint64_t     mDecoderTime_ns;
+
+    // AutoDetect sends the probe after each setting change
+    const uint8_t* mDetectProbe;
+    unsigned int   mDetectProbeSize_byte;
+
+    // ===== Session ========================================================
+    Session           mSession;
+    CaptureWriter     mSessionWriter;
+
+    // nullptr when the current command uses the main port
+    Session::Channel* mChannel;
+
 };
 
 // Constants
 // //////////////////////////////////////////////////////////////////////////
 
-static const Cfg::MetaData MD_DATA_FILE("DataFile = {Name}");
+static const Cfg::MetaData MD_CAPTURE_TIMEOUT   ("CaptureTimeout = {Value_ms}");
+static const Cfg::MetaData MD_DATA_FILE         ("DataFile = {Name}");
+static const Cfg::MetaData MD_DATA_RETENTION    ("DataRetention = {Size_MiB}");
+static const Cfg::MetaData MD_DATA_SEGMENT_SIZE ("DataSegmentSize = {Size_MiB}");
+static const Cfg::MetaData MD_DATA_SEGMENT_TIME ("DataSegmentTime = {Duration_s}");
+static const Cfg::MetaData MD_DATA_SEGMENTS     ("DataSegments = {Prefix}");
+static const Cfg::MetaData MD_PORTS             ("Ports.{Name}.{Entry} = {Value}");
+static const Cfg::MetaData MD_SESSION_FILE      ("SessionFile = {Name}");
 
 // Static function declarations
 // //////////////////////////////////////////////////////////////////////////
 
-static void CreateTimestamp(char* aOut, unsigned int aOutSize_byte);
+// Reconnect the port with the setting
+static void ApplySetting(Com::Port* aPort, uint32_t aSpeed_bps, Com::Parity aParity);
+
+static DI::Object* CreatePort();
 
-static void Dump(FILE* aOut, const void* aIn, unsigned int aInSize_byte);
+static const char* GetOpName(const CaptureFile::RecordHeader& aHeader);
+
+// Return  Trigger::CONDITION_...
+static unsigned int ToConditions(const char* aIn);
 
 static unsigned int ToFlags(const char* aIn);
 
-static unsigned int ToFrameT(const void* aIn, unsigned int aInSize_byte, void* aOut, unsigned int aOutSize_byte);
+// ASCII {Pattern} or Hex {Pattern}
+static void ToPattern(CLI::CommandLine* aCmd, std::vector<uint8_t>* aOut);
 
 // Entry point
 // //////////////////////////////////////////////////////////////////////////
 
-const char* Tool::DATA_FILE_DEFAULT = "";
+const uint32_t Tool::CAPTURE_TIMEOUT_DEFAULT_ms = 1000;
+const char*    Tool::DATA_FILE_DEFAULT          = "";
+const uint32_t Tool::DATA_SEGMENT_SIZE_DEFAULT_MiB = 256;
 
 const unsigned int Tool::FLAG_DISPLAY       = 0x00000001;
 const unsigned int Tool::FLAG_DUMP          = 0x00000002;
@@ -151,13 +422,42 @@ int main(int aCount, const char** aVector)
 // Public
 // //////////////////////////////////////////////////////////////////
 
-Tool::Tool() : mDataFile(nullptr, DATA_FILE_DEFAULT), mMacros(this)
+Tool::Tool()
+    : mCaptureTimeout_ms(CAPTURE_TIMEOUT_DEFAULT_ms)
+    , mDataFile(nullptr, DATA_FILE_DEFAULT)
+    , mDataSegmentSize_MiB(DATA_SEGMENT_SIZE_DEFAULT_MiB)
+    , mSessionFile(nullptr, DATA_FILE_DEFAULT)
+    , mMacros(this)
+    , mUnreadSize_byte(0)
+    , mUnreadTime_ns(0)
+    , mStats(&mByteGaps)
+    , mReceiver(&mPort, &mByteGaps)
+    , mFormatter(stdout)
+    , mDeframer(this)
+    , mDeframerFlags(0)
+    , mDeframerTime_ns(0)
+    , mDelimiterFlags(0)
+    , mDecoderFlags(0)
+    , mDecoderTime_ns(0)
+    , mDetectProbe(nullptr)
+    , mDetectProbeSize_byte(0)
+    , mChannel(nullptr)
 {
-    mDataFile.SetMode("wb");
+    mDataFile   .SetMode("wb");
+    mSessionFile.SetMode("wb");
+
+    mPorts.SetCreator(CreatePort);
 
     Ptr_OF<DI::Object> lEntry;
 
-    lEntry.Set(&mDataFile, false); AddEntry("DataFile", lEntry, &MD_DATA_FILE);
+    lEntry.Set(&mCaptureTimeout_ms  , false); AddEntry("CaptureTimeout" , lEntry, &MD_CAPTURE_TIMEOUT);
+    lEntry.Set(&mDataFile           , false); AddEntry("DataFile"       , lEntry, &MD_DATA_FILE);
+    lEntry.Set(&mDataRetention_MiB  , false); AddEntry("DataRetention"  , lEntry, &MD_DATA_RETENTION);
+    lEntry.Set(&mDataSegmentSize_MiB, false); AddEntry("DataSegmentSize", lEntry, &MD_DATA_SEGMENT_SIZE);
+    lEntry.Set(&mDataSegmentTime_s  , false); AddEntry("DataSegmentTime", lEntry, &MD_DATA_SEGMENT_TIME);
+    lEntry.Set(&mDataSegments       , false); AddEntry("DataSegments"   , lEntry, &MD_DATA_SEGMENTS);
+    lEntry.Set(&mPorts              , false); AddEntry("Ports"          , lEntry, &MD_PORTS);
+    lEntry.Set(&mSessionFile        , false); AddEntry("SessionFile"    , lEntry, &MD_SESSION_FILE);
 
     lEntry.Set(&mPort, false); AddEntry("Port", lEntry);
 
@@ -166,343 +466,2139 @@ Tool::Tool() : mDataFile(nullptr, DATA_FILE_DEFAULT), mMacros(this)
     AddModule(&mMacros);
 }
 
-void Tool::Receive(unsigned int aSize_byte, unsigned int aFlags)
+// The captures are closed before DI::File closes the files
+Tool::~Tool()
 {
-    assert(LINE_LENGTH > aSize_byte);
+    mSession.Stop();
 
-    char lData[LINE_LENGTH];
+    mTrigger.Disarm();
 
-    unsigned int lSize_byte;
+    mCaptureRoll  .Close();
+    mCaptureWriter.Close();
+    mSessionWriter.Close();
+}
 
-    if (0 == aSize_byte)
-    {
-        lSize_byte = mPort.Read(lData, sizeof(lData), 0);
-    }
-    else
-    {
-        lSize_byte = mPort.Read(lData, aSize_byte, Com::Port::FLAG_READ_ALL);
-    }
+bool Tool::AutoDetect(const uint32_t* aSpeeds_bps, unsigned int aSpeedCount, const uint8_t* aProbe, unsigned int aProbeSize_byte, unsigned int aWindow_ms)
+{
+    assert(nullptr != aSpeeds_bps);
+    assert(0 < aSpeedCount);
 
-    lData[lSize_byte] = '\0';
+    KMS_EXCEPTION_ASSERT(!GetReceiver()->IsRunning(), RESULT_INVALID_COMMAND, "The capture is running", "");
 
-    if (0 < lSize_byte)
-    {
-        std::cout << Console::Color::GREEN;
+    mDetectProbe          = aProbe;
+    mDetectProbeSize_byte = aProbeSize_byte;
 
-        DisplayDumpWrite(lData, lSize_byte, aFlags, "Receive");
+    Detector lDetector;
 
-        std::cout << Console::Color::WHITE << std::flush;
-    }
-}
+    unsigned int lBestParity;
+    double       lBestScore;
+    uint32_t     lBestSpeed_bps;
 
-void Tool::ReceiveAndVerify(const void* aIn, unsigned int aInSize_byte, unsigned int aFlags)
-{
-    assert(0 < aInSize_byte);
-    assert(LINE_LENGTH > aInSize_byte);
+    auto lConfident = lDetector.Sweep(this, aSpeeds_bps, aSpeedCount, aWindow_ms, std::cout, &lBestSpeed_bps, &lBestParity, &lBestScore);
 
-    char lIn[LINE_LENGTH];
-    unsigned int lInSize_byte;
+    mDetectProbe = nullptr;
 
-    if (0 != (aFlags & FLAG_FRAME_T))
+    // The port keeps the setting of the last try when it is the confident
+    // match.
+    if (!lConfident)
+    {
+        ApplySetting(GetPort(), lBestSpeed_bps, Detector::PARITIES[lBestParity]);
+
+        mUnreadSize_byte = 0;
+    }
+
+    std::cout << (lConfident ? Console::Color::GREEN : Console::Color::RED);
+    std::cout << "AutoDetect : " << lBestSpeed_bps << " 8" << Detector::PARITY_CHARS[lBestParity] << "1, score " << static_cast<unsigned int>(lBestScore * 100.0) << " %";
+
+    if (lConfident)
     {
-        lInSize_byte = ToFrameT(aIn, aInSize_byte, lIn, sizeof(lIn));
+        auto lProtocol = lDetector.GetProtocol();
+        if (nullptr != lProtocol)
+        {
+            std::cout << ", " << lProtocol;
+        }
     }
     else
     {
-        lInSize_byte = aInSize_byte;
-        memcpy(lIn, aIn, lInSize_byte);
+        std::cout << ", no confident match";
     }
 
-    char lData[LINE_LENGTH];
+    std::cout << Console::Color::WHITE << std::endl;
 
-    auto lSize_byte = mPort.Read(lData, lInSize_byte, Com::Port::FLAG_READ_ALL);
+    return lConfident;
+}
 
-    lData[lSize_byte] = '\0';
+void Tool::Benchmark(unsigned int aFlags, unsigned int aSize_byte, unsigned int aTotal_MiB)
+{
+    assert(0 < aSize_byte);
 
-    auto lMatch = (lInSize_byte == lSize_byte);
-    if (lMatch)
+    static const unsigned int PATHS[] = { FLAG_DISPLAY, FLAG_DUMP, FLAG_WRITE };
+    static const char*        NAMES[] = { "DISPLAY"   , "DUMP"   , "WRITE"    };
+
+    // Printable characters mixed with control and extended bytes
+    std::vector<uint8_t> lData(aSize_byte);
+
+    for (unsigned int i = 0; i < aSize_byte; i++)
     {
-        lMatch = 0 == memcmp(lIn, lData, lSize_byte);
+        lData[i] = static_cast<uint8_t>(i * 37 + 11);
     }
 
-    if (lMatch)
-    {
-        std::cout << Console::Color::GREEN;
+    uint64_t lTotal_byte = static_cast<uint64_t>(aTotal_MiB) * 1024 * 1024;
 
-        DisplayDumpWrite(lData, lSize_byte, aFlags, "Receive and verify PASSED");
+    double lResults_MBps[3];
 
-        std::cout << Console::Color::WHITE << std::flush;
-    }
-    else
+    for (unsigned int p = 0; p < 3; p++)
     {
-        std::cout << Console::Color::RED;
+        lResults_MBps[p] = 0.0;
 
-        DisplayDumpWrite(lData, lSize_byte, aFlags | FLAG_DUMP | FLAG_TIMESTAMP, "Receive and verify FAILED");
+        if (0 == (aFlags & PATHS[p])) { continue; }
+        if ((FLAG_WRITE == PATHS[p]) && (nullptr == mDataFile.Get()) && (0 == strlen(mDataSegments))) { continue; }
 
-        std::cout << Console::Color::WHITE << std::flush;
-    }
-}
+        auto lStart = std::chrono::steady_clock::now();
 
-void Tool::Send(const void* aIn, unsigned int aInSize_byte, unsigned int aFlags)
-{
-    assert(0 < aInSize_byte);
-    assert(LINE_LENGTH > aInSize_byte);
+        for (uint64_t lDone_byte = 0; lDone_byte < lTotal_byte; lDone_byte += aSize_byte)
+        {
+            DisplayDumpWrite(lData.data(), aSize_byte, PATHS[p] | (aFlags & FLAG_TIMESTAMP), "Benchmark", Clock_GetTime_ns(), CaptureFile::DIRECTION_SEND);
+        }
 
-    char lIn[LINE_LENGTH];
-    unsigned int lInSize_byte;
+        mFormatter.Flush();
 
-    if (0 != (aFlags & FLAG_FRAME_T))
-    {
-        lInSize_byte = ToFrameT(aIn, aInSize_byte, lIn, sizeof(lIn));
-    }
-    else
-    {
-        lInSize_byte = aInSize_byte;
-        memcpy(lIn, aIn, lInSize_byte);
-    }
+        if (mCaptureWriter.IsOpen())
+        {
+            mCaptureWriter.Flush();
+        }
 
-    lIn[lInSize_byte] = '\0';
+        mCaptureRoll.Flush();
 
-    mPort.Write(lIn, lInSize_byte);
+        auto lDuration_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - lStart).count();
+        if (0.0 < lDuration_s)
+        {
+            lResults_MBps[p] = lTotal_byte / lDuration_s / 1000000.0;
+        }
+    }
 
     std::cout << Console::Color::BLUE;
 
-    DisplayDumpWrite(lIn, lInSize_byte, aFlags, "Send");
+    for (unsigned int p = 0; p < 3; p++)
+    {
+        if (0 != (aFlags & PATHS[p]))
+        {
+            std::cout << "Benchmark " << NAMES[p] << " : ";
+
+            if (0.0 < lResults_MBps[p])
+            {
+                std::cout << static_cast<uint64_t>(lResults_MBps[p]) << " MB/s\n";
+            }
+            else
+            {
+                std::cout << "Skipped (no DataFile)\n";
+            }
+        }
+    }
 
     std::cout << Console::Color::WHITE << std::flush;
 }
 
-// ===== CLI::Tool ==================================================
-
-void Tool::DisplayHelp(FILE* aFile) const
+void Tool::Bridge(Session::Channel* aChannel, unsigned int aFlags, unsigned int aDuration_ms)
 {
-    assert(nullptr != aFile);
+    assert(nullptr != aChannel);
 
-    fprintf(aFile,
-        "ClearDTR\n"
-        "ClearRTS\n"
-        "Connect\n"
-        "Disconnect\n"
-        "Receive [Flags] [Size_byte]\n"
-        "ReceiveAndVerify ASCII {Flags} {Expected}\n"
-        "ReceiveAndVerify Hex {Flags} {Expected}\n"
-        "Send ASCII {Flags} {Data}\n"
-        "Send Hex {Flags} {Data}\n"
-        "SetDTR\n"
-        "SetRTS\n"
-        "Status\n");
+    static const char* OPS[2] = { "Bridge >", "Bridge <" };
 
-    CLI::Tool::DisplayHelp(aFile);
-}
+    KMS_EXCEPTION_ASSERT(!mSession .IsRunning(), RESULT_INVALID_COMMAND, "The session is running", "");
+    KMS_EXCEPTION_ASSERT(!mReceiver.IsRunning(), RESULT_INVALID_COMMAND, "The capture is running", "");
 
-int Tool::ExecuteCommand(CLI::CommandLine* aCmd)
-{
-    assert(nullptr != aCmd);
+    Session::Channel* lChannels [2] = { nullptr, aChannel };
+    LatencyStats      lLatencies[2];
+    Receiver*         lReceivers[2] = { &mReceiver, &aChannel->mReceiver };
 
-    int lResult = __LINE__;
+    // The data read from one port goes to the other one
+    lReceivers[0]->SetForward(aChannel->mPort, lLatencies + 0);
+    lReceivers[1]->SetForward(&mPort         , lLatencies + 1);
 
-    auto lCmd = aCmd->GetCurrent();
+    mUnreadSize_byte = 0;
 
-    if      (0 == _stricmp(lCmd, "ClearDTR"        )) { aCmd->Next(); lResult = Cmd_ClearDTR        (aCmd); }
-    else if (0 == _stricmp(lCmd, "ClearRTS"        )) { aCmd->Next(); lResult = Cmd_ClearRTS        (aCmd); }
-    else if (0 == _stricmp(lCmd, "Connect"         )) { aCmd->Next(); lResult = Cmd_Connect         (aCmd); }
-    else if (0 == _stricmp(lCmd, "Disconnect"      )) { aCmd->Next(); lResult = Cmd_Disconnect      (aCmd); }
-    else if (0 == _stricmp(lCmd, "Receive"         )) { aCmd->Next(); lResult = Cmd_Receive         (aCmd); }
-    else if (0 == _stricmp(lCmd, "ReceiveAndVerify")) { aCmd->Next(); lResult = Cmd_ReceiveAndVerify(aCmd); }
-    else if (0 == _stricmp(lCmd, "Send"            )) { aCmd->Next(); lResult = Cmd_Send            (aCmd); }
-    else if (0 == _stricmp(lCmd, "SetDTR"          )) { aCmd->Next(); lResult = Cmd_SetDTR          (aCmd); }
-    else if (0 == _stricmp(lCmd, "SetRTS"          )) { aCmd->Next(); lResult = Cmd_SetRTS          (aCmd); }
-    else if (0 == _stricmp(lCmd, "Status"          )) { aCmd->Next(); lResult = Cmd_Status          (aCmd); }
-    else
-    {
-        lResult = CLI::Tool::ExecuteCommand(aCmd);
-    }
+    auto lStart_ns = Clock_GetTime_ns();
+    auto lEnd_ns   = lStart_ns + static_cast<uint64_t>(aDuration_ms) * 1000000;
 
-    return lResult;
-}
+    unsigned int lColor = 2;
 
-int Tool::Run()
-{
-    if (!mPort.Connect())
+    try
     {
-        KMS_EXCEPTION(RESULT_CONNECT_FAILED, "Connexion failed", "");
-    }
+        lReceivers[0]->Start();
+        lReceivers[1]->Start();
 
-    return CLI::Tool::Run();
-}
+        while (Clock_GetTime_ns() < lEnd_ns)
+        {
+            const uint8_t* lData     [2];
+            unsigned int   lSize_byte[2];
+            uint64_t       lTime_ns  [2];
 
-// Private
-// //////////////////////////////////////////////////////////////////////////
+            for (unsigned int i = 0; i < 2; i++)
+            {
+                lData[i] = lReceivers[i]->Read_Begin(lSize_byte + i, 0, lTime_ns + i);
+            }
 
-int Tool::Cmd_ClearDTR(CLI::CommandLine* aCmd)
-{
-    assert(nullptr != aCmd);
+            // The oldest chunk first, so the output is in time order
+            unsigned int lIndex;
 
-    KMS_EXCEPTION_ASSERT(aCmd->IsAtEnd(), RESULT_INVALID_COMMAND, "Too many command arguments", aCmd->GetCurrent());
+            if      ((0 < lSize_byte[0]) && ((0 == lSize_byte[1]) || (lTime_ns[0] <= lTime_ns[1]))) { lIndex = 0; }
+            else if  (0 < lSize_byte[1])                                                           { lIndex = 1; }
+            else
+            {
+                mFormatter.Flush();
 
-    mPort.SetDTR(false);
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                continue;
+            }
 
-    return 0;
-}
+            if (lColor != lIndex)
+            {
+                mFormatter.Flush();
 
-int Tool::Cmd_ClearRTS(CLI::CommandLine* aCmd)
-{
-    assert(nullptr != aCmd);
+                std::cout << ((0 == lIndex) ? Console::Color::BLUE : Console::Color::GREEN);
 
-    KMS_EXCEPTION_ASSERT(aCmd->IsAtEnd(), RESULT_INVALID_COMMAND, "Too many command arguments", aCmd->GetCurrent());
+                lColor = lIndex;
+            }
 
-    mPort.SetRTS(false);
+            // DisplayDumpWrite records the index of the port the data
+            // comes from.
+            mChannel = lChannels[lIndex];
 
-    return 0;
-}
+            DisplayDumpWrite(lData[lIndex], lSize_byte[lIndex], aFlags, OPS[lIndex], lTime_ns[lIndex], CaptureFile::DIRECTION_RECEIVE);
 
-int Tool::Cmd_Connect(CLI::CommandLine* aCmd)
-{
-    assert(nullptr != aCmd);
+            lReceivers[lIndex]->Read_End(lSize_byte[lIndex]);
+        }
+    }
+    catch (...)
+    {
+        mFormatter.Flush();
 
-    KMS_EXCEPTION_ASSERT(aCmd->IsAtEnd(), RESULT_INVALID_COMMAND, "Too many command arguments", aCmd->GetCurrent());
+        std::cout << Console::Color::WHITE << std::flush;
 
-    if (!mPort.Connect())
-    {
-        KMS_EXCEPTION(RESULT_CONNECT_FAILED, "Connexion failed", "");
+        for (auto lReceiver : lReceivers)
+        {
+            lReceiver->Stop();
+            lReceiver->SetForward(nullptr);
+        }
+
+        mChannel = nullptr;
+        throw;
     }
 
-    return 0;
-}
+    mFormatter.Flush();
 
-int Tool::Cmd_Disconnect(CLI::CommandLine* aCmd)
-{
-    assert(nullptr != aCmd);
+    for (auto lReceiver : lReceivers)
+    {
+        lReceiver->Stop();
+        lReceiver->SetForward(nullptr);
+    }
 
-    KMS_EXCEPTION_ASSERT(aCmd->IsAtEnd(), RESULT_INVALID_COMMAND, "Too many command arguments", aCmd->GetCurrent());
+    mChannel = nullptr;
 
-    mPort.Disconnect();
+    auto lDuration_ns = Clock_GetTime_ns() - lStart_ns;
 
-    return 0;
-}
+    std::cout << Console::Color::BLUE;
 
-int Tool::Cmd_Receive(CLI::CommandLine* aCmd)
-{
-    assert(nullptr != aCmd);
+    for (unsigned int i = 0; i < 2; i++)
+    {
+        auto lTotal_byte = lReceivers[i]->GetByteCount() + lReceivers[i]->GetOverflow_byte();
 
-    unsigned int lFlags     = 0;
-    unsigned int lSize_byte = 0;
+        std::cout << OPS[i] << " : " << lTotal_byte << " bytes";
 
-    if (!aCmd->IsAtEnd())
-    {
-        lFlags     =          ToFlags (aCmd->GetCurrent()); aCmd->Next();
-        lSize_byte = Convert::ToUInt32(aCmd->GetCurrent()); aCmd->Next();
+        if (0 < lDuration_ns)
+        {
+            std::cout << ", " << lTotal_byte * 1000000000 / lDuration_ns << " B/s";
+        }
 
-        KMS_EXCEPTION_ASSERT(aCmd->IsAtEnd(), RESULT_INVALID_COMMAND, "Too many command arguments", aCmd->GetCurrent());
-    }
+        std::cout << "\n";
 
-    Receive(lSize_byte, lFlags);
+        lLatencies[i].Display(std::cout, "    Forward latency");
+    }
 
-    return 0;
+    std::cout << Console::Color::WHITE << std::flush;
 }
 
-int Tool::Cmd_ReceiveAndVerify(CLI::CommandLine* aCmd)
+void Tool::Decode(Decoder* aDecoder, unsigned int aCount, unsigned int aFlags)
 {
-    assert(nullptr != aCmd);
+    assert(nullptr != aDecoder);
 
-    int lResult = __LINE__;
+    auto lStart = std::chrono::steady_clock::now();
 
-    auto lCmd = aCmd->GetCurrent();
+    uint64_t lTotal_byte = 0;
 
-    if      (0 == _stricmp(lCmd, "ASCII")) { aCmd->Next(); lResult = Cmd_ReceiveAndVerify_ASCII(aCmd); }
-    else if (0 == _stricmp(lCmd, "Hex"  )) { aCmd->Next(); lResult = Cmd_ReceiveAndVerify_Hex  (aCmd); }
+    mDecoderFlags = aFlags;
 
-    return lResult;
-}
+    // The color stays the same for all the frames, so the formatter output
+    // is written once per received chunk.
+    std::cout << Console::Color::GREEN;
 
-int Tool::Cmd_ReceiveAndVerify_ASCII(CLI::CommandLine* aCmd)
-{
-    assert(nullptr != aCmd);
+    while ((0 == aCount) || (aCount > aDecoder->mFrameCount))
+    {
+        unsigned int lSize_byte;
 
-    auto lFlags = ToFlags(aCmd->GetCurrent()); aCmd->Next();
-    auto lData  =         aCmd->GetCurrent() ; aCmd->Next();
+        if (GetReceiver()->IsRunning() && (0 == mUnreadSize_byte))
+        {
+            auto lData = Read_Begin(&lSize_byte, mCaptureTimeout_ms, &mDecoderTime_ns);
+            if (0 == lSize_byte)
+            {
+                break;
+            }
 
-    KMS_EXCEPTION_ASSERT(aCmd->IsAtEnd(), RESULT_INVALID_COMMAND, "Too many command arguments", aCmd->GetCurrent());
+            aDecoder->Push(lData, lSize_byte);
 
-    ReceiveAndVerify(lData, static_cast<unsigned int>(strlen(lData)), lFlags);
+            GetReceiver()->Read_End(lSize_byte);
+        }
+        else
+        {
+            uint8_t lData[LINE_LENGTH];
 
-    return 0;
-}
+            lSize_byte = Read(lData, sizeof(lData), 0, &mDecoderTime_ns);
+            if (0 == lSize_byte)
+            {
+                break;
+            }
 
-int Tool::Cmd_ReceiveAndVerify_Hex(CLI::CommandLine* aCmd)
-{
-    assert(nullptr != aCmd);
+            aDecoder->Push(lData, lSize_byte);
+        }
 
-    auto lFlags = ToFlags(aCmd->GetCurrent()); aCmd->Next();
-    auto lData  =         aCmd->GetCurrent() ; aCmd->Next();
+        mFormatter.Flush();
 
-    KMS_EXCEPTION_ASSERT(aCmd->IsAtEnd(), RESULT_INVALID_COMMAND, "Too many command arguments", aCmd->GetCurrent());
+        lTotal_byte += lSize_byte;
+    }
 
-    ReceiveAndVerify_Hex(lData, lFlags);
-    
-    return 0;
-}
+    mFormatter.Flush();
 
-int Tool::Cmd_Send(CLI::CommandLine* aCmd)
-{
-    assert(nullptr != aCmd);
+    auto lDuration_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - lStart).count();
 
-    int lResult = __LINE__;
+    auto lErrors = aDecoder->mErrorCount;
+    auto lFrames = aDecoder->mFrameCount;
 
-    auto lCmd = aCmd->GetCurrent();
+    std::cout << ((0 == lErrors) ? Console::Color::GREEN : Console::Color::RED);
+    std::cout << "Decode " << aDecoder->GetName() << " : " << lFrames << " frames, " << lErrors << " errors, " << aDecoder->mDiscarded_byte << " bytes discarded, " << lTotal_byte << " bytes";
 
-    if      (0 == _stricmp(lCmd, "ASCII")) { aCmd->Next(); lResult = Cmd_Send_ASCII(aCmd); }
-    else if (0 == _stricmp(lCmd, "Hex"  )) { aCmd->Next(); lResult = Cmd_Send_Hex  (aCmd); }
+    if (0.0 < lDuration_s)
+    {
+        std::cout << ", " << static_cast<uint64_t>(lFrames / lDuration_s) << " frames/s";
+    }
 
-    return lResult;
+    std::cout << Console::Color::WHITE << std::endl;
 }
 
-int Tool::Cmd_Send_ASCII(CLI::CommandLine* aCmd)
+unsigned int Tool::Expect(Matcher* aMatcher, unsigned int aTimeout_ms, unsigned int aFlags)
 {
-    assert(nullptr != aCmd);
+    assert(nullptr != aMatcher);
 
-    auto lFlags = ToFlags(aCmd->GetCurrent()); aCmd->Next();
-    auto lData  =         aCmd->GetCurrent() ; aCmd->Next();
+    aMatcher->Reset();
 
-    KMS_EXCEPTION_ASSERT(aCmd->IsAtEnd(), RESULT_INVALID_COMMAND, "Too many command arguments", aCmd->GetCurrent());
+    auto lStart_ns = Clock_GetTime_ns();
+    auto lEnd_ns   = lStart_ns + static_cast<uint64_t>(aTimeout_ms) * 1000000;
 
-    Send(lData, static_cast<unsigned int>(strlen(lData)), lFlags);
+    unsigned int lResult = Matcher::NO_MATCH;
+    uint64_t     lTime_ns = lStart_ns;
+    uint64_t     lTotal_byte = 0;
 
-    return 0;
-}
+    std::cout << Console::Color::GREEN;
 
-int Tool::Cmd_Send_Hex(CLI::CommandLine* aCmd)
-{
-    assert(nullptr != aCmd);
+    for (;;)
+    {
+        auto lNow_ns = Clock_GetTime_ns();
+        if (lEnd_ns <= lNow_ns)
+        {
+            break;
+        }
 
-    auto lFlags = ToFlags(aCmd->GetCurrent()); aCmd->Next();
-    auto lData  =         aCmd->GetCurrent() ; aCmd->Next();
+        auto lRemaining_ms = static_cast<unsigned int>((lEnd_ns - lNow_ns + 999999) / 1000000);
 
-    KMS_EXCEPTION_ASSERT(aCmd->IsAtEnd(), RESULT_INVALID_COMMAND, "Too many command arguments", aCmd->GetCurrent());
+        unsigned int lSize_byte;
+        unsigned int lUsed_byte;
 
-    Send_Hex(lData, lFlags);
+        if (GetReceiver()->IsRunning() && (0 == mUnreadSize_byte))
+        {
+            auto lData = Read_Begin(&lSize_byte, lRemaining_ms, &lTime_ns);
+            if (0 == lSize_byte)
+            {
+                continue;
+            }
 
-    return 0;
-}
+            lUsed_byte = aMatcher->Scan(lData, lSize_byte, &lResult);
 
-int Tool::Cmd_SetDTR(CLI::CommandLine* aCmd)
-{
-    assert(nullptr != aCmd);
+            DisplayDumpWrite(lData, lUsed_byte, aFlags, "Expect", lTime_ns, CaptureFile::DIRECTION_RECEIVE);
 
-    KMS_EXCEPTION_ASSERT(aCmd->IsAtEnd(), RESULT_INVALID_COMMAND, "Too many command arguments", aCmd->GetCurrent());
+            GetReceiver()->Read_End(lUsed_byte);
+        }
+        else
+        {
+            uint8_t lData[LINE_LENGTH];
 
-    mPort.SetDTR(true);
+            lSize_byte = Read(lData, sizeof(lData), 0, &lTime_ns);
+            if (0 == lSize_byte)
+            {
+                continue;
+            }
 
-    return 0;
+            lUsed_byte = aMatcher->Scan(lData, lSize_byte, &lResult);
+
+            DisplayDumpWrite(lData, lUsed_byte, aFlags, "Expect", lTime_ns, CaptureFile::DIRECTION_RECEIVE);
+
+            // Read returned the previous unused bytes first, so mUnread is
+            // empty here.
+            mUnreadSize_byte = lSize_byte - lUsed_byte;
+            mUnreadTime_ns   = lTime_ns;
+
+            memcpy(mUnread, lData + lUsed_byte, mUnreadSize_byte);
+        }
+
+        lTotal_byte += lUsed_byte;
+
+        if (Matcher::NO_MATCH != lResult)
+        {
+            break;
+        }
+    }
+
+    mFormatter.Flush();
+
+    if (Matcher::NO_MATCH == lResult)
+    {
+        std::cout << Console::Color::RED << "Expect : TIMEOUT after " << aTimeout_ms << " ms, " << lTotal_byte << " bytes";
+    }
+    else
+    {
+        // The data may have arrived before the call
+        auto lDuration_ns = (lStart_ns < lTime_ns) ? lTime_ns - lStart_ns : 0;
+
+        std::cout << "Expect : Pattern " << lResult << " after " << lDuration_ns / 1000 << " us, " << lTotal_byte << " bytes";
+    }
+
+    std::cout << Console::Color::WHITE << std::endl;
+
+    if ((Matcher::NO_MATCH == lResult) && (0 != (aFlags & FLAG_EXIT_ON_ERROR)))
+    {
+        KMS_EXCEPTION(RESULT_EXPECT_TIMEOUT, "Expect timeout", aTimeout_ms);
+    }
+
+    return lResult;
+}
+
+void Tool::Export(const char* aFileName, bool aHex, uint64_t aFrom_ms, uint64_t aTo_ms)
+{
+    assert(nullptr != aFileName);
+    assert(aFrom_ms <= aTo_ms);
+
+    // Make sure the exported data includes what ComTool wrote so far
+    if (mCaptureWriter.IsOpen())
+    {
+        mCaptureWriter.Flush();
+    }
+
+    mCaptureRoll.Flush();
+
+    CaptureReader lReader(aFileName);
+
+    uint64_t lFrom_ns = aFrom_ms * 1000000;
+    uint64_t lTo_ns   = (UINT64_MAX / 1000000 > aTo_ms) ? aTo_ms * 1000000 : UINT64_MAX;
+
+    lReader.Seek(lFrom_ns);
+
+    const uint8_t* lData;
+    CaptureFile::RecordHeader lHeader;
+
+    while (nullptr != (lData = lReader.Next(&lHeader)))
+    {
+        // The record times never decrease, see CaptureWriter::Write
+        if (lFrom_ns > lHeader.mTime_ns) { continue; }
+        if (lTo_ns   < lHeader.mTime_ns) { break; }
+
+        char lTime[NAME_LENGTH];
+
+        mTimeFormatter.Format_Wall(lReader.GetStart_ns() + lHeader.mTime_ns, lTime, sizeof(lTime));
+
+        mFormatter.Write(GetOpName(lHeader));
+        mFormatter.Write(" ", 1);
+
+        // Records of the session ports
+        if (0 != lHeader.mPort)
+        {
+            char lPort[NAME_LENGTH];
+
+            sprintf_s(lPort SizeInfo(lPort), "[%u] ", lHeader.mPort);
+
+            mFormatter.Write(lPort);
+        }
+
+        mFormatter.Write(lTime);
+
+        // The record was read before the previous one, its time is the one
+        // of the previous record
+        if (0 != (lHeader.mFlags & CaptureFile::FLAG_TIME_CLAMPED))
+        {
+            mFormatter.Write(" (time clamped)");
+        }
+
+        mFormatter.Write("\n", 1);
+
+        if (aHex)
+        {
+            mFormatter.Dump(lData, lHeader.mSize_byte);
+        }
+        else
+        {
+            mFormatter.Display(lData, lHeader.mSize_byte);
+        }
+    }
+
+    mFormatter.Flush();
+}
+
+void Tool::Generate(Generator* aGenerator, unsigned int aFlags, uint64_t aCount, unsigned int aDuration_ms)
+{
+    assert(nullptr != aGenerator);
+
+    uint8_t lCaptureFlags = (0 != (aFlags & FLAG_FRAME_T)) ? CaptureFile::FLAG_FRAME : 0;
+
+    Timer lTimer;
+
+    aGenerator->Start(aCount, aDuration_ms);
+
+    std::cout << Console::Color::BLUE;
+
+    unsigned int lStream;
+    uint64_t     lDue_ns;
+
+    while (aGenerator->Next(&lStream, &lDue_ns))
+    {
+        lTimer.WaitUntil(lDue_ns);
+
+        unsigned int lSize_byte;
+
+        auto lData = aGenerator->GetData(lStream, &lSize_byte);
+
+        uint64_t lTime_ns;
+
+        Write(lData, lSize_byte, &lTime_ns);
+
+        aGenerator->Sent(lStream, lTime_ns);
+
+        // The output goes out while waiting for the next deadline
+        DisplayDumpWrite(lData, lSize_byte, aFlags, "Generate", lTime_ns, CaptureFile::DIRECTION_SEND, lCaptureFlags);
+
+        mFormatter.Flush();
+    }
+
+    aGenerator->Display(std::cout);
+
+    std::cout << Console::Color::WHITE << std::flush;
+}
+
+void Tool::Query(const char* aFileName, unsigned int aInterval_s, const uint8_t* aPattern, unsigned int aPatternSize_byte)
+{
+    assert(nullptr != aFileName);
+
+    // Make sure the query includes what ComTool wrote so far
+    if (mCaptureWriter.IsOpen())
+    {
+        mCaptureWriter.Flush();
+    }
+
+    mCaptureRoll.Flush();
+
+    ::Query lQuery(aFileName);
+
+    lQuery.SetInterval(aInterval_s);
+
+    if (nullptr != aPattern)
+    {
+        lQuery.SetPattern(aPattern, aPatternSize_byte);
+    }
+
+    lQuery.Run();
+
+    lQuery.Display(std::cout, &mTimeFormatter);
+}
+
+void Tool::Receive(unsigned int aSize_byte, unsigned int aFlags)
+{
+    assert(LINE_LENGTH > aSize_byte);
+
+    if ((0 == aSize_byte) && GetReceiver()->IsRunning() && (0 == mUnreadSize_byte))
+    {
+        // Display the data directly from the ring, without copying it
+        unsigned int lSize_byte;
+        uint64_t     lTime_ns;
+
+        auto lData = Read_Begin(&lSize_byte, mCaptureTimeout_ms, &lTime_ns);
+
+        if (LINE_LENGTH <= lSize_byte)
+        {
+            lSize_byte = LINE_LENGTH - 1;
+        }
+
+        if (0 < lSize_byte)
+        {
+            std::cout << Console::Color::GREEN;
+
+            DisplayDumpWrite(lData, lSize_byte, aFlags, "Receive", lTime_ns, CaptureFile::DIRECTION_RECEIVE);
+
+            mFormatter.Flush();
+
+            std::cout << Console::Color::WHITE << std::flush;
+
+            GetReceiver()->Read_End(lSize_byte);
+        }
+        return;
+    }
+
+    char lData[LINE_LENGTH];
+
+    unsigned int lSize_byte;
+    uint64_t     lTime_ns;
+
+    if (0 == aSize_byte)
+    {
+        lSize_byte = Read(lData, sizeof(lData) - 1, 0, &lTime_ns);
+    }
+    else
+    {
+        lSize_byte = Read(lData, aSize_byte, Com::Port::FLAG_READ_ALL, &lTime_ns);
+    }
+
+    lData[lSize_byte] = '\0';
+
+    if (0 < lSize_byte)
+    {
+        std::cout << Console::Color::GREEN;
+
+        DisplayDumpWrite(lData, lSize_byte, aFlags, "Receive", lTime_ns, CaptureFile::DIRECTION_RECEIVE);
+
+        mFormatter.Flush();
+
+        std::cout << Console::Color::WHITE << std::flush;
+    }
+}
+
+void Tool::ReceiveAndVerify(const void* aIn, unsigned int aInSize_byte, unsigned int aFlags)
+{
+    assert(0 < aInSize_byte);
+    assert(LINE_LENGTH > aInSize_byte);
+
+    char lIn[LINE_LENGTH];
+    unsigned int lInSize_byte;
+
+    if (0 != (aFlags & FLAG_FRAME_T))
+    {
+        lInSize_byte = FrameT_Encode(aIn, aInSize_byte, lIn, sizeof(lIn));
+    }
+    else
+    {
+        lInSize_byte = aInSize_byte;
+        memcpy(lIn, aIn, lInSize_byte);
+    }
+
+    char lData[LINE_LENGTH];
+
+    uint64_t lTime_ns;
+
+    auto lSize_byte = Read(lData, lInSize_byte, Com::Port::FLAG_READ_ALL, &lTime_ns);
+
+    lData[lSize_byte] = '\0';
+
+    auto lMatch = (lInSize_byte == lSize_byte);
+    if (lMatch)
+    {
+        lMatch = 0 == memcmp(lIn, lData, lSize_byte);
+    }
+
+    if (lMatch)
+    {
+        std::cout << Console::Color::GREEN;
+
+        DisplayDumpWrite(lData, lSize_byte, aFlags, "Receive and verify PASSED", lTime_ns, CaptureFile::DIRECTION_RECEIVE, CaptureFile::FLAG_VERIFY_PASSED);
+
+        mFormatter.Flush();
+
+        std::cout << Console::Color::WHITE << std::flush;
+    }
+    else
+    {
+        std::cout << Console::Color::RED;
+
+        DisplayDumpWrite(lData, lSize_byte, aFlags | FLAG_DUMP | FLAG_TIMESTAMP, "Receive and verify FAILED", lTime_ns, CaptureFile::DIRECTION_RECEIVE, CaptureFile::FLAG_VERIFY_FAILED);
+
+        mFormatter.Flush();
+
+        std::cout << Console::Color::WHITE << std::flush;
+    }
+}
+
+void Tool::ReceiveFrames(unsigned int aCount, unsigned int aFlags)
+{
+    auto lErrors = mDeframer.mCRCErrorCount;
+    auto lFrames = mDeframer.mFrameCount;
+    auto lStart  = std::chrono::steady_clock::now();
+
+    uint64_t lTotal_byte = 0;
+
+    mDeframerFlags = aFlags;
+
+    // The color stays the same for all the frames, so the formatter output
+    // is written once per received chunk.
+    std::cout << Console::Color::GREEN;
+
+    while ((0 == aCount) || (aCount > mDeframer.mFrameCount - lFrames))
+    {
+        unsigned int lSize_byte;
+
+        if (GetReceiver()->IsRunning() && (0 == mUnreadSize_byte))
+        {
+            auto lData = Read_Begin(&lSize_byte, mCaptureTimeout_ms, &mDeframerTime_ns);
+            if (0 == lSize_byte)
+            {
+                break;
+            }
+
+            mDeframer.Push(lData, lSize_byte);
+
+            GetReceiver()->Read_End(lSize_byte);
+        }
+        else
+        {
+            uint8_t lData[LINE_LENGTH];
+
+            lSize_byte = Read(lData, sizeof(lData), 0, &mDeframerTime_ns);
+            if (0 == lSize_byte)
+            {
+                break;
+            }
+
+            mDeframer.Push(lData, lSize_byte);
+        }
+
+        mFormatter.Flush();
+
+        lTotal_byte += lSize_byte;
+    }
+
+    mFormatter.Flush();
+
+    auto lDuration_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - lStart).count();
+
+    lErrors = mDeframer.mCRCErrorCount - lErrors;
+    lFrames = mDeframer.mFrameCount    - lFrames;
+
+    std::cout << ((0 == lErrors) ? Console::Color::GREEN : Console::Color::RED);
+    std::cout << "Receive frames : " << lFrames << " frames, " << lErrors << " CRC errors, " << lTotal_byte << " bytes";
+
+    if (0.0 < lDuration_s)
+    {
+        std::cout << ", " << static_cast<uint64_t>(lFrames / lDuration_s) << " frames/s";
+    }
+
+    std::cout << Console::Color::WHITE << std::endl;
+}
+
+void Tool::ReceiveMessages(Delimiter* aDelimiter, unsigned int aCount, unsigned int aFlags)
+{
+    assert(nullptr != aDelimiter);
+
+    auto lStart = std::chrono::steady_clock::now();
+
+    uint64_t lTotal_byte = 0;
+
+    mDelimiterFlags = aFlags;
+
+    std::cout << Console::Color::GREEN;
+
+    while ((0 == aCount) || (aCount > aDelimiter->mMessageCount))
+    {
+        // While a message is pending, wait only until its inter-character
+        // timeout.
+        auto lDeadline_ns = aDelimiter->GetDeadline_ns();
+        auto lTimeout_ms  = static_cast<unsigned int>(mCaptureTimeout_ms);
+
+        if (UINT64_MAX != lDeadline_ns)
+        {
+            auto lNow_ns = Clock_GetTime_ns();
+
+            lTimeout_ms = (lDeadline_ns > lNow_ns) ? static_cast<unsigned int>((lDeadline_ns - lNow_ns + 999999) / 1000000) : 0;
+        }
+
+        unsigned int lSize_byte;
+        uint64_t     lTime_ns;
+
+        if (GetReceiver()->IsRunning() && (0 == mUnreadSize_byte))
+        {
+            // The end of a gap is not a read timeout, Read_Begin would
+            // count it.
+            auto lData = GetReceiver()->Read_Begin(&lSize_byte, lTimeout_ms, &lTime_ns);
+            if (0 < lSize_byte)
+            {
+                aDelimiter->Push(lData, lSize_byte, lTime_ns);
+
+                GetReceiver()->Read_End(lSize_byte);
+            }
+            else if (UINT64_MAX == lDeadline_ns)
+            {
+                mStats.AddTimeout();
+            }
+        }
+        else
+        {
+            uint8_t lData[LINE_LENGTH];
+
+            lSize_byte = Read(lData, sizeof(lData), 0, &lTime_ns);
+            if (0 < lSize_byte)
+            {
+                aDelimiter->Push(lData, lSize_byte, lTime_ns);
+            }
+        }
+
+        if (0 == lSize_byte)
+        {
+            if (UINT64_MAX == lDeadline_ns)
+            {
+                break;
+            }
+
+            aDelimiter->Check(Clock_GetTime_ns());
+        }
+
+        mFormatter.Flush();
+
+        lTotal_byte += lSize_byte;
+    }
+
+    aDelimiter->Flush();
+
+    mFormatter.Flush();
+
+    auto lDuration_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - lStart).count();
+
+    auto lIncomplete = aDelimiter->mIncompleteCount;
+    auto lMessages   = aDelimiter->mMessageCount;
+
+    std::cout << ((0 == lIncomplete) ? Console::Color::GREEN : Console::Color::RED);
+    std::cout << "Receive messages : " << lMessages << " messages, " << lIncomplete << " incomplete, " << lTotal_byte << " bytes";
+
+    if (0.0 < lDuration_s)
+    {
+        std::cout << ", " << static_cast<uint64_t>(lMessages / lDuration_s) << " messages/s";
+    }
+
+    std::cout << Console::Color::WHITE << std::endl;
+}
+
+void Tool::Respond(Responder* aResponder, unsigned int aFlags, unsigned int aDuration_ms)
+{
+    assert(nullptr != aResponder);
+
+    aResponder->Reset();
+
+    LatencyStats lLateness;
+
+    auto lStart_ns = Clock_GetTime_ns();
+    auto lEnd_ns   = lStart_ns + static_cast<uint64_t>(aDuration_ms) * 1000000;
+
+    uint64_t lReplyCount = 0;
+    uint64_t lTotal_byte = 0;
+
+    for (;;)
+    {
+        auto lNow_ns = Clock_GetTime_ns();
+        if (lEnd_ns <= lNow_ns)
+        {
+            break;
+        }
+
+        auto lRemaining_ms = static_cast<unsigned int>((lEnd_ns - lNow_ns + 999999) / 1000000);
+
+        uint8_t        lBuffer[LINE_LENGTH];
+        const uint8_t* lData;
+        unsigned int   lSize_byte;
+        uint64_t       lTime_ns;
+
+        bool lRing = GetReceiver()->IsRunning() && (0 == mUnreadSize_byte);
+        if (lRing)
+        {
+            lData = Read_Begin(&lSize_byte, lRemaining_ms, &lTime_ns);
+        }
+        else
+        {
+            lData      = lBuffer;
+            lSize_byte = Read(lBuffer, sizeof(lBuffer), 0, lRemaining_ms, &lTime_ns);
+        }
+
+        if (0 == lSize_byte)
+        {
+            continue;
+        }
+
+        // A chunk may hold more than one pattern
+        unsigned int lOffset_byte = 0;
+
+        while (lSize_byte > lOffset_byte)
+        {
+            unsigned int lRule;
+
+            auto lUsed_byte = aResponder->Scan(lData + lOffset_byte, lSize_byte - lOffset_byte, &lRule);
+
+            std::cout << Console::Color::GREEN;
+
+            DisplayDumpWrite(lData + lOffset_byte, lUsed_byte, aFlags, "Respond", lTime_ns, CaptureFile::DIRECTION_RECEIVE);
+
+            lOffset_byte += lUsed_byte;
+
+            if (Matcher::NO_MATCH != lRule)
+            {
+                unsigned int lReply_byte;
+
+                auto lReply  = aResponder->GetResponse(lRule, &lReply_byte);
+                auto lDue_ns = lTime_ns + static_cast<uint64_t>(aResponder->GetDelay_us(lRule)) * 1000;
+
+                mFormatter.Flush();
+
+                Clock_WaitUntil(lDue_ns);
+
+                uint64_t lSent_ns;
+
+                Write(lReply, lReply_byte, &lSent_ns);
+
+                lLateness.Add((lDue_ns < lSent_ns) ? lSent_ns - lDue_ns : 0);
+
+                std::cout << Console::Color::BLUE;
+
+                DisplayDumpWrite(lReply, lReply_byte, aFlags, "Reply", lSent_ns, CaptureFile::DIRECTION_SEND, aResponder->IsFrameT(lRule) ? CaptureFile::FLAG_FRAME : 0);
+
+                mFormatter.Flush();
+
+                lReplyCount++;
+            }
+        }
+
+        mFormatter.Flush();
+
+        if (lRing)
+        {
+            GetReceiver()->Read_End(lSize_byte);
+        }
+
+        lTotal_byte += lSize_byte;
+    }
+
+    std::cout << Console::Color::BLUE;
+    std::cout << "Respond : " << lTotal_byte << " bytes received, " << lReplyCount << " replies\n";
+
+    aResponder->Display(std::cout);
+
+    lLateness.Display(std::cout, "    Reply lateness");
+
+    std::cout << Console::Color::WHITE << std::flush;
+}
+
+void Tool::Send(const void* aIn, unsigned int aInSize_byte, unsigned int aFlags)
+{
+    assert(0 < aInSize_byte);
+
+    uint8_t lHeader [FRAME_T_HEADER_byte];
+    uint8_t lTrailer[FRAME_T_TRAILER_byte];
+
+    Segment lSegments[3] = { { lHeader, sizeof(lHeader) }, { aIn, aInSize_byte }, { lTrailer, sizeof(lTrailer) } };
+
+    // Without FRAME_T, the payload is the only segment
+    auto         lFirst = lSegments + 1;
+    unsigned int lCount = 1;
+
+    if (0 != (aFlags & FLAG_FRAME_T))
+    {
+        FrameT_Encode_Segments(aIn, aInSize_byte, lHeader, lTrailer);
+
+        lFirst = lSegments;
+        lCount = 3;
+    }
+
+    unsigned int lSize_byte;
+    uint64_t     lTime_ns;
+
+    auto lData = Write(lFirst, lCount, &lSize_byte, &lTime_ns);
+
+    std::cout << Console::Color::BLUE;
+
+    DisplayDumpWrite(lData, lSize_byte, aFlags, "Send", lTime_ns, CaptureFile::DIRECTION_SEND);
+
+    mFormatter.Flush();
+
+    std::cout << Console::Color::WHITE << std::flush;
+}
+
+void Tool::SendFile(const char* aFileName, unsigned int aFlags, unsigned int aRate_Bps, unsigned int aDelay_us, unsigned int aChunk_byte)
+{
+    assert(nullptr != aFileName);
+    assert(0 < aChunk_byte);
+
+    MappedFile lFile(aFileName);
+
+    auto lData      = lFile.GetData();
+    auto lSize_byte = lFile.GetSize_byte();
+
+    bool    lFrameT = (0 != (aFlags & FLAG_FRAME_T));
+    uint8_t lHeader [FRAME_T_HEADER_byte];
+    uint8_t lTrailer[FRAME_T_TRAILER_byte];
+
+    uint64_t lChunkCount = 0;
+    uint64_t lTotal_byte = 0;
+
+    auto lStart_ns = Clock_GetTime_ns();
+
+    std::cout << Console::Color::BLUE;
+
+    for (uint64_t lOffset_byte = 0; lOffset_byte < lSize_byte; lOffset_byte += aChunk_byte)
+    {
+        auto lIn_byte = (lSize_byte - lOffset_byte < aChunk_byte) ? static_cast<unsigned int>(lSize_byte - lOffset_byte) : aChunk_byte;
+
+        // Without FRAME_T, the chunk goes directly from the mapping
+        Segment lSegments[3] = { { lHeader, sizeof(lHeader) }, { lData + lOffset_byte, lIn_byte }, { lTrailer, sizeof(lTrailer) } };
+
+        auto         lFirst        = lSegments + 1;
+        unsigned int lCount        = 1;
+        uint8_t      lCaptureFlags = 0;
+
+        if (lFrameT)
+        {
+            FrameT_Encode_Segments(lData + lOffset_byte, lIn_byte, lHeader, lTrailer);
+
+            lFirst = lSegments;
+            lCount = 3;
+
+            lCaptureFlags = CaptureFile::FLAG_FRAME;
+        }
+
+        // The schedule is computed from the start, so the sleep errors do
+        // not accumulate.
+        if (0 < aRate_Bps)
+        {
+            auto lDue_ns = lStart_ns + lTotal_byte * 1000000000 / aRate_Bps;
+            auto lNow_ns = Clock_GetTime_ns();
+
+            if (lDue_ns > lNow_ns)
+            {
+                std::this_thread::sleep_for(std::chrono::nanoseconds(lDue_ns - lNow_ns));
+            }
+        }
+
+        unsigned int lOut_byte;
+        uint64_t     lTime_ns;
+
+        Write(lFirst, lCount, &lOut_byte, &lTime_ns);
+
+        DisplayDumpWrite(lData + lOffset_byte, lIn_byte, aFlags, "SendFile", lTime_ns, CaptureFile::DIRECTION_SEND, lCaptureFlags);
+
+        lChunkCount++;
+        lTotal_byte += lOut_byte;
+
+        if ((0 < aDelay_us) && (lSize_byte > lOffset_byte + lIn_byte))
+        {
+            std::this_thread::sleep_for(std::chrono::microseconds(aDelay_us));
+        }
+    }
+
+    mFormatter.Flush();
+
+    auto lDuration_ns = Clock_GetTime_ns() - lStart_ns;
+
+    std::cout << "SendFile : " << lSize_byte << " bytes, " << lChunkCount << " chunks, " << lTotal_byte << " bytes sent in " << lDuration_ns / 1000000 << " ms";
+
+    if (0 < lDuration_ns)
+    {
+        std::cout << ", " << lTotal_byte * 1000000000 / lDuration_ns << " B/s";
+    }
+
+    std::cout << Console::Color::WHITE << std::endl;
+}
+
+// ===== CLI::Tool ==================================================
+
+void Tool::DisplayHelp(FILE* aFile) const
+{
+    assert(nullptr != aFile);
+
+    fprintf(aFile,
+        "AutoDetect [Port] [Window_ms] [Probe={Hex}] [Speed_bps ...]\n"
+        "Bench {Flags} [7|15|31] [Size_byte] [Chunk_byte]\n"
+        "Benchmark {Flags} [Size_byte] [Total_MiB]\n"
+        "Bridge {Flags} {Port} {Duration_ms}\n"
+        "Capture Expand {Segment} {Capture}\n"
+        "Capture Start [Size_byte]\n"
+        "Capture Stop\n"
+        "ClearDTR [Port]\n"
+        "ClearRTS [Port]\n"
+        "Connect [Port]\n"
+        "Decode [Port] {Flags} {%s} [Count]\n"
+        "Disconnect [Port]\n"
+        "Expect [Port] ASCII {Flags} {Timeout_ms} {Pattern} [Pattern ...]\n"
+        "Expect [Port] Hex {Flags} {Timeout_ms} {Pattern} [Pattern ...]\n"
+        "Export {Capture} [HEX|TEXT] [From_ms] [To_ms]\n"
+        "Gaps [Reset]\n"
+        "Generate [Port] {Flags} {Count|{Duration}ms} {Period_us} {Hex} [{Period_us} {Hex} ...]\n"
+        "Query {Capture} [Interval_s] [ASCII|Hex {Pattern}]\n"
+        "Receive [Port] [Flags] [Size_byte]\n"
+        "ReceiveAndVerify [Port] ASCII {Flags} {Expected}\n"
+        "ReceiveAndVerify [Port] Hex {Flags} {Expected}\n"
+        "ReceiveFrames [Port] {Flags} [Count]\n"
+        "ReceiveMessages [Port] {Flags} {Gap}us|End={Hex}|Length={Offset}:{1|2|2BE}[:{Extra_byte}] [...] [Count]\n"
+        "Respond [Port] {Flags} {RuleFile} {Duration_ms}\n"
+        #ifdef _DEBUG
+            "SelfTest\n"
+        #endif
+        "Send [Port] ASCII {Flags} {Data}\n"
+        "Send [Port] Hex {Flags} {Data}\n"
+        "SendFile [Port] {Flags} {Path} [Rate_Bps|{Delay}us] [Chunk_byte]\n"
+        "Session Start [Size_byte]\n"
+        "Session Stop\n"
+        "SetDTR [Port]\n"
+        "SetRTS [Port]\n"
+        "Status [JSON|Reset]\n"
+        "Status Log {File} {Period_ms}\n"
+        "Status Log Stop\n"
+        "Trigger Start {Prefix} {CRC_ERROR|PATTERN|VERIFY_FAILED} {Pre_ms} {Post_ms} [Size_byte] [ASCII|Hex {Pattern}]\n"
+        "Trigger Stop\n",
+        Decoder::NAMES);
+
+    CLI::Tool::DisplayHelp(aFile);
+}
+
+int Tool::ExecuteCommand(CLI::CommandLine* aCmd)
+{
+    assert(nullptr != aCmd);
+
+    int lResult = __LINE__;
+
+    mTrigger.Tick(Clock_GetTime_ns());
+
+    auto lCmd = aCmd->GetCurrent();
+
+    if      (0 == _stricmp(lCmd, "AutoDetect"      )) { aCmd->Next(); lResult = Cmd_AutoDetect      (aCmd); }
+    else if (0 == _stricmp(lCmd, "Bench"           )) { aCmd->Next(); lResult = Cmd_Bench           (aCmd); }
+    else if (0 == _stricmp(lCmd, "Benchmark"       )) { aCmd->Next(); lResult = Cmd_Benchmark       (aCmd); }
+    else if (0 == _stricmp(lCmd, "Bridge"          )) { aCmd->Next(); lResult = Cmd_Bridge          (aCmd); }
+    else if (0 == _stricmp(lCmd, "Capture"         )) { aCmd->Next(); lResult = Cmd_Capture         (aCmd); }
+    else if (0 == _stricmp(lCmd, "ClearDTR"        )) { aCmd->Next(); lResult = Cmd_ClearDTR        (aCmd); }
+    else if (0 == _stricmp(lCmd, "ClearRTS"        )) { aCmd->Next(); lResult = Cmd_ClearRTS        (aCmd); }
+    else if (0 == _stricmp(lCmd, "Connect"         )) { aCmd->Next(); lResult = Cmd_Connect         (aCmd); }
+    else if (0 == _stricmp(lCmd, "Decode"          )) { aCmd->Next(); lResult = Cmd_Decode          (aCmd); }
+    else if (0 == _stricmp(lCmd, "Disconnect"      )) { aCmd->Next(); lResult = Cmd_Disconnect      (aCmd); }
+    else if (0 == _stricmp(lCmd, "Expect"          )) { aCmd->Next(); lResult = Cmd_Expect          (aCmd); }
+    else if (0 == _stricmp(lCmd, "Export"          )) { aCmd->Next(); lResult = Cmd_Export          (aCmd); }
+    else if (0 == _stricmp(lCmd, "Gaps"            )) { aCmd->Next(); lResult = Cmd_Gaps            (aCmd); }
+    else if (0 == _stricmp(lCmd, "Generate"        )) { aCmd->Next(); lResult = Cmd_Generate        (aCmd); }
+    else if (0 == _stricmp(lCmd, "Query"           )) { aCmd->Next(); lResult = Cmd_Query           (aCmd); }
+    else if (0 == _stricmp(lCmd, "Receive"         )) { aCmd->Next(); lResult = Cmd_Receive         (aCmd); }
+    else if (0 == _stricmp(lCmd, "ReceiveAndVerify")) { aCmd->Next(); lResult = Cmd_ReceiveAndVerify(aCmd); }
+    else if (0 == _stricmp(lCmd, "ReceiveFrames"   )) { aCmd->Next(); lResult = Cmd_ReceiveFrames   (aCmd); }
+    else if (0 == _stricmp(lCmd, "ReceiveMessages" )) { aCmd->Next(); lResult = Cmd_ReceiveMessages (aCmd); }
+    else if (0 == _stricmp(lCmd, "Respond"         )) { aCmd->Next(); lResult = Cmd_Respond         (aCmd); }
+    #ifdef _DEBUG
+        else if (0 == _stricmp(lCmd, "SelfTest"    )) { aCmd->Next(); lResult = Cmd_SelfTest        (aCmd); }
+    #endif
+    else if (0 == _stricmp(lCmd, "Send"            )) { aCmd->Next(); lResult = Cmd_Send            (aCmd); }
+    else if (0 == _stricmp(lCmd, "SendFile"        )) { aCmd->Next(); lResult = Cmd_SendFile        (aCmd); }
+    else if (0 == _stricmp(lCmd, "Session"         )) { aCmd->Next(); lResult = Cmd_Session         (aCmd); }
+    else if (0 == _stricmp(lCmd, "SetDTR"          )) { aCmd->Next(); lResult = Cmd_SetDTR          (aCmd); }
+    else if (0 == _stricmp(lCmd, "SetRTS"          )) { aCmd->Next(); lResult = Cmd_SetRTS          (aCmd); }
+    else if (0 == _stricmp(lCmd, "Status"          )) { aCmd->Next(); lResult = Cmd_Status          (aCmd); }
+    else if (0 == _stricmp(lCmd, "Trigger"         )) { aCmd->Next(); lResult = Cmd_Trigger         (aCmd); }
+    else
+    {
+        lResult = CLI::Tool::ExecuteCommand(aCmd);
+    }
+
+    return lResult;
+}
+
+int Tool::Run()
+{
+    if (!mPort.Connect())
+    {
+        KMS_EXCEPTION(RESULT_CONNECT_FAILED, "Connexion failed", "");
+    }
+
+    for (auto& lVT : mPorts.mInternal)
+    {
+        auto lPort = dynamic_cast<Com::Port*>(lVT.second.Get());
+        assert(nullptr != lPort);
+
+        if (!lPort->Connect())
+        {
+            KMS_EXCEPTION(RESULT_CONNECT_FAILED, "Connexion failed", lVT.first.c_str());
+        }
+
+        mSession.AddPort(lVT.first.c_str(), lPort);
+    }
+
+    return CLI::Tool::Run();
+}
+
+// ===== IDecoderListener ===========================================
+
+void Tool::OnDecoded(const uint8_t* aIn, unsigned int aInSize_byte, const char* aInfo)
+{
+    // Decode selects the color and flushes the formatter. With the time
+    // stamp, DisplayDumpWrite writes the description.
+    if ((0 == (mDecoderFlags & FLAG_TIMESTAMP)) || (0 == (mDecoderFlags & (FLAG_DISPLAY | FLAG_DUMP))))
+    {
+        mFormatter.Write(aInfo);
+        mFormatter.Write("\n", 1);
+    }
+
+    DisplayDumpWrite(aIn, aInSize_byte, mDecoderFlags, aInfo, mDecoderTime_ns, CaptureFile::DIRECTION_RECEIVE, CaptureFile::FLAG_FRAME);
+}
+
+void Tool::OnDecodeError(const uint8_t* aIn, unsigned int aInSize_byte, const char* aReason)
+{
+    char lOp[LINE_LENGTH];
+
+    sprintf_s(lOp SizeInfo(lOp), "Decode ERROR %s", aReason);
+
+    mFormatter.Flush();
+
+    std::cout << Console::Color::RED;
+
+    DisplayDumpWrite(aIn, aInSize_byte, mDecoderFlags | FLAG_DUMP | FLAG_TIMESTAMP, lOp, mDecoderTime_ns, CaptureFile::DIRECTION_RECEIVE, CaptureFile::FLAG_FRAME_ERROR);
+
+    mFormatter.Flush();
+
+    std::cout << Console::Color::GREEN;
+}
+
+// ===== IDetectTarget ==============================================
+
+void Tool::OnDetectBegin(uint32_t aSpeed_bps, Com::Parity aParity)
+{
+    ApplySetting(GetPort(), aSpeed_bps, aParity);
+
+    // The bytes received with the previous setting do not count
+    mUnreadSize_byte = 0;
+
+    if (nullptr != mDetectProbe)
+    {
+        uint64_t lTime_ns;
+
+        Write(mDetectProbe, mDetectProbeSize_byte, &lTime_ns);
+    }
+
+    // The receiver thread waits on the port, so a read waits at most for
+    // its timeout.
+    GetReceiver()->Start();
+}
+
+unsigned int Tool::OnDetectRead(uint8_t* aOut, unsigned int aOutSize_byte, unsigned int aTimeout_ms)
+{
+    return GetReceiver()->Read(aOut, aOutSize_byte, 0, aTimeout_ms);
+}
+
+void Tool::OnDetectEnd()
+{
+    GetReceiver()->Stop();
+}
+
+// ===== IFrameListener =============================================
+
+void Tool::OnFrame(const uint8_t* aIn, unsigned int aInSize_byte)
+{
+    mFrameGaps.Add(mDeframerTime_ns);
+
+    // ReceiveFrames selects the color and flushes the formatter
+    DisplayDumpWrite(aIn, aInSize_byte, mDeframerFlags, "Receive frame", mDeframerTime_ns, CaptureFile::DIRECTION_RECEIVE, CaptureFile::FLAG_FRAME);
+}
+
+void Tool::OnFrameError(const uint8_t* aIn, unsigned int aInSize_byte)
+{
+    mFormatter.Flush();
+
+    std::cout << Console::Color::RED;
+
+    DisplayDumpWrite(aIn, aInSize_byte, mDeframerFlags | FLAG_DUMP | FLAG_TIMESTAMP, "Receive frame CRC ERROR", mDeframerTime_ns, CaptureFile::DIRECTION_RECEIVE, CaptureFile::FLAG_FRAME_ERROR);
+
+    mFormatter.Flush();
+
+    std::cout << Console::Color::GREEN;
+}
+
+// ===== IMessageListener ===========================================
+
+void Tool::OnMessage(const uint8_t* aIn, unsigned int aInSize_byte, uint64_t aTime_ns, bool aComplete)
+{
+    // ReceiveMessages selects the color and flushes the formatter
+    if (aComplete)
+    {
+        DisplayDumpWrite(aIn, aInSize_byte, mDelimiterFlags, "Receive message", aTime_ns, CaptureFile::DIRECTION_RECEIVE, CaptureFile::FLAG_MESSAGE);
+    }
+    else
+    {
+        mFormatter.Flush();
+
+        std::cout << Console::Color::RED;
+
+        DisplayDumpWrite(aIn, aInSize_byte, mDelimiterFlags | FLAG_DUMP | FLAG_TIMESTAMP, "Receive message INCOMPLETE", aTime_ns, CaptureFile::DIRECTION_RECEIVE, CaptureFile::FLAG_MESSAGE_ERROR);
+
+        mFormatter.Flush();
+
+        std::cout << Console::Color::GREEN;
+    }
+}
+
+// Private
+// //////////////////////////////////////////////////////////////////////////
+
+int Tool::Cmd_AutoDetect(CLI::CommandLine* aCmd)
+{
+    assert(nullptr != aCmd);
+
+    SelectPort(aCmd);
+
+    unsigned int lWindow_ms = AUTO_DETECT_WINDOW_DEFAULT_ms;
+
+    if (!aCmd->IsAtEnd() && (0 != _strnicmp(aCmd->GetCurrent(), "Probe=", 6)))
+    {
+        lWindow_ms = Convert::ToUInt32(aCmd->GetCurrent()); aCmd->Next();
+    }
+
+    std::vector<uint8_t> lProbe;
+
+    if (!aCmd->IsAtEnd() && (0 == _strnicmp(aCmd->GetCurrent(), "Probe=", 6)))
+    {
+        auto lHex = aCmd->GetCurrent() + 6;
+
+        lProbe.resize(strlen(lHex) / 2 + 1);
+        lProbe.resize(Hex_ToBytes(lHex, lProbe.data(), static_cast<unsigned int>(lProbe.size())));
+
+        aCmd->Next();
+    }
+
+    std::vector<uint32_t> lSpeeds_bps;
+
+    while (!aCmd->IsAtEnd())
+    {
+        lSpeeds_bps.push_back(Convert::ToUInt32(aCmd->GetCurrent())); aCmd->Next();
+    }
+
+    if (lSpeeds_bps.empty())
+    {
+        lSpeeds_bps.assign(Detector::SPEEDS_bps, Detector::SPEEDS_bps + Detector::SPEED_QTY);
+    }
+
+    AutoDetect(lSpeeds_bps.data(), static_cast<unsigned int>(lSpeeds_bps.size()), lProbe.empty() ? nullptr : lProbe.data(), static_cast<unsigned int>(lProbe.size()), lWindow_ms);
+
+    return 0;
+}
+
+// The port needs a loopback connector
+int Tool::Cmd_Bench(CLI::CommandLine* aCmd)
+{
+    assert(nullptr != aCmd);
+
+    auto lFlags = ToFlags(aCmd->GetCurrent()); aCmd->Next();
+
+    unsigned int lChunk_byte = Bench::CHUNK_DEFAULT_byte;
+    unsigned int lOrder      = BENCH_ORDER_DEFAULT;
+    unsigned int lSize_byte  = BENCH_SIZE_DEFAULT_byte;
+
+    if (!aCmd->IsAtEnd()) { lOrder      = Convert::ToUInt32(aCmd->GetCurrent()); aCmd->Next(); }
+    if (!aCmd->IsAtEnd()) { lSize_byte  = Convert::ToUInt32(aCmd->GetCurrent()); aCmd->Next(); }
+    if (!aCmd->IsAtEnd()) { lChunk_byte = Convert::ToUInt32(aCmd->GetCurrent()); aCmd->Next(); }
+
+    KMS_EXCEPTION_ASSERT(aCmd->IsAtEnd(), RESULT_INVALID_COMMAND, "Too many command arguments", aCmd->GetCurrent());
+
+    Bench lBench(&mPort, &mReceiver);
+
+    lBench.Run(lOrder, lSize_byte, lChunk_byte, mCaptureTimeout_ms);
+
+    std::cout << (lBench.IsPassed() ? Console::Color::GREEN : Console::Color::RED);
+
+    lBench.Display(std::cout);
+
+    std::cout << Console::Color::WHITE << std::flush;
+
+    KMS_EXCEPTION_ASSERT(lBench.IsPassed() || (0 == (lFlags & FLAG_EXIT_ON_ERROR)), RESULT_BENCH_FAILED, "Bench failed", "");
+
+    return 0;
+}
+
+int Tool::Cmd_Benchmark(CLI::CommandLine* aCmd)
+{
+    assert(nullptr != aCmd);
+
+    auto lFlags = ToFlags(aCmd->GetCurrent()); aCmd->Next();
+
+    unsigned int lSize_byte = BENCHMARK_SIZE_DEFAULT_byte;
+    unsigned int lTotal_MiB = BENCHMARK_TOTAL_DEFAULT_MiB;
+
+    if (!aCmd->IsAtEnd())
+    {
+        lSize_byte = Convert::ToUInt32(aCmd->GetCurrent()); aCmd->Next();
+
+        KMS_EXCEPTION_ASSERT(0 < lSize_byte, RESULT_INVALID_VALUE, "Invalid size", "");
+
+        if (!aCmd->IsAtEnd())
+        {
+            lTotal_MiB = Convert::ToUInt32(aCmd->GetCurrent()); aCmd->Next();
+        }
+
+        KMS_EXCEPTION_ASSERT(aCmd->IsAtEnd(), RESULT_INVALID_COMMAND, "Too many command arguments", aCmd->GetCurrent());
+    }
+
+    Benchmark(lFlags, lSize_byte, lTotal_MiB);
+
+    return 0;
+}
+
+int Tool::Cmd_Bridge(CLI::CommandLine* aCmd)
+{
+    assert(nullptr != aCmd);
+
+    auto lFlags       =          ToFlags (aCmd->GetCurrent()); aCmd->Next();
+    auto lName        =                   aCmd->GetCurrent() ; aCmd->Next();
+    auto lDuration_ms = Convert::ToUInt32(aCmd->GetCurrent()); aCmd->Next();
+
+    KMS_EXCEPTION_ASSERT(aCmd->IsAtEnd(), RESULT_INVALID_COMMAND, "Too many command arguments", aCmd->GetCurrent());
+
+    auto lChannel = mSession.FindChannel(lName);
+    KMS_EXCEPTION_ASSERT(nullptr != lChannel, RESULT_INVALID_COMMAND, "Unknown port", lName);
+
+    Bridge(lChannel, lFlags, lDuration_ms);
+
+    return 0;
+}
+
+int Tool::Cmd_Capture(CLI::CommandLine* aCmd)
+{
+    assert(nullptr != aCmd);
+
+    int lResult = __LINE__;
+
+    auto lCmd = aCmd->GetCurrent();
+
+    if      (0 == _stricmp(lCmd, "Expand")) { aCmd->Next(); lResult = Cmd_Capture_Expand(aCmd); }
+    else if (0 == _stricmp(lCmd, "Start" )) { aCmd->Next(); lResult = Cmd_Capture_Start (aCmd); }
+    else if (0 == _stricmp(lCmd, "Stop"  )) { aCmd->Next(); lResult = Cmd_Capture_Stop  (aCmd); }
+
+    return lResult;
+}
+
+int Tool::Cmd_Capture_Expand(CLI::CommandLine* aCmd)
+{
+    assert(nullptr != aCmd);
+
+    auto lIn  = aCmd->GetCurrent(); aCmd->Next();
+    auto lOut = aCmd->GetCurrent(); aCmd->Next();
+
+    KMS_EXCEPTION_ASSERT(aCmd->IsAtEnd(), RESULT_INVALID_COMMAND, "Too many command arguments", aCmd->GetCurrent());
+
+    CaptureRoll::Expand(lIn, lOut);
+
+    return 0;
+}
+
+int Tool::Cmd_Capture_Start(CLI::CommandLine* aCmd)
+{
+    assert(nullptr != aCmd);
+
+    unsigned int lSize_byte = Receiver::SIZE_DEFAULT_byte;
+
+    if (!aCmd->IsAtEnd())
+    {
+        lSize_byte = Convert::ToUInt32(aCmd->GetCurrent()); aCmd->Next();
+
+        KMS_EXCEPTION_ASSERT(aCmd->IsAtEnd(), RESULT_INVALID_COMMAND, "Too many command arguments", aCmd->GetCurrent());
+    }
+
+    mReceiver.Start(lSize_byte);
+
+    return 0;
+}
+
+int Tool::Cmd_Capture_Stop(CLI::CommandLine* aCmd)
+{
+    assert(nullptr != aCmd);
+
+    KMS_EXCEPTION_ASSERT(aCmd->IsAtEnd(), RESULT_INVALID_COMMAND, "Too many command arguments", aCmd->GetCurrent());
+
+    mReceiver.Stop();
+
+    return 0;
+}
+
+int Tool::Cmd_ClearDTR(CLI::CommandLine* aCmd)
+{
+    assert(nullptr != aCmd);
+
+    SelectPort(aCmd);
+
+    KMS_EXCEPTION_ASSERT(aCmd->IsAtEnd(), RESULT_INVALID_COMMAND, "Too many command arguments", aCmd->GetCurrent());
+
+    GetPort()->SetDTR(false);
+
+    return 0;
+}
+
+int Tool::Cmd_ClearRTS(CLI::CommandLine* aCmd)
+{
+    assert(nullptr != aCmd);
+
+    SelectPort(aCmd);
+
+    KMS_EXCEPTION_ASSERT(aCmd->IsAtEnd(), RESULT_INVALID_COMMAND, "Too many command arguments", aCmd->GetCurrent());
+
+    GetPort()->SetRTS(false);
+
+    return 0;
+}
+
+int Tool::Cmd_Connect(CLI::CommandLine* aCmd)
+{
+    assert(nullptr != aCmd);
+
+    SelectPort(aCmd);
+
+    KMS_EXCEPTION_ASSERT(aCmd->IsAtEnd(), RESULT_INVALID_COMMAND, "Too many command arguments", aCmd->GetCurrent());
+
+    if (!GetPort()->Connect())
+    {
+        KMS_EXCEPTION(RESULT_CONNECT_FAILED, "Connexion failed", "");
+    }
+
+    return 0;
+}
+
+int Tool::Cmd_Decode(CLI::CommandLine* aCmd)
+{
+    assert(nullptr != aCmd);
+
+    SelectPort(aCmd);
+
+    auto lFlags = ToFlags(aCmd->GetCurrent()); aCmd->Next();
+
+    std::unique_ptr<Decoder> lDecoder(Decoder::Create(aCmd->GetCurrent(), this)); aCmd->Next();
+
+    unsigned int lCount = 0;
+
+    if (!aCmd->IsAtEnd())
+    {
+        lCount = Convert::ToUInt32(aCmd->GetCurrent()); aCmd->Next();
+
+        KMS_EXCEPTION_ASSERT(aCmd->IsAtEnd(), RESULT_INVALID_COMMAND, "Too many command arguments", aCmd->GetCurrent());
+    }
+
+    Decode(lDecoder.get(), lCount, lFlags);
+
+    return 0;
+}
+
+int Tool::Cmd_Disconnect(CLI::CommandLine* aCmd)
+{
+    assert(nullptr != aCmd);
+
+    SelectPort(aCmd);
+
+    KMS_EXCEPTION_ASSERT(aCmd->IsAtEnd(), RESULT_INVALID_COMMAND, "Too many command arguments", aCmd->GetCurrent());
+    KMS_EXCEPTION_ASSERT((nullptr == mChannel) || !mSession.IsRunning(), RESULT_INVALID_COMMAND, "The session is running", "");
+
+    GetReceiver()->Stop();
+
+    mUnreadSize_byte = 0;
+
+    GetPort()->Disconnect();
+
+    return 0;
+}
+
+int Tool::Cmd_Expect(CLI::CommandLine* aCmd)
+{
+    assert(nullptr != aCmd);
+
+    SelectPort(aCmd);
+
+    auto lType = aCmd->GetCurrent(); aCmd->Next();
+
+    bool lHex;
+
+    if      (0 == _stricmp(lType, "ASCII")) { lHex = false; }
+    else if (0 == _stricmp(lType, "Hex"  )) { lHex = true ; }
+    else
+    {
+        KMS_EXCEPTION(RESULT_INVALID_COMMAND, "Invalid command", lType);
+    }
+
+    auto lFlags      = ToFlags         (aCmd->GetCurrent()); aCmd->Next();
+    auto lTimeout_ms = Convert::ToUInt32(aCmd->GetCurrent()); aCmd->Next();
+
+    KMS_EXCEPTION_ASSERT(!aCmd->IsAtEnd(), RESULT_INVALID_COMMAND, "No pattern", "");
+
+    Matcher lMatcher;
+
+    while (!aCmd->IsAtEnd())
+    {
+        if (lHex)
+        {
+            lMatcher.AddPattern_Hex(aCmd->GetCurrent());
+        }
+        else
+        {
+            lMatcher.AddPattern_ASCII(aCmd->GetCurrent());
+        }
+
+        aCmd->Next();
+    }
+
+    lMatcher.Compile();
+
+    Expect(&lMatcher, lTimeout_ms, lFlags);
+
+    return 0;
+}
+
+int Tool::Cmd_Export(CLI::CommandLine* aCmd)
+{
+    assert(nullptr != aCmd);
+
+    auto lFileName = aCmd->GetCurrent(); aCmd->Next();
+
+    auto     lHex     = true;
+    uint64_t lFrom_ms = 0;
+    uint64_t lTo_ms   = UINT64_MAX;
+
+    if (!aCmd->IsAtEnd())
+    {
+        auto lFormat = aCmd->GetCurrent(); aCmd->Next();
+
+        if      (0 == _stricmp(lFormat, "HEX" )) { lHex = true; }
+        else if (0 == _stricmp(lFormat, "TEXT")) { lHex = false; }
+        else
+        {
+            KMS_EXCEPTION(RESULT_INVALID_COMMAND, "Invalid export format", lFormat);
+        }
+    }
+
+    if (!aCmd->IsAtEnd()) { lFrom_ms = Convert::ToUInt32(aCmd->GetCurrent()); aCmd->Next(); }
+    if (!aCmd->IsAtEnd()) { lTo_ms   = Convert::ToUInt32(aCmd->GetCurrent()); aCmd->Next(); }
+
+    KMS_EXCEPTION_ASSERT(aCmd->IsAtEnd(), RESULT_INVALID_COMMAND, "Too many command arguments", aCmd->GetCurrent());
+    KMS_EXCEPTION_ASSERT(lFrom_ms <= lTo_ms, RESULT_INVALID_COMMAND, "Invalid time range", "");
+
+    Export(lFileName, lHex, lFrom_ms, lTo_ms);
+
+    return 0;
+}
+
+int Tool::Cmd_Gaps(CLI::CommandLine* aCmd)
+{
+    assert(nullptr != aCmd);
+
+    if (!aCmd->IsAtEnd())
+    {
+        auto lOp = aCmd->GetCurrent(); aCmd->Next();
+
+        KMS_EXCEPTION_ASSERT(0 == _stricmp(lOp, "Reset"), RESULT_INVALID_COMMAND, "Invalid command", lOp);
+        KMS_EXCEPTION_ASSERT(aCmd->IsAtEnd(), RESULT_INVALID_COMMAND, "Too many command arguments", aCmd->GetCurrent());
+
+        mByteGaps .Reset();
+        mFrameGaps.Reset();
+        return 0;
+    }
+
+    mByteGaps .Display(std::cout, "Byte gaps ", true);
+    mFrameGaps.Display(std::cout, "Frame gaps", true);
+
+    std::cout << std::flush;
+
+    return 0;
+}
+
+int Tool::Cmd_Generate(CLI::CommandLine* aCmd)
+{
+    assert(nullptr != aCmd);
+
+    SelectPort(aCmd);
+
+    auto lFlags = ToFlags(aCmd->GetCurrent()); aCmd->Next();
+    auto lLimit =         aCmd->GetCurrent() ; aCmd->Next();
+
+    uint64_t     lCount       = 0;
+    unsigned int lDuration_ms = 0;
+
+    auto lLen = strlen(lLimit);
+
+    if ((2 < lLen) && (NAME_LENGTH > lLen) && (0 == _stricmp(lLimit + lLen - 2, "ms")))
+    {
+        char lValue[NAME_LENGTH];
+
+        memcpy(lValue, lLimit, lLen - 2);
+        lValue[lLen - 2] = '\0';
+
+        lDuration_ms = Convert::ToUInt32(lValue);
+    }
+    else
+    {
+        lCount = Convert::ToUInt32(lLimit);
+    }
+
+    KMS_EXCEPTION_ASSERT(!aCmd->IsAtEnd(), RESULT_INVALID_COMMAND, "No stream", "");
+
+    Generator lGenerator;
+
+    while (!aCmd->IsAtEnd())
+    {
+        auto lPeriod_us = Convert::ToUInt32(aCmd->GetCurrent()); aCmd->Next();
+
+        KMS_EXCEPTION_ASSERT(!aCmd->IsAtEnd(), RESULT_INVALID_COMMAND, "No payload", "");
+
+        uint8_t lData[LINE_LENGTH];
+
+        auto lSize_byte = Hex_ToBytes(aCmd->GetCurrent(), lData, sizeof(lData)); aCmd->Next();
+
+        if (0 != (lFlags & FLAG_FRAME_T))
+        {
+            uint8_t lFrame[LINE_LENGTH + FRAME_T_OVERHEAD_byte];
+
+            lSize_byte = FrameT_Encode(lData, lSize_byte, lFrame, sizeof(lFrame));
+
+            lGenerator.AddStream(lFrame, lSize_byte, lPeriod_us);
+        }
+        else
+        {
+            lGenerator.AddStream(lData, lSize_byte, lPeriod_us);
+        }
+    }
+
+    Generate(&lGenerator, lFlags, lCount, lDuration_ms);
+
+    return 0;
+}
+
+int Tool::Cmd_Query(CLI::CommandLine* aCmd)
+{
+    assert(nullptr != aCmd);
+
+    auto lFileName = aCmd->GetCurrent(); aCmd->Next();
+
+    unsigned int lInterval_s = QUERY_INTERVAL_DEFAULT_s;
+
+    std::vector<uint8_t> lPattern;
+
+    if (!aCmd->IsAtEnd())
+    {
+        auto lArg = aCmd->GetCurrent();
+
+        if ((0 != _stricmp(lArg, "ASCII")) && (0 != _stricmp(lArg, "Hex")))
+        {
+            lInterval_s = Convert::ToUInt32(lArg); aCmd->Next();
+        }
+    }
+
+    if (!aCmd->IsAtEnd())
+    {
+        ToPattern(aCmd, &lPattern);
+    }
+
+    KMS_EXCEPTION_ASSERT(aCmd->IsAtEnd(), RESULT_INVALID_COMMAND, "Too many command arguments", aCmd->GetCurrent());
+
+    if (lPattern.empty())
+    {
+        Query(lFileName, lInterval_s);
+    }
+    else
+    {
+        Query(lFileName, lInterval_s, lPattern.data(), static_cast<unsigned int>(lPattern.size()));
+    }
+
+    return 0;
+}
+
+int Tool::Cmd_Receive(CLI::CommandLine* aCmd)
+{
+    assert(nullptr != aCmd);
+
+    SelectPort(aCmd);
+
+    unsigned int lFlags     = 0;
+    unsigned int lSize_byte = 0;
+
+    if (!aCmd->IsAtEnd())
+    {
+        lFlags = ToFlags(aCmd->GetCurrent()); aCmd->Next();
+
+        if (!aCmd->IsAtEnd())
+        {
+            lSize_byte = Convert::ToUInt32(aCmd->GetCurrent()); aCmd->Next();
+
+            KMS_EXCEPTION_ASSERT(aCmd->IsAtEnd(), RESULT_INVALID_COMMAND, "Too many command arguments", aCmd->GetCurrent());
+        }
+    }
+
+    Receive(lSize_byte, lFlags);
+
+    return 0;
+}
+
+int Tool::Cmd_ReceiveAndVerify(CLI::CommandLine* aCmd)
+{
+    assert(nullptr != aCmd);
+
+    SelectPort(aCmd);
+
+    int lResult = __LINE__;
+
+    auto lCmd = aCmd->GetCurrent();
+
+    if      (0 == _stricmp(lCmd, "ASCII")) { aCmd->Next(); lResult = Cmd_ReceiveAndVerify_ASCII(aCmd); }
+    else if (0 == _stricmp(lCmd, "Hex"  )) { aCmd->Next(); lResult = Cmd_ReceiveAndVerify_Hex  (aCmd); }
+
+    return lResult;
+}
+
+int Tool::Cmd_ReceiveAndVerify_ASCII(CLI::CommandLine* aCmd)
+{
+    assert(nullptr != aCmd);
+
+    auto lFlags = ToFlags(aCmd->GetCurrent()); aCmd->Next();
+    auto lData  =         aCmd->GetCurrent() ; aCmd->Next();
+
+    KMS_EXCEPTION_ASSERT(aCmd->IsAtEnd(), RESULT_INVALID_COMMAND, "Too many command arguments", aCmd->GetCurrent());
+
+    ReceiveAndVerify(lData, static_cast<unsigned int>(strlen(lData)), lFlags);
+
+    return 0;
+}
+
+int Tool::Cmd_ReceiveAndVerify_Hex(CLI::CommandLine* aCmd)
+{
+    assert(nullptr != aCmd);
+
+    auto lFlags = ToFlags(aCmd->GetCurrent()); aCmd->Next();
+    auto lData  =         aCmd->GetCurrent() ; aCmd->Next();
+
+    KMS_EXCEPTION_ASSERT(aCmd->IsAtEnd(), RESULT_INVALID_COMMAND, "Too many command arguments", aCmd->GetCurrent());
+
+    ReceiveAndVerify_Hex(lData, lFlags);
+    
+    return 0;
+}
+
+int Tool::Cmd_ReceiveFrames(CLI::CommandLine* aCmd)
+{
+    assert(nullptr != aCmd);
+
+    SelectPort(aCmd);
+
+    auto lFlags = ToFlags(aCmd->GetCurrent()); aCmd->Next();
+
+    unsigned int lCount = 0;
+
+    if (!aCmd->IsAtEnd())
+    {
+        lCount = Convert::ToUInt32(aCmd->GetCurrent()); aCmd->Next();
+
+        KMS_EXCEPTION_ASSERT(aCmd->IsAtEnd(), RESULT_INVALID_COMMAND, "Too many command arguments", aCmd->GetCurrent());
+    }
+
+    ReceiveFrames(lCount, lFlags);
+
+    return 0;
+}
+
+int Tool::Cmd_ReceiveMessages(CLI::CommandLine* aCmd)
+{
+    assert(nullptr != aCmd);
+
+    SelectPort(aCmd);
+
+    auto lFlags = ToFlags(aCmd->GetCurrent()); aCmd->Next();
+
+    Delimiter lDelimiter(this);
+
+    unsigned int lCount = 0;
+    bool         lRule  = false;
+
+    while (!aCmd->IsAtEnd())
+    {
+        auto lArg = aCmd->GetCurrent(); aCmd->Next();
+
+        auto lLen = strlen(lArg);
+
+        if ((2 < lLen) && (NAME_LENGTH > lLen) && (0 == _stricmp(lArg + lLen - 2, "us")))
+        {
+            char lValue[NAME_LENGTH];
+
+            memcpy(lValue, lArg, lLen - 2);
+            lValue[lLen - 2] = '\0';
+
+            lDelimiter.SetGap(Convert::ToUInt32(lValue));
+        }
+        else if (0 == _strnicmp(lArg, "End=", 4))
+        {
+            uint8_t lTerminator[NAME_LENGTH];
+
+            auto lSize_byte = Hex_ToBytes(lArg + 4, lTerminator, sizeof(lTerminator));
+
+            lDelimiter.SetTerminator(lTerminator, lSize_byte);
+        }
+        else if (0 == _strnicmp(lArg, "Length=", 7))
+        {
+            char         lSize[NAME_LENGTH];
+            unsigned int lExtra_byte  = 0;
+            unsigned int lOffset_byte = 0;
+
+            auto lFieldCount = sscanf_s(lArg + 7, "%u:%15[0-9A-Za-z]:%u", &lOffset_byte, lSize SizeInfo(lSize), &lExtra_byte);
+
+            KMS_EXCEPTION_ASSERT(2 <= lFieldCount, RESULT_INVALID_VALUE, "Invalid length rule", lArg);
+
+            if      (0 == _stricmp(lSize, "1"  )) { lDelimiter.SetLength(lOffset_byte, 1, false, lExtra_byte); }
+            else if (0 == _stricmp(lSize, "2"  )) { lDelimiter.SetLength(lOffset_byte, 2, false, lExtra_byte); }
+            else if (0 == _stricmp(lSize, "2BE")) { lDelimiter.SetLength(lOffset_byte, 2, true , lExtra_byte); }
+            else
+            {
+                KMS_EXCEPTION(RESULT_INVALID_VALUE, "Invalid length field size", lArg);
+            }
+        }
+        else
+        {
+            lCount = Convert::ToUInt32(lArg);
+
+            KMS_EXCEPTION_ASSERT(aCmd->IsAtEnd(), RESULT_INVALID_COMMAND, "Too many command arguments", aCmd->GetCurrent());
+            break;
+        }
+
+        lRule = true;
+    }
+
+    KMS_EXCEPTION_ASSERT(lRule, RESULT_INVALID_COMMAND, "No delimiting rule", "");
+
+    ReceiveMessages(&lDelimiter, lCount, lFlags);
+
+    return 0;
+}
+
+int Tool::Cmd_Respond(CLI::CommandLine* aCmd)
+{
+    assert(nullptr != aCmd);
+
+    SelectPort(aCmd);
+
+    auto lFlags       = ToFlags          (aCmd->GetCurrent()); aCmd->Next();
+    auto lFileName    =                   aCmd->GetCurrent() ; aCmd->Next();
+    auto lDuration_ms = Convert::ToUInt32(aCmd->GetCurrent()); aCmd->Next();
+
+    KMS_EXCEPTION_ASSERT(aCmd->IsAtEnd(), RESULT_INVALID_COMMAND, "Too many command arguments", aCmd->GetCurrent());
+
+    Responder lResponder;
+
+    lResponder.Load(lFileName);
+
+    Respond(&lResponder, lFlags, lDuration_ms);
+
+    return 0;
+}
+
+#ifdef _DEBUG
+
+    int Tool::Cmd_SelfTest(CLI::CommandLine* aCmd)
+    {
+        assert(nullptr != aCmd);
+
+        KMS_EXCEPTION_ASSERT(aCmd->IsAtEnd(), RESULT_INVALID_COMMAND, "Too many command arguments", aCmd->GetCurrent());
+
+        auto lFailed = SelfTest_Run(std::cout);
+
+        std::cout << ((0 == lFailed) ? Console::Color::GREEN : Console::Color::RED);
+        std::cout << "Self test : " << lFailed << " failed" << Console::Color::WHITE << std::endl;
+
+        KMS_EXCEPTION_ASSERT(0 == lFailed, RESULT_SELF_TEST_FAILED, "Self test failed", lFailed);
+
+        return 0;
+    }
+
+#endif
+
+int Tool::Cmd_Send(CLI::CommandLine* aCmd)
+{
+    assert(nullptr != aCmd);
+
+    SelectPort(aCmd);
+
+    int lResult = __LINE__;
+
+    auto lCmd = aCmd->GetCurrent();
+
+    if      (0 == _stricmp(lCmd, "ASCII")) { aCmd->Next(); lResult = Cmd_Send_ASCII(aCmd); }
+    else if (0 == _stricmp(lCmd, "Hex"  )) { aCmd->Next(); lResult = Cmd_Send_Hex  (aCmd); }
+
+    return lResult;
+}
+
+int Tool::Cmd_Send_ASCII(CLI::CommandLine* aCmd)
+{
+    assert(nullptr != aCmd);
+
+    auto lFlags = ToFlags(aCmd->GetCurrent()); aCmd->Next();
+    auto lData  =         aCmd->GetCurrent() ; aCmd->Next();
+
+    KMS_EXCEPTION_ASSERT(aCmd->IsAtEnd(), RESULT_INVALID_COMMAND, "Too many command arguments", aCmd->GetCurrent());
+
+    Send(lData, static_cast<unsigned int>(strlen(lData)), lFlags);
+
+    return 0;
+}
+
+int Tool::Cmd_Send_Hex(CLI::CommandLine* aCmd)
+{
+    assert(nullptr != aCmd);
+
+    auto lFlags = ToFlags(aCmd->GetCurrent()); aCmd->Next();
+    auto lData  =         aCmd->GetCurrent() ; aCmd->Next();
+
+    KMS_EXCEPTION_ASSERT(aCmd->IsAtEnd(), RESULT_INVALID_COMMAND, "Too many command arguments", aCmd->GetCurrent());
+
+    Send_Hex(lData, lFlags);
+
+    return 0;
+}
+
+int Tool::Cmd_SendFile(CLI::CommandLine* aCmd)
+{
+    assert(nullptr != aCmd);
+
+    SelectPort(aCmd);
+
+    auto lFlags    = ToFlags(aCmd->GetCurrent()); aCmd->Next();
+    auto lFileName =         aCmd->GetCurrent() ; aCmd->Next();
+
+    unsigned int lChunk_byte = SEND_FILE_CHUNK_DEFAULT_byte;
+    unsigned int lDelay_us   = 0;
+    unsigned int lRate_Bps   = 0;
+
+    if (!aCmd->IsAtEnd())
+    {
+        auto lRate = aCmd->GetCurrent(); aCmd->Next();
+
+        auto lLen = strlen(lRate);
+
+        if ((2 < lLen) && (NAME_LENGTH > lLen) && (0 == _stricmp(lRate + lLen - 2, "us")))
+        {
+            char lValue[NAME_LENGTH];
+
+            memcpy(lValue, lRate, lLen - 2);
+            lValue[lLen - 2] = '\0';
+
+            lDelay_us = Convert::ToUInt32(lValue);
+        }
+        else
+        {
+            lRate_Bps = Convert::ToUInt32(lRate);
+        }
+    }
+
+    if (!aCmd->IsAtEnd())
+    {
+        lChunk_byte = Convert::ToUInt32(aCmd->GetCurrent()); aCmd->Next();
+
+        KMS_EXCEPTION_ASSERT(0 < lChunk_byte, RESULT_INVALID_VALUE, "Invalid chunk size", "");
+    }
+
+    KMS_EXCEPTION_ASSERT(aCmd->IsAtEnd(), RESULT_INVALID_COMMAND, "Too many command arguments", aCmd->GetCurrent());
+
+    SendFile(lFileName, lFlags, lRate_Bps, lDelay_us, lChunk_byte);
+
+    return 0;
+}
+
+int Tool::Cmd_Session(CLI::CommandLine* aCmd)
+{
+    assert(nullptr != aCmd);
+
+    int lResult = __LINE__;
+
+    auto lCmd = aCmd->GetCurrent();
+
+    if      (0 == _stricmp(lCmd, "Start")) { aCmd->Next(); lResult = Cmd_Session_Start(aCmd); }
+    else if (0 == _stricmp(lCmd, "Stop" )) { aCmd->Next(); lResult = Cmd_Session_Stop (aCmd); }
+
+    return lResult;
+}
+
+int Tool::Cmd_Session_Start(CLI::CommandLine* aCmd)
+{
+    assert(nullptr != aCmd);
+
+    unsigned int lSize_byte = Receiver::SIZE_DEFAULT_byte;
+
+    if (!aCmd->IsAtEnd())
+    {
+        lSize_byte = Convert::ToUInt32(aCmd->GetCurrent()); aCmd->Next();
+
+        KMS_EXCEPTION_ASSERT(aCmd->IsAtEnd(), RESULT_INVALID_COMMAND, "Too many command arguments", aCmd->GetCurrent());
+    }
+
+    CaptureWriter* lCapture = nullptr;
+
+    if (nullptr != mSessionFile.Get())
+    {
+        if (!mSessionWriter.IsOpen())
+        {
+            mSessionWriter.Open(mSessionFile);
+        }
+
+        lCapture = &mSessionWriter;
+    }
+
+    // The bytes Expect did not use are no longer the next bytes of the
+    // port once the loop drains it.
+    if (nullptr != mChannel)
+    {
+        mUnreadSize_byte = 0;
+    }
+
+    mSession.Start(lSize_byte, lCapture);
+
+    return 0;
+}
+
+int Tool::Cmd_Session_Stop(CLI::CommandLine* aCmd)
+{
+    assert(nullptr != aCmd);
+
+    KMS_EXCEPTION_ASSERT(aCmd->IsAtEnd(), RESULT_INVALID_COMMAND, "Too many command arguments", aCmd->GetCurrent());
+
+    mSession.Stop();
+
+    if (mSessionWriter.IsOpen())
+    {
+        mSessionWriter.Flush();
+    }
+
+    return 0;
+}
+
+int Tool::Cmd_SetDTR(CLI::CommandLine* aCmd)
+{
+    assert(nullptr != aCmd);
+
+    SelectPort(aCmd);
+
+    KMS_EXCEPTION_ASSERT(aCmd->IsAtEnd(), RESULT_INVALID_COMMAND, "Too many command arguments", aCmd->GetCurrent());
+
+    GetPort()->SetDTR(true);
+
+    return 0;
 }
 
 int Tool::Cmd_SetRTS(CLI::CommandLine* aCmd)
 {
     assert(nullptr != aCmd);
 
+    SelectPort(aCmd);
+
     KMS_EXCEPTION_ASSERT(aCmd->IsAtEnd(), RESULT_INVALID_COMMAND, "Too many command arguments", aCmd->GetCurrent());
 
-    mPort.SetRTS(true);
+    GetPort()->SetRTS(true);
 
     return 0;
 }
@@ -511,46 +2607,289 @@ int Tool::Cmd_Status(CLI::CommandLine* aCmd)
 {
     assert(nullptr != aCmd);
 
+    if (!aCmd->IsAtEnd())
+    {
+        auto lOp = aCmd->GetCurrent(); aCmd->Next();
+
+        if (0 == _stricmp(lOp, "JSON"))
+        {
+            KMS_EXCEPTION_ASSERT(aCmd->IsAtEnd(), RESULT_INVALID_COMMAND, "Too many command arguments", aCmd->GetCurrent());
+
+            mStats.Display_JSON(std::cout);
+
+            std::cout << std::endl;
+        }
+        else if (0 == _stricmp(lOp, "Log"))
+        {
+            KMS_EXCEPTION_ASSERT(!aCmd->IsAtEnd(), RESULT_INVALID_COMMAND, "Invalid command", "Status Log");
+
+            auto lFile = aCmd->GetCurrent(); aCmd->Next();
+
+            if (0 == _stricmp(lFile, "Stop"))
+            {
+                mStats.Log_Stop();
+            }
+            else
+            {
+                KMS_EXCEPTION_ASSERT(!aCmd->IsAtEnd(), RESULT_INVALID_COMMAND, "No period", lFile);
+
+                auto lPeriod_ms = Convert::ToUInt32(aCmd->GetCurrent()); aCmd->Next();
+
+                mStats.Log_Start(lFile, lPeriod_ms);
+            }
+        }
+        else if (0 == _stricmp(lOp, "Reset"))
+        {
+            mStats.Reset();
+        }
+        else
+        {
+            KMS_EXCEPTION(RESULT_INVALID_COMMAND, "Invalid command", lOp);
+        }
+
+        KMS_EXCEPTION_ASSERT(aCmd->IsAtEnd(), RESULT_INVALID_COMMAND, "Too many command arguments", aCmd->GetCurrent());
+
+        return 0;
+    }
+
+    std::cout << mPort << "\n";
+
+    mReceiver.DisplayStatus(std::cout);
+    mDeframer.DisplayStatus(std::cout);
+    mByteGaps .Display(std::cout, "Byte gaps ", false);
+    mFrameGaps.Display(std::cout, "Frame gaps", false);
+    mStats    .Display(std::cout);
+
+    if (mCaptureRoll.IsOpen())
+    {
+        mCaptureRoll.Display(std::cout);
+    }
+
+    if (mTrigger.IsArmed())
+    {
+        mTrigger.Display(std::cout);
+    }
+
+    if (0 < mSession.GetChannelCount())
+    {
+        mSession.DisplayStatus(std::cout);
+    }
+
+    std::cout << std::endl;
+
+    return 0;
+}
+
+int Tool::Cmd_Trigger(CLI::CommandLine* aCmd)
+{
+    assert(nullptr != aCmd);
+
+    int lResult = __LINE__;
+
+    auto lCmd = aCmd->GetCurrent();
+
+    if      (0 == _stricmp(lCmd, "Start")) { aCmd->Next(); lResult = Cmd_Trigger_Start(aCmd); }
+    else if (0 == _stricmp(lCmd, "Stop" )) { aCmd->Next(); lResult = Cmd_Trigger_Stop (aCmd); }
+
+    return lResult;
+}
+
+int Tool::Cmd_Trigger_Start(CLI::CommandLine* aCmd)
+{
+    assert(nullptr != aCmd);
+
+    auto lPrefix     =                   aCmd->GetCurrent() ; aCmd->Next();
+    auto lConditions = ToConditions     (aCmd->GetCurrent()); aCmd->Next();
+    auto lPre_ms     = Convert::ToUInt32(aCmd->GetCurrent()); aCmd->Next();
+    auto lPost_ms    = Convert::ToUInt32(aCmd->GetCurrent()); aCmd->Next();
+
+    unsigned int lSize_byte = Trigger::SIZE_DEFAULT_byte;
+
+    if (!aCmd->IsAtEnd())
+    {
+        auto lArg = aCmd->GetCurrent();
+
+        if ((0 != _stricmp(lArg, "ASCII")) && (0 != _stricmp(lArg, "Hex")))
+        {
+            lSize_byte = Convert::ToUInt32(lArg); aCmd->Next();
+        }
+    }
+
+    std::vector<uint8_t> lPattern;
+
+    if (!aCmd->IsAtEnd())
+    {
+        ToPattern(aCmd, &lPattern);
+    }
+
+    KMS_EXCEPTION_ASSERT(aCmd->IsAtEnd(), RESULT_INVALID_COMMAND, "Too many command arguments", aCmd->GetCurrent());
+
+    mTrigger.SetPattern(lPattern.data(), static_cast<unsigned int>(lPattern.size()));
+    mTrigger.Arm(lPrefix, lConditions, lPre_ms, lPost_ms, lSize_byte);
+
+    return 0;
+}
+
+int Tool::Cmd_Trigger_Stop(CLI::CommandLine* aCmd)
+{
+    assert(nullptr != aCmd);
+
     KMS_EXCEPTION_ASSERT(aCmd->IsAtEnd(), RESULT_INVALID_COMMAND, "Too many command arguments", aCmd->GetCurrent());
 
-    std::cout << mPort << std::endl;
+    mTrigger.Disarm();
 
     return 0;
 }
 
-void Tool::DisplayDumpWrite(const void* aIn, unsigned int aInSize_byte, unsigned int aFlags, const char* aOp)
+void Tool::DisplayDumpWrite(const void* aIn, unsigned int aInSize_byte, unsigned int aFlags, const char* aOp, uint64_t aTime_ns, uint8_t aDirection, uint8_t aCaptureFlags)
 {
     assert(nullptr != aIn);
     assert(nullptr != aOp);
 
-    char lNow[NAME_LENGTH];
+    // Write counts the sent data, so the Benchmark data does not count
+    if (CaptureFile::DIRECTION_RECEIVE == aDirection)
+    {
+        mStats.AddRecord(aTime_ns, aDirection, aCaptureFlags, aInSize_byte);
+    }
+
+    // The caller flushes mFormatter
+    if ((0 != (aFlags & FLAG_TIMESTAMP)) && (0 != (aFlags & (FLAG_DISPLAY | FLAG_DUMP))))
+    {
+        char lNow[NAME_LENGTH];
+
+        mTimeFormatter.Format(aTime_ns, lNow, sizeof(lNow));
 
-    CreateTimestamp(lNow, sizeof(lNow));
+        mFormatter.Write(aOp);
+        mFormatter.Write(" ", 1);
+        mFormatter.Write(lNow);
+        mFormatter.Write("\n", 1);
+    }
 
     if (0 != (aFlags & FLAG_DISPLAY))
     {
-        if (0 != (aFlags & FLAG_TIMESTAMP)) { std::cout << aOp << " " << lNow << "\n"; }
+        mFormatter.Display(aIn, aInSize_byte);
+    }
 
-        char lDisplay[LINE_LENGTH];
+    if (0 != (aFlags & FLAG_DUMP))
+    {
+        mFormatter.Dump(aIn, aInSize_byte);
+    }
 
-        Convert::ToDisplay(reinterpret_cast<const char*>(aIn), aInSize_byte, lDisplay, sizeof(lDisplay));
+    uint16_t lPort = (nullptr == mChannel) ? 0 : mChannel->mIndex;
 
-        std::cout << lDisplay << "\n";
+    if (0 != (aFlags & FLAG_WRITE))
+    {
+        // The segments replace DataFile
+        if (0 < strlen(mDataSegments))
+        {
+            if (!mCaptureRoll.IsOpen())
+            {
+                mCaptureRoll.Open(mDataSegments, static_cast<uint64_t>(mDataSegmentSize_MiB) * 1024 * 1024, mDataSegmentTime_s, static_cast<uint64_t>(mDataRetention_MiB) * 1024 * 1024);
+            }
+
+            mCaptureRoll.Write(aTime_ns, aDirection, aCaptureFlags, aIn, aInSize_byte, lPort);
+        }
+        else if (nullptr != mDataFile.Get())
+        {
+            if (!mCaptureWriter.IsOpen())
+            {
+                mCaptureWriter.Open(mDataFile);
+            }
+
+            mCaptureWriter.Write(mCaptureWriter.ToTime_ns(aTime_ns), aDirection, aCaptureFlags, aIn, aInSize_byte, lPort);
+        }
     }
 
-    if (0 != (aFlags & FLAG_DUMP))
+    // The trigger sees the data even without FLAG_WRITE
+    if (mTrigger.IsArmed())
+    {
+        mTrigger.Write(aTime_ns, aDirection, aCaptureFlags, aIn, aInSize_byte, lPort);
+    }
+}
+
+GapStats * Tool::GetGaps    () { return (nullptr == mChannel) ? &mByteGaps : &mChannel->mGaps; }
+Com::Port* Tool::GetPort    () { return (nullptr == mChannel) ? &mPort     : mChannel->mPort; }
+Receiver * Tool::GetReceiver() { return (nullptr == mChannel) ? &mReceiver : &mChannel->mReceiver; }
+
+unsigned int Tool::Read(void* aOut, unsigned int aOutSize_byte, unsigned int aFlags, uint64_t* aTime_ns)
+{
+    return Read(aOut, aOutSize_byte, aFlags, mCaptureTimeout_ms, aTime_ns);
+}
+
+unsigned int Tool::Read(void* aOut, unsigned int aOutSize_byte, unsigned int aFlags, unsigned int aTimeout_ms, uint64_t* aTime_ns)
+{
+    assert(nullptr != aTime_ns);
+
+    auto lOut = static_cast<uint8_t*>(aOut);
+
+    unsigned int lResult_byte = 0;
+
+    if (0 < mUnreadSize_byte)
+    {
+        lResult_byte = (aOutSize_byte < mUnreadSize_byte) ? aOutSize_byte : mUnreadSize_byte;
+
+        memcpy(lOut, mUnread, lResult_byte);
+
+        mUnreadSize_byte -= lResult_byte;
+
+        memmove(mUnread, mUnread + lResult_byte, mUnreadSize_byte);
+
+        *aTime_ns = mUnreadTime_ns;
+
+        if ((aOutSize_byte <= lResult_byte) || (0 == (aFlags & Com::Port::FLAG_READ_ALL)))
+        {
+            return lResult_byte;
+        }
+    }
+
+    uint64_t     lTime_ns;
+    unsigned int lSize_byte;
+
+    if (GetReceiver()->IsRunning())
+    {
+        lSize_byte = GetReceiver()->Read(lOut + lResult_byte, aOutSize_byte - lResult_byte, aFlags, aTimeout_ms, &lTime_ns);
+    }
+    else
     {
-        if ((0 != (aFlags & FLAG_TIMESTAMP)) && (0 == (aFlags & FLAG_DISPLAY))) { std::cout << aOp << " " << lNow << "\n"; }
+        lSize_byte = GetPort()->Read(lOut + lResult_byte, aOutSize_byte - lResult_byte, aFlags);
+
+        lTime_ns = Clock_GetTime_ns();
+
+        if (0 < lSize_byte)
+        {
+            GetGaps()->Add(lTime_ns);
+        }
+    }
 
-        Dump(stdout, aIn, aInSize_byte);
+    if (0 == lResult_byte)
+    {
+        *aTime_ns = lTime_ns;
     }
 
-    if ((0 != (aFlags & FLAG_WRITE)) && (nullptr != mDataFile.Get()))
+    lResult_byte += lSize_byte;
+
+    if ((0 == lResult_byte) || ((0 != (aFlags & Com::Port::FLAG_READ_ALL)) && (aOutSize_byte > lResult_byte)))
     {
-        fprintf(mDataFile, "%s %s\n", aOp, lNow);
+        mStats.AddTimeout();
+        mTrigger.Tick(Clock_GetTime_ns());
+    }
+
+    return lResult_byte;
+}
+
+const uint8_t* Tool::Read_Begin(unsigned int* aSize_byte, unsigned int aTimeout_ms, uint64_t* aTime_ns)
+{
+    assert(nullptr != aSize_byte);
 
-        Dump(mDataFile, aIn, aInSize_byte);
+    auto lResult = GetReceiver()->Read_Begin(aSize_byte, aTimeout_ms, aTime_ns);
+
+    if (0 == *aSize_byte)
+    {
+        mStats.AddTimeout();
+        mTrigger.Tick(Clock_GetTime_ns());
     }
+
+    return lResult;
 }
 
 void Tool::ReceiveAndVerify_Hex(const char* aIn, unsigned int aFlags)
@@ -562,74 +2901,157 @@ void Tool::ReceiveAndVerify_Hex(const char* aIn, unsigned int aFlags)
     ReceiveAndVerify(lData, lSize_byte, aFlags);
 }
 
-void Tool::Send_Hex(const char* aIn, unsigned int aFlags)
+void Tool::SelectPort(CLI::CommandLine* aCmd)
 {
-    uint8_t lData[LINE_LENGTH];
+    assert(nullptr != aCmd);
 
-    auto lSize_byte = Convert::ToUInt8Array(aIn, " ", "", lData, sizeof(lData));
+    Session::Channel* lChannel = nullptr;
 
-    Send(lData, lSize_byte, aFlags);
-}
+    if (!aCmd->IsAtEnd())
+    {
+        lChannel = mSession.FindChannel(aCmd->GetCurrent());
+        if (nullptr != lChannel)
+        {
+            aCmd->Next();
+        }
+    }
 
-// Static functions
-// //////////////////////////////////////////////////////////////////////////
+    if (mChannel != lChannel)
+    {
+        mChannel = lChannel;
+
+        mDeframer.Reset();
 
-void CreateTimestamp(char* aOut, unsigned int aOutSize_byte)
+        mUnreadSize_byte = 0;
+    }
+}
+
+void Tool::Send_Hex(const char* aIn, unsigned int aFlags)
 {
-    assert(nullptr != aOut);
+    assert(nullptr != aIn);
 
-    SYSTEMTIME lTime;
+    // At most one byte per pair of characters
+    std::vector<uint8_t> lData(strlen(aIn) / 2 + 1);
 
-    GetLocalTime(&lTime);
+    auto lSize_byte = Convert::ToUInt8Array(aIn, " ", "", lData.data(), static_cast<unsigned int>(lData.size()));
 
-    sprintf_s(aOut SizeInfoV(aOutSize_byte), "%u-%u-%u %u:%u:%u.%03u",
-        lTime.wYear, lTime.wMonth, lTime.wDay, lTime.wHour, lTime.wMinute, lTime.wSecond, lTime.wMilliseconds);
+    Send(lData.data(), lSize_byte, aFlags);
 }
 
-void Dump(FILE* aOut, const void* aIn, unsigned int aInSize_byte)
+void Tool::Write(const void* aIn, unsigned int aInSize_byte, uint64_t* aTime_ns)
 {
-    assert(nullptr != aOut);
-    assert(nullptr != aIn);
+    assert(nullptr != aTime_ns);
 
-    auto lIn = static_cast<const uint8_t*>(aIn);
+    if (nullptr == mChannel)
+    {
+        *aTime_ns = Clock_GetTime_ns();
 
-    for (unsigned int i = 0; i < aInSize_byte; i++)
+        mPort.Write(aIn, aInSize_byte);
+    }
+    else
     {
-        fprintf(aOut, " %02x", lIn[i]);
+        mSession.Write(mChannel, aIn, aInSize_byte, aTime_ns);
     }
 
-    fprintf(aOut, "\n");
+    mStats.AddRecord(*aTime_ns, CaptureFile::DIRECTION_SEND, 0, aInSize_byte);
 }
 
-unsigned int ToFrameT(const void* aIn, unsigned int aInSize_byte, void* aOut, unsigned int aOutSize_byte)
+const uint8_t* Tool::Write(const Segment* aSegments, unsigned int aCount, unsigned int* aSize_byte, uint64_t* aTime_ns)
 {
-    assert(nullptr != aIn);
-    assert(nullptr != aOut);
+    assert(nullptr != aSegments);
+    assert(0 < aCount);
+    assert(nullptr != aSize_byte);
 
-    KMS_EXCEPTION_ASSERT(aInSize_byte + 4 <= aOutSize_byte, RESULT_OUTPUT_TOO_SHORT, "The output buffer is too short", aInSize_byte);
+    const uint8_t* lResult;
 
-    auto lOut = reinterpret_cast<uint8_t*>(aOut);
-    unsigned int lResult_byte = 0;
+    if (1 == aCount)
+    {
+        lResult     = static_cast<const uint8_t*>(aSegments[0].mData);
+        *aSize_byte = aSegments[0].mSize_byte;
+    }
+    else
+    {
+        unsigned int lSize_byte = 0;
 
-    lOut[lResult_byte] = 0x7e; lResult_byte++;
-    memcpy(lOut + lResult_byte, aIn, aInSize_byte); lResult_byte += aInSize_byte;
+        for (unsigned int i = 0; i < aCount; i++)
+        {
+            lSize_byte += aSegments[i].mSize_byte;
+        }
 
-    uint16_t lCRC = 0xffff;
+        // The buffer keeps its size from one write to the next
+        if (mGather.size() < lSize_byte)
+        {
+            mGather.resize(lSize_byte);
+        }
 
-    for (unsigned int i = 0; i < lResult_byte; i++)
-    {
-        uint8_t lByte = lOut[i];
+        unsigned int lOffset_byte = 0;
+
+        for (unsigned int i = 0; i < aCount; i++)
+        {
+            memcpy(mGather.data() + lOffset_byte, aSegments[i].mData, aSegments[i].mSize_byte);
 
-        lByte ^= lCRC;
-        lByte ^= lByte << 4;
+            lOffset_byte += aSegments[i].mSize_byte;
+        }
 
-        lCRC = ((lByte << 8) | (0xff & (lCRC >> 8))) ^ (lByte >> 4) ^ (lByte << 3);
+        lResult     = mGather.data();
+        *aSize_byte = lSize_byte;
     }
 
-    memcpy(lOut + lResult_byte, &lCRC, sizeof(lCRC)); lResult_byte += sizeof(lCRC);
-    lOut[lResult_byte] = 0x7f; lResult_byte++;
+    Write(lResult, *aSize_byte, aTime_ns);
 
-    return lResult_byte;
+    return lResult;
+}
+
+// Static functions
+// //////////////////////////////////////////////////////////////////////////
+
+void ApplySetting(Com::Port* aPort, uint32_t aSpeed_bps, Com::Parity aParity)
+{
+    assert(nullptr != aPort);
+
+    aPort->Disconnect();
+
+    aPort->mParity = aParity;
+    aPort->mSpeed  = aSpeed_bps;
+
+    if (!aPort->Connect())
+    {
+        KMS_EXCEPTION(RESULT_CONNECT_FAILED, "Connexion failed", aSpeed_bps);
+    }
+}
+
+DI::Object* CreatePort()
+{
+    auto lResult = new Com::Port();
+
+    lResult->SetConnectFlags(Dev::Device::FLAG_ACCESS_READ | Dev::Device::FLAG_ACCESS_WRITE);
+
+    return lResult;
+}
+
+const char* GetOpName(const CaptureFile::RecordHeader& aHeader)
+{
+    if (CaptureFile::DIRECTION_SEND == aHeader.mDirection) { return "Send"; }
+
+    if (0 != (aHeader.mFlags & CaptureFile::FLAG_VERIFY_FAILED)) { return "Receive and verify FAILED"; }
+    if (0 != (aHeader.mFlags & CaptureFile::FLAG_VERIFY_PASSED)) { return "Receive and verify PASSED"; }
+    if (0 != (aHeader.mFlags & CaptureFile::FLAG_FRAME        )) { return "Receive frame"; }
+    if (0 != (aHeader.mFlags & CaptureFile::FLAG_FRAME_ERROR  )) { return "Receive frame CRC ERROR"; }
+    if (0 != (aHeader.mFlags & CaptureFile::FLAG_MESSAGE      )) { return "Receive message"; }
+    if (0 != (aHeader.mFlags & CaptureFile::FLAG_MESSAGE_ERROR)) { return "Receive message INCOMPLETE"; }
+
+    return "Receive";
+}
+
+unsigned int ToConditions(const char* aIn)
+{
+    unsigned int lResult = 0;
+
+    if (NULL != strstr(aIn, "CRC_ERROR"    )) { lResult |= Trigger::CONDITION_CRC_ERROR; }
+    if (NULL != strstr(aIn, "PATTERN"      )) { lResult |= Trigger::CONDITION_PATTERN; }
+    if (NULL != strstr(aIn, "VERIFY_FAILED")) { lResult |= Trigger::CONDITION_VERIFY_FAILED; }
+
+    return lResult;
 }
 
 unsigned int ToFlags(const char* aIn)
@@ -645,3 +3067,31 @@ unsigned int ToFlags(const char* aIn)
 
     return lResult;
 }
+
+void ToPattern(CLI::CommandLine* aCmd, std::vector<uint8_t>* aOut)
+{
+    assert(nullptr != aCmd);
+    assert(nullptr != aOut);
+
+    auto lType = aCmd->GetCurrent(); aCmd->Next();
+
+    KMS_EXCEPTION_ASSERT(!aCmd->IsAtEnd(), RESULT_INVALID_COMMAND, "No pattern", "");
+
+    auto lData = aCmd->GetCurrent(); aCmd->Next();
+
+    if (0 == _stricmp(lType, "ASCII"))
+    {
+        aOut->assign(lData, lData + strlen(lData));
+    }
+    else if (0 == _stricmp(lType, "Hex"))
+    {
+        aOut->resize(strlen(lData) / 2 + 1);
+        aOut->resize(Hex_ToBytes(lData, aOut->data(), static_cast<unsigned int>(aOut->size())));
+    }
+    else
+    {
+        KMS_EXCEPTION(RESULT_INVALID_COMMAND, "Invalid command", lType);
+    }
+
+    KMS_EXCEPTION_ASSERT(!aOut->empty(), RESULT_INVALID_COMMAND, "Empty pattern", lData);
+}
@@ -0,0 +1,13 @@
+// Author    KMS - Martin Dubois, P. Eng.
+// Copyright (C) 2024 KMS
+// License   http://www.apache.org/licenses/LICENSE-2.0
+// Product   KMS-Tools
+// File      ComTool/Component.h
+
+#pragma once
+
+#include <KMS/Base.h>
+
+// ===== C++ ================================================================
+#include <atomic>
+#include <thread>
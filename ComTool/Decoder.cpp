@@ -0,0 +1,83 @@
+// Author    KMS - Martin Dubois, P. Eng.
+// Copyright (C) 2024 KMS
+// License   http://www.apache.org/licenses/LICENSE-2.0
+// Product   KMS-Tools
+// File      ComTool/Decoder.cpp
+
+#include "Component.h"
+
+// ===== Local ==============================================================
+#include "Decoder_COBS.h"
+#include "Decoder_FrameT.h"
+#include "Decoder_ModbusRTU.h"
+#include "Decoder_NMEA.h"
+#include "Decoder_SLIP.h"
+#include "IDecoderListener.h"
+
+#include "Decoder.h"
+
+using namespace KMS;
+
+// Constants
+// //////////////////////////////////////////////////////////////////////////
+
+const char* Decoder::NAMES = "COBS|FRAME_T|ModbusRTU|NMEA|SLIP";
+
+// Public
+// //////////////////////////////////////////////////////////////////////////
+
+Decoder* Decoder::Create(const char* aName, IDecoderListener* aListener)
+{
+    assert(nullptr != aName);
+
+    if (0 == _stricmp(aName, "COBS"     )) { return new Decoder_COBS     (aListener); }
+    if (0 == _stricmp(aName, "FRAME_T"  )) { return new Decoder_FrameT   (aListener); }
+    if (0 == _stricmp(aName, "ModbusRTU")) { return new Decoder_ModbusRTU(aListener); }
+    if (0 == _stricmp(aName, "NMEA"     )) { return new Decoder_NMEA     (aListener); }
+    if (0 == _stricmp(aName, "SLIP"     )) { return new Decoder_SLIP     (aListener); }
+
+    KMS_EXCEPTION(RESULT_INVALID_VALUE, "Unknown decoder", aName);
+}
+
+Decoder::~Decoder() {}
+
+const char* Decoder::GetName() const { return mName; }
+
+void Decoder::Reset()
+{
+    mDiscarded_byte = 0;
+    mErrorCount     = 0;
+    mFrameCount     = 0;
+}
+
+void Decoder::DisplayStatus(std::ostream& aOut) const
+{
+    aOut << mName << " frames : " << mFrameCount     << "\n";
+    aOut << "    Errors    : "    << mErrorCount     << "\n";
+    aOut << "    Discarded : "    << mDiscarded_byte << " bytes\n";
+}
+
+// Protected
+// //////////////////////////////////////////////////////////////////////////
+
+Decoder::Decoder(const char* aName, IDecoderListener* aListener) : mListener(aListener), mName(aName)
+{
+    assert(nullptr != aName);
+    assert(nullptr != aListener);
+
+    Decoder::Reset();
+}
+
+void Decoder::OnError(const uint8_t* aIn, unsigned int aInSize_byte, const char* aReason)
+{
+    mErrorCount++;
+
+    mListener->OnDecodeError(aIn, aInSize_byte, aReason);
+}
+
+void Decoder::OnFrame(const uint8_t* aIn, unsigned int aInSize_byte, const char* aInfo)
+{
+    mFrameCount++;
+
+    mListener->OnDecoded(aIn, aInSize_byte, aInfo);
+}
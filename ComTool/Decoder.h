@@ -0,0 +1,58 @@
+// Author    KMS - Martin Dubois, P. Eng.
+// Copyright (C) 2024 KMS
+// License   http://www.apache.org/licenses/LICENSE-2.0
+// Product   KMS-Tools
+// File      ComTool/Decoder.h
+
+#pragma once
+
+// ===== Local ==============================================================
+class IDecoderListener;
+
+// Incremental stream protocol decoder. Push receives the data as read, in
+// chunks of any size, and the decoder reports each frame to the listener.
+// The decoders work directly on the pushed data and copy only the bytes
+// they must transform or the frames spread over many chunks.
+class Decoder
+{
+
+public:
+
+    // The names Create accepts, separated by |
+    static const char* NAMES;
+
+    // aName   COBS, FRAME_T, ModbusRTU, NMEA or SLIP (case insensitive)
+    // Return  A new decoder the caller must delete
+    static Decoder* Create(const char* aName, IDecoderListener* aListener);
+
+    virtual ~Decoder();
+
+    const char* GetName() const;
+
+    // Drop the partial frame and clear the counters
+    virtual void Reset();
+
+    virtual void Push(const uint8_t* aIn, unsigned int aInSize_byte) = 0;
+
+    void DisplayStatus(std::ostream& aOut) const;
+
+    uint64_t mDiscarded_byte;
+    uint64_t mErrorCount;
+    uint64_t mFrameCount;
+
+protected:
+
+    Decoder(const char* aName, IDecoderListener* aListener);
+
+    void OnError(const uint8_t* aIn, unsigned int aInSize_byte, const char* aReason);
+
+    void OnFrame(const uint8_t* aIn, unsigned int aInSize_byte, const char* aInfo);
+
+private:
+
+    NO_COPY(Decoder);
+
+    IDecoderListener* mListener;
+    const char*       mName;
+
+};
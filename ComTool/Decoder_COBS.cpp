@@ -0,0 +1,143 @@
+// Author    KMS - Martin Dubois, P. Eng.
+// Copyright (C) 2024 KMS
+// License   http://www.apache.org/licenses/LICENSE-2.0
+// Product   KMS-Tools
+// File      ComTool/Decoder_COBS.cpp
+
+#include "Component.h"
+
+// ===== Local ==============================================================
+#include "Decoder_COBS.h"
+
+// Constants
+// //////////////////////////////////////////////////////////////////////////
+
+#define BYTE_END (0x00)
+
+// Encoded size, one code byte each 254 bytes
+#define MAX_SIZE_byte (4096 + 4096 / 254 + 1)
+
+// Public
+// //////////////////////////////////////////////////////////////////////////
+
+Decoder_COBS::Decoder_COBS(IDecoderListener* aListener) : Decoder("COBS", aListener)
+{
+    mDecoded.reserve(MAX_SIZE_byte);
+    mEncoded.reserve(MAX_SIZE_byte);
+
+    Reset();
+}
+
+// ===== Decoder ============================================================
+
+void Decoder_COBS::Reset()
+{
+    Decoder::Reset();
+
+    mEncoded.clear();
+
+    mError = false;
+}
+
+void Decoder_COBS::Push(const uint8_t* aIn, unsigned int aInSize_byte)
+{
+    assert(nullptr != aIn);
+
+    auto lIn  = aIn;
+    auto lEnd = aIn + aInSize_byte;
+
+    while (lIn < lEnd)
+    {
+        auto lFound = static_cast<const uint8_t*>(memchr(lIn, BYTE_END, lEnd - lIn));
+
+        auto lSize_byte = static_cast<unsigned int>(((nullptr == lFound) ? lEnd : lFound) - lIn);
+
+        if (mError)
+        {
+            mDiscarded_byte += lSize_byte;
+        }
+        else if (MAX_SIZE_byte < mEncoded.size() + lSize_byte)
+        {
+            mEncoded.insert(mEncoded.end(), lIn, lIn + (MAX_SIZE_byte - mEncoded.size()));
+
+            OnError(mEncoded.data(), static_cast<unsigned int>(mEncoded.size()), "Frame too long");
+
+            mDiscarded_byte += mEncoded.size() + lSize_byte - MAX_SIZE_byte;
+
+            mEncoded.clear();
+
+            mError = true;
+        }
+        else if ((nullptr != lFound) && mEncoded.empty())
+        {
+            Decode(lIn, lSize_byte);
+        }
+        else
+        {
+            mEncoded.insert(mEncoded.end(), lIn, lIn + lSize_byte);
+
+            if (nullptr != lFound)
+            {
+                Decode(mEncoded.data(), static_cast<unsigned int>(mEncoded.size()));
+
+                mEncoded.clear();
+            }
+        }
+
+        if (nullptr == lFound)
+        {
+            break;
+        }
+
+        mError = false;
+
+        lIn = lFound + 1;
+    }
+}
+
+// Private
+// //////////////////////////////////////////////////////////////////////////
+
+void Decoder_COBS::Decode(const uint8_t* aIn, unsigned int aInSize_byte)
+{
+    assert(nullptr != aIn);
+
+    // Empty frames only flush the line
+    if (0 == aInSize_byte)
+    {
+        return;
+    }
+
+    mDecoded.clear();
+
+    unsigned int i = 0;
+
+    while (aInSize_byte > i)
+    {
+        unsigned int lCode = aIn[i];
+        i++;
+
+        if (aInSize_byte < i + lCode - 1)
+        {
+            OnError(aIn, aInSize_byte, "Truncated block");
+            return;
+        }
+
+        mDecoded.insert(mDecoded.end(), aIn + i, aIn + i + lCode - 1);
+
+        i += lCode - 1;
+
+        // A full block (0xff) is not followed by a 0x00, nor is the last
+        // block.
+        if ((0xff > lCode) && (aInSize_byte > i))
+        {
+            mDecoded.push_back(0x00);
+        }
+    }
+
+    char lInfo[NAME_LENGTH];
+
+    sprintf_s(lInfo SizeInfo(lInfo), "COBS, %u bytes", static_cast<unsigned int>(mDecoded.size()));
+
+    OnFrame(mDecoded.data(), static_cast<unsigned int>(mDecoded.size()), lInfo);
+}
@@ -0,0 +1,42 @@
+// Author    KMS - Martin Dubois, P. Eng.
+// Copyright (C) 2024 KMS
+// License   http://www.apache.org/licenses/LICENSE-2.0
+// Product   KMS-Tools
+// File      ComTool/Decoder_COBS.h
+
+#pragma once
+
+// ===== C++ ================================================================
+#include <vector>
+
+// ===== Local ==============================================================
+#include "Decoder.h"
+
+// Consistent Overhead Byte Stuffing, 0x00 ends the frames. A frame
+// completely inside the pushed data is decoded from it, the others are
+// first collected.
+class Decoder_COBS final : public Decoder
+{
+
+public:
+
+    Decoder_COBS(IDecoderListener* aListener);
+
+    // ===== Decoder ================================================
+    virtual void Reset();
+    virtual void Push(const uint8_t* aIn, unsigned int aInSize_byte);
+
+private:
+
+    // aIn  The encoded frame, without the 0x00
+    void Decode(const uint8_t* aIn, unsigned int aInSize_byte);
+
+    std::vector<uint8_t> mDecoded;
+
+    // Encoded bytes received before the pushed data
+    std::vector<uint8_t> mEncoded;
+
+    // The frame was too long, discard until the next 0x00
+    bool mError;
+
+};
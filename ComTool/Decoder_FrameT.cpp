@@ -0,0 +1,47 @@
+// Author    KMS - Martin Dubois, P. Eng.
+// Copyright (C) 2024 KMS
+// License   http://www.apache.org/licenses/LICENSE-2.0
+// Product   KMS-Tools
+// File      ComTool/Decoder_FrameT.cpp
+
+#include "Component.h"
+
+// ===== Local ==============================================================
+#include "Decoder_FrameT.h"
+
+// Public
+// //////////////////////////////////////////////////////////////////////////
+
+Decoder_FrameT::Decoder_FrameT(IDecoderListener* aListener) : Decoder("FRAME_T", aListener), mDeframer(this) {}
+
+// ===== Decoder ============================================================
+
+void Decoder_FrameT::Reset()
+{
+    Decoder::Reset();
+
+    mDeframer.Reset();
+}
+
+void Decoder_FrameT::Push(const uint8_t* aIn, unsigned int aInSize_byte)
+{
+    mDeframer.Push(aIn, aInSize_byte);
+
+    mDiscarded_byte = mDeframer.mDiscarded_byte;
+}
+
+// ===== IFrameListener =====================================================
+
+void Decoder_FrameT::OnFrame(const uint8_t* aIn, unsigned int aInSize_byte)
+{
+    char lInfo[NAME_LENGTH];
+
+    sprintf_s(lInfo SizeInfo(lInfo), "FRAME_T, %u bytes", aInSize_byte);
+
+    Decoder::OnFrame(aIn, aInSize_byte, lInfo);
+}
+
+void Decoder_FrameT::OnFrameError(const uint8_t* aIn, unsigned int aInSize_byte)
+{
+    OnError(aIn, aInSize_byte, "CRC error");
+}
@@ -0,0 +1,34 @@
+// Author    KMS - Martin Dubois, P. Eng.
+// Copyright (C) 2024 KMS
+// License   http://www.apache.org/licenses/LICENSE-2.0
+// Product   KMS-Tools
+// File      ComTool/Decoder_FrameT.h
+
+#pragma once
+
+// ===== Local ==============================================================
+#include "Decoder.h"
+#include "Deframer.h"
+#include "IFrameListener.h"
+
+// FRAME_T through the Deframer ReceiveFrames uses
+class Decoder_FrameT final : public Decoder, public IFrameListener
+{
+
+public:
+
+    Decoder_FrameT(IDecoderListener* aListener);
+
+    // ===== Decoder ================================================
+    virtual void Reset();
+    virtual void Push(const uint8_t* aIn, unsigned int aInSize_byte);
+
+    // ===== IFrameListener =========================================
+    virtual void OnFrame     (const uint8_t* aIn, unsigned int aInSize_byte);
+    virtual void OnFrameError(const uint8_t* aIn, unsigned int aInSize_byte);
+
+private:
+
+    Deframer mDeframer;
+
+};
@@ -0,0 +1,300 @@
+// Author    KMS - Martin Dubois, P. Eng.
+// Copyright (C) 2024 KMS
+// License   http://www.apache.org/licenses/LICENSE-2.0
+// Product   KMS-Tools
+// File      ComTool/Decoder_ModbusRTU.cpp
+
+#include "Component.h"
+
+// ===== Local ==============================================================
+#include "CRC16.h"
+
+#include "Decoder_ModbusRTU.h"
+
+// Constants
+// //////////////////////////////////////////////////////////////////////////
+
+// The largest size GetSizes returns, function 0x17 with 255 data bytes
+#define FRAME_MAX_byte (13 + 255)
+
+#define MAX_UNIT (247)
+
+// Static function declarations
+// //////////////////////////////////////////////////////////////////////////
+
+static const char* GetExceptionName(uint8_t aCode);
+
+static const char* GetFunctionName(uint8_t aFunction);
+
+// Public
+// //////////////////////////////////////////////////////////////////////////
+
+Decoder_ModbusRTU::Decoder_ModbusRTU(IDecoderListener* aListener) : Decoder("ModbusRTU", aListener)
+{
+    Reset();
+}
+
+// ===== Decoder ============================================================
+
+void Decoder_ModbusRTU::Reset()
+{
+    Decoder::Reset();
+
+    mFrame.clear();
+
+    mResync = false;
+}
+
+void Decoder_ModbusRTU::Push(const uint8_t* aIn, unsigned int aInSize_byte)
+{
+    assert(nullptr != aIn);
+
+    unsigned int lIn_byte = 0;
+
+    if (!mFrame.empty())
+    {
+        // Only the frames starting in the tail of the previous chunk go
+        // through mFrame. Adding FRAME_MAX_byte bytes completes them.
+        auto lTail_byte = static_cast<unsigned int>(mFrame.size());
+
+        auto lCopy_byte = (FRAME_MAX_byte < aInSize_byte) ? FRAME_MAX_byte : aInSize_byte;
+
+        mFrame.insert(mFrame.end(), aIn, aIn + lCopy_byte);
+
+        auto lStart_byte = Scan(mFrame.data(), static_cast<unsigned int>(mFrame.size()), lTail_byte);
+        if (lTail_byte > lStart_byte)
+        {
+            assert(aInSize_byte == lCopy_byte);
+
+            mFrame.erase(mFrame.begin(), mFrame.begin() + lStart_byte);
+            return;
+        }
+
+        mFrame.clear();
+
+        lIn_byte = lStart_byte - lTail_byte;
+    }
+
+    // The frames of the chunk are decoded where they are
+    lIn_byte += Scan(aIn + lIn_byte, aInSize_byte - lIn_byte, aInSize_byte - lIn_byte);
+
+    mFrame.assign(aIn + lIn_byte, aIn + aInSize_byte);
+}
+
+// Private
+// //////////////////////////////////////////////////////////////////////////
+
+void Decoder_ModbusRTU::Frame_Found(const uint8_t* aIn, unsigned int aInSize_byte)
+{
+    assert(nullptr != aIn);
+    assert(4 <= aInSize_byte);
+
+    auto lSize_byte = aInSize_byte - 2;
+
+    uint8_t lFunction = aIn[1];
+
+    char lInfo[LINE_LENGTH];
+
+    if (0 != (lFunction & 0x80))
+    {
+        sprintf_s(lInfo SizeInfo(lInfo), "Modbus unit %u, function 0x%02x exception %u %s", aIn[0], lFunction, aIn[2], GetExceptionName(aIn[2]));
+    }
+    else
+    {
+        sprintf_s(lInfo SizeInfo(lInfo), "Modbus unit %u, function 0x%02x %s, %u bytes", aIn[0], lFunction, GetFunctionName(lFunction), lSize_byte);
+    }
+
+    OnFrame(aIn, lSize_byte, lInfo);
+}
+
+// The request and the response of most functions have different sizes.
+// Some sizes come from a byte count, when it is not received yet, aWait is
+// set.
+unsigned int Decoder_ModbusRTU::GetSizes(const uint8_t* aIn, unsigned int aInSize_byte, unsigned int* aSizes, bool* aWait) const
+{
+    assert(nullptr != aIn);
+    assert(2 <= aInSize_byte);
+    assert(nullptr != aSizes);
+    assert(nullptr != aWait);
+
+    *aWait = false;
+
+    if (MAX_UNIT < aIn[0])
+    {
+        return 0;
+    }
+
+    auto lCount = [&](unsigned int aIndex, unsigned int aOverhead_byte) -> unsigned int
+    {
+        if (aInSize_byte <= aIndex)
+        {
+            *aWait = true;
+            return UINT32_MAX;
+        }
+
+        return aOverhead_byte + aIn[aIndex];
+    };
+
+    unsigned int lResult = 2;
+
+    switch (aIn[1])
+    {
+    case 0x01:
+    case 0x02:
+    case 0x03:
+    case 0x04: aSizes[0] = lCount(2, 5); aSizes[1] = 8; break;
+
+    case 0x05:
+    case 0x06:
+    case 0x08: aSizes[0] = 8; lResult = 1; break;
+
+    case 0x07: aSizes[0] = 4; aSizes[1] = 5; break;
+    case 0x0b: aSizes[0] = 4; aSizes[1] = 8; break;
+
+    case 0x0c:
+    case 0x11: aSizes[0] = 4; aSizes[1] = lCount(2, 5); break;
+
+    case 0x0f:
+    case 0x10: aSizes[0] = 8; aSizes[1] = lCount(6, 9); break;
+
+    case 0x16: aSizes[0] = 10; lResult = 1; break;
+
+    case 0x17: aSizes[0] = lCount(2, 5); aSizes[1] = lCount(10, 13); break;
+
+    default:
+        if ((0 == (aIn[1] & 0x80)) || (0 == (aIn[1] & 0x7f)))
+        {
+            return 0;
+        }
+
+        aSizes[0] = 5; lResult = 1;
+    }
+
+    // A size waiting for its byte count is larger than the received data,
+    // so the sizes stay in increasing order.
+    if ((2 == lResult) && (aSizes[0] > aSizes[1]))
+    {
+        std::swap(aSizes[0], aSizes[1]);
+    }
+
+    return lResult;
+}
+
+unsigned int Decoder_ModbusRTU::Scan(const uint8_t* aIn, unsigned int aInSize_byte, unsigned int aStartEnd_byte)
+{
+    assert(nullptr != aIn);
+    assert(aInSize_byte >= aStartEnd_byte);
+
+    unsigned int lStart_byte = 0;
+
+    while (aStartEnd_byte > lStart_byte)
+    {
+        auto lData      = aIn + lStart_byte;
+        auto lSize_byte = aInSize_byte - lStart_byte;
+
+        if (2 > lSize_byte)
+        {
+            break;
+        }
+
+        unsigned int lSizes[2];
+        bool         lWait;
+
+        auto lCount = GetSizes(lData, lSize_byte, lSizes, &lWait);
+
+        unsigned int lChecked_byte = 0;
+        unsigned int lFound_byte   = 0;
+
+        for (unsigned int i = 0; i < lCount; i++)
+        {
+            auto lFrame_byte = lSizes[i];
+
+            if (lSize_byte < lFrame_byte)
+            {
+                lWait = true;
+                break;
+            }
+
+            uint16_t lCRC = lData[lFrame_byte - 2] | (lData[lFrame_byte - 1] << 8);
+
+            if (CRC16_Modbus_Compute(CRC16_MODBUS_INIT, lData, lFrame_byte - 2) == lCRC)
+            {
+                lFound_byte = lFrame_byte;
+                break;
+            }
+
+            lChecked_byte = lFrame_byte;
+        }
+
+        if (0 < lFound_byte)
+        {
+            mResync = false;
+
+            Frame_Found(lData, lFound_byte);
+
+            lStart_byte += lFound_byte;
+            continue;
+        }
+
+        if (lWait)
+        {
+            break;
+        }
+
+        // The following drops, until the next good frame, come from the
+        // same error. They only count as discarded bytes.
+        if (mResync || (0 == lChecked_byte))
+        {
+            mDiscarded_byte++;
+        }
+        else
+        {
+            OnError(lData, lChecked_byte, "CRC error");
+        }
+
+        mResync = true;
+
+        lStart_byte++;
+    }
+
+    return lStart_byte;
+}
+
+// Static functions
+// //////////////////////////////////////////////////////////////////////////
+
+const char* GetExceptionName(uint8_t aCode)
+{
+    switch (aCode)
+    {
+    case 0x01: return "Illegal function";
+    case 0x02: return "Illegal data address";
+    case 0x03: return "Illegal data value";
+    case 0x04: return "Server device failure";
+    case 0x05: return "Acknowledge";
+    case 0x06: return "Server device busy";
+    case 0x08: return "Memory parity error";
+    case 0x0a: return "Gateway path unavailable";
+    case 0x0b: return "Gateway target failed to respond";
+    }
+
+    return "";
+}
+
+const char* GetFunctionName(uint8_t aFunction)
+{
+    switch (aFunction)
+    {
+    case 0x01: return "Read coils";
+    case 0x02: return "Read discrete inputs";
+    case 0x03: return "Read holding registers";
+    case 0x04: return "Read input registers";
+    case 0x05: return "Write single coil";
+    case 0x06: return "Write single register";
+    case 0x0f: return "Write multiple coils";
+    case 0x10: return "Write multiple registers";
+    case 0x17: return "Read/write multiple registers";
+    }
+
+    return "";
+}
@@ -0,0 +1,54 @@
+// Author    KMS - Martin Dubois, P. Eng.
+// Copyright (C) 2024 KMS
+// License   http://www.apache.org/licenses/LICENSE-2.0
+// Product   KMS-Tools
+// File      ComTool/Decoder_ModbusRTU.h
+
+#pragma once
+
+// ===== C++ ================================================================
+#include <vector>
+
+// ===== Local ==============================================================
+#include "Decoder.h"
+
+// Modbus RTU frames (unit, function, data, CRC-16). The frames are found by
+// their CRC rather than by the silence between them, so the decoder works
+// on captured data without timing. The function code gives the possible
+// frame sizes, request or response, so only these CRC are verified. When
+// none matches, the first byte is dropped and the search restarts at the
+// next one. The known functions are 1 to 8, 11, 12, 15 to 17, 22, 23 and
+// the exceptions.
+class Decoder_ModbusRTU final : public Decoder
+{
+
+public:
+
+    Decoder_ModbusRTU(IDecoderListener* aListener);
+
+    // ===== Decoder ================================================
+    virtual void Reset();
+    virtual void Push(const uint8_t* aIn, unsigned int aInSize_byte);
+
+private:
+
+    // aIn  The frame, CRC included
+    void Frame_Found(const uint8_t* aIn, unsigned int aInSize_byte);
+
+    // aIn     The received bytes, starting at the frame
+    // aSizes  The possible frame sizes, in increasing order
+    // aWait   Set when more data is needed to know a size
+    // Return  The number of sizes, 0 when aIn cannot start a frame
+    unsigned int GetSizes(const uint8_t* aIn, unsigned int aInSize_byte, unsigned int* aSizes, bool* aWait) const;
+
+    // aStartEnd_byte  The frames starting at or after this offset are left
+    //                 to the caller
+    // Return          The offset of the first byte not decoded
+    unsigned int Scan(const uint8_t* aIn, unsigned int aInSize_byte, unsigned int aStartEnd_byte);
+
+    // The unfinished tail of the previous chunk
+    std::vector<uint8_t> mFrame;
+
+    bool mResync;
+
+};
@@ -0,0 +1,192 @@
+// Author    KMS - Martin Dubois, P. Eng.
+// Copyright (C) 2024 KMS
+// License   http://www.apache.org/licenses/LICENSE-2.0
+// Product   KMS-Tools
+// File      ComTool/Decoder_NMEA.cpp
+
+#include "Component.h"
+
+// ===== Local ==============================================================
+#include "Hex.h"
+
+#include "Decoder_NMEA.h"
+
+// Constants
+// //////////////////////////////////////////////////////////////////////////
+
+// NMEA 0183 limit, the line feed excluded
+#define MAX_SIZE_byte (81)
+
+// Public
+// //////////////////////////////////////////////////////////////////////////
+
+Decoder_NMEA::Decoder_NMEA(IDecoderListener* aListener) : Decoder("NMEA", aListener)
+{
+    mSentence.reserve(MAX_SIZE_byte);
+
+    Reset();
+}
+
+// ===== Decoder ============================================================
+
+void Decoder_NMEA::Reset()
+{
+    Decoder::Reset();
+
+    mSentence.clear();
+
+    mStarted = false;
+}
+
+void Decoder_NMEA::Push(const uint8_t* aIn, unsigned int aInSize_byte)
+{
+    assert(nullptr != aIn);
+
+    auto lIn  = aIn;
+    auto lEnd = aIn + aInSize_byte;
+
+    while (lIn < lEnd)
+    {
+        if (!mStarted)
+        {
+            auto lStart = lIn;
+
+            while ((lEnd > lStart) && ('$' != *lStart) && ('!' != *lStart))
+            {
+                lStart++;
+            }
+
+            mDiscarded_byte += lStart - lIn;
+
+            if (lEnd <= lStart)
+            {
+                break;
+            }
+
+            lIn      = lStart;
+            mStarted = true;
+        }
+
+        auto lFound = static_cast<const uint8_t*>(memchr(lIn, '\n', lEnd - lIn));
+
+        auto lSize_byte = static_cast<unsigned int>(((nullptr == lFound) ? lEnd : lFound) - lIn);
+
+        if (MAX_SIZE_byte < mSentence.size() + lSize_byte)
+        {
+            // When the sentence starts in this data, lIn points to its $
+            bool lFirst = mSentence.empty();
+
+            mSentence.insert(mSentence.end(), lIn, lIn + (MAX_SIZE_byte - mSentence.size()));
+
+            OnError(mSentence.data(), static_cast<unsigned int>(mSentence.size()), "Sentence too long");
+
+            // Search the next sentence after the rejected start
+            if (lFirst)
+            {
+                lIn++;
+            }
+
+            mSentence.clear();
+            mStarted = false;
+            continue;
+        }
+
+        if (nullptr == lFound)
+        {
+            mSentence.insert(mSentence.end(), lIn, lEnd);
+            break;
+        }
+
+        if (mSentence.empty())
+        {
+            Decode(lIn, lSize_byte);
+        }
+        else
+        {
+            mSentence.insert(mSentence.end(), lIn, lFound);
+
+            Decode(mSentence.data(), static_cast<unsigned int>(mSentence.size()));
+
+            mSentence.clear();
+        }
+
+        mStarted = false;
+
+        lIn = lFound + 1;
+    }
+}
+
+// Private
+// //////////////////////////////////////////////////////////////////////////
+
+void Decoder_NMEA::Decode(const uint8_t* aIn, unsigned int aInSize_byte)
+{
+    assert(nullptr != aIn);
+    assert(0 < aInSize_byte);
+
+    unsigned int lSize_byte = aInSize_byte;
+
+    if ('\r' == aIn[lSize_byte - 1])
+    {
+        lSize_byte--;
+    }
+
+    // ===== Checksum =======================================================
+    const char*  lChecksum = "no checksum";
+    unsigned int lData_byte = lSize_byte;
+    uint8_t      lSum       = 0;
+
+    for (unsigned int i = 1; i < lSize_byte; i++)
+    {
+        if ('*' == aIn[i])
+        {
+            lData_byte = i;
+            break;
+        }
+
+        lSum ^= aIn[i];
+    }
+
+    if (lSize_byte > lData_byte)
+    {
+        int lHigh = (lSize_byte > lData_byte + 2) ? Hex_ToDigit(static_cast<char>(aIn[lData_byte + 1])) : -1;
+        int lLow  = (lSize_byte > lData_byte + 2) ? Hex_ToDigit(static_cast<char>(aIn[lData_byte + 2])) : -1;
+
+        if ((0 > lHigh) || (0 > lLow) || (lSize_byte != lData_byte + 3))
+        {
+            OnError(aIn, lSize_byte, "Invalid checksum field");
+            return;
+        }
+
+        if (((lHigh << 4) | lLow) != lSum)
+        {
+            OnError(aIn, lSize_byte, "Checksum error");
+            return;
+        }
+
+        lChecksum = "checksum OK";
+    }
+
+    // ===== Address and fields =============================================
+    unsigned int lAddress_byte = 1;
+    unsigned int lFieldCount   = 0;
+
+    while ((lData_byte > lAddress_byte) && (',' != aIn[lAddress_byte]))
+    {
+        lAddress_byte++;
+    }
+
+    for (unsigned int i = lAddress_byte; i < lData_byte; i++)
+    {
+        if (',' == aIn[i])
+        {
+            lFieldCount++;
+        }
+    }
+
+    char lInfo[LINE_LENGTH];
+
+    sprintf_s(lInfo SizeInfo(lInfo), "NMEA %.*s, %u fields, %s", static_cast<int>(lAddress_byte - 1), reinterpret_cast<const char*>(aIn + 1), lFieldCount, lChecksum);
+
+    OnFrame(aIn, lSize_byte, lInfo);
+}
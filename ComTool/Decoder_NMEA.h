@@ -0,0 +1,38 @@
+// Author    KMS - Martin Dubois, P. Eng.
+// Copyright (C) 2024 KMS
+// License   http://www.apache.org/licenses/LICENSE-2.0
+// Product   KMS-Tools
+// File      ComTool/Decoder_NMEA.h
+
+#pragma once
+
+// ===== C++ ================================================================
+#include <vector>
+
+// ===== Local ==============================================================
+#include "Decoder.h"
+
+// NMEA 0183 sentences, from $ or ! to the line feed, checksum verified when
+// present. A sentence completely inside the pushed data is decoded from
+// it, the others are first collected.
+class Decoder_NMEA final : public Decoder
+{
+
+public:
+
+    Decoder_NMEA(IDecoderListener* aListener);
+
+    // ===== Decoder ================================================
+    virtual void Reset();
+    virtual void Push(const uint8_t* aIn, unsigned int aInSize_byte);
+
+private:
+
+    // aIn  The sentence, without the line feed
+    void Decode(const uint8_t* aIn, unsigned int aInSize_byte);
+
+    std::vector<uint8_t> mSentence;
+
+    bool mStarted;
+
+};
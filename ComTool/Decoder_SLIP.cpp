@@ -0,0 +1,126 @@
+// Author    KMS - Martin Dubois, P. Eng.
+// Copyright (C) 2024 KMS
+// License   http://www.apache.org/licenses/LICENSE-2.0
+// Product   KMS-Tools
+// File      ComTool/Decoder_SLIP.cpp
+
+#include "Component.h"
+
+// ===== Local ==============================================================
+#include "Decoder_SLIP.h"
+
+// Constants
+// //////////////////////////////////////////////////////////////////////////
+
+#define BYTE_END     (0xc0)
+#define BYTE_ESC     (0xdb)
+#define BYTE_ESC_END (0xdc)
+#define BYTE_ESC_ESC (0xdd)
+
+#define MAX_SIZE_byte (4096)
+
+// Public
+// //////////////////////////////////////////////////////////////////////////
+
+Decoder_SLIP::Decoder_SLIP(IDecoderListener* aListener) : Decoder("SLIP", aListener)
+{
+    mFrame.reserve(MAX_SIZE_byte);
+
+    Reset();
+}
+
+// ===== Decoder ============================================================
+
+void Decoder_SLIP::Reset()
+{
+    Decoder::Reset();
+
+    mFrame.clear();
+
+    mError  = false;
+    mEscape = false;
+}
+
+void Decoder_SLIP::Push(const uint8_t* aIn, unsigned int aInSize_byte)
+{
+    assert(nullptr != aIn);
+
+    for (unsigned int i = 0; i < aInSize_byte; i++)
+    {
+        auto lByte = aIn[i];
+
+        if (BYTE_END == lByte)
+        {
+            // Empty frames only flush the line
+            if ((!mError) && (!mFrame.empty()))
+            {
+                if (mEscape)
+                {
+                    Error("Escape before the end");
+                }
+                else
+                {
+                    char lInfo[NAME_LENGTH];
+
+                    sprintf_s(lInfo SizeInfo(lInfo), "SLIP, %u bytes", static_cast<unsigned int>(mFrame.size()));
+
+                    OnFrame(mFrame.data(), static_cast<unsigned int>(mFrame.size()), lInfo);
+                }
+            }
+
+            mFrame.clear();
+
+            mError  = false;
+            mEscape = false;
+            continue;
+        }
+
+        if (mError)
+        {
+            mDiscarded_byte++;
+            continue;
+        }
+
+        if (mEscape)
+        {
+            mEscape = false;
+
+            switch (lByte)
+            {
+            case BYTE_ESC_END: lByte = BYTE_END; break;
+            case BYTE_ESC_ESC: lByte = BYTE_ESC; break;
+
+            default:
+                mFrame.push_back(BYTE_ESC);
+                mFrame.push_back(lByte);
+                Error("Invalid escape sequence");
+                continue;
+            }
+        }
+        else if (BYTE_ESC == lByte)
+        {
+            mEscape = true;
+            continue;
+        }
+
+        if (MAX_SIZE_byte <= mFrame.size())
+        {
+            Error("Frame too long");
+            continue;
+        }
+
+        mFrame.push_back(lByte);
+    }
+}
+
+// Private
+// //////////////////////////////////////////////////////////////////////////
+
+void Decoder_SLIP::Error(const char* aReason)
+{
+    OnError(mFrame.data(), static_cast<unsigned int>(mFrame.size()), aReason);
+
+    mFrame.clear();
+
+    mError = true;
+}
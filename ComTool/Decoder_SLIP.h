@@ -0,0 +1,38 @@
+// Author    KMS - Martin Dubois, P. Eng.
+// Copyright (C) 2024 KMS
+// License   http://www.apache.org/licenses/LICENSE-2.0
+// Product   KMS-Tools
+// File      ComTool/Decoder_SLIP.h
+
+#pragma once
+
+// ===== C++ ================================================================
+#include <vector>
+
+// ===== Local ==============================================================
+#include "Decoder.h"
+
+// SLIP (RFC 1055). 0xc0 ends the frames, 0xdb 0xdc stands for 0xc0 and
+// 0xdb 0xdd for 0xdb. After an error, the bytes are discarded until the
+// next 0xc0.
+class Decoder_SLIP final : public Decoder
+{
+
+public:
+
+    Decoder_SLIP(IDecoderListener* aListener);
+
+    // ===== Decoder ================================================
+    virtual void Reset();
+    virtual void Push(const uint8_t* aIn, unsigned int aInSize_byte);
+
+private:
+
+    void Error(const char* aReason);
+
+    std::vector<uint8_t> mFrame;
+
+    bool mError;
+    bool mEscape;
+
+};
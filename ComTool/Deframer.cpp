@@ -0,0 +1,222 @@
+// Author    KMS - Martin Dubois, P. Eng.
+// Copyright (C) 2024 KMS
+// License   http://www.apache.org/licenses/LICENSE-2.0
+// Product   KMS-Tools
+// File      ComTool/Deframer.cpp
+
+#include "Component.h"
+
+// ===== Local ==============================================================
+#include "CRC16.h"
+#include "Deframer.h"
+#include "IFrameListener.h"
+
+// Constants
+// //////////////////////////////////////////////////////////////////////////
+
+#define BYTE_BEGIN (0x7e)
+#define BYTE_END   (0x7f)
+
+// 0x7e, CRC (2 bytes) and 0x7f
+#define OVERHEAD_byte (4)
+
+const unsigned int Deframer::MAX_SIZE_DEFAULT_byte = 4096;
+
+// Public
+// //////////////////////////////////////////////////////////////////////////
+
+Deframer::Deframer(IFrameListener* aListener, unsigned int aMaxSize_byte)
+    : mListener(aListener)
+    , mMaxSize_byte(aMaxSize_byte + OVERHEAD_byte)
+{
+    assert(nullptr != aListener);
+
+    mFrame.reserve(mMaxSize_byte);
+
+    Reset();
+}
+
+void Deframer::Push(const void* aIn, unsigned int aInSize_byte)
+{
+    assert(nullptr != aIn);
+
+    auto lIn  = static_cast<const uint8_t*>(aIn);
+    auto lEnd = lIn + aInSize_byte;
+
+    while (lIn < lEnd)
+    {
+        const uint8_t* lFound;
+        unsigned int   lSize_byte;
+
+        switch (mState)
+        {
+        case State::IDLE:
+            lFound = static_cast<const uint8_t*>(memchr(lIn, BYTE_BEGIN, lEnd - lIn));
+            if (nullptr == lFound)
+            {
+                mDiscarded_byte += lEnd - lIn;
+                return;
+            }
+
+            mDiscarded_byte += lFound - lIn;
+
+            lIn = lFound + 1;
+
+            Frame_Begin();
+            break;
+
+        case State::FRAME:
+            lFound = static_cast<const uint8_t*>(memchr(lIn, BYTE_END, lEnd - lIn));
+
+            lSize_byte = static_cast<unsigned int>(((nullptr == lFound) ? lEnd : lFound + 1) - lIn);
+
+            if (mMaxSize_byte < mFrame.size() + lSize_byte)
+            {
+                // No 0x7f matched the CRC before the maximum frame size.
+                // Complete the frame up to the maximum size and restart
+                // the search at the next 0x7e it contains.
+                lSize_byte = mMaxSize_byte - static_cast<unsigned int>(mFrame.size());
+
+                mFrame.insert(mFrame.end(), lIn, lIn + lSize_byte);
+
+                lIn += lSize_byte;
+
+                Resync();
+                break;
+            }
+
+            mFrame.insert(mFrame.end(), lIn, lIn + lSize_byte);
+
+            lIn += lSize_byte;
+
+            if (nullptr != lFound)
+            {
+                Frame_Check();
+            }
+            break;
+
+        case State::FRAME_END:
+            if (BYTE_BEGIN == *lIn)
+            {
+                Frame_Error();
+
+                lIn++;
+
+                Frame_Begin();
+            }
+            else
+            {
+                // The 0x7f was part of the payload
+                mState = State::FRAME;
+            }
+            break;
+
+        default: assert(false);
+        }
+    }
+}
+
+void Deframer::Reset()
+{
+    mCRCErrorCount  = 0;
+    mDiscarded_byte = 0;
+    mFrameCount     = 0;
+
+    mFrame.clear();
+
+    mResync = false;
+    mState  = State::IDLE;
+}
+
+void Deframer::DisplayStatus(std::ostream& aOut) const
+{
+    aOut << "Frames         : " << mFrameCount     << "\n";
+    aOut << "    CRC errors : " << mCRCErrorCount  << "\n";
+    aOut << "    Discarded  : " << mDiscarded_byte << " bytes\n";
+}
+
+// Private
+// //////////////////////////////////////////////////////////////////////////
+
+void Deframer::Frame_Begin()
+{
+    mFrame.clear();
+    mFrame.push_back(BYTE_BEGIN);
+
+    mCRC          = CRC16_INIT;
+    mCRCSize_byte = 0;
+
+    mState = State::FRAME;
+}
+
+// The CRC is updated incrementally, so each received byte goes through the
+// CRC kernel only once even when the payload contains 0x7f.
+void Deframer::Frame_Check()
+{
+    auto lSize_byte = static_cast<unsigned int>(mFrame.size());
+
+    if (OVERHEAD_byte <= lSize_byte)
+    {
+        auto lData_byte = lSize_byte - 3;
+
+        mCRC = CRC16_Compute(mCRC, mFrame.data() + mCRCSize_byte, lData_byte - mCRCSize_byte);
+        mCRCSize_byte = lData_byte;
+
+        uint16_t lCRC = mFrame[lData_byte] | (mFrame[lData_byte + 1] << 8);
+
+        if (mCRC == lCRC)
+        {
+            mFrameCount++;
+            mResync = false;
+
+            mListener->OnFrame(mFrame.data() + 1, lSize_byte - OVERHEAD_byte);
+
+            mState = State::IDLE;
+            return;
+        }
+    }
+
+    mState = State::FRAME_END;
+}
+
+// Each frame ended by 0x7f and 0x7e counts as one error, even during a
+// resynchronization.
+void Deframer::Frame_Error()
+{
+    mCRCErrorCount++;
+    mResync = false;
+
+    mListener->OnFrameError(mFrame.data(), static_cast<unsigned int>(mFrame.size()));
+}
+
+void Deframer::Resync()
+{
+    auto lNext = static_cast<const uint8_t*>(memchr(mFrame.data() + 1, BYTE_BEGIN, mFrame.size() - 1));
+
+    auto lErrorSize_byte = static_cast<unsigned int>((nullptr == lNext) ? mFrame.size() : lNext - mFrame.data());
+
+    // The following rejections, until the next good frame, come from the
+    // same error. They only count as discarded bytes.
+    if (mResync)
+    {
+        mDiscarded_byte += lErrorSize_byte;
+    }
+    else
+    {
+        mCRCErrorCount++;
+        mResync = true;
+
+        mListener->OnFrameError(mFrame.data(), lErrorSize_byte);
+    }
+
+    mState = State::IDLE;
+
+    if (nullptr != lNext)
+    {
+        // The bytes following the bad frame are shorter than the maximum
+        // frame size, so pushing them again cannot overflow and recurse.
+        std::vector<uint8_t> lTail(mFrame.begin() + lErrorSize_byte, mFrame.end());
+
+        Push(lTail.data(), static_cast<unsigned int>(lTail.size()));
+    }
+}
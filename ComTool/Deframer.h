@@ -0,0 +1,71 @@
+// Author    KMS - Martin Dubois, P. Eng.
+// Copyright (C) 2024 KMS
+// License   http://www.apache.org/licenses/LICENSE-2.0
+// Product   KMS-Tools
+// File      ComTool/Deframer.h
+
+#pragma once
+
+// ===== C++ ================================================================
+#include <vector>
+
+// ===== Local ==============================================================
+class IFrameListener;
+
+// Incremental FRAME_T decoder (0x7e, payload, CRC-16, 0x7f). The payload is
+// not escaped, so a 0x7f only ends the frame when the CRC matches. A frame
+// is rejected when a 0x7f failing the CRC is followed by the 0x7e of the
+// next frame, or when it reaches the maximum size without a matching CRC.
+class Deframer
+{
+
+public:
+
+    static const unsigned int MAX_SIZE_DEFAULT_byte;
+
+    Deframer(IFrameListener* aListener, unsigned int aMaxSize_byte = MAX_SIZE_DEFAULT_byte);
+
+    void Push(const void* aIn, unsigned int aInSize_byte);
+
+    // Drop the partial frame and clear the counters
+    void Reset();
+
+    void DisplayStatus(std::ostream& aOut) const;
+
+    uint64_t mCRCErrorCount;
+    uint64_t mDiscarded_byte;
+    uint64_t mFrameCount;
+
+private:
+
+    NO_COPY(Deframer);
+
+    enum class State
+    {
+        IDLE,
+        FRAME,
+
+        // A 0x7f failed the CRC, a 0x7e right after it starts the next
+        // frame
+        FRAME_END,
+    };
+
+    void Frame_Begin();
+    void Frame_Check();
+    void Frame_Error();
+
+    void Resync();
+
+    std::vector<uint8_t> mFrame;
+
+    IFrameListener* mListener;
+    unsigned int    mMaxSize_byte;
+
+    // CRC of mFrame[0 .. mCRCSize_byte[
+    uint16_t     mCRC;
+    unsigned int mCRCSize_byte;
+
+    bool  mResync;
+    State mState;
+
+};
@@ -0,0 +1,251 @@
+// Author    KMS - Martin Dubois, P. Eng.
+// Copyright (C) 2024 KMS
+// License   http://www.apache.org/licenses/LICENSE-2.0
+// Product   KMS-Tools
+// File      ComTool/Delimiter.cpp
+
+#include "Component.h"
+
+// ===== Local ==============================================================
+#include "Delimiter.h"
+#include "IMessageListener.h"
+
+using namespace KMS;
+
+// Constants
+// //////////////////////////////////////////////////////////////////////////
+
+const unsigned int Delimiter::MAX_SIZE_DEFAULT_byte = 4096;
+
+// Public
+// //////////////////////////////////////////////////////////////////////////
+
+Delimiter::Delimiter(IMessageListener* aListener, unsigned int aMaxSize_byte)
+    : mListener(aListener)
+    , mMaxSize_byte(aMaxSize_byte)
+    , mGap_ns(0)
+    , mLengthBigEndian(false)
+    , mLengthExtra_byte(0)
+    , mLengthOffset_byte(0)
+    , mLengthSize_byte(0)
+{
+    assert(nullptr != aListener);
+    assert(0 < aMaxSize_byte);
+
+    mMessage.reserve(mMaxSize_byte);
+
+    Reset();
+}
+
+void Delimiter::SetGap(unsigned int aGap_us) { mGap_ns = static_cast<uint64_t>(aGap_us) * 1000; }
+
+void Delimiter::SetLength(unsigned int aOffset_byte, unsigned int aSize_byte, bool aBigEndian, unsigned int aExtra_byte)
+{
+    KMS_EXCEPTION_ASSERT(2 >= aSize_byte, RESULT_INVALID_VALUE, "Invalid length field size", aSize_byte);
+
+    mLengthBigEndian   = aBigEndian;
+    mLengthExtra_byte  = aExtra_byte;
+    mLengthOffset_byte = aOffset_byte;
+    mLengthSize_byte   = aSize_byte;
+}
+
+void Delimiter::SetTerminator(const uint8_t* aIn, unsigned int aSize_byte)
+{
+    assert((nullptr != aIn) || (0 == aSize_byte));
+
+    mTerminator.assign(aIn, aIn + aSize_byte);
+}
+
+void Delimiter::Check(uint64_t aNow_ns)
+{
+    if (GetDeadline_ns() <= aNow_ns)
+    {
+        Emit(mMessage.data(), static_cast<unsigned int>(mMessage.size()), true);
+
+        mMessage.clear();
+    }
+}
+
+void Delimiter::Flush()
+{
+    if (!mMessage.empty())
+    {
+        // Without terminator and length field, the end of the data is the
+        // end of the message.
+        Emit(mMessage.data(), static_cast<unsigned int>(mMessage.size()), mTerminator.empty() && (0 == mLengthSize_byte));
+
+        mMessage.clear();
+    }
+}
+
+uint64_t Delimiter::GetDeadline_ns() const
+{
+    return ((0 == mGap_ns) || mMessage.empty()) ? UINT64_MAX : mLast_ns + mGap_ns;
+}
+
+void Delimiter::Push(const void* aIn, unsigned int aInSize_byte, uint64_t aTime_ns)
+{
+    assert(nullptr != aIn);
+
+    Check(aTime_ns);
+
+    mLast_ns = aTime_ns;
+
+    auto lIn  = static_cast<const uint8_t*>(aIn);
+    auto lEnd = lIn + aInSize_byte;
+
+    while (lIn < lEnd)
+    {
+        if (mMessage.empty())
+        {
+            mTime_ns = aTime_ns;
+        }
+
+        auto lRoom_byte = mMaxSize_byte - static_cast<unsigned int>(mMessage.size());
+        auto lSize_byte = static_cast<unsigned int>(lEnd - lIn);
+
+        if (lRoom_byte < lSize_byte)
+        {
+            lSize_byte = lRoom_byte;
+        }
+
+        auto lEnd_byte = FindEnd(lIn, lSize_byte);
+        if (0 < lEnd_byte)
+        {
+            if (mMessage.empty())
+            {
+                Emit(lIn, lEnd_byte, true);
+            }
+            else
+            {
+                mMessage.insert(mMessage.end(), lIn, lIn + lEnd_byte);
+
+                Emit(mMessage.data(), static_cast<unsigned int>(mMessage.size()), true);
+
+                mMessage.clear();
+            }
+
+            lIn += lEnd_byte;
+        }
+        else
+        {
+            mMessage.insert(mMessage.end(), lIn, lIn + lSize_byte);
+
+            lIn += lSize_byte;
+
+            if (mMaxSize_byte <= mMessage.size())
+            {
+                Emit(mMessage.data(), static_cast<unsigned int>(mMessage.size()), false);
+
+                mMessage.clear();
+            }
+        }
+    }
+}
+
+void Delimiter::Reset()
+{
+    mIncompleteCount = 0;
+    mMessageCount    = 0;
+
+    mLast_ns = 0;
+    mTime_ns = 0;
+
+    mMessage.clear();
+}
+
+void Delimiter::DisplayStatus(std::ostream& aOut) const
+{
+    aOut << "Messages         : " << mMessageCount    << "\n";
+    aOut << "    Incomplete   : " << mIncompleteCount << "\n";
+}
+
+// Private
+// //////////////////////////////////////////////////////////////////////////
+
+void Delimiter::Emit(const uint8_t* aIn, unsigned int aInSize_byte, bool aComplete)
+{
+    mMessageCount++;
+
+    if (!aComplete)
+    {
+        mIncompleteCount++;
+    }
+
+    mListener->OnMessage(aIn, aInSize_byte, mTime_ns, aComplete);
+}
+
+unsigned int Delimiter::FindEnd(const uint8_t* aIn, unsigned int aInSize_byte) const
+{
+    auto lPending_byte = static_cast<unsigned int>(mMessage.size());
+
+    if (0 < mLengthSize_byte)
+    {
+        auto lHeader_byte = mLengthOffset_byte + mLengthSize_byte;
+        if (lPending_byte + aInSize_byte < lHeader_byte)
+        {
+            return 0;
+        }
+
+        unsigned int lLength_byte = GetByte(mLengthOffset_byte, aIn);
+
+        if (2 == mLengthSize_byte)
+        {
+            unsigned int lSecond = GetByte(mLengthOffset_byte + 1, aIn);
+
+            lLength_byte = mLengthBigEndian ? (lLength_byte << 8) | lSecond : lLength_byte | (lSecond << 8);
+        }
+
+        // A message longer than the maximum size ends when it reaches it
+        auto lTotal_byte = lHeader_byte + lLength_byte + mLengthExtra_byte;
+
+        return ((lTotal_byte <= lPending_byte + aInSize_byte) && (lTotal_byte > lPending_byte)) ? lTotal_byte - lPending_byte : 0;
+    }
+
+    if (!mTerminator.empty())
+    {
+        auto lLast        = mTerminator.back();
+        auto lTerm_byte   = static_cast<unsigned int>(mTerminator.size());
+        auto lPtr         = aIn;
+        auto lEnd         = aIn + aInSize_byte;
+
+        for (;;)
+        {
+            auto lFound = static_cast<const uint8_t*>(memchr(lPtr, lLast, lEnd - lPtr));
+            if (nullptr == lFound)
+            {
+                break;
+            }
+
+            auto lResult_byte = static_cast<unsigned int>(lFound - aIn) + 1;
+            auto lTotal_byte  = lPending_byte + lResult_byte;
+
+            if (lTerm_byte <= lTotal_byte)
+            {
+                unsigned int i;
+
+                for (i = 0; i < lTerm_byte - 1; i++)
+                {
+                    if (mTerminator[i] != GetByte(lTotal_byte - lTerm_byte + i, aIn))
+                    {
+                        break;
+                    }
+                }
+
+                if (lTerm_byte - 1 == i)
+                {
+                    return lResult_byte;
+                }
+            }
+
+            lPtr = lFound + 1;
+        }
+    }
+
+    return 0;
+}
+
+uint8_t Delimiter::GetByte(unsigned int aIndex, const uint8_t* aIn) const
+{
+    return (mMessage.size() > aIndex) ? mMessage[aIndex] : aIn[aIndex - mMessage.size()];
+}
@@ -0,0 +1,94 @@
+// Author    KMS - Martin Dubois, P. Eng.
+// Copyright (C) 2024 KMS
+// License   http://www.apache.org/licenses/LICENSE-2.0
+// Product   KMS-Tools
+// File      ComTool/Delimiter.h
+
+#pragma once
+
+// ===== C++ ================================================================
+#include <vector>
+
+// ===== Local ==============================================================
+class IMessageListener;
+
+// Incremental grouping of the received bytes into messages. A message ends
+// at a terminator sequence or after the size a length field gives. When
+// the inter-character timeout is set, a silence also ends the message. The
+// silence is measured between received chunks, the bytes read together
+// belong to the same message. A message completely inside a pushed chunk
+// goes to the listener without being copied.
+class Delimiter
+{
+
+public:
+
+    static const unsigned int MAX_SIZE_DEFAULT_byte;
+
+    Delimiter(IMessageListener* aListener, unsigned int aMaxSize_byte = MAX_SIZE_DEFAULT_byte);
+
+    // aGap_us  0 disables the inter-character timeout
+    void SetGap(unsigned int aGap_us);
+
+    // The message is aOffset_byte bytes, the length field, the number of
+    // bytes the field gives, then aExtra_byte bytes (a CRC for example).
+    // aSize_byte  1 or 2, 0 disables the length field
+    void SetLength(unsigned int aOffset_byte, unsigned int aSize_byte, bool aBigEndian, unsigned int aExtra_byte);
+
+    // The terminator is part of the message
+    // aSize_byte  0 disables the terminator
+    void SetTerminator(const uint8_t* aIn, unsigned int aSize_byte);
+
+    // End the pending message if the inter-character timeout elapsed
+    void Check(uint64_t aNow_ns);
+
+    // End the pending message, whatever the rules
+    void Flush();
+
+    // Return  The time the pending message ends if no data comes, or
+    //         UINT64_MAX
+    uint64_t GetDeadline_ns() const;
+
+    // aTime_ns  Clock_GetTime_ns value of the chunk
+    void Push(const void* aIn, unsigned int aInSize_byte, uint64_t aTime_ns);
+
+    // Drop the pending message and clear the counters
+    void Reset();
+
+    void DisplayStatus(std::ostream& aOut) const;
+
+    uint64_t mIncompleteCount;
+    uint64_t mMessageCount;
+
+private:
+
+    NO_COPY(Delimiter);
+
+    void Emit(const uint8_t* aIn, unsigned int aInSize_byte, bool aComplete);
+
+    // Return  The number of bytes of aIn completing the message, 0 when
+    //         the message does not end in aIn
+    unsigned int FindEnd(const uint8_t* aIn, unsigned int aInSize_byte) const;
+
+    // Byte of the pending message followed by aIn
+    uint8_t GetByte(unsigned int aIndex, const uint8_t* aIn) const;
+
+    IMessageListener* mListener;
+    unsigned int      mMaxSize_byte;
+
+    // ===== Rules ==========================================================
+    uint64_t mGap_ns;
+
+    bool         mLengthBigEndian;
+    unsigned int mLengthExtra_byte;
+    unsigned int mLengthOffset_byte;
+    unsigned int mLengthSize_byte;
+
+    std::vector<uint8_t> mTerminator;
+
+    // ===== Pending message ================================================
+    uint64_t             mLast_ns;
+    std::vector<uint8_t> mMessage;
+    uint64_t             mTime_ns;
+
+};
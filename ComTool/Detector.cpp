@@ -0,0 +1,267 @@
+// Author    KMS - Martin Dubois, P. Eng.
+// Copyright (C) 2024 KMS
+// License   http://www.apache.org/licenses/LICENSE-2.0
+// Product   KMS-Tools
+// File      ComTool/Detector.cpp
+
+#include "Component.h"
+
+// ===== Local ==============================================================
+#include "Clock.h"
+#include "FrameT.h"
+
+#include "Detector.h"
+
+using namespace KMS;
+
+// Constants
+// //////////////////////////////////////////////////////////////////////////
+
+// Random data sometimes passes a check, one frame proves nothing
+#define PROTOCOL_MIN_FRAMES (2)
+
+// Only the protocols with a check, COBS and SLIP accept almost anything.
+// The decoders report the frames without some bytes: the FRAME_T framing
+// and CRC, the Modbus CRC and the NMEA end of line.
+static const char*        PROTOCOL_NAMES          [] = { "FRAME_T"            , "ModbusRTU", "NMEA" };
+static const unsigned int PROTOCOL_OVERHEADS_byte[] = { FRAME_T_OVERHEAD_byte, 2          , 2 };
+
+const double       Detector::CONFIDENT_SCORE     = 0.85;
+const unsigned int Detector::CONFIDENT_SIZE_byte = 32;
+
+const Com::Parity  Detector::PARITIES    [] = { Com::Parity::NONE, Com::Parity::EVEN, Com::Parity::ODD };
+const char         Detector::PARITY_CHARS[] = { 'N', 'E', 'O' };
+const unsigned int Detector::PARITY_QTY     = sizeof(PARITIES) / sizeof(PARITIES[0]);
+
+const uint32_t     Detector::SPEEDS_bps[] = { 9600, 115200, 19200, 38400, 57600, 4800, 230400, 2400, 460800, 1200, 921600 };
+const unsigned int Detector::SPEED_QTY    = sizeof(SPEEDS_bps) / sizeof(SPEEDS_bps[0]);
+
+// Public
+// //////////////////////////////////////////////////////////////////////////
+
+Detector::Detector()
+{
+    static_assert(sizeof(PROTOCOL_NAMES) / sizeof(PROTOCOL_NAMES[0]) == PROTOCOL_QTY, "Invalid PROTOCOL_NAMES");
+
+    for (unsigned int i = 0; i < PROTOCOL_QTY; i++)
+    {
+        mProtocols[i].reset(new Protocol(PROTOCOL_NAMES[i], PROTOCOL_OVERHEADS_byte[i]));
+    }
+
+    Reset();
+}
+
+uint64_t Detector::GetByteCount() const { return mByteCount; }
+
+double Detector::GetScore() const
+{
+    if (0 == mByteCount)
+    {
+        return 0.0;
+    }
+
+    double lResult;
+
+    GetBestProtocol(&lResult);
+
+    double lPrintable = static_cast<double>(mPrintableCount) / mByteCount;
+    double lNotZero   = static_cast<double>(mByteCount - mZeroCount) / mByteCount / 2.0;
+
+    if (lResult < lPrintable) { lResult = lPrintable; }
+    if (lResult < lNotZero  ) { lResult = lNotZero; }
+
+    return lResult;
+}
+
+const char* Detector::GetProtocol() const
+{
+    double lScore;
+
+    auto lIndex = GetBestProtocol(&lScore);
+
+    return ((0.0 < lScore) && (GetScore() <= lScore)) ? mProtocols[lIndex]->mDecoder->GetName() : nullptr;
+}
+
+bool Detector::IsConfident() const
+{
+    return (CONFIDENT_SIZE_byte <= mByteCount) && (CONFIDENT_SCORE <= GetScore());
+}
+
+void Detector::Push(const uint8_t* aIn, unsigned int aInSize_byte)
+{
+    assert(nullptr != aIn);
+
+    for (unsigned int i = 0; i < aInSize_byte; i++)
+    {
+        auto lB = aIn[i];
+
+        if ((0x20 <= lB) && (0x7e >= lB)) { mPrintableCount++; }
+        else if (('\r' == lB) || ('\n' == lB) || ('\t' == lB)) { mPrintableCount++; }
+        else if (0x00 == lB) { mZeroCount++; }
+    }
+
+    mByteCount += aInSize_byte;
+
+    for (auto& lP : mProtocols)
+    {
+        lP->mDecoder->Push(aIn, aInSize_byte);
+    }
+}
+
+void Detector::Reset()
+{
+    mByteCount      = 0;
+    mPrintableCount = 0;
+    mZeroCount      = 0;
+
+    for (auto& lP : mProtocols)
+    {
+        lP->Reset();
+    }
+}
+
+bool Detector::Sweep(IDetectTarget* aTarget, const uint32_t* aSpeeds_bps, unsigned int aSpeedCount, unsigned int aWindow_ms, std::ostream& aOut, uint32_t* aSpeed_bps, unsigned int* aParity, double* aScore)
+{
+    assert(nullptr != aTarget);
+    assert(nullptr != aSpeeds_bps);
+    assert(0 < aSpeedCount);
+    assert(nullptr != aSpeed_bps);
+    assert(nullptr != aParity);
+    assert(nullptr != aScore);
+
+    bool lResult = false;
+
+    *aParity    = 0;
+    *aScore     = -1.0;
+    *aSpeed_bps = aSpeeds_bps[0];
+
+    for (unsigned int p = 0; (!lResult) && (p < PARITY_QTY); p++)
+    {
+        for (unsigned int s = 0; (!lResult) && (s < aSpeedCount); s++)
+        {
+            aTarget->OnDetectBegin(aSpeeds_bps[s], PARITIES[p]);
+
+            Reset();
+
+            auto lEnd_ns = Clock_GetTime_ns() + static_cast<uint64_t>(aWindow_ms) * 1000000;
+
+            // A confident match ends the window early. Each read waits at
+            // most for the time left in the window.
+            for (;;)
+            {
+                auto lNow_ns = Clock_GetTime_ns();
+                if ((lEnd_ns <= lNow_ns) || IsConfident())
+                {
+                    break;
+                }
+
+                auto lLeft_ms = static_cast<unsigned int>((lEnd_ns - lNow_ns + 999999) / 1000000);
+
+                uint8_t lData[LINE_LENGTH];
+
+                auto lSize_byte = aTarget->OnDetectRead(lData, sizeof(lData), lLeft_ms);
+                if (0 < lSize_byte)
+                {
+                    Push(lData, lSize_byte);
+                }
+            }
+
+            aTarget->OnDetectEnd();
+
+            lResult = IsConfident();
+
+            auto lScore = GetScore();
+            if (*aScore < lScore)
+            {
+                *aParity    = p;
+                *aScore     = lScore;
+                *aSpeed_bps = aSpeeds_bps[s];
+            }
+
+            aOut << (lResult ? Console::Color::GREEN : Console::Color::WHITE);
+            aOut << "AutoDetect " << aSpeeds_bps[s] << " 8" << PARITY_CHARS[p] << "1 : ";
+
+            Display(aOut);
+        }
+    }
+
+    return lResult;
+}
+
+void Detector::Display(std::ostream& aOut) const
+{
+    char lLine[LINE_LENGTH];
+
+    if (0 == mByteCount)
+    {
+        aOut << "0 bytes\n";
+        return;
+    }
+
+    double lProtocol;
+
+    auto lIndex = GetBestProtocol(&lProtocol);
+
+    sprintf_s(lLine SizeInfo(lLine), "%llu bytes, score %.2f (%s %.2f, printable %.2f, 0x00 %.2f)",
+        static_cast<unsigned long long>(mByteCount), GetScore(), mProtocols[lIndex]->mDecoder->GetName(), lProtocol,
+        static_cast<double>(mPrintableCount) / mByteCount, static_cast<double>(mZeroCount) / mByteCount);
+
+    aOut << lLine << "\n";
+}
+
+// Private
+// //////////////////////////////////////////////////////////////////////////
+
+unsigned int Detector::GetBestProtocol(double* aScore) const
+{
+    assert(nullptr != aScore);
+
+    unsigned int lResult = 0;
+
+    *aScore = 0.0;
+
+    for (unsigned int i = 0; i < PROTOCOL_QTY; i++)
+    {
+        auto lScore = mProtocols[i]->GetScore(mByteCount);
+        if (*aScore < lScore)
+        {
+            *aScore = lScore;
+            lResult = i;
+        }
+    }
+
+    return lResult;
+}
+
+// ===== Protocol ===========================================================
+
+Detector::Protocol::Protocol(const char* aName, unsigned int aOverhead_byte)
+    : mDecoder(Decoder::Create(aName, this)), mOverhead_byte(aOverhead_byte)
+{}
+
+double Detector::Protocol::GetScore(uint64_t aByteCount) const
+{
+    if ((PROTOCOL_MIN_FRAMES > mDecoder->mFrameCount) || (0 == aByteCount))
+    {
+        return 0.0;
+    }
+
+    return (aByteCount > mFrame_byte) ? static_cast<double>(mFrame_byte) / aByteCount : 1.0;
+}
+
+void Detector::Protocol::Reset()
+{
+    mDecoder->Reset();
+
+    mFrame_byte = 0;
+}
+
+// ===== IDecoderListener ===================================================
+
+void Detector::Protocol::OnDecoded(const uint8_t*, unsigned int aInSize_byte, const char*)
+{
+    mFrame_byte += aInSize_byte + mOverhead_byte;
+}
+
+// The bytes outside the frames already lower the score
+void Detector::Protocol::OnDecodeError(const uint8_t*, unsigned int, const char*) {}
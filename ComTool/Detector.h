@@ -0,0 +1,112 @@
+// Author    KMS - Martin Dubois, P. Eng.
+// Copyright (C) 2024 KMS
+// License   http://www.apache.org/licenses/LICENSE-2.0
+// Product   KMS-Tools
+// File      ComTool/Detector.h
+
+#pragma once
+
+// ===== C++ ================================================================
+#include <memory>
+
+// ===== Local ==============================================================
+#include "Decoder.h"
+#include "IDecoderListener.h"
+#include "IDetectTarget.h"
+
+// Score the bytes received with one port setting. With the wrong speed or
+// parity, the UART builds bytes from parts of the real characters and
+// returns 0x00 for the characters with a framing or parity error. The
+// score is the largest of
+//   - the part of the bytes in frames of a protocol with a check (FRAME_T,
+//     Modbus RTU, NMEA),
+//   - the part of printable ASCII bytes,
+//   - half the part of non 0x00 bytes, so an unknown binary protocol still
+//     ranks the candidates but never looks certain.
+class Detector
+{
+
+public:
+
+    // The minimum score and number of bytes of a confident match
+    static const double       CONFIDENT_SCORE;
+    static const unsigned int CONFIDENT_SIZE_byte;
+
+    // The settings Sweep tries, the most frequent first
+    static const KMS::Com::Parity PARITIES    [];
+    static const char             PARITY_CHARS[];
+    static const unsigned int     PARITY_QTY;
+    static const uint32_t         SPEEDS_bps  [];
+    static const unsigned int     SPEED_QTY;
+
+    Detector();
+
+    uint64_t GetByteCount() const;
+
+    // Return  0.0 to 1.0
+    double GetScore() const;
+
+    // Return  The best protocol or nullptr when the score does not come from
+    //         a protocol
+    const char* GetProtocol() const;
+
+    bool IsConfident() const;
+
+    void Push(const uint8_t* aIn, unsigned int aInSize_byte);
+
+    void Reset();
+
+    // Try each speed with each parity, in the PARITIES order, until the
+    // received data gives a confident match. After a confident match, the
+    // detector keeps the scores of the last setting, the matching one.
+    // aWindow_ms  Maximum receive time per setting
+    // aOut        One line per setting
+    // aSpeed_bps  The speed of the best setting
+    // aParity     The parity of the best setting, index in PARITIES
+    // aScore      The score of the best setting
+    // Return      true when the match is confident
+    bool Sweep(IDetectTarget* aTarget, const uint32_t* aSpeeds_bps, unsigned int aSpeedCount, unsigned int aWindow_ms, std::ostream& aOut, uint32_t* aSpeed_bps, unsigned int* aParity, double* aScore);
+
+    // One line: bytes, score and its parts
+    void Display(std::ostream& aOut) const;
+
+private:
+
+    NO_COPY(Detector);
+
+    class Protocol : public IDecoderListener
+    {
+
+    public:
+
+        // aOverhead_byte  The frame bytes the decoder does not report
+        Protocol(const char* aName, unsigned int aOverhead_byte);
+
+        // Return  The part of the bytes in valid frames
+        double GetScore(uint64_t aByteCount) const;
+
+        void Reset();
+
+        // ===== IDecoderListener =======================================
+        virtual void OnDecoded    (const uint8_t* aIn, unsigned int aInSize_byte, const char* aInfo);
+        virtual void OnDecodeError(const uint8_t* aIn, unsigned int aInSize_byte, const char* aReason);
+
+        std::unique_ptr<Decoder> mDecoder;
+
+        uint64_t     mFrame_byte;
+        unsigned int mOverhead_byte;
+
+    };
+
+    // Return  The index of the best protocol
+    unsigned int GetBestProtocol(double* aScore) const;
+
+    static const unsigned int PROTOCOL_QTY = 3;
+
+    uint64_t mByteCount;
+    uint64_t mPrintableCount;
+    uint64_t mZeroCount;
+
+    std::unique_ptr<Protocol> mProtocols[PROTOCOL_QTY];
+
+};
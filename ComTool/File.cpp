@@ -0,0 +1,32 @@
+// Author    KMS - Martin Dubois, P. Eng.
+// Copyright (C) 2024 KMS
+// License   http://www.apache.org/licenses/LICENSE-2.0
+// Product   KMS-Tools
+// File      ComTool/File.cpp
+
+#include "Component.h"
+
+// ===== Local ==============================================================
+#include "File.h"
+
+// Functions
+// //////////////////////////////////////////////////////////////////////////
+
+FILE* File_Open(const char* aFileName, const char* aMode)
+{
+    assert(nullptr != aFileName);
+    assert(nullptr != aMode);
+
+    FILE* lResult;
+
+    #ifdef _KMS_WINDOWS_
+        if (0 != fopen_s(&lResult, aFileName, aMode))
+        {
+            lResult = nullptr;
+        }
+    #else
+        lResult = fopen(aFileName, aMode);
+    #endif
+
+    return lResult;
+}
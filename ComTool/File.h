@@ -0,0 +1,11 @@
+// Author    KMS - Martin Dubois, P. Eng.
+// Copyright (C) 2024 KMS
+// License   http://www.apache.org/licenses/LICENSE-2.0
+// Product   KMS-Tools
+// File      ComTool/File.h
+
+#pragma once
+
+// aMode  fopen mode
+// Return  nullptr when the file cannot be opened, the caller reports it
+extern FILE* File_Open(const char* aFileName, const char* aMode);
@@ -0,0 +1,302 @@
+// Author    KMS - Martin Dubois, P. Eng.
+// Copyright (C) 2024 KMS
+// License   http://www.apache.org/licenses/LICENSE-2.0
+// Product   KMS-Tools
+// File      ComTool/Formatter.cpp
+
+#include "Component.h"
+
+// ===== C++ ================================================================
+#if defined(_M_X64) || defined(__x86_64__)
+    #define FORMATTER_SIMD
+    #include <tmmintrin.h>
+    #ifdef _KMS_WINDOWS_
+        #include <intrin.h>
+    #endif
+#endif
+
+// ===== Local ==============================================================
+#include "Formatter.h"
+
+// Constants
+// //////////////////////////////////////////////////////////////////////////
+
+// Largest input encoded at once, the hex encoding uses 3 output bytes per
+// input byte and the new line uses 1.
+#define CHUNK_byte ((BUFFER_SIZE_byte - 1) / 3)
+
+#ifdef FORMATTER_SIMD
+    #ifdef __GNUC__
+        #define TARGET_SSSE3 __attribute__((target("ssse3")))
+    #else
+        #define TARGET_SSSE3
+    #endif
+#endif
+
+static const char HEX_DIGITS[] = "0123456789abcdef";
+
+const unsigned int Formatter::BUFFER_SIZE_byte = 64 * 1024;
+
+// Static function declarations
+// //////////////////////////////////////////////////////////////////////////
+
+#ifdef FORMATTER_SIMD
+    static bool IsSSSE3Supported();
+
+    static unsigned int EncodeHex_SSSE3(const uint8_t* aIn, unsigned int aInSize_byte, char* aOut);
+#endif
+
+// Static variables
+// //////////////////////////////////////////////////////////////////////////
+
+#ifdef FORMATTER_SIMD
+    static const bool sSSSE3 = IsSSSE3Supported();
+#endif
+
+// Functions
+// //////////////////////////////////////////////////////////////////////////
+
+void Formatter_EncodeDisplay(const void* aIn, unsigned int aInSize_byte, char* aOut)
+{
+    assert(nullptr != aIn);
+    assert(nullptr != aOut);
+
+    auto lIn = static_cast<const uint8_t*>(aIn);
+
+    unsigned int i = 0;
+
+    #ifdef FORMATTER_SIMD
+        // SSE2 is part of x64. Bytes above 0x7f are negative, so the signed
+        // compare also rejects them.
+        auto lDot   = _mm_set1_epi8('.');
+        auto lFirst = _mm_set1_epi8(' ' - 1);
+        auto lLast  = _mm_set1_epi8('~' + 1);
+
+        for (; i + 16 <= aInSize_byte; i += 16)
+        {
+            auto lData = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lIn + i));
+
+            auto lMask = _mm_and_si128(_mm_cmpgt_epi8(lData, lFirst), _mm_cmplt_epi8(lData, lLast));
+
+            lData = _mm_or_si128(_mm_and_si128(lMask, lData), _mm_andnot_si128(lMask, lDot));
+
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(aOut + i), lData);
+        }
+    #endif
+
+    for (; i < aInSize_byte; i++)
+    {
+        aOut[i] = ((' ' <= lIn[i]) && ('~' >= lIn[i])) ? lIn[i] : '.';
+    }
+}
+
+void Formatter_EncodeHex(const void* aIn, unsigned int aInSize_byte, char* aOut)
+{
+    assert(nullptr != aIn);
+    assert(nullptr != aOut);
+
+    auto lIn = static_cast<const uint8_t*>(aIn);
+
+    unsigned int lDone_byte = 0;
+
+    #ifdef FORMATTER_SIMD
+        if (sSSSE3)
+        {
+            lDone_byte = EncodeHex_SSSE3(lIn, aInSize_byte, aOut);
+        }
+    #endif
+
+    Formatter_EncodeHex_Scalar(lIn + lDone_byte, aInSize_byte - lDone_byte, aOut + 3 * lDone_byte);
+}
+
+void Formatter_EncodeHex_Scalar(const void* aIn, unsigned int aInSize_byte, char* aOut)
+{
+    assert(nullptr != aIn);
+    assert(nullptr != aOut);
+
+    auto lIn = static_cast<const uint8_t*>(aIn);
+
+    for (unsigned int i = 0; i < aInSize_byte; i++)
+    {
+        aOut[0] = ' ';
+        aOut[1] = HEX_DIGITS[lIn[i] >> 4];
+        aOut[2] = HEX_DIGITS[lIn[i] & 0x0f];
+
+        aOut += 3;
+    }
+}
+
+// Public
+// //////////////////////////////////////////////////////////////////////////
+
+Formatter::Formatter(FILE* aOut) : mBuffer(new char[BUFFER_SIZE_byte]), mOut(aOut), mUsed_byte(0)
+{
+    assert(nullptr != aOut);
+}
+
+Formatter::~Formatter()
+{
+    Flush();
+
+    delete[] mBuffer;
+}
+
+void Formatter::Display(const void* aIn, unsigned int aInSize_byte)
+{
+    assert(nullptr != aIn);
+
+    auto lIn = static_cast<const uint8_t*>(aIn);
+
+    unsigned int lSize_byte;
+
+    for (unsigned int i = 0; i < aInSize_byte; i += lSize_byte)
+    {
+        lSize_byte = aInSize_byte - i;
+        if (BUFFER_SIZE_byte - 1 < lSize_byte)
+        {
+            lSize_byte = BUFFER_SIZE_byte - 1;
+        }
+
+        Formatter_EncodeDisplay(lIn + i, lSize_byte, Reserve(lSize_byte));
+
+        mUsed_byte += lSize_byte;
+    }
+
+    *Reserve(1) = '\n'; mUsed_byte++;
+}
+
+void Formatter::Dump(const void* aIn, unsigned int aInSize_byte)
+{
+    assert(nullptr != aIn);
+
+    auto lIn = static_cast<const uint8_t*>(aIn);
+
+    unsigned int lSize_byte;
+
+    for (unsigned int i = 0; i < aInSize_byte; i += lSize_byte)
+    {
+        lSize_byte = aInSize_byte - i;
+        if (CHUNK_byte < lSize_byte)
+        {
+            lSize_byte = CHUNK_byte;
+        }
+
+        Formatter_EncodeHex(lIn + i, lSize_byte, Reserve(3 * lSize_byte));
+
+        mUsed_byte += 3 * lSize_byte;
+    }
+
+    *Reserve(1) = '\n'; mUsed_byte++;
+}
+
+void Formatter::Flush()
+{
+    if (0 < mUsed_byte)
+    {
+        fwrite(mBuffer, 1, mUsed_byte, mOut);
+        fflush(mOut);
+
+        mUsed_byte = 0;
+    }
+}
+
+void Formatter::Write(const char* aIn)
+{
+    assert(nullptr != aIn);
+
+    Write(aIn, static_cast<unsigned int>(strlen(aIn)));
+}
+
+void Formatter::Write(const char* aIn, unsigned int aInSize_byte)
+{
+    assert(nullptr != aIn);
+
+    if (BUFFER_SIZE_byte < aInSize_byte)
+    {
+        Flush();
+
+        fwrite(aIn, 1, aInSize_byte, mOut);
+    }
+    else
+    {
+        memcpy(Reserve(aInSize_byte), aIn, aInSize_byte);
+
+        mUsed_byte += aInSize_byte;
+    }
+}
+
+// Private
+// //////////////////////////////////////////////////////////////////////////
+
+char* Formatter::Reserve(unsigned int aSize_byte)
+{
+    assert(BUFFER_SIZE_byte >= aSize_byte);
+
+    if (BUFFER_SIZE_byte - mUsed_byte < aSize_byte)
+    {
+        Flush();
+    }
+
+    return mBuffer + mUsed_byte;
+}
+
+// Static functions
+// //////////////////////////////////////////////////////////////////////////
+
+#ifdef FORMATTER_SIMD
+
+    bool IsSSSE3Supported()
+    {
+        #ifdef _KMS_WINDOWS_
+            int lInfo[4];
+
+            __cpuid(lInfo, 1);
+
+            return 0 != (lInfo[2] & (1 << 9));
+        #else
+            __builtin_cpu_init();
+
+            return __builtin_cpu_supports("ssse3");
+        #endif
+    }
+
+    // Each group of 16 input bytes produces 48 output bytes. The nibbles are
+    // converted to digits with a table lookup, interleaved, then the 3
+    // shuffles spread the 32 digits and leave room for the spaces.
+    TARGET_SSSE3 unsigned int EncodeHex_SSSE3(const uint8_t* aIn, unsigned int aInSize_byte, char* aOut)
+    {
+        auto lDigits = _mm_loadu_si128(reinterpret_cast<const __m128i*>(HEX_DIGITS));
+        auto lMask   = _mm_set1_epi8(0x0f);
+
+        auto lA0 = _mm_setr_epi8(-128, 0, 1, -128, 2, 3, -128, 4, 5, -128, 6, 7, -128, 8, 9, -128);
+        auto lA1 = _mm_setr_epi8(10, 11, -128, 12, 13, -128, 14, 15, -128, -128, -128, -128, -128, -128, -128, -128);
+        auto lB1 = _mm_setr_epi8(-128, -128, -128, -128, -128, -128, -128, -128, -128, 0, 1, -128, 2, 3, -128, 4);
+        auto lB2 = _mm_setr_epi8(5, -128, 6, 7, -128, 8, 9, -128, 10, 11, -128, 12, 13, -128, 14, 15);
+
+        auto lS0 = _mm_setr_epi8(' ', 0, 0, ' ', 0, 0, ' ', 0, 0, ' ', 0, 0, ' ', 0, 0, ' ');
+        auto lS1 = _mm_setr_epi8(0, 0, ' ', 0, 0, ' ', 0, 0, ' ', 0, 0, ' ', 0, 0, ' ', 0);
+        auto lS2 = _mm_setr_epi8(0, ' ', 0, 0, ' ', 0, 0, ' ', 0, 0, ' ', 0, 0, ' ', 0, 0);
+
+        unsigned int i;
+
+        for (i = 0; i + 16 <= aInSize_byte; i += 16)
+        {
+            auto lData = _mm_loadu_si128(reinterpret_cast<const __m128i*>(aIn + i));
+
+            auto lHi = _mm_shuffle_epi8(lDigits, _mm_and_si128(_mm_srli_epi16(lData, 4), lMask));
+            auto lLo = _mm_shuffle_epi8(lDigits, _mm_and_si128(lData, lMask));
+
+            auto lA = _mm_unpacklo_epi8(lHi, lLo);
+            auto lB = _mm_unpackhi_epi8(lHi, lLo);
+
+            auto lOut = reinterpret_cast<__m128i*>(aOut + 3 * i);
+
+            _mm_storeu_si128(lOut    , _mm_or_si128(_mm_shuffle_epi8(lA, lA0), lS0));
+            _mm_storeu_si128(lOut + 1, _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(lA, lA1), _mm_shuffle_epi8(lB, lB1)), lS1));
+            _mm_storeu_si128(lOut + 2, _mm_or_si128(_mm_shuffle_epi8(lB, lB2), lS2));
+        }
+
+        return i;
+    }
+
+#endif
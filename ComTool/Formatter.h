@@ -0,0 +1,54 @@
+// Author    KMS - Martin Dubois, P. Eng.
+// Copyright (C) 2024 KMS
+// License   http://www.apache.org/licenses/LICENSE-2.0
+// Product   KMS-Tools
+// File      ComTool/Formatter.h
+
+#pragma once
+
+// Encodes data as text into a large buffer written to the output file only
+// when full or when Flush is called. The hex encoding processes 16 bytes per
+// iteration when the processor supports SSSE3.
+class Formatter
+{
+
+public:
+
+    static const unsigned int BUFFER_SIZE_byte;
+
+    Formatter(FILE* aOut);
+
+    ~Formatter();
+
+    // Printable ASCII characters as is, other bytes as '.', then a new line
+    void Display(const void* aIn, unsigned int aInSize_byte);
+
+    // " xx" for each byte, then a new line
+    void Dump(const void* aIn, unsigned int aInSize_byte);
+
+    void Flush();
+
+    void Write(const char* aIn);
+    void Write(const char* aIn, unsigned int aInSize_byte);
+
+private:
+
+    NO_COPY(Formatter);
+
+    // Flush the buffer if it does not have aSize_byte free bytes
+    char* Reserve(unsigned int aSize_byte);
+
+    char*        mBuffer;
+    FILE*        mOut;
+    unsigned int mUsed_byte;
+
+};
+
+// Encoding functions, exposed for validation
+
+// aOut  3 * aInSize_byte bytes
+extern void Formatter_EncodeHex(const void* aIn, unsigned int aInSize_byte, char* aOut);
+extern void Formatter_EncodeHex_Scalar(const void* aIn, unsigned int aInSize_byte, char* aOut);
+
+// aOut  aInSize_byte bytes
+extern void Formatter_EncodeDisplay(const void* aIn, unsigned int aInSize_byte, char* aOut);
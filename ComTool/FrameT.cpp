@@ -0,0 +1,50 @@
+// Author    KMS - Martin Dubois, P. Eng.
+// Copyright (C) 2024 KMS
+// License   http://www.apache.org/licenses/LICENSE-2.0
+// Product   KMS-Tools
+// File      ComTool/FrameT.cpp
+
+#include "Component.h"
+
+// ===== Local ==============================================================
+#include "CRC16.h"
+
+#include "FrameT.h"
+
+using namespace KMS;
+
+// Functions
+// //////////////////////////////////////////////////////////////////////////
+
+unsigned int FrameT_Encode(const void* aIn, unsigned int aInSize_byte, void* aOut, unsigned int aOutSize_byte)
+{
+    assert(nullptr != aIn);
+    assert(nullptr != aOut);
+
+    KMS_EXCEPTION_ASSERT(aInSize_byte + FRAME_T_OVERHEAD_byte <= aOutSize_byte, RESULT_OUTPUT_TOO_SHORT, "The output buffer is too short", aInSize_byte);
+
+    auto lOut = reinterpret_cast<uint8_t*>(aOut);
+
+    memcpy(lOut + FRAME_T_HEADER_byte, aIn, aInSize_byte);
+
+    FrameT_Encode_Segments(aIn, aInSize_byte, lOut, lOut + FRAME_T_HEADER_byte + aInSize_byte);
+
+    return aInSize_byte + FRAME_T_OVERHEAD_byte;
+}
+
+void FrameT_Encode_Segments(const void* aIn, unsigned int aInSize_byte, uint8_t* aHeader, uint8_t* aTrailer)
+{
+    assert(nullptr != aIn);
+    assert(nullptr != aHeader);
+    assert(nullptr != aTrailer);
+
+    aHeader[0] = 0x7e;
+
+    // The CRC goes through the segments where they are
+    uint16_t lCRC = CRC16_Compute(CRC16_INIT, aHeader, FRAME_T_HEADER_byte);
+
+    lCRC = CRC16_Compute(lCRC, aIn, aInSize_byte);
+
+    memcpy(aTrailer, &lCRC, sizeof(lCRC));
+    aTrailer[sizeof(lCRC)] = 0x7f;
+}
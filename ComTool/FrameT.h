@@ -0,0 +1,24 @@
+// Author    KMS - Martin Dubois, P. Eng.
+// Copyright (C) 2024 KMS
+// License   http://www.apache.org/licenses/LICENSE-2.0
+// Product   KMS-Tools
+// File      ComTool/FrameT.h
+
+#pragma once
+
+// FRAME_T : 0x7e, payload, CRC-16 (little endian), 0x7f. The CRC covers the
+// 0x7e and the payload.
+
+#define FRAME_T_HEADER_byte   (1)
+#define FRAME_T_OVERHEAD_byte (4)
+#define FRAME_T_TRAILER_byte  (3)
+
+// aOut    aInSize_byte + FRAME_T_OVERHEAD_byte bytes
+// Return  The size of the frame
+extern unsigned int FrameT_Encode(const void* aIn, unsigned int aInSize_byte, void* aOut, unsigned int aOutSize_byte);
+
+// Prepare the bytes going before and after the payload, without copying
+// it. The frame is aHeader, aIn and aTrailer sent one after the other.
+// aHeader   FRAME_T_HEADER_byte bytes
+// aTrailer  FRAME_T_TRAILER_byte bytes
+extern void FrameT_Encode_Segments(const void* aIn, unsigned int aInSize_byte, uint8_t* aHeader, uint8_t* aTrailer);
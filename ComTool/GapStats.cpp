@@ -0,0 +1,145 @@
+// Author    KMS - Martin Dubois, P. Eng.
+// Copyright (C) 2024 KMS
+// License   http://www.apache.org/licenses/LICENSE-2.0
+// Product   KMS-Tools
+// File      ComTool/GapStats.cpp
+
+#include "Component.h"
+
+// ===== Local ==============================================================
+#include "GapStats.h"
+
+// Constants
+// //////////////////////////////////////////////////////////////////////////
+
+#define BAR_LENGTH (40)
+
+// Static function declarations
+// //////////////////////////////////////////////////////////////////////////
+
+static void DisplayTime(std::ostream& aOut, uint64_t aTime_ns);
+
+// Public
+// //////////////////////////////////////////////////////////////////////////
+
+GapStats::GapStats() { Reset(); }
+
+void GapStats::Add(uint64_t aTime_ns)
+{
+    auto lLast_ns = mLast_ns.load(std::memory_order_relaxed);
+
+    mLast_ns.store(aTime_ns, std::memory_order_relaxed);
+
+    if ((0 == lLast_ns) || (lLast_ns > aTime_ns))
+    {
+        return;
+    }
+
+    AddGap(aTime_ns - lLast_ns);
+}
+
+void GapStats::AddGap(uint64_t aGap_ns)
+{
+    unsigned int lBucket = 0;
+
+    for (auto lGap_us = aGap_ns / 1000; (0 < lGap_us) && (BUCKET_QTY - 1 > lBucket); lGap_us >>= 1)
+    {
+        lBucket++;
+    }
+
+    mBuckets[lBucket].fetch_add(1, std::memory_order_relaxed);
+
+    if (mMax_ns.load(std::memory_order_relaxed) < aGap_ns) { mMax_ns.store(aGap_ns, std::memory_order_relaxed); }
+    if (mMin_ns.load(std::memory_order_relaxed) > aGap_ns) { mMin_ns.store(aGap_ns, std::memory_order_relaxed); }
+
+    mCount.fetch_add(1, std::memory_order_relaxed);
+}
+
+uint64_t GapStats::GetMax_ns() const { return mMax_ns.load(std::memory_order_relaxed); }
+
+void GapStats::Merge(const GapStats& aIn)
+{
+    for (unsigned int i = 0; i < BUCKET_QTY; i++)
+    {
+        mBuckets[i].fetch_add(aIn.mBuckets[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+
+    auto lMax_ns = aIn.mMax_ns.load(std::memory_order_relaxed);
+    auto lMin_ns = aIn.mMin_ns.load(std::memory_order_relaxed);
+
+    if (mMax_ns.load(std::memory_order_relaxed) < lMax_ns) { mMax_ns.store(lMax_ns, std::memory_order_relaxed); }
+    if (mMin_ns.load(std::memory_order_relaxed) > lMin_ns) { mMin_ns.store(lMin_ns, std::memory_order_relaxed); }
+
+    mCount.fetch_add(aIn.mCount.load(std::memory_order_relaxed), std::memory_order_relaxed);
+}
+
+void GapStats::Reset()
+{
+    for (auto& lBucket : mBuckets)
+    {
+        lBucket = 0;
+    }
+
+    mCount   = 0;
+    mLast_ns = 0;
+    mMax_ns  = 0;
+    mMin_ns  = UINT64_MAX;
+}
+
+void GapStats::Display(std::ostream& aOut, const char* aName, bool aHistogram) const
+{
+    assert(nullptr != aName);
+
+    uint64_t lCount = mCount;
+
+    aOut << aName << " : " << lCount << " gaps";
+
+    if (0 < lCount)
+    {
+        aOut << ", min ";
+        DisplayTime(aOut, mMin_ns);
+        aOut << ", max ";
+        DisplayTime(aOut, mMax_ns);
+    }
+
+    aOut << "\n";
+
+    if (aHistogram && (0 < lCount))
+    {
+        uint64_t lMax = 0;
+
+        for (const auto& lBucket : mBuckets)
+        {
+            if (lMax < lBucket) { lMax = lBucket; }
+        }
+
+        for (unsigned int i = 0; i < BUCKET_QTY; i++)
+        {
+            uint64_t lValue = mBuckets[i];
+            if (0 == lValue) { continue; }
+
+            char lLine[LINE_LENGTH];
+
+            if (0 == i)
+            {
+                sprintf_s(lLine SizeInfo(lLine), "    %10s - %10u us : %10llu ", "", 1, static_cast<unsigned long long>(lValue));
+            }
+            else
+            {
+                sprintf_s(lLine SizeInfo(lLine), "    %10u - %10u us : %10llu ", 1U << (i - 1), 1U << i, static_cast<unsigned long long>(lValue));
+            }
+
+            aOut << lLine << std::string(static_cast<size_t>((lValue * BAR_LENGTH + lMax - 1) / lMax), '#') << "\n";
+        }
+    }
+}
+
+// Static functions
+// //////////////////////////////////////////////////////////////////////////
+
+void DisplayTime(std::ostream& aOut, uint64_t aTime_ns)
+{
+    if      (10000       > aTime_ns) { aOut << aTime_ns                  << " ns"; }
+    else if (10000000    > aTime_ns) { aOut << aTime_ns / 1000           << " us"; }
+    else                             { aOut << aTime_ns / 1000000        << " ms"; }
+}
@@ -0,0 +1,51 @@
+// Author    KMS - Martin Dubois, P. Eng.
+// Copyright (C) 2024 KMS
+// License   http://www.apache.org/licenses/LICENSE-2.0
+// Product   KMS-Tools
+// File      ComTool/GapStats.h
+
+#pragma once
+
+// ===== C++ ================================================================
+#include <atomic>
+
+// Statistics about the time between consecutive events. Only one thread
+// calls Add. The other threads may display the statistics at any time.
+class GapStats
+{
+
+public:
+
+    // Bucket 0 counts the gaps shorter than 1 us, bucket i the gaps from
+    // 2^(i-1) us to 2^i us.
+    static const unsigned int BUCKET_QTY = 32;
+
+    GapStats();
+
+    // aTime_ns  Clock_GetTime_ns value of the event
+    void Add(uint64_t aTime_ns);
+
+    // Count a gap measured elsewhere
+    void AddGap(uint64_t aGap_ns);
+
+    // Return  0 when there is no gap yet
+    uint64_t GetMax_ns() const;
+
+    // Add the gaps of another instance, when no thread calls its Add
+    void Merge(const GapStats& aIn);
+
+    void Reset();
+
+    void Display(std::ostream& aOut, const char* aName, bool aHistogram) const;
+
+private:
+
+    NO_COPY(GapStats);
+
+    std::atomic<uint64_t> mBuckets[BUCKET_QTY];
+    std::atomic<uint64_t> mCount;
+    std::atomic<uint64_t> mLast_ns;
+    std::atomic<uint64_t> mMax_ns;
+    std::atomic<uint64_t> mMin_ns;
+
+};
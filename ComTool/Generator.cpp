@@ -0,0 +1,150 @@
+// Author    KMS - Martin Dubois, P. Eng.
+// Copyright (C) 2024 KMS
+// License   http://www.apache.org/licenses/LICENSE-2.0
+// Product   KMS-Tools
+// File      ComTool/Generator.cpp
+
+#include "Component.h"
+
+// ===== Local ==============================================================
+#include "Clock.h"
+
+#include "Generator.h"
+
+using namespace KMS;
+
+// Public
+// //////////////////////////////////////////////////////////////////////////
+
+Generator::Generator() : mCount(0), mEnd_ns(UINT64_MAX), mSent(0), mStart_ns(0) {}
+
+unsigned int Generator::AddStream(const void* aIn, unsigned int aInSize_byte, unsigned int aPeriod_us)
+{
+    assert(nullptr != aIn);
+
+    KMS_EXCEPTION_ASSERT(0 < aInSize_byte, RESULT_INVALID_VALUE, "Empty payload", "");
+    KMS_EXCEPTION_ASSERT(0 < aPeriod_us  , RESULT_INVALID_VALUE, "Invalid period", "");
+
+    auto lIn = static_cast<const uint8_t*>(aIn);
+
+    Stream lStream;
+
+    lStream.mCount       = 0;
+    lStream.mData.assign(lIn, lIn + aInSize_byte);
+    lStream.mMaxDrift_ns = 0;
+    lStream.mNext_ns     = 0;
+    lStream.mPeriod_ns   = static_cast<uint64_t>(aPeriod_us) * 1000;
+    lStream.mSkipped     = 0;
+
+    mStreams.push_back(std::move(lStream));
+
+    return static_cast<unsigned int>(mStreams.size() - 1);
+}
+
+const uint8_t* Generator::GetData(unsigned int aStream, unsigned int* aSize_byte) const
+{
+    assert(mStreams.size() > aStream);
+    assert(nullptr != aSize_byte);
+
+    auto& lStream = mStreams[aStream];
+
+    *aSize_byte = static_cast<unsigned int>(lStream.mData.size());
+
+    return lStream.mData.data();
+}
+
+void Generator::Start(uint64_t aCount, unsigned int aDuration_ms)
+{
+    KMS_EXCEPTION_ASSERT(!mStreams.empty(), RESULT_INVALID_STATE, "No stream", "");
+
+    mCount    = aCount;
+    mSent     = 0;
+    mStart_ns = Clock_GetTime_ns();
+    mEnd_ns   = (0 == aDuration_ms) ? UINT64_MAX : mStart_ns + static_cast<uint64_t>(aDuration_ms) * 1000000;
+
+    mDrift.Reset();
+
+    // All the streams send their first payload at the start
+    for (auto& lStream : mStreams)
+    {
+        lStream.mCount       = 0;
+        lStream.mMaxDrift_ns = 0;
+        lStream.mNext_ns     = mStart_ns;
+        lStream.mSkipped     = 0;
+    }
+}
+
+bool Generator::Next(unsigned int* aStream, uint64_t* aDue_ns) const
+{
+    assert(nullptr != aStream);
+    assert(nullptr != aDue_ns);
+
+    if ((0 < mCount) && (mCount <= mSent))
+    {
+        return false;
+    }
+
+    // There are few streams, a linear search costs less than a heap
+    unsigned int lResult = 0;
+
+    for (unsigned int i = 1; i < mStreams.size(); i++)
+    {
+        if (mStreams[lResult].mNext_ns > mStreams[i].mNext_ns)
+        {
+            lResult = i;
+        }
+    }
+
+    *aStream = lResult;
+    *aDue_ns = mStreams[lResult].mNext_ns;
+
+    return mEnd_ns > *aDue_ns;
+}
+
+void Generator::Sent(unsigned int aStream, uint64_t aTime_ns)
+{
+    assert(mStreams.size() > aStream);
+
+    auto& lStream = mStreams[aStream];
+
+    auto lDrift_ns = (lStream.mNext_ns < aTime_ns) ? aTime_ns - lStream.mNext_ns : 0;
+
+    mDrift.Add(lDrift_ns);
+
+    if (lStream.mMaxDrift_ns < lDrift_ns)
+    {
+        lStream.mMaxDrift_ns = lDrift_ns;
+    }
+
+    lStream.mCount++;
+    lStream.mNext_ns += lStream.mPeriod_ns;
+
+    if (lStream.mNext_ns <= aTime_ns)
+    {
+        auto lSkipped = (aTime_ns - lStream.mNext_ns) / lStream.mPeriod_ns + 1;
+
+        lStream.mNext_ns += lSkipped * lStream.mPeriod_ns;
+        lStream.mSkipped += lSkipped;
+    }
+
+    mSent++;
+}
+
+void Generator::Display(std::ostream& aOut) const
+{
+    auto lDuration_ns = Clock_GetTime_ns() - mStart_ns;
+
+    aOut << "Generate : " << mSent << " sends in " << lDuration_ns / 1000000 << " ms\n";
+
+    unsigned int lIndex = 0;
+
+    for (auto& lStream : mStreams)
+    {
+        aOut << "    Stream " << lIndex << " : every " << lStream.mPeriod_ns / 1000 << " us, " << lStream.mData.size() << " bytes, ";
+        aOut << lStream.mCount << " sends, " << lStream.mSkipped << " skipped, max drift " << lStream.mMaxDrift_ns / 1000 << " us\n";
+
+        lIndex++;
+    }
+
+    mDrift.Display(aOut, "    Drift");
+}
@@ -0,0 +1,70 @@
+// Author    KMS - Martin Dubois, P. Eng.
+// Copyright (C) 2024 KMS
+// License   http://www.apache.org/licenses/LICENSE-2.0
+// Product   KMS-Tools
+// File      ComTool/Generator.h
+
+#pragma once
+
+// ===== C++ ================================================================
+#include <vector>
+
+// ===== Local ==============================================================
+#include "LatencyStats.h"
+
+// Fixed period schedule of many payloads, sent by one thread. The
+// deadlines of each stream are computed from the start, so the send delays
+// do not accumulate. A stream late by more than its period skips the missed
+// deadlines rather than sending a burst.
+class Generator
+{
+
+public:
+
+    Generator();
+
+    // aIn     Copied
+    // Return  The index of the stream
+    unsigned int AddStream(const void* aIn, unsigned int aInSize_byte, unsigned int aPeriod_us);
+
+    const uint8_t* GetData(unsigned int aStream, unsigned int* aSize_byte) const;
+
+    // aCount        Total number of sends, 0 means no limit
+    // aDuration_ms  0 means no limit
+    void Start(uint64_t aCount, unsigned int aDuration_ms);
+
+    // aStream  The stream with the earliest deadline
+    // aDue_ns  Its deadline, a Clock_GetTime_ns value
+    // Return   false when the count or the duration is reached
+    bool Next(unsigned int* aStream, uint64_t* aDue_ns) const;
+
+    // aTime_ns  Clock_GetTime_ns value taken just before the write
+    void Sent(unsigned int aStream, uint64_t aTime_ns);
+
+    // One line per stream and the drift distribution
+    void Display(std::ostream& aOut) const;
+
+private:
+
+    NO_COPY(Generator);
+
+    struct Stream
+    {
+        uint64_t             mCount;
+        std::vector<uint8_t> mData;
+        uint64_t             mMaxDrift_ns;
+        uint64_t             mNext_ns;
+        uint64_t             mPeriod_ns;
+        uint64_t             mSkipped;
+    };
+
+    uint64_t mCount;
+    uint64_t mEnd_ns;
+    uint64_t mSent;
+    uint64_t mStart_ns;
+
+    LatencyStats mDrift;
+
+    std::vector<Stream> mStreams;
+
+};
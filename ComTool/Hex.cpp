@@ -0,0 +1,47 @@
+// Author    KMS - Martin Dubois, P. Eng.
+// Copyright (C) 2024 KMS
+// License   http://www.apache.org/licenses/LICENSE-2.0
+// Product   KMS-Tools
+// File      ComTool/Hex.cpp
+
+#include "Component.h"
+
+// ===== Local ==============================================================
+#include "Hex.h"
+
+using namespace KMS;
+
+// Functions
+// //////////////////////////////////////////////////////////////////////////
+
+int Hex_ToDigit(char aIn)
+{
+    if (('0' <= aIn) && ('9' >= aIn)) { return aIn - '0'; }
+    if (('a' <= aIn) && ('f' >= aIn)) { return aIn - 'a' + 10; }
+    if (('A' <= aIn) && ('F' >= aIn)) { return aIn - 'A' + 10; }
+
+    return -1;
+}
+
+unsigned int Hex_ToBytes(const char* aIn, uint8_t* aOut, unsigned int aOutSize_byte)
+{
+    assert(nullptr != aIn);
+    assert(nullptr != aOut);
+
+    auto lLen = static_cast<unsigned int>(strlen(aIn));
+
+    KMS_EXCEPTION_ASSERT((0 < lLen) && (0 == (lLen % 2)), RESULT_INVALID_VALUE, "Invalid hexadecimal data", aIn);
+    KMS_EXCEPTION_ASSERT(lLen / 2 <= aOutSize_byte, RESULT_OUTPUT_TOO_SHORT, "The data is too long", aIn);
+
+    for (unsigned int i = 0; i < lLen; i += 2)
+    {
+        auto lHigh = Hex_ToDigit(aIn[i]);
+        auto lLow  = Hex_ToDigit(aIn[i + 1]);
+
+        KMS_EXCEPTION_ASSERT((0 <= lHigh) && (0 <= lLow), RESULT_INVALID_VALUE, "Invalid hexadecimal data", aIn);
+
+        aOut[i / 2] = static_cast<uint8_t>((lHigh << 4) | lLow);
+    }
+
+    return lLen / 2;
+}
@@ -0,0 +1,15 @@
+// Author    KMS - Martin Dubois, P. Eng.
+// Copyright (C) 2024 KMS
+// License   http://www.apache.org/licenses/LICENSE-2.0
+// Product   KMS-Tools
+// File      ComTool/Hex.h
+
+#pragma once
+
+// Return  The value of the hexadecimal digit, -1 when aIn is not one
+extern int Hex_ToDigit(char aIn);
+
+// aIn  Hexadecimal text, two digits per byte and no separator
+// Return  The number of bytes
+// Exception  RESULT_INVALID_VALUE, RESULT_OUTPUT_TOO_SHORT
+extern unsigned int Hex_ToBytes(const char* aIn, uint8_t* aOut, unsigned int aOutSize_byte);
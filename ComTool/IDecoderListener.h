@@ -0,0 +1,22 @@
+// Author    KMS - Martin Dubois, P. Eng.
+// Copyright (C) 2024 KMS
+// License   http://www.apache.org/licenses/LICENSE-2.0
+// Product   KMS-Tools
+// File      ComTool/IDecoderListener.h
+
+#pragma once
+
+class IDecoderListener
+{
+
+public:
+
+    // aIn    The decoded frame, valid during the call
+    // aInfo  One line description of the frame
+    virtual void OnDecoded(const uint8_t* aIn, unsigned int aInSize_byte, const char* aInfo) = 0;
+
+    // aIn      The rejected bytes, valid during the call
+    // aReason  One line description of the error
+    virtual void OnDecodeError(const uint8_t* aIn, unsigned int aInSize_byte, const char* aReason) = 0;
+
+};
@@ -0,0 +1,28 @@
+// Author    KMS - Martin Dubois, P. Eng.
+// Copyright (C) 2024 KMS
+// License   http://www.apache.org/licenses/LICENSE-2.0
+// Product   KMS-Tools
+// File      ComTool/IDetectTarget.h
+
+#pragma once
+
+// ===== Import/Includes ====================================================
+#include <KMS/Com/Port.h>
+
+// The bytes Detector::Sweep scores come from a port or from generated data
+class IDetectTarget
+{
+
+public:
+
+    // Apply the setting, drop the bytes received with the previous one and
+    // send the probe, if any
+    virtual void OnDetectBegin(uint32_t aSpeed_bps, KMS::Com::Parity aParity) = 0;
+
+    // Return  The number of bytes received, 0 when aTimeout_ms passed
+    //         without data
+    virtual unsigned int OnDetectRead(uint8_t* aOut, unsigned int aOutSize_byte, unsigned int aTimeout_ms) = 0;
+
+    virtual void OnDetectEnd() = 0;
+
+};
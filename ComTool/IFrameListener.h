@@ -0,0 +1,20 @@
+// Author    KMS - Martin Dubois, P. Eng.
+// Copyright (C) 2024 KMS
+// License   http://www.apache.org/licenses/LICENSE-2.0
+// Product   KMS-Tools
+// File      ComTool/IFrameListener.h
+
+#pragma once
+
+class IFrameListener
+{
+
+public:
+
+    // aIn  The payload, without the delimiters and the CRC
+    virtual void OnFrame(const uint8_t* aIn, unsigned int aInSize_byte) = 0;
+
+    // aIn  The whole rejected frame, delimiters included
+    virtual void OnFrameError(const uint8_t* aIn, unsigned int aInSize_byte) = 0;
+
+};
@@ -0,0 +1,19 @@
+// Author    KMS - Martin Dubois, P. Eng.
+// Copyright (C) 2024 KMS
+// License   http://www.apache.org/licenses/LICENSE-2.0
+// Product   KMS-Tools
+// File      ComTool/IMessageListener.h
+
+#pragma once
+
+class IMessageListener
+{
+
+public:
+
+    // aTime_ns    Clock_GetTime_ns value of the first byte
+    // aComplete   false when the message reached the maximum size or when
+    //             the data stopped before its end
+    virtual void OnMessage(const uint8_t* aIn, unsigned int aInSize_byte, uint64_t aTime_ns, bool aComplete) = 0;
+
+};
@@ -0,0 +1,281 @@
+// Author    KMS - Martin Dubois, P. Eng.
+// Copyright (C) 2024 KMS
+// License   http://www.apache.org/licenses/LICENSE-2.0
+// Product   KMS-Tools
+// File      ComTool/LZ.cpp
+
+#include "Component.h"
+
+// ===== Local ==============================================================
+#include "LZ.h"
+
+using namespace KMS;
+
+KMS_RESULT_STATIC(RESULT_DECOMPRESS_FAILED);
+
+// Constants
+// //////////////////////////////////////////////////////////////////////////
+
+// 4096 entries, 16 KiB on the stack
+#define HASH_BITS (12)
+#define HASH_QTY  (1 << HASH_BITS)
+
+// The format requires the last 5 bytes to be literals and the last match to
+// start at least 12 bytes before the end.
+#define LAST_LITERALS_byte (5)
+#define MATCH_LIMIT_byte   (12)
+
+#define MATCH_MIN_byte (4)
+#define OFFSET_MAX     (65535)
+
+#define LENGTH_MASK (15)
+
+// Static function declarations
+// //////////////////////////////////////////////////////////////////////////
+
+static unsigned int Hash(const uint8_t* aIn);
+
+static uint32_t Read32(const uint8_t* aIn);
+
+static uint8_t* WriteLength(uint8_t* aOut, unsigned int aLength);
+
+// Functions
+// //////////////////////////////////////////////////////////////////////////
+
+// Greedy parse, one hash table entry per position
+unsigned int LZ_Compress(const uint8_t* aIn, unsigned int aInSize_byte, uint8_t* aOut, unsigned int aOutSize_byte)
+{
+    assert(nullptr != aIn);
+    assert(nullptr != aOut);
+
+    uint32_t lTable[HASH_QTY];
+
+    memset(&lTable, 0, sizeof(lTable));
+
+    auto lAnchor = aIn;
+    auto lEnd    = aIn + aInSize_byte;
+    auto lIn     = aIn;
+    auto lOut    = aOut;
+    auto lOutEnd = aOut + aOutSize_byte;
+
+    if (MATCH_LIMIT_byte < aInSize_byte)
+    {
+        auto lMatchLimit = lEnd - LAST_LITERALS_byte;
+        auto lStartLimit = lEnd - MATCH_LIMIT_byte;
+
+        while (lStartLimit > lIn)
+        {
+            auto lHash = Hash(lIn);
+            auto lRef  = aIn + lTable[lHash];
+
+            lTable[lHash] = static_cast<uint32_t>(lIn - aIn);
+
+            if ((lRef >= lIn) || (OFFSET_MAX < lIn - lRef) || (Read32(lRef) != Read32(lIn)))
+            {
+                lIn++;
+                continue;
+            }
+
+            while ((lAnchor < lIn) && (aIn < lRef) && (lIn[-1] == lRef[-1]))
+            {
+                lIn--;
+                lRef--;
+            }
+
+            auto lMatchEnd = lIn + MATCH_MIN_byte;
+
+            for (auto lR = lRef + MATCH_MIN_byte; (lMatchLimit > lMatchEnd) && (*lMatchEnd == *lR); lR++)
+            {
+                lMatchEnd++;
+            }
+
+            auto lLiteral_byte = static_cast<unsigned int>(lIn - lAnchor);
+            auto lMatch_byte   = static_cast<unsigned int>(lMatchEnd - lIn) - MATCH_MIN_byte;
+
+            // Token, literals and their length, offset, match length
+            if (lOutEnd - lOut < 1 + lLiteral_byte + lLiteral_byte / 255 + 1 + 2 + lMatch_byte / 255 + 1)
+            {
+                return 0;
+            }
+
+            auto lToken = lOut++;
+
+            *lToken = static_cast<uint8_t>(((LENGTH_MASK <= lLiteral_byte) ? LENGTH_MASK : lLiteral_byte) << 4);
+
+            if (LENGTH_MASK <= lLiteral_byte)
+            {
+                lOut = WriteLength(lOut, lLiteral_byte - LENGTH_MASK);
+            }
+
+            memcpy(lOut, lAnchor, lLiteral_byte);
+
+            lOut += lLiteral_byte;
+
+            auto lOffset = static_cast<unsigned int>(lIn - lRef);
+
+            *lOut++ = static_cast<uint8_t>(lOffset & 0xff);
+            *lOut++ = static_cast<uint8_t>(lOffset >> 8);
+
+            *lToken |= static_cast<uint8_t>((LENGTH_MASK <= lMatch_byte) ? LENGTH_MASK : lMatch_byte);
+
+            if (LENGTH_MASK <= lMatch_byte)
+            {
+                lOut = WriteLength(lOut, lMatch_byte - LENGTH_MASK);
+            }
+
+            lIn     = lMatchEnd;
+            lAnchor = lIn;
+        }
+    }
+
+    // ===== Last literals ==================================================
+    auto lLiteral_byte = static_cast<unsigned int>(lEnd - lAnchor);
+
+    if (lOutEnd - lOut < 1 + lLiteral_byte + lLiteral_byte / 255 + 1)
+    {
+        return 0;
+    }
+
+    *lOut++ = static_cast<uint8_t>(((LENGTH_MASK <= lLiteral_byte) ? LENGTH_MASK : lLiteral_byte) << 4);
+
+    if (LENGTH_MASK <= lLiteral_byte)
+    {
+        lOut = WriteLength(lOut, lLiteral_byte - LENGTH_MASK);
+    }
+
+    memcpy(lOut, lAnchor, lLiteral_byte);
+
+    lOut += lLiteral_byte;
+
+    return static_cast<unsigned int>(lOut - aOut);
+}
+
+unsigned int LZ_Decompress(const uint8_t* aIn, unsigned int aInSize_byte, uint8_t* aOut, unsigned int aOutSize_byte)
+{
+    assert(nullptr != aIn);
+    assert(nullptr != aOut);
+
+    auto lIn     = aIn;
+    auto lInEnd  = aIn + aInSize_byte;
+    auto lOut    = aOut;
+    auto lOutEnd = aOut + aOutSize_byte;
+
+    while (lInEnd > lIn)
+    {
+        auto lToken = *lIn++;
+
+        // ===== Literals ===================================================
+        unsigned int lLiteral_byte = lToken >> 4;
+
+        if (LENGTH_MASK == lLiteral_byte)
+        {
+            uint8_t lByte;
+
+            do
+            {
+                KMS_EXCEPTION_ASSERT(lInEnd > lIn, RESULT_DECOMPRESS_FAILED, "Corrupted block", "");
+
+                lByte = *lIn++;
+
+                lLiteral_byte += lByte;
+            }
+            while (255 == lByte);
+        }
+
+        KMS_EXCEPTION_ASSERT(lInEnd - lIn >= lLiteral_byte, RESULT_DECOMPRESS_FAILED, "Corrupted block", "");
+        KMS_EXCEPTION_ASSERT(lOutEnd - lOut >= lLiteral_byte, RESULT_DECOMPRESS_FAILED, "The output buffer is too short", aOutSize_byte);
+
+        memcpy(lOut, lIn, lLiteral_byte);
+
+        lIn  += lLiteral_byte;
+        lOut += lLiteral_byte;
+
+        // The last sequence has no match
+        if (lInEnd == lIn)
+        {
+            break;
+        }
+
+        // ===== Match ======================================================
+        KMS_EXCEPTION_ASSERT(2 <= lInEnd - lIn, RESULT_DECOMPRESS_FAILED, "Corrupted block", "");
+
+        unsigned int lOffset = lIn[0] | (static_cast<unsigned int>(lIn[1]) << 8);
+
+        lIn += 2;
+
+        KMS_EXCEPTION_ASSERT((0 < lOffset) && (lOut - aOut >= lOffset), RESULT_DECOMPRESS_FAILED, "Corrupted block", lOffset);
+
+        unsigned int lMatch_byte = lToken & LENGTH_MASK;
+
+        if (LENGTH_MASK == lMatch_byte)
+        {
+            uint8_t lByte;
+
+            do
+            {
+                KMS_EXCEPTION_ASSERT(lInEnd > lIn, RESULT_DECOMPRESS_FAILED, "Corrupted block", "");
+
+                lByte = *lIn++;
+
+                lMatch_byte += lByte;
+            }
+            while (255 == lByte);
+        }
+
+        lMatch_byte += MATCH_MIN_byte;
+
+        KMS_EXCEPTION_ASSERT(lOutEnd - lOut >= lMatch_byte, RESULT_DECOMPRESS_FAILED, "The output buffer is too short", aOutSize_byte);
+
+        auto lRef = lOut - lOffset;
+
+        if (lOffset >= lMatch_byte)
+        {
+            memcpy(lOut, lRef, lMatch_byte);
+
+            lOut += lMatch_byte;
+        }
+        else
+        {
+            // The match repeats the bytes it is writing
+            for (unsigned int i = 0; i < lMatch_byte; i++)
+            {
+                *lOut++ = *lRef++;
+            }
+        }
+    }
+
+    return static_cast<unsigned int>(lOut - aOut);
+}
+
+// Static functions
+// //////////////////////////////////////////////////////////////////////////
+
+unsigned int Hash(const uint8_t* aIn)
+{
+    return (Read32(aIn) * 2654435761U) >> (32 - HASH_BITS);
+}
+
+uint32_t Read32(const uint8_t* aIn)
+{
+    uint32_t lResult;
+
+    memcpy(&lResult, aIn, sizeof(lResult));
+
+    return lResult;
+}
+
+uint8_t* WriteLength(uint8_t* aOut, unsigned int aLength)
+{
+    assert(nullptr != aOut);
+
+    while (255 <= aLength)
+    {
+        *aOut++ = 255;
+
+        aLength -= 255;
+    }
+
+    *aOut++ = static_cast<uint8_t>(aLength);
+
+    return aOut;
+}
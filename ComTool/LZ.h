@@ -0,0 +1,19 @@
+// Author    KMS - Martin Dubois, P. Eng.
+// Copyright (C) 2024 KMS
+// License   http://www.apache.org/licenses/LICENSE-2.0
+// Product   KMS-Tools
+// File      ComTool/LZ.h
+
+#pragma once
+
+// Fast block compression, LZ4 block format. One block is compressed or
+// decompressed at once, there is no streaming state.
+
+// Return  The size of the compressed block, 0 when it does not fit in the
+//         output buffer
+extern unsigned int LZ_Compress(const uint8_t* aIn, unsigned int aInSize_byte, uint8_t* aOut, unsigned int aOutSize_byte);
+
+// Exception  RESULT_DECOMPRESS_FAILED  The block is corrupted or does not
+//                                      fit in the output buffer
+// Return  The size of the decompressed block
+extern unsigned int LZ_Decompress(const uint8_t* aIn, unsigned int aInSize_byte, uint8_t* aOut, unsigned int aOutSize_byte);
@@ -0,0 +1,147 @@
+// Author    KMS - Martin Dubois, P. Eng.
+// Copyright (C) 2024 KMS
+// License   http://www.apache.org/licenses/LICENSE-2.0
+// Product   KMS-Tools
+// File      ComTool/LatencyStats.cpp
+
+#include "Component.h"
+
+// ===== Local ==============================================================
+#include "LatencyStats.h"
+
+// Static function declarations
+// //////////////////////////////////////////////////////////////////////////
+
+static void DisplayTime(std::ostream& aOut, uint64_t aTime_ns);
+
+static unsigned int GetBucket(uint64_t aValue_ns);
+
+// Middle of the values the bucket counts
+static uint64_t GetBucketValue(unsigned int aBucket);
+
+// Public
+// //////////////////////////////////////////////////////////////////////////
+
+LatencyStats::LatencyStats() { Reset(); }
+
+void LatencyStats::Add(uint64_t aDuration_ns)
+{
+    mBuckets[GetBucket(aDuration_ns)].fetch_add(1, std::memory_order_relaxed);
+
+    if (mMax_ns.load(std::memory_order_relaxed) < aDuration_ns) { mMax_ns.store(aDuration_ns, std::memory_order_relaxed); }
+
+    mCount.fetch_add(1, std::memory_order_relaxed);
+}
+
+uint64_t LatencyStats::GetCount() const { return mCount; }
+
+uint64_t LatencyStats::GetMax_ns() const { return mMax_ns; }
+
+uint64_t LatencyStats::GetPercentile_ns(double aPercent) const
+{
+    uint64_t lCount = mCount;
+    if (0 == lCount)
+    {
+        return 0;
+    }
+
+    auto lRank = static_cast<uint64_t>(aPercent * lCount / 100.0);
+    if (lCount <= lRank)
+    {
+        lRank = lCount - 1;
+    }
+
+    uint64_t lSum = 0;
+
+    for (unsigned int i = 0; i < BUCKET_QTY; i++)
+    {
+        lSum += mBuckets[i];
+        if (lRank < lSum)
+        {
+            auto lResult_ns = GetBucketValue(i);
+
+            // The bucket may extend past the largest value
+            return (mMax_ns < lResult_ns) ? mMax_ns.load() : lResult_ns;
+        }
+    }
+
+    return mMax_ns;
+}
+
+void LatencyStats::Reset()
+{
+    for (auto& lBucket : mBuckets)
+    {
+        lBucket = 0;
+    }
+
+    mCount  = 0;
+    mMax_ns = 0;
+}
+
+void LatencyStats::Display(std::ostream& aOut, const char* aName) const
+{
+    assert(nullptr != aName);
+
+    uint64_t lCount = mCount;
+
+    aOut << aName << " : " << lCount << " samples";
+
+    if (0 < lCount)
+    {
+        aOut << ", p50 ";
+        DisplayTime(aOut, GetPercentile_ns(50.0));
+        aOut << ", p99 ";
+        DisplayTime(aOut, GetPercentile_ns(99.0));
+        aOut << ", max ";
+        DisplayTime(aOut, mMax_ns);
+    }
+
+    aOut << "\n";
+}
+
+// Static functions
+// //////////////////////////////////////////////////////////////////////////
+
+void DisplayTime(std::ostream& aOut, uint64_t aTime_ns)
+{
+    if      (10000       > aTime_ns) { aOut << aTime_ns                  << " ns"; }
+    else if (10000000    > aTime_ns) { aOut << aTime_ns / 1000           << " us"; }
+    else                             { aOut << aTime_ns / 1000000        << " ms"; }
+}
+
+// The values below 16 have their own bucket. Above, the 4 bits following
+// the most significant one select the bucket in the power of 2.
+unsigned int GetBucket(uint64_t aValue_ns)
+{
+    if (16 > aValue_ns)
+    {
+        return static_cast<unsigned int>(aValue_ns);
+    }
+
+    unsigned int lExp = 4;
+
+    while ((aValue_ns >> (lExp + 1)) != 0)
+    {
+        lExp++;
+    }
+
+    auto lSub = static_cast<unsigned int>((aValue_ns >> (lExp - 4)) & 0xf);
+
+    return (lExp - 3) * 16 + lSub;
+}
+
+uint64_t GetBucketValue(unsigned int aBucket)
+{
+    if (16 > aBucket)
+    {
+        return aBucket;
+    }
+
+    unsigned int lExp = aBucket / 16 + 3;
+    unsigned int lSub = aBucket % 16;
+
+    auto lLow_ns = static_cast<uint64_t>(16 + lSub) << (lExp - 4);
+
+    return lLow_ns + ((1ULL << (lExp - 4)) >> 1);
+}
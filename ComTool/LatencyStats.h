@@ -0,0 +1,49 @@
+// Author    KMS - Martin Dubois, P. Eng.
+// Copyright (C) 2024 KMS
+// License   http://www.apache.org/licenses/LICENSE-2.0
+// Product   KMS-Tools
+// File      ComTool/LatencyStats.h
+
+#pragma once
+
+// ===== C++ ================================================================
+#include <atomic>
+
+// Distribution of durations, precise enough to report percentiles. Each
+// power of 2 is split into 16 buckets, so a percentile is within 1/16 of
+// the real value whatever the magnitude. Only one thread calls Add. The
+// other threads may read the statistics at any time.
+class LatencyStats
+{
+
+public:
+
+    LatencyStats();
+
+    void Add(uint64_t aDuration_ns);
+
+    uint64_t GetCount() const;
+
+    uint64_t GetMax_ns() const;
+
+    // aPercent  0.0 to 100.0
+    // Return    0 when the distribution is empty
+    uint64_t GetPercentile_ns(double aPercent) const;
+
+    void Reset();
+
+    // One line: count, p50, p99 and maximum
+    void Display(std::ostream& aOut, const char* aName) const;
+
+private:
+
+    NO_COPY(LatencyStats);
+
+    static const unsigned int SUB_BUCKET_QTY = 16;
+    static const unsigned int BUCKET_QTY     = 61 * SUB_BUCKET_QTY;
+
+    std::atomic<uint64_t> mBuckets[BUCKET_QTY];
+    std::atomic<uint64_t> mCount;
+    std::atomic<uint64_t> mMax_ns;
+
+};
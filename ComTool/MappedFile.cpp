@@ -0,0 +1,110 @@
+// Author    KMS - Martin Dubois, P. Eng.
+// Copyright (C) 2024 KMS
+// License   http://www.apache.org/licenses/LICENSE-2.0
+// Product   KMS-Tools
+// File      ComTool/MappedFile.cpp
+
+#include "Component.h"
+
+// ===== C ==================================================================
+#ifdef _KMS_WINDOWS_
+    #include <Windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+// ===== Local ==============================================================
+#include "MappedFile.h"
+
+using namespace KMS;
+
+KMS_RESULT_STATIC(RESULT_MAP_FAILED);
+
+// Public
+// //////////////////////////////////////////////////////////////////////////
+
+MappedFile::MappedFile(const char* aFileName) : mData(nullptr), mSize_byte(0)
+{
+    assert(nullptr != aFileName);
+
+    #ifdef _KMS_WINDOWS_
+
+        auto lFile = CreateFileA(aFileName, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        KMS_EXCEPTION_ASSERT(INVALID_HANDLE_VALUE != lFile, RESULT_MAP_FAILED, "Cannot open the file", aFileName);
+
+        LARGE_INTEGER lSize;
+
+        if (!GetFileSizeEx(lFile, &lSize))
+        {
+            CloseHandle(lFile);
+            KMS_EXCEPTION(RESULT_MAP_FAILED, "Cannot retrieve the file size", aFileName);
+        }
+
+        mSize_byte = lSize.QuadPart;
+
+        if (0 < mSize_byte)
+        {
+            // The view keeps the mapping and the file open
+            auto lMapping = CreateFileMappingA(lFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            if (nullptr != lMapping)
+            {
+                mData = static_cast<const uint8_t*>(MapViewOfFile(lMapping, FILE_MAP_READ, 0, 0, 0));
+
+                CloseHandle(lMapping);
+            }
+        }
+
+        CloseHandle(lFile);
+
+    #else
+
+        auto lFile = open(aFileName, O_RDONLY);
+        KMS_EXCEPTION_ASSERT(0 <= lFile, RESULT_MAP_FAILED, "Cannot open the file", aFileName);
+
+        struct stat lStat;
+
+        if (0 != fstat(lFile, &lStat))
+        {
+            close(lFile);
+            KMS_EXCEPTION(RESULT_MAP_FAILED, "Cannot retrieve the file size", aFileName);
+        }
+
+        mSize_byte = lStat.st_size;
+
+        if (0 < mSize_byte)
+        {
+            // The mapping keeps the file open
+            auto lData = mmap(nullptr, mSize_byte, PROT_READ, MAP_PRIVATE, lFile, 0);
+            if (MAP_FAILED != lData)
+            {
+                madvise(lData, mSize_byte, MADV_SEQUENTIAL);
+
+                mData = static_cast<const uint8_t*>(lData);
+            }
+        }
+
+        close(lFile);
+
+    #endif
+
+    KMS_EXCEPTION_ASSERT((0 == mSize_byte) || (nullptr != mData), RESULT_MAP_FAILED, "Cannot map the file", aFileName);
+}
+
+MappedFile::~MappedFile()
+{
+    if (nullptr != mData)
+    {
+        #ifdef _KMS_WINDOWS_
+            UnmapViewOfFile(mData);
+        #else
+            munmap(const_cast<uint8_t*>(mData), mSize_byte);
+        #endif
+    }
+}
+
+const uint8_t* MappedFile::GetData() const { return mData; }
+
+uint64_t MappedFile::GetSize_byte() const { return mSize_byte; }
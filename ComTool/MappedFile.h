@@ -0,0 +1,33 @@
+// Author    KMS - Martin Dubois, P. Eng.
+// Copyright (C) 2024 KMS
+// License   http://www.apache.org/licenses/LICENSE-2.0
+// Product   KMS-Tools
+// File      ComTool/MappedFile.h
+
+#pragma once
+
+// Read only view of a complete file. The data is read from the disk the
+// first time it is accessed, so sending a file from the view never copies
+// it into an intermediate buffer.
+class MappedFile
+{
+
+public:
+
+    MappedFile(const char* aFileName);
+
+    ~MappedFile();
+
+    // nullptr when the file is empty
+    const uint8_t* GetData() const;
+
+    uint64_t GetSize_byte() const;
+
+private:
+
+    NO_COPY(MappedFile);
+
+    const uint8_t* mData;
+    uint64_t       mSize_byte;
+
+};
@@ -0,0 +1,358 @@
+// Author    KMS - Martin Dubois, P. Eng.
+// Copyright (C) 2024 KMS
+// License   http://www.apache.org/licenses/LICENSE-2.0
+// Product   KMS-Tools
+// File      ComTool/Matcher.cpp
+
+#include "Component.h"
+
+// ===== C++ ================================================================
+#include <algorithm>
+#include <queue>
+
+// ===== Local ==============================================================
+#include "Hex.h"
+
+#include "Matcher.h"
+
+using namespace KMS;
+
+// Constants
+// //////////////////////////////////////////////////////////////////////////
+
+const unsigned int Matcher::NO_MATCH = 0xffffffff;
+
+// Static function declarations
+// //////////////////////////////////////////////////////////////////////////
+
+static bool ToNibble(char aIn, uint8_t* aValue, uint8_t* aMask);
+
+// Public
+// //////////////////////////////////////////////////////////////////////////
+
+Matcher::Matcher() : mCompiled(false), mHistoryMask(0), mPos(0), mState(0)
+{
+    mNodes.emplace_back();
+
+    std::fill(mNodes[0].mNext, mNodes[0].mNext + 256, -1);
+
+    mNodes[0].mFail = 0;
+}
+
+unsigned int Matcher::AddPattern(const uint8_t* aValues, const uint8_t* aMasks, unsigned int aSize_byte)
+{
+    assert(nullptr != aValues);
+
+    assert(!mCompiled);
+
+    KMS_EXCEPTION_ASSERT(0 < aSize_byte, RESULT_INVALID_VALUE, "Empty pattern", "");
+
+    auto lResult = static_cast<unsigned int>(mPatterns.size());
+
+    Pattern lPattern;
+
+    lPattern.mMasks .resize(aSize_byte);
+    lPattern.mValues.resize(aSize_byte);
+
+    // The anchor is the longest run of fully specified bytes
+    unsigned int lAnchor      = 0;
+    unsigned int lAnchor_byte = 0;
+    unsigned int lRun_byte    = 0;
+
+    for (unsigned int i = 0; i < aSize_byte; i++)
+    {
+        uint8_t lMask = (nullptr == aMasks) ? 0xff : aMasks[i];
+
+        lPattern.mMasks [i] = lMask;
+        lPattern.mValues[i] = aValues[i] & lMask;
+
+        lRun_byte = (0xff == lMask) ? lRun_byte + 1 : 0;
+
+        if (lAnchor_byte < lRun_byte)
+        {
+            lAnchor      = i + 1 - lRun_byte;
+            lAnchor_byte = lRun_byte;
+        }
+    }
+
+    lPattern.mTail_byte = aSize_byte - lAnchor - lAnchor_byte;
+
+    if (0 == lAnchor_byte)
+    {
+        mUnanchored.push_back(lResult);
+    }
+    else
+    {
+        int32_t lNode = 0;
+
+        for (unsigned int i = lAnchor; i < lAnchor + lAnchor_byte; i++)
+        {
+            auto lByte = lPattern.mValues[i];
+
+            if (0 > mNodes[lNode].mNext[lByte])
+            {
+                mNodes[lNode].mNext[lByte] = static_cast<int32_t>(mNodes.size());
+
+                mNodes.emplace_back();
+
+                std::fill(mNodes.back().mNext, mNodes.back().mNext + 256, -1);
+            }
+
+            lNode = mNodes[lNode].mNext[lByte];
+        }
+
+        mNodes[lNode].mOutputs.push_back(lResult);
+    }
+
+    mPatterns.push_back(lPattern);
+
+    return lResult;
+}
+
+unsigned int Matcher::AddPattern_ASCII(const char* aIn)
+{
+    assert(nullptr != aIn);
+
+    return AddPattern(reinterpret_cast<const uint8_t*>(aIn), nullptr, static_cast<unsigned int>(strlen(aIn)));
+}
+
+unsigned int Matcher::AddPattern_Hex(const char* aIn)
+{
+    assert(nullptr != aIn);
+
+    auto lSize = static_cast<unsigned int>(strlen(aIn));
+
+    KMS_EXCEPTION_ASSERT(0 == (lSize % 2), RESULT_INVALID_VALUE, "Incomplete byte in the pattern", aIn);
+
+    std::vector<uint8_t> lMasks (lSize / 2);
+    std::vector<uint8_t> lValues(lSize / 2);
+
+    for (unsigned int i = 0; i < lSize / 2; i++)
+    {
+        uint8_t lHM, lHV, lLM, lLV;
+
+        KMS_EXCEPTION_ASSERT(ToNibble(aIn[2 * i], &lHV, &lHM) && ToNibble(aIn[2 * i + 1], &lLV, &lLM), RESULT_INVALID_VALUE, "Invalid character in the pattern", aIn);
+
+        lMasks [i] = (lHM << 4) | lLM;
+        lValues[i] = (lHV << 4) | lLV;
+    }
+
+    return AddPattern(lValues.data(), lMasks.data(), lSize / 2);
+}
+
+// Breadth first traversal setting the fail links, then every missing
+// transition is replaced by the transition of the fail node. Scan then
+// follows exactly one transition per byte.
+void Matcher::Compile()
+{
+    assert(!mCompiled);
+
+    std::queue<int32_t> lQueue;
+
+    for (unsigned int c = 0; c < 256; c++)
+    {
+        auto& lNext = mNodes[0].mNext[c];
+
+        if (0 > lNext)
+        {
+            lNext = 0;
+        }
+        else
+        {
+            mNodes[lNext].mFail = 0;
+
+            lQueue.push(lNext);
+        }
+    }
+
+    while (!lQueue.empty())
+    {
+        auto lNode = lQueue.front(); lQueue.pop();
+
+        for (unsigned int c = 0; c < 256; c++)
+        {
+            auto lNext = mNodes[lNode].mNext[c];
+            auto lFail = mNodes[mNodes[lNode].mFail].mNext[c];
+
+            if (0 > lNext)
+            {
+                mNodes[lNode].mNext[c] = lFail;
+            }
+            else
+            {
+                mNodes[lNext].mFail = lFail;
+
+                const auto& lOutputs = mNodes[lFail].mOutputs;
+
+                mNodes[lNext].mOutputs.insert(mNodes[lNext].mOutputs.end(), lOutputs.begin(), lOutputs.end());
+
+                lQueue.push(lNext);
+            }
+        }
+    }
+
+    unsigned int lMax_byte = 1;
+
+    for (const auto& lPattern : mPatterns)
+    {
+        while (lMax_byte < lPattern.mValues.size())
+        {
+            lMax_byte <<= 1;
+        }
+    }
+
+    mHistory.resize(lMax_byte);
+    mHistoryMask = lMax_byte - 1;
+
+    mCompiled = true;
+
+    Reset();
+}
+
+void Matcher::Reset()
+{
+    mCandidates.clear();
+
+    mPos   = 0;
+    mState = 0;
+}
+
+unsigned int Matcher::Scan(const void* aIn, unsigned int aInSize_byte, unsigned int* aPattern)
+{
+    assert(nullptr != aIn);
+    assert(nullptr != aPattern);
+
+    assert(mCompiled);
+
+    auto lIn = static_cast<const uint8_t*>(aIn);
+
+    unsigned int lResult = NO_MATCH;
+
+    // Local copies, the history writes would otherwise force the compiler
+    // to reload the members for each byte.
+    auto lHistory = mHistory.data();
+    auto lNodes   = mNodes.data();
+    auto lPos     = mPos;
+    auto lState   = mState;
+
+    unsigned int i;
+
+    for (i = 0; i < aInSize_byte; i++)
+    {
+        auto lByte = lIn[i];
+
+        lHistory[lPos & mHistoryMask] = lByte;
+
+        lState = lNodes[lState].mNext[lByte];
+
+        for (auto lPattern : lNodes[lState].mOutputs)
+        {
+            auto lTail_byte = mPatterns[lPattern].mTail_byte;
+
+            if (0 == lTail_byte)
+            {
+                Check(lPos, lPattern, &lResult);
+            }
+            else
+            {
+                mCandidates.push_back({ lPos + lTail_byte, lPattern });
+            }
+        }
+
+        if (!mCandidates.empty())
+        {
+            for (const auto& lCandidate : mCandidates)
+            {
+                if (lPos == lCandidate.mEnd)
+                {
+                    Check(lPos, lCandidate.mPattern, &lResult);
+                }
+            }
+
+            mCandidates.erase(std::remove_if(mCandidates.begin(), mCandidates.end(), [lPos](const Candidate& aC) { return lPos >= aC.mEnd; }), mCandidates.end());
+        }
+
+        for (auto lPattern : mUnanchored)
+        {
+            Check(lPos, lPattern, &lResult);
+        }
+
+        lPos++;
+
+        if (NO_MATCH != lResult)
+        {
+            i++;
+            break;
+        }
+    }
+
+    mPos   = lPos;
+    mState = lState;
+
+    *aPattern = lResult;
+
+    return i;
+}
+
+// Private
+// //////////////////////////////////////////////////////////////////////////
+
+// When several patterns end on the same byte, the lowest index wins
+void Matcher::Check(uint64_t aPos, unsigned int aPattern, unsigned int* aResult) const
+{
+    if ((*aResult > aPattern) && Verify(aPos, aPattern))
+    {
+        *aResult = aPattern;
+    }
+}
+
+bool Matcher::Verify(uint64_t aEnd, unsigned int aPattern) const
+{
+    const auto& lPattern = mPatterns[aPattern];
+
+    auto lSize_byte = lPattern.mValues.size();
+
+    if (aEnd + 1 < lSize_byte)
+    {
+        return false;
+    }
+
+    auto lBegin = aEnd + 1 - lSize_byte;
+
+    for (unsigned int i = 0; i < lSize_byte; i++)
+    {
+        if ((mHistory[(lBegin + i) & mHistoryMask] & lPattern.mMasks[i]) != lPattern.mValues[i])
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// Static functions
+// //////////////////////////////////////////////////////////////////////////
+
+bool ToNibble(char aIn, uint8_t* aValue, uint8_t* aMask)
+{
+    assert(nullptr != aValue);
+    assert(nullptr != aMask);
+
+    if ('?' == aIn)
+    {
+        *aMask  = 0;
+        *aValue = 0;
+        return true;
+    }
+
+    auto lDigit = Hex_ToDigit(aIn);
+    if (0 > lDigit)
+    {
+        return false;
+    }
+
+    *aMask  = 0xf;
+    *aValue = static_cast<uint8_t>(lDigit);
+
+    return true;
+}
@@ -0,0 +1,95 @@
+// Author    KMS - Martin Dubois, P. Eng.
+// Copyright (C) 2024 KMS
+// License   http://www.apache.org/licenses/LICENSE-2.0
+// Product   KMS-Tools
+// File      ComTool/Matcher.h
+
+#pragma once
+
+// ===== C++ ================================================================
+#include <vector>
+
+// Incremental search of a set of patterns. Each pattern byte has a mask, so
+// patterns may contain wildcards. The longest fully specified part of each
+// pattern (the anchor) goes into an Aho-Corasick automaton. When an anchor
+// is found, the complete pattern is verified against the history once its
+// last byte is received.
+class Matcher
+{
+
+public:
+
+    static const unsigned int NO_MATCH;
+
+    Matcher();
+
+    // aMasks  nullptr means all the bits of all the bytes are significant
+    // Return  The index of the pattern
+    unsigned int AddPattern(const uint8_t* aValues, const uint8_t* aMasks, unsigned int aSize_byte);
+
+    unsigned int AddPattern_ASCII(const char* aIn);
+
+    // Pairs of hexadecimal digits, without separator. A '?' replaces any
+    // digit, so "??" matches any byte and "4?" any byte from 0x40 to 0x4f.
+    unsigned int AddPattern_Hex(const char* aIn);
+
+    // Build the automaton, call it after adding the patterns
+    void Compile();
+
+    // Restart the search, the patterns stay
+    void Reset();
+
+    // aPattern  The index of the pattern or NO_MATCH
+    // Return    The number of bytes processed. When a pattern matches, the
+    //           processing stops after its last byte.
+    unsigned int Scan(const void* aIn, unsigned int aInSize_byte, unsigned int* aPattern);
+
+private:
+
+    NO_COPY(Matcher);
+
+    struct Candidate
+    {
+        uint64_t     mEnd;
+        unsigned int mPattern;
+    };
+
+    struct Node
+    {
+        int32_t mNext[256];
+        int32_t mFail;
+
+        // The patterns with an anchor ending at this node, directly or
+        // through the fail links
+        std::vector<unsigned int> mOutputs;
+    };
+
+    struct Pattern
+    {
+        std::vector<uint8_t> mMasks;
+        std::vector<uint8_t> mValues;
+
+        // Number of bytes after the anchor
+        unsigned int mTail_byte;
+    };
+
+    void Check(uint64_t aPos, unsigned int aPattern, unsigned int* aResult) const;
+
+    bool Verify(uint64_t aEnd, unsigned int aPattern) const;
+
+    bool mCompiled;
+
+    std::vector<Node>         mNodes;
+    std::vector<Pattern>      mPatterns;
+    std::vector<unsigned int> mUnanchored;
+
+    // ===== Search state ===================================================
+    std::vector<Candidate> mCandidates;
+
+    std::vector<uint8_t> mHistory;
+    unsigned int         mHistoryMask;
+
+    uint64_t mPos;
+    int32_t  mState;
+
+};
@@ -0,0 +1,166 @@
+// Author    KMS - Martin Dubois, P. Eng.
+// Copyright (C) 2024 KMS
+// License   http://www.apache.org/licenses/LICENSE-2.0
+// Product   KMS-Tools
+// File      ComTool/PRBS.cpp
+
+#include "Component.h"
+
+// ===== Local ==============================================================
+#include "PRBS.h"
+
+using namespace KMS;
+
+// Constants
+// //////////////////////////////////////////////////////////////////////////
+
+// The checker synchronizes again when more than a quarter of the bytes of a
+// window are wrong. Random data gives about all bytes wrong.
+#define WINDOW_byte        (64)
+#define WINDOW_ERRORS_byte (WINDOW_byte / 4)
+
+// Static function declarations
+// //////////////////////////////////////////////////////////////////////////
+
+static unsigned int CountBits(uint8_t aIn);
+
+// Public
+// //////////////////////////////////////////////////////////////////////////
+
+PRBS::PRBS(unsigned int aOrder) : mOrder(aOrder)
+{
+    switch (aOrder)
+    {
+    case  7: mTap =  6; break;
+    case 15: mTap = 14; break;
+    case 31: mTap = 28; break;
+
+    default: KMS_EXCEPTION(RESULT_INVALID_VALUE, "Invalid PRBS order (7, 15 or 31)", aOrder);
+    }
+
+    mMask = (1U << aOrder) - 1;
+
+    Reset();
+}
+
+unsigned int PRBS::GetOrder() const { return mOrder; }
+
+void PRBS::Generate(void* aOut, unsigned int aOutSize_byte)
+{
+    assert(nullptr != aOut);
+
+    auto lOut = static_cast<uint8_t*>(aOut);
+
+    for (unsigned int i = 0; i < aOutSize_byte; i++)
+    {
+        lOut[i] = NextByte();
+    }
+}
+
+void PRBS::Check(const void* aIn, unsigned int aInSize_byte)
+{
+    assert(nullptr != aIn);
+
+    auto lIn = static_cast<const uint8_t*>(aIn);
+
+    for (unsigned int i = 0; i < aInSize_byte; i++)
+    {
+        auto lByte = lIn[i];
+
+        if (mOrder > mSync_bit)
+        {
+            // The state of a Fibonacci LFSR is its last output bits, so the
+            // received bits become the state.
+            for (unsigned int b = 0; (b < 8) && (mOrder > mSync_bit); b++)
+            {
+                mState = ((mState << 1) | ((lByte >> b) & 1)) & mMask;
+                mSync_bit++;
+            }
+
+            // The bits of the byte following the synchronization are not
+            // checked, the next byte starts on a byte boundary.
+            if (mOrder <= mSync_bit)
+            {
+                for (unsigned int b = (mOrder % 8); (0 != b) && (b < 8); b++)
+                {
+                    auto lBit = ((mState >> (mOrder - 1)) ^ (mState >> (mTap - 1))) & 1;
+
+                    mState = ((mState << 1) | lBit) & mMask;
+                }
+            }
+
+            continue;
+        }
+
+        mByteCount++;
+
+        auto lErrors = CountBits(lByte ^ NextByte());
+        if (0 < lErrors)
+        {
+            mBitErrorCount += lErrors;
+            mByteErrorCount++;
+            mWindowErrors_byte++;
+        }
+
+        mWindow_byte++;
+        if (WINDOW_byte <= mWindow_byte)
+        {
+            if (WINDOW_ERRORS_byte < mWindowErrors_byte)
+            {
+                mSyncLossCount++;
+                mSync_bit = 0;
+            }
+
+            mWindow_byte       = 0;
+            mWindowErrors_byte = 0;
+        }
+    }
+}
+
+void PRBS::Reset()
+{
+    mBitErrorCount  = 0;
+    mByteCount      = 0;
+    mByteErrorCount = 0;
+    mSyncLossCount  = 0;
+
+    mState = mMask;
+
+    mSync_bit          = 0;
+    mWindow_byte       = 0;
+    mWindowErrors_byte = 0;
+}
+
+// Private
+// //////////////////////////////////////////////////////////////////////////
+
+uint8_t PRBS::NextByte()
+{
+    uint8_t lResult = 0;
+
+    for (unsigned int b = 0; b < 8; b++)
+    {
+        auto lBit = ((mState >> (mOrder - 1)) ^ (mState >> (mTap - 1))) & 1;
+
+        mState = ((mState << 1) | lBit) & mMask;
+
+        lResult |= lBit << b;
+    }
+
+    return lResult;
+}
+
+// Static functions
+// //////////////////////////////////////////////////////////////////////////
+
+unsigned int CountBits(uint8_t aIn)
+{
+    unsigned int lResult = 0;
+
+    for (uint8_t lIn = aIn; 0 != lIn; lIn &= lIn - 1)
+    {
+        lResult++;
+    }
+
+    return lResult;
+}
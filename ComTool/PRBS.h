@@ -0,0 +1,53 @@
+// Author    KMS - Martin Dubois, P. Eng.
+// Copyright (C) 2024 KMS
+// License   http://www.apache.org/licenses/LICENSE-2.0
+// Product   KMS-Tools
+// File      ComTool/PRBS.h
+
+#pragma once
+
+// Pseudo random bit sequence (ITU-T O.150) generator and checker. PRBS-7
+// uses x^7 + x^6 + 1, PRBS-15 x^15 + x^14 + 1 and PRBS-31 x^31 + x^28 + 1.
+// The bits go in the bytes LSB first, the order of the serial line.
+class PRBS
+{
+
+public:
+
+    // aOrder  7, 15 or 31
+    PRBS(unsigned int aOrder);
+
+    unsigned int GetOrder() const;
+
+    void Generate(void* aOut, unsigned int aOutSize_byte);
+
+    // The checker synchronizes on the first received bits, then compares
+    // the received bits with its own sequence. It synchronizes again when
+    // too many bytes are wrong, after lost or inserted bytes for example.
+    void Check(const void* aIn, unsigned int aInSize_byte);
+
+    void Reset();
+
+    // ===== Checker statistics =============================================
+    uint64_t mBitErrorCount;
+    uint64_t mByteCount;
+    uint64_t mByteErrorCount;
+    uint64_t mSyncLossCount;
+
+private:
+
+    NO_COPY(PRBS);
+
+    uint8_t NextByte();
+
+    unsigned int mOrder;
+    unsigned int mTap;
+    uint32_t     mMask;
+    uint32_t     mState;
+
+    // ===== Checker ========================================================
+    unsigned int mSync_bit;
+    unsigned int mWindow_byte;
+    unsigned int mWindowErrors_byte;
+
+};
@@ -0,0 +1,562 @@
+// Author    KMS - Martin Dubois, P. Eng.
+// Copyright (C) 2024 KMS
+// License   http://www.apache.org/licenses/LICENSE-2.0
+// Product   KMS-Tools
+// File      ComTool/Query.cpp
+
+#include "Component.h"
+
+// ===== C++ ================================================================
+#include <algorithm>
+
+// ===== Local ==============================================================
+#include "Clock.h"
+#include "Search.h"
+#include "TimeFormatter.h"
+
+#include "Query.h"
+
+using namespace KMS;
+
+KMS_RESULT_STATIC(RESULT_INVALID_CAPTURE);
+
+// Constants
+// //////////////////////////////////////////////////////////////////////////
+
+// Below this size, starting the threads costs more than they save
+#define CHUNK_MIN_byte (4 * 1024 * 1024)
+
+static const char* DIRECTION_NAMES[2] = { "Receive", "Send" };
+
+// Public
+// //////////////////////////////////////////////////////////////////////////
+
+Query::Query(const char* aFileName) : mDuration_ns(0), mFile(aFileName), mInterval_ns(0), mMatchCount(0)
+{
+    auto lData      = mFile.GetData();
+    auto lSize_byte = mFile.GetSize_byte();
+
+    KMS_EXCEPTION_ASSERT(sizeof(mHeader) <= lSize_byte, RESULT_INVALID_CAPTURE, "The capture file is too short", aFileName);
+
+    memcpy(&mHeader, lData, sizeof(mHeader));
+
+    KMS_EXCEPTION_ASSERT(0 == memcmp(CaptureFile::MAGIC_FILE, mHeader.mMagic, sizeof(mHeader.mMagic)), RESULT_INVALID_CAPTURE, "Not a capture file", aFileName);
+    KMS_EXCEPTION_ASSERT(mHeader.mHeaderSize_byte <= lSize_byte, RESULT_INVALID_CAPTURE, "The capture file is too short", aFileName);
+
+    mEnd_byte = lSize_byte;
+
+    CaptureFile::FileTrailer lTrailer;
+
+    if (sizeof(mHeader) + sizeof(lTrailer) <= lSize_byte)
+    {
+        memcpy(&lTrailer, lData + lSize_byte - sizeof(lTrailer), sizeof(lTrailer));
+
+        uint64_t lIndexSize_byte = sizeof(CaptureFile::IndexEntry) * static_cast<uint64_t>(lTrailer.mIndexCount);
+
+        if ((0 == memcmp(CaptureFile::MAGIC_INDEX, lTrailer.mMagic, sizeof(lTrailer.mMagic)))
+            && (lTrailer.mIndexOffset_byte + lIndexSize_byte + sizeof(lTrailer) == lSize_byte))
+        {
+            mEnd_byte = lTrailer.mIndexOffset_byte;
+
+            mIndex.resize(lTrailer.mIndexCount);
+
+            if (0 < lTrailer.mIndexCount)
+            {
+                memcpy(mIndex.data(), lData + lTrailer.mIndexOffset_byte, static_cast<size_t>(lIndexSize_byte));
+            }
+        }
+    }
+}
+
+uint64_t Query::GetMatchCount() const { return mMatchCount; }
+
+void Query::SetInterval(unsigned int aInterval_s) { mInterval_ns = static_cast<uint64_t>(aInterval_s) * 1000000000; }
+
+void Query::SetPattern(const uint8_t* aIn, unsigned int aInSize_byte)
+{
+    assert((nullptr != aIn) || (0 == aInSize_byte));
+
+    mPattern.assign(aIn, aIn + aInSize_byte);
+}
+
+void Query::Run(unsigned int aThreadCount)
+{
+    auto lStart_ns = Clock_GetTime_ns();
+
+    auto lThreadCount = aThreadCount;
+    if (0 == lThreadCount)
+    {
+        lThreadCount = std::thread::hardware_concurrency();
+        if (0 == lThreadCount)
+        {
+            lThreadCount = 1;
+        }
+    }
+
+    auto lChunkCount = (mEnd_byte - mHeader.mHeaderSize_byte) / CHUNK_MIN_byte + 1;
+    if (lThreadCount > lChunkCount)
+    {
+        lThreadCount = static_cast<unsigned int>(lChunkCount);
+    }
+
+    Split(lThreadCount);
+
+    std::vector<std::thread> lThreads;
+
+    for (auto& lChunk : mChunks)
+    {
+        lThreads.push_back(std::thread(&Query::ProcessChunk, this, lChunk.get()));
+    }
+
+    for (auto& lThread : lThreads)
+    {
+        lThread.join();
+    }
+
+    mGaps.Reset();
+    mIntervals.clear();
+    mMatchCount = 0;
+    mMatches.clear();
+    mStreams.clear();
+
+    for (const auto& lChunk : mChunks)
+    {
+        Merge(*lChunk);
+    }
+
+    mChunks.clear();
+
+    // The matches of a chunk come before the ones of the next chunk, except
+    // the ones spanning the boundary
+    std::stable_sort(mMatches.begin(), mMatches.end(), [](const Match& aA, const Match& aB) { return aA.mTime_ns < aB.mTime_ns; });
+
+    if (MATCH_QTY < mMatches.size())
+    {
+        mMatches.resize(MATCH_QTY);
+    }
+
+    mDuration_ns = Clock_GetTime_ns() - lStart_ns;
+}
+
+void Query::Display(std::ostream& aOut, TimeFormatter* aTimeFormatter) const
+{
+    assert(nullptr != aTimeFormatter);
+
+    Interval lTotal;
+
+    memset(&lTotal, 0, sizeof(lTotal));
+
+    for (const auto& lI : mIntervals)
+    {
+        lTotal.mByteCount         += lI.mByteCount;
+        lTotal.mCRCErrorCount     += lI.mCRCErrorCount;
+        lTotal.mRecordCount       += lI.mRecordCount;
+        lTotal.mVerifyFailedCount += lI.mVerifyFailedCount;
+        lTotal.mVerifyPassedCount += lI.mVerifyPassedCount;
+    }
+
+    auto lDuration_ms = mDuration_ns / 1000000;
+    auto lFile_MB     = static_cast<double>(mEnd_byte) / 1000000.0;
+
+    char lLine[LINE_LENGTH];
+
+    sprintf_s(lLine SizeInfo(lLine), "Query              : %llu records, %llu bytes, %llu ms, %.1f MB/s",
+        static_cast<unsigned long long>(lTotal.mRecordCount), static_cast<unsigned long long>(lTotal.mByteCount), static_cast<unsigned long long>(lDuration_ms),
+        (0 < mDuration_ns) ? lFile_MB * 1000000000.0 / mDuration_ns : 0.0);
+
+    aOut << lLine << "\n";
+    aOut << "    Verify         : " << lTotal.mVerifyPassedCount << " passed, " << lTotal.mVerifyFailedCount << " failed\n";
+    aOut << "    CRC errors     : " << lTotal.mCRCErrorCount << "\n";
+
+    if (!mPattern.empty())
+    {
+        aOut << "    Matches        : " << mMatchCount << "\n";
+
+        for (const auto& lM : mMatches)
+        {
+            char lTime[NAME_LENGTH];
+
+            aTimeFormatter->Format_Wall(mHeader.mStart_ns + lM.mTime_ns, lTime, sizeof(lTime));
+
+            sprintf_s(lLine SizeInfo(lLine), "        %s  %s [%u]", lTime, DIRECTION_NAMES[lM.mDirection & 1], lM.mPort);
+
+            aOut << lLine << "\n";
+        }
+    }
+
+    if ((0 < mInterval_ns) && (!mIntervals.empty()))
+    {
+        aOut << "Intervals          : " << mInterval_ns / 1000000000 << " s\n";
+
+        auto lFirst = mHeader.mStart_ns / mInterval_ns;
+
+        for (unsigned int i = 0; i < mIntervals.size(); i++)
+        {
+            const auto& lI = mIntervals[i];
+            if (0 == lI.mRecordCount) { continue; }
+
+            char lTime[NAME_LENGTH];
+
+            aTimeFormatter->Format_Wall((lFirst + i) * mInterval_ns, lTime, sizeof(lTime));
+
+            sprintf_s(lLine SizeInfo(lLine), "    %s : %8llu records, %10llu bytes, %6llu passed, %6llu failed, %6llu CRC errors",
+                lTime,
+                static_cast<unsigned long long>(lI.mRecordCount),
+                static_cast<unsigned long long>(lI.mByteCount),
+                static_cast<unsigned long long>(lI.mVerifyPassedCount),
+                static_cast<unsigned long long>(lI.mVerifyFailedCount),
+                static_cast<unsigned long long>(lI.mCRCErrorCount));
+
+            aOut << lLine;
+
+            if (!mPattern.empty())
+            {
+                aOut << ", " << lI.mMatchCount << " matches";
+            }
+
+            aOut << "\n";
+        }
+    }
+
+    mGaps.Display(aOut, "Receive gaps       ", true);
+}
+
+// Private
+// //////////////////////////////////////////////////////////////////////////
+
+void Query::AddMatch(std::vector<Interval>* aIntervals, std::vector<Match>* aMatches, uint64_t aTime_ns, uint8_t aDirection, uint16_t aPort)
+{
+    assert(nullptr != aMatches);
+
+    GetInterval(aIntervals, aTime_ns)->mMatchCount++;
+
+    if (MATCH_QTY > aMatches->size())
+    {
+        Match lMatch;
+
+        lMatch.mDirection = aDirection;
+        lMatch.mPort      = aPort;
+        lMatch.mTime_ns   = aTime_ns;
+
+        aMatches->push_back(lMatch);
+    }
+}
+
+unsigned int Query::FindJoined(std::vector<uint8_t>* aJoin, const std::vector<uint8_t>& aTail, const uint8_t* aIn, unsigned int aInSize_byte, const uint64_t* aTimes_ns, uint64_t aTime_ns,
+    std::vector<Interval>* aIntervals, std::vector<Match>* aMatches, uint8_t aDirection, uint16_t aPort)
+{
+    assert(nullptr != aJoin);
+    assert(nullptr != aIn);
+
+    auto lPatternSize_byte = static_cast<unsigned int>(mPattern.size());
+    auto lTailSize_byte    = static_cast<unsigned int>(aTail.size());
+
+    // Only the first bytes of aIn can complete a match starting in aTail
+    auto lInSize_byte = std::min(aInSize_byte, lPatternSize_byte - 1);
+
+    aJoin->assign(aTail.begin(), aTail.end());
+    aJoin->insert(aJoin->end(), aIn, aIn + lInSize_byte);
+
+    auto lBegin = aJoin->data();
+    auto lEnd   = lBegin + aJoin->size();
+
+    unsigned int lResult = 0;
+
+    for (auto lPtr = Search_Find(lBegin, lEnd - lBegin, mPattern.data(), lPatternSize_byte);
+        (nullptr != lPtr) && (lBegin + lTailSize_byte > lPtr);
+        lPtr = Search_Find(lPtr + 1, lEnd - lPtr - 1, mPattern.data(), lPatternSize_byte))
+    {
+        // The record holding the last byte completes the match
+        auto lLast = static_cast<unsigned int>(lPtr - lBegin) + lPatternSize_byte - 1 - lTailSize_byte;
+
+        AddMatch(aIntervals, aMatches, (nullptr == aTimes_ns) ? aTime_ns : aTimes_ns[lLast], aDirection, aPort);
+
+        lResult++;
+    }
+
+    return lResult;
+}
+
+// The intervals are aligned on the wall clock, so hours start at minute 0
+Query::Interval* Query::GetInterval(std::vector<Interval>* aIntervals, uint64_t aTime_ns)
+{
+    assert(nullptr != aIntervals);
+
+    size_t lIndex = 0;
+
+    if (0 < mInterval_ns)
+    {
+        lIndex = static_cast<size_t>((mHeader.mStart_ns + aTime_ns) / mInterval_ns - mHeader.mStart_ns / mInterval_ns);
+    }
+
+    if (aIntervals->size() <= lIndex)
+    {
+        Interval lZero;
+
+        memset(&lZero, 0, sizeof(lZero));
+
+        aIntervals->resize(lIndex + 1, lZero);
+    }
+
+    return aIntervals->data() + lIndex;
+}
+
+void Query::Merge(const Chunk& aChunk)
+{
+    mGaps.Merge(aChunk.mGaps);
+
+    if (mIntervals.size() < aChunk.mIntervals.size())
+    {
+        Interval lZero;
+
+        memset(&lZero, 0, sizeof(lZero));
+
+        mIntervals.resize(aChunk.mIntervals.size(), lZero);
+    }
+
+    for (unsigned int i = 0; i < aChunk.mIntervals.size(); i++)
+    {
+        auto& lDst = mIntervals[i];
+        auto& lSrc = aChunk.mIntervals[i];
+
+        lDst.mByteCount         += lSrc.mByteCount;
+        lDst.mCRCErrorCount     += lSrc.mCRCErrorCount;
+        lDst.mMatchCount        += lSrc.mMatchCount;
+        lDst.mRecordCount       += lSrc.mRecordCount;
+        lDst.mVerifyFailedCount += lSrc.mVerifyFailedCount;
+        lDst.mVerifyPassedCount += lSrc.mVerifyPassedCount;
+    }
+
+    mMatchCount += aChunk.mMatchCount;
+
+    mMatches.insert(mMatches.end(), aChunk.mMatches.begin(), aChunk.mMatches.end());
+
+    for (const auto& lVT : aChunk.mStreams)
+    {
+        auto  lDirection = static_cast<uint8_t >(lVT.first & 0xff);
+        auto  lPort      = static_cast<uint16_t>(lVT.first >> 8);
+        auto& lSrc       = lVT.second;
+
+        auto lIt = mStreams.find(lVT.first);
+        if (mStreams.end() == lIt)
+        {
+            mStreams[lVT.first] = lSrc;
+            continue;
+        }
+
+        auto& lDst = lIt->second;
+
+        // The gap between the last record of the previous chunk and the
+        // first one of this chunk
+        if ((CaptureFile::DIRECTION_RECEIVE == lDirection) && (lDst.mLast_ns <= lSrc.mFirst_ns))
+        {
+            mGaps.AddGap(lSrc.mFirst_ns - lDst.mLast_ns);
+        }
+
+        lDst.mLast_ns = lSrc.mLast_ns;
+
+        if (mPattern.empty()) { continue; }
+
+        if ((!lDst.mTail.empty()) && (!lSrc.mHead.empty()))
+        {
+            mMatchCount += FindJoined(&mJoin, lDst.mTail, lSrc.mHead.data(), static_cast<unsigned int>(lSrc.mHead.size()), lSrc.mHeadTimes_ns.data(), 0,
+                &mIntervals, &mMatches, lDirection, lPort);
+        }
+
+        // When the chunk has less bytes than the tail, its tail holds all
+        // of them
+        if (mPattern.size() - 1 <= lSrc.mTail.size())
+        {
+            lDst.mTail = lSrc.mTail;
+        }
+        else
+        {
+            UpdateTail(&lDst.mTail, lSrc.mTail.data(), static_cast<unsigned int>(lSrc.mTail.size()));
+        }
+    }
+}
+
+// Thread
+void Query::ProcessChunk(Chunk* aChunk)
+{
+    assert(nullptr != aChunk);
+
+    auto lData = mFile.GetData();
+
+    uint64_t lOffset_byte = aChunk->mBegin_byte;
+
+    while (aChunk->mEnd_byte >= lOffset_byte + sizeof(CaptureFile::RecordHeader))
+    {
+        CaptureFile::RecordHeader lHeader;
+
+        memcpy(&lHeader, lData + lOffset_byte, sizeof(lHeader));
+
+        lOffset_byte += sizeof(lHeader);
+
+        // A record truncated by a crash ends the capture
+        if (aChunk->mEnd_byte < lOffset_byte + lHeader.mSize_byte)
+        {
+            break;
+        }
+
+        ProcessRecord(aChunk, lHeader, lData + lOffset_byte);
+
+        lOffset_byte += lHeader.mSize_byte;
+    }
+}
+
+void Query::ProcessRecord(Chunk* aChunk, const CaptureFile::RecordHeader& aHeader, const uint8_t* aIn)
+{
+    assert(nullptr != aChunk);
+    assert(nullptr != aIn);
+
+    auto lInterval = GetInterval(&aChunk->mIntervals, aHeader.mTime_ns);
+
+    lInterval->mByteCount += aHeader.mSize_byte;
+    lInterval->mRecordCount++;
+
+    if (0 != (aHeader.mFlags & CaptureFile::FLAG_FRAME_ERROR  )) { lInterval->mCRCErrorCount++; }
+    if (0 != (aHeader.mFlags & CaptureFile::FLAG_VERIFY_FAILED)) { lInterval->mVerifyFailedCount++; }
+    if (0 != (aHeader.mFlags & CaptureFile::FLAG_VERIFY_PASSED)) { lInterval->mVerifyPassedCount++; }
+
+    uint32_t lKey = (static_cast<uint32_t>(aHeader.mPort) << 8) | aHeader.mDirection;
+
+    auto lIt = aChunk->mStreams.find(lKey);
+    if (aChunk->mStreams.end() == lIt)
+    {
+        lIt = aChunk->mStreams.insert(std::make_pair(lKey, Stream())).first;
+
+        lIt->second.mFirst_ns = aHeader.mTime_ns;
+    }
+    else if ((CaptureFile::DIRECTION_RECEIVE == aHeader.mDirection) && (lIt->second.mLast_ns <= aHeader.mTime_ns))
+    {
+        aChunk->mGaps.AddGap(aHeader.mTime_ns - lIt->second.mLast_ns);
+    }
+
+    auto& lStream = lIt->second;
+
+    lStream.mLast_ns = aHeader.mTime_ns;
+
+    if (mPattern.empty() || (0 == aHeader.mSize_byte)) { return; }
+
+    auto lPatternSize_byte = static_cast<unsigned int>(mPattern.size());
+
+    // ===== Matches completed by this record ===============================
+    if (!lStream.mTail.empty())
+    {
+        aChunk->mMatchCount += FindJoined(&aChunk->mJoin, lStream.mTail, aIn, aHeader.mSize_byte, nullptr, aHeader.mTime_ns,
+            &aChunk->mIntervals, &aChunk->mMatches, aHeader.mDirection, aHeader.mPort);
+    }
+
+    // ===== Matches inside this record =====================================
+    auto lEnd = aIn + aHeader.mSize_byte;
+
+    for (auto lPtr = Search_Find(aIn, aHeader.mSize_byte, mPattern.data(), lPatternSize_byte);
+        nullptr != lPtr;
+        lPtr = Search_Find(lPtr + 1, lEnd - lPtr - 1, mPattern.data(), lPatternSize_byte))
+    {
+        AddMatch(&aChunk->mIntervals, &aChunk->mMatches, aHeader.mTime_ns, aHeader.mDirection, aHeader.mPort);
+
+        aChunk->mMatchCount++;
+    }
+
+    // ===== Edges used by Merge ============================================
+    if (lPatternSize_byte - 1 > lStream.mHead.size())
+    {
+        auto lSize_byte = std::min(aHeader.mSize_byte, static_cast<uint32_t>(lPatternSize_byte - 1 - lStream.mHead.size()));
+
+        lStream.mHead.insert(lStream.mHead.end(), aIn, aIn + lSize_byte);
+        lStream.mHeadTimes_ns.insert(lStream.mHeadTimes_ns.end(), lSize_byte, aHeader.mTime_ns);
+    }
+
+    UpdateTail(&lStream.mTail, aIn, aHeader.mSize_byte);
+}
+
+// Cut at the index entries. A capture without an index, not closed, needs
+// one walk of the record headers to find the boundaries.
+void Query::Split(unsigned int aChunkCount)
+{
+    assert(0 < aChunkCount);
+
+    auto lBegin_byte = static_cast<uint64_t>(mHeader.mHeaderSize_byte);
+    auto lSize_byte  = mEnd_byte - lBegin_byte;
+
+    std::vector<uint64_t> lBounds_byte;
+
+    lBounds_byte.push_back(lBegin_byte);
+
+    if (!mIndex.empty())
+    {
+        for (unsigned int i = 1; i < aChunkCount; i++)
+        {
+            auto lTarget_byte = lBegin_byte + lSize_byte * i / aChunkCount;
+
+            auto lIt = std::lower_bound(mIndex.begin(), mIndex.end(), lTarget_byte,
+                [](const CaptureFile::IndexEntry& aE, uint64_t aO) { return aE.mOffset_byte < aO; });
+
+            if ((mIndex.end() != lIt) && (lBounds_byte.back() < lIt->mOffset_byte) && (mEnd_byte > lIt->mOffset_byte))
+            {
+                lBounds_byte.push_back(lIt->mOffset_byte);
+            }
+        }
+    }
+    else if (1 < aChunkCount)
+    {
+        auto lData = mFile.GetData();
+
+        unsigned int lNext = 1;
+        auto         lOffset_byte = lBegin_byte;
+
+        while ((aChunkCount > lNext) && (mEnd_byte >= lOffset_byte + sizeof(CaptureFile::RecordHeader)))
+        {
+            if (lBegin_byte + lSize_byte * lNext / aChunkCount <= lOffset_byte)
+            {
+                lBounds_byte.push_back(lOffset_byte);
+                lNext++;
+            }
+
+            CaptureFile::RecordHeader lHeader;
+
+            memcpy(&lHeader, lData + lOffset_byte, sizeof(lHeader));
+
+            lOffset_byte += sizeof(lHeader) + lHeader.mSize_byte;
+        }
+    }
+
+    lBounds_byte.push_back(mEnd_byte);
+
+    mChunks.clear();
+
+    for (unsigned int i = 0; i + 1 < lBounds_byte.size(); i++)
+    {
+        auto lChunk = new Chunk;
+
+        lChunk->mBegin_byte = lBounds_byte[i];
+        lChunk->mEnd_byte   = lBounds_byte[i + 1];
+        lChunk->mMatchCount = 0;
+
+        mChunks.push_back(std::unique_ptr<Chunk>(lChunk));
+    }
+}
+
+void Query::UpdateTail(std::vector<uint8_t>* aTail, const uint8_t* aIn, unsigned int aInSize_byte) const
+{
+    assert(nullptr != aTail);
+    assert(nullptr != aIn);
+
+    auto lTailSize_byte = static_cast<unsigned int>(mPattern.size() - 1);
+
+    if (lTailSize_byte <= aInSize_byte)
+    {
+        aTail->assign(aIn + aInSize_byte - lTailSize_byte, aIn + aInSize_byte);
+    }
+    else
+    {
+        aTail->insert(aTail->end(), aIn, aIn + aInSize_byte);
+
+        if (lTailSize_byte < aTail->size())
+        {
+            aTail->erase(aTail->begin(), aTail->end() - lTailSize_byte);
+        }
+    }
+}
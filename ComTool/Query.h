@@ -0,0 +1,136 @@
+// Author    KMS - Martin Dubois, P. Eng.
+// Copyright (C) 2024 KMS
+// License   http://www.apache.org/licenses/LICENSE-2.0
+// Product   KMS-Tools
+// File      ComTool/Query.h
+
+#pragma once
+
+// ===== C++ ================================================================
+#include <map>
+#include <memory>
+#include <vector>
+
+// ===== Local ==============================================================
+#include "CaptureFile.h"
+#include "GapStats.h"
+#include "MappedFile.h"
+
+class TimeFormatter;
+
+// Scan a complete capture. Each thread walks a part of the records, cut at
+// the index entries, then the parts are merged in file order. A match may
+// span many records of the same port and direction, as when the driver
+// splits a line in many reads, and the boundary between two parts.
+class Query
+{
+
+public:
+
+    // The number of matches Display lists
+    static const unsigned int MATCH_QTY = 10;
+
+    Query(const char* aFileName);
+
+    uint64_t GetMatchCount() const;
+
+    // aInterval_s  0 for one interval covering the capture
+    void SetInterval(unsigned int aInterval_s);
+
+    void SetPattern(const uint8_t* aIn, unsigned int aInSize_byte);
+
+    // aThreadCount  0 for one thread per processor
+    void Run(unsigned int aThreadCount = 0);
+
+    void Display(std::ostream& aOut, TimeFormatter* aTimeFormatter) const;
+
+private:
+
+    NO_COPY(Query);
+
+    struct Interval
+    {
+        uint64_t mByteCount;
+        uint64_t mCRCErrorCount;
+        uint64_t mMatchCount;
+        uint64_t mRecordCount;
+        uint64_t mVerifyFailedCount;
+        uint64_t mVerifyPassedCount;
+    };
+
+    struct Match
+    {
+        uint64_t mTime_ns;
+        uint8_t  mDirection;
+        uint16_t mPort;
+    };
+
+    // The records of one port and direction
+    struct Stream
+    {
+        uint64_t mFirst_ns;
+        uint64_t mLast_ns;
+
+        // The first and the last pattern size - 1 bytes, and the time of the
+        // record of each first byte
+        std::vector<uint8_t>  mHead;
+        std::vector<uint64_t> mHeadTimes_ns;
+        std::vector<uint8_t>  mTail;
+    };
+
+    // The part of the records one thread walks
+    struct Chunk
+    {
+        uint64_t mBegin_byte;
+        uint64_t mEnd_byte;
+
+        GapStats                   mGaps;
+        std::vector<Interval>      mIntervals;
+        std::vector<uint8_t>       mJoin;
+        uint64_t                   mMatchCount;
+        std::vector<Match>         mMatches;
+        std::map<uint32_t, Stream> mStreams;
+    };
+
+    // aMatches  Keeps the first MATCH_QTY matches
+    void AddMatch(std::vector<Interval>* aIntervals, std::vector<Match>* aMatches, uint64_t aTime_ns, uint8_t aDirection, uint16_t aPort);
+
+    // Search the pattern in the join of aTail and aIn, only where it starts
+    // in aTail
+    //
+    // aTimes_ns  The time of each byte of aIn, nullptr when all the bytes
+    //            have the time aTime_ns
+    //
+    // Return  The number of matches
+    unsigned int FindJoined(std::vector<uint8_t>* aJoin, const std::vector<uint8_t>& aTail, const uint8_t* aIn, unsigned int aInSize_byte, const uint64_t* aTimes_ns, uint64_t aTime_ns,
+        std::vector<Interval>* aIntervals, std::vector<Match>* aMatches, uint8_t aDirection, uint16_t aPort);
+
+    Interval* GetInterval(std::vector<Interval>* aIntervals, uint64_t aTime_ns);
+
+    void Merge(const Chunk& aChunk);
+
+    void ProcessChunk(Chunk* aChunk);
+
+    void ProcessRecord(Chunk* aChunk, const CaptureFile::RecordHeader& aHeader, const uint8_t* aIn);
+
+    void Split(unsigned int aChunkCount);
+
+    void UpdateTail(std::vector<uint8_t>* aTail, const uint8_t* aIn, unsigned int aInSize_byte) const;
+
+    std::vector<std::unique_ptr<Chunk>> mChunks;
+
+    uint64_t                             mDuration_ns;
+    uint64_t                             mEnd_byte;
+    MappedFile                           mFile;
+    GapStats                             mGaps;
+    CaptureFile::FileHeader              mHeader;
+    std::vector<CaptureFile::IndexEntry> mIndex;
+    uint64_t                             mInterval_ns;
+    std::vector<Interval>                mIntervals;
+    std::vector<uint8_t>                 mJoin;
+    uint64_t                             mMatchCount;
+    std::vector<Match>                   mMatches;
+    std::vector<uint8_t>                 mPattern;
+    std::map<uint32_t, Stream>           mStreams;
+
+};
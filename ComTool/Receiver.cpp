@@ -0,0 +1,503 @@
+// Author    KMS - Martin Dubois, P. Eng.
+// Copyright (C) 2024 KMS
+// License   http://www.apache.org/licenses/LICENSE-2.0
+// Product   KMS-Tools
+// File      ComTool/Receiver.cpp
+
+#include "Component.h"
+
+// ===== C++ ================================================================
+#include <chrono>
+
+// ===== Local ==============================================================
+#include "Clock.h"
+#include "GapStats.h"
+#include "LatencyStats.h"
+
+#include "Receiver.h"
+
+using namespace KMS;
+
+// Constants
+// //////////////////////////////////////////////////////////////////////////
+
+// 16 MiB is more than 50 s of data at 3 Mbaud
+const unsigned int Receiver::SIZE_DEFAULT_byte = 16 * 1024 * 1024;
+
+// Power of 2. When the queue is full, the following chunk also covers the
+// bytes of the chunks which were not queued.
+#define CHUNK_QTY (4096)
+
+#define OVERFLOW_SIZE_byte (64 * 1024)
+
+// After a failed read, the receiver thread waits this long before trying
+// again
+#define RETRY_PERIOD_ms (1)
+
+// Static function declarations
+// //////////////////////////////////////////////////////////////////////////
+
+static unsigned int ToPowerOf2(unsigned int aIn);
+
+// Public
+// //////////////////////////////////////////////////////////////////////////
+
+Receiver::Receiver(Com::Port* aPort, GapStats* aGaps)
+    : mGaps(aGaps)
+    , mPort(aPort)
+    , mRing(nullptr)
+    , mRunning(false)
+    , mChunks(new Chunk[CHUNK_QTY])
+    , mChunkRead(0)
+    , mChunkWrite(0)
+    , mRead_byte(0)
+    , mForward(nullptr)
+    , mForwardLatency(nullptr)
+    , mOverflow(nullptr)
+    , mByteCount(0)
+    , mChunkLostCount(0)
+    , mErrorCount(0)
+    , mFullCount(0)
+    , mOverflow_byte(0)
+    , mMaxUsed_byte(0)
+{
+    assert(nullptr != aPort);
+}
+
+Receiver::~Receiver()
+{
+    Stop();
+
+    if (nullptr != mRing)
+    {
+        delete mRing;
+    }
+
+    delete[] mChunks;
+
+    if (nullptr != mOverflow)
+    {
+        delete[] mOverflow;
+    }
+}
+
+uint64_t Receiver::GetByteCount() const { return mByteCount; }
+
+uint64_t Receiver::GetOverflow_byte() const { return mOverflow_byte; }
+
+bool Receiver::IsFull() const { return (nullptr != mRing) && (0 == mRing->GetFree_byte()); }
+
+bool Receiver::IsRunning() const { return mRunning; }
+
+void Receiver::SetForward(Com::Port* aForward, LatencyStats* aLatency)
+{
+    KMS_EXCEPTION_ASSERT(!mRunning, RESULT_INVALID_COMMAND, "The capture is running", "");
+
+    mForward        = aForward;
+    mForwardLatency = aLatency;
+
+    if ((nullptr != mForward) && (nullptr == mOverflow))
+    {
+        mOverflow = new uint8_t[OVERFLOW_SIZE_byte];
+    }
+}
+
+void Receiver::Start(unsigned int aSize_byte, bool aThread)
+{
+    KMS_EXCEPTION_ASSERT(!mRunning, RESULT_INVALID_COMMAND, "The capture is already running", "");
+
+    auto lSize_byte = ToPowerOf2(aSize_byte);
+
+    if ((nullptr != mRing) && (mRing->GetSize_byte() != lSize_byte))
+    {
+        delete mRing;
+        mRing = nullptr;
+    }
+
+    if (nullptr == mRing)
+    {
+        mRing = new RingBuffer(lSize_byte);
+    }
+    else
+    {
+        mRing->Reset();
+    }
+
+    mChunkRead  = 0;
+    mChunkWrite = 0;
+    mRead_byte  = 0;
+
+    mByteCount      = 0;
+    mChunkLostCount = 0;
+    mErrorCount     = 0;
+    mFullCount     = 0;
+    mOverflow_byte = 0;
+    mMaxUsed_byte  = 0;
+
+    mRunning = true;
+
+    if (aThread)
+    {
+        mThread = std::thread(&Receiver::Run, this);
+    }
+}
+
+void Receiver::Stop()
+{
+    mRunning = false;
+
+    NotifyRoom();
+
+    if (mThread.joinable())
+    {
+        mThread.join();
+    }
+}
+
+unsigned int Receiver::Read(void* aOut, unsigned int aOutSize_byte, unsigned int aFlags, unsigned int aTimeout_ms, uint64_t* aTime_ns)
+{
+    assert(nullptr != aOut);
+    assert(nullptr != mRing);
+
+    auto lOut = static_cast<uint8_t*>(aOut);
+    unsigned int lResult_byte = 0;
+
+    auto lEnd = std::chrono::steady_clock::now() + std::chrono::milliseconds(aTimeout_ms);
+
+    for (;;)
+    {
+        auto lSize_byte = mRing->Read(lOut + lResult_byte, aOutSize_byte - lResult_byte);
+        if (0 < lSize_byte)
+        {
+            if ((0 == lResult_byte) && (nullptr != aTime_ns))
+            {
+                *aTime_ns = FindTime(mRead_byte, nullptr);
+            }
+
+            lResult_byte += lSize_byte;
+            mRead_byte   += lSize_byte;
+        }
+
+        if (aOutSize_byte <= lResult_byte) { break; }
+
+        if ((0 < lResult_byte) && (0 == (aFlags & Com::Port::FLAG_READ_ALL))) { break; }
+
+        if (std::chrono::steady_clock::now() >= lEnd) { break; }
+
+        WaitData(lEnd);
+    }
+
+    ReleaseChunks(mRead_byte);
+
+    if (0 < lResult_byte)
+    {
+        NotifyRoom();
+    }
+
+    if ((0 == lResult_byte) && (nullptr != aTime_ns))
+    {
+        *aTime_ns = Clock_GetTime_ns();
+    }
+
+    return lResult_byte;
+}
+
+const uint8_t* Receiver::Read_Begin(unsigned int* aSize_byte, unsigned int aTimeout_ms, uint64_t* aTime_ns)
+{
+    assert(nullptr != aSize_byte);
+    assert(nullptr != mRing);
+
+    auto lEnd = std::chrono::steady_clock::now() + std::chrono::milliseconds(aTimeout_ms);
+
+    for (;;)
+    {
+        auto lResult = mRing->Read_Begin(aSize_byte);
+
+        if (0 < *aSize_byte)
+        {
+            if (nullptr != aTime_ns)
+            {
+                uint64_t lAvailable_byte;
+
+                *aTime_ns = FindTime(mRead_byte, &lAvailable_byte);
+
+                if (*aSize_byte > lAvailable_byte)
+                {
+                    *aSize_byte = static_cast<unsigned int>(lAvailable_byte);
+                }
+            }
+
+            return lResult;
+        }
+
+        if (std::chrono::steady_clock::now() >= lEnd)
+        {
+            return lResult;
+        }
+
+        WaitData(lEnd);
+    }
+}
+
+void Receiver::Read_End(unsigned int aSize_byte)
+{
+    assert(nullptr != mRing);
+
+    mRing->Read_End(aSize_byte);
+
+    mRead_byte += aSize_byte;
+
+    ReleaseChunks(mRead_byte);
+
+    NotifyRoom();
+}
+
+// The bytes are read directly into the ring so they are never copied
+// before the consumer sees them. When the ring is full, the bytes stay in
+// the driver buffer until the consumer makes room.
+bool Receiver::Poll(unsigned int* aSize_byte, const uint8_t** aData, uint64_t* aTime_ns)
+{
+    assert(nullptr != aSize_byte);
+    assert(nullptr != mPort);
+    assert(nullptr != mRing);
+
+    unsigned int lSize_byte;
+
+    auto lOut = mRing->Write_Begin(&lSize_byte);
+    if (0 == lSize_byte)
+    {
+        mFullCount++;
+
+        if (nullptr == mForward)
+        {
+            *aSize_byte = 0;
+            return false;
+        }
+
+        lOut       = mOverflow;
+        lSize_byte = OVERFLOW_SIZE_byte;
+    }
+
+    try
+    {
+        lSize_byte = mPort->Read(lOut, lSize_byte, 0);
+    }
+    catch (...)
+    {
+        mErrorCount++;
+
+        *aSize_byte = 0;
+        return false;
+    }
+
+    if (0 < lSize_byte)
+    {
+        auto lNow_ns = Clock_GetTime_ns();
+
+        if (nullptr != mForward)
+        {
+            Forward(lOut, lSize_byte, lNow_ns);
+
+            if (mOverflow == lOut)
+            {
+                mOverflow_byte += lSize_byte;
+
+                *aSize_byte = 0;
+                return true;
+            }
+        }
+
+        auto lWrite = mChunkWrite.load(std::memory_order_relaxed);
+
+        if (CHUNK_QTY > lWrite - mChunkRead.load(std::memory_order_acquire))
+        {
+            auto& lChunk = mChunks[lWrite % CHUNK_QTY];
+
+            lChunk.mEnd_byte = mByteCount + lSize_byte;
+            lChunk.mTime_ns  = lNow_ns;
+
+            mChunkWrite.store(lWrite + 1, std::memory_order_release);
+        }
+        else
+        {
+            mChunkLostCount++;
+        }
+
+        // Only Poll writes into the ring, so the bytes stay valid until
+        // the next call even if the consumer releases them.
+        if (nullptr != aData)
+        {
+            *aData = lOut;
+        }
+
+        if (nullptr != aTime_ns)
+        {
+            *aTime_ns = lNow_ns;
+        }
+
+        mRing->Write_End(lSize_byte);
+
+        NotifyData();
+
+        mByteCount += lSize_byte;
+
+        if (nullptr != mGaps)
+        {
+            mGaps->Add(lNow_ns);
+        }
+
+        auto lUsed_byte = mRing->GetUsed_byte();
+        if (mMaxUsed_byte < lUsed_byte)
+        {
+            mMaxUsed_byte = lUsed_byte;
+        }
+    }
+
+    *aSize_byte = lSize_byte;
+    return true;
+}
+
+void Receiver::DisplayStatus(std::ostream& aOut) const
+{
+    aOut << "Capture    : " << (mRunning ? "Running" : "Stopped") << "\n";
+
+    if (nullptr != mRing)
+    {
+        aOut << "    Ring   : " << mRing->GetUsed_byte() << " / " << mRing->GetSize_byte() << " bytes (max " << mMaxUsed_byte << ")\n";
+        aOut << "    Bytes  : " << mByteCount  << "\n";
+        aOut << "    Chunks : " << mChunkWrite << " (" << mChunkLostCount << " without time)\n";
+        aOut << "    Errors : " << mErrorCount << "\n";
+        aOut << "    Full   : " << mFullCount  << "\n";
+
+        if (nullptr != mForward)
+        {
+            aOut << "    Forwarded without the ring : " << mOverflow_byte << " bytes\n";
+        }
+    }
+}
+
+// Private
+// //////////////////////////////////////////////////////////////////////////
+
+uint64_t Receiver::FindTime(uint64_t aPos_byte, uint64_t* aAvailable_byte)
+{
+    ReleaseChunks(aPos_byte);
+
+    auto lRead  = mChunkRead .load(std::memory_order_relaxed);
+    auto lWrite = mChunkWrite.load(std::memory_order_acquire);
+
+    if (lRead >= lWrite)
+    {
+        // Not expected, the bytes are always published after their chunk
+        if (nullptr != aAvailable_byte) { *aAvailable_byte = UINT64_MAX; }
+        return Clock_GetTime_ns();
+    }
+
+    const auto& lChunk = mChunks[lRead % CHUNK_QTY];
+
+    if (nullptr != aAvailable_byte)
+    {
+        *aAvailable_byte = lChunk.mEnd_byte - aPos_byte;
+    }
+
+    return lChunk.mTime_ns;
+}
+
+void Receiver::ReleaseChunks(uint64_t aPos_byte)
+{
+    auto lRead  = mChunkRead .load(std::memory_order_relaxed);
+    auto lWrite = mChunkWrite.load(std::memory_order_acquire);
+
+    while ((lRead < lWrite) && (mChunks[lRead % CHUNK_QTY].mEnd_byte <= aPos_byte))
+    {
+        lRead++;
+    }
+
+    mChunkRead.store(lRead, std::memory_order_release);
+}
+
+void Receiver::Forward(const uint8_t* aIn, unsigned int aInSize_byte, uint64_t aTime_ns)
+{
+    assert(nullptr != mForward);
+
+    try
+    {
+        if (!mForward->Write(aIn, aInSize_byte))
+        {
+            mErrorCount++;
+            return;
+        }
+    }
+    catch (...)
+    {
+        mErrorCount++;
+        return;
+    }
+
+    if (nullptr != mForwardLatency)
+    {
+        mForwardLatency->Add(Clock_GetTime_ns() - aTime_ns);
+    }
+}
+
+void Receiver::NotifyData()
+{
+    std::lock_guard<std::mutex> lLock(mMutex);
+
+    mDataCondition.notify_one();
+}
+
+void Receiver::NotifyRoom()
+{
+    std::lock_guard<std::mutex> lLock(mMutex);
+
+    mRoomCondition.notify_one();
+}
+
+void Receiver::WaitData(std::chrono::steady_clock::time_point aEnd)
+{
+    std::unique_lock<std::mutex> lLock(mMutex);
+
+    mDataCondition.wait_until(lLock, aEnd, [this] { return 0 < mRing->GetUsed_byte(); });
+}
+
+void Receiver::Run()
+{
+    while (mRunning)
+    {
+        unsigned int lSize_byte;
+
+        if (!Poll(&lSize_byte))
+        {
+            std::unique_lock<std::mutex> lLock(mMutex);
+
+            // A full ring waits for the consumer to make room, a failed
+            // read waits before trying again. Stop ends both waits.
+            if (IsFull())
+            {
+                mRoomCondition.wait(lLock, [this] { return (!mRunning) || (!IsFull()); });
+            }
+            else
+            {
+                mRoomCondition.wait_for(lLock, std::chrono::milliseconds(RETRY_PERIOD_ms), [this] { return !mRunning; });
+            }
+        }
+    }
+}
+
+// Static functions
+// //////////////////////////////////////////////////////////////////////////
+
+unsigned int ToPowerOf2(unsigned int aIn)
+{
+    KMS_EXCEPTION_ASSERT(0x80000000 >= aIn, RESULT_INVALID_VALUE, "The capture size is too large", aIn);
+
+    unsigned int lResult = 4096;
+
+    while (lResult < aIn)
+    {
+        lResult <<= 1;
+    }
+
+    return lResult;
+}
@@ -0,0 +1,161 @@
+// Author    KMS - Martin Dubois, P. Eng.
+// Copyright (C) 2024 KMS
+// License   http://www.apache.org/licenses/LICENSE-2.0
+// Product   KMS-Tools
+// File      ComTool/Receiver.h
+
+#pragma once
+
+// ===== C++ ================================================================
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+// ===== Import/Includes ====================================================
+#include <KMS/Com/Port.h>
+
+// ===== Local ==============================================================
+#include "RingBuffer.h"
+
+class GapStats;
+class LatencyStats;
+
+// The receiver thread drains the port into the ring buffer. The thread
+// calling Read is the only consumer. The receiver thread takes the time of
+// each chunk just after it was read, so the consumer gets the time the bytes
+// arrived rather than the time it processed them. A receiver started
+// without its thread is drained by the thread calling Poll, so one thread
+// can service many ports. A forwarding receiver writes each chunk to
+// another port before publishing it in the ring. A consumer waiting for
+// data and a receiver thread waiting for room block on condition
+// variables, each side wakes the other as soon as it moved data.
+class Receiver
+{
+
+public:
+
+    static const unsigned int SIZE_DEFAULT_byte;
+
+    // aGaps  Receives the time of each chunk, may be nullptr
+    Receiver(KMS::Com::Port* aPort, GapStats* aGaps = nullptr);
+
+    ~Receiver();
+
+    // Number of bytes received since Start, without the bytes forwarded
+    // while the ring was full
+    uint64_t GetByteCount() const;
+
+    // Number of bytes forwarded while the ring was full
+    uint64_t GetOverflow_byte() const;
+
+    // Return  true when the ring has no room left
+    bool IsFull() const;
+
+    bool IsRunning() const;
+
+    // Call it before Start
+    // aForward  The port receiving the data as soon as it is read, nullptr
+    //           to stop forwarding
+    // aLatency  Receives the time each forward write takes, may be nullptr
+    void SetForward(KMS::Com::Port* aForward, LatencyStats* aLatency = nullptr);
+
+    // aSize_byte  Ring size, rounded up to the next power of 2
+    // aThread     false when the caller drains the port with Poll
+    void Start(unsigned int aSize_byte = SIZE_DEFAULT_byte, bool aThread = true);
+
+    void Stop();
+
+    // aFlags    KMS::Com::Port::FLAG_READ_ALL
+    // aTime_ns  Clock_GetTime_ns value of the first byte, may be nullptr
+    unsigned int Read(void* aOut, unsigned int aOutSize_byte, unsigned int aFlags, unsigned int aTimeout_ms, uint64_t* aTime_ns = nullptr);
+
+    // Wait for data and return the first contiguous region without copying
+    // it. The caller must call Read_End once done with the data. When
+    // aTime_ns is not nullptr, the region is limited to one received chunk
+    // and aTime_ns receives its time.
+    const uint8_t* Read_Begin(unsigned int* aSize_byte, unsigned int aTimeout_ms, uint64_t* aTime_ns = nullptr);
+
+    void Read_End(unsigned int aSize_byte);
+
+    // Read the port once into the ring
+    // aSize_byte  The number of bytes read
+    // aData       The first byte read, valid until the next call, may be
+    //             nullptr
+    // aTime_ns    Clock_GetTime_ns value of the bytes read, may be nullptr
+    // Return      false when the ring is full or the read failed, the
+    //             caller should wait before calling Poll again
+    bool Poll(unsigned int* aSize_byte, const uint8_t** aData = nullptr, uint64_t* aTime_ns = nullptr);
+
+    void DisplayStatus(std::ostream& aOut) const;
+
+private:
+
+    NO_COPY(Receiver);
+
+    struct Chunk
+    {
+        uint64_t mEnd_byte;
+        uint64_t mTime_ns;
+    };
+
+    // aPos_byte        Position of the byte in the received stream
+    // aAvailable_byte  Number of bytes of the chunk from aPos_byte
+    uint64_t FindTime(uint64_t aPos_byte, uint64_t* aAvailable_byte);
+
+    // Release the chunks ending at or before aPos_byte
+    void ReleaseChunks(uint64_t aPos_byte);
+
+    // Wake the consumer waiting in Read or Read_Begin
+    void NotifyData();
+
+    // Wake the receiver thread waiting for room in the ring
+    void NotifyRoom();
+
+    // Return when the ring holds data or at aEnd
+    void WaitData(std::chrono::steady_clock::time_point aEnd);
+
+    void Run();
+
+    void Forward(const uint8_t* aIn, unsigned int aInSize_byte, uint64_t aTime_ns);
+
+    GapStats*       mGaps;
+    KMS::Com::Port* mPort;
+    RingBuffer*     mRing;
+    std::thread     mThread;
+
+    std::atomic<bool> mRunning;
+
+    // ===== Wake up ========================================================
+    // The ring itself is lock free, the mutex only orders the waits and
+    // the notifications so none is lost.
+    std::condition_variable mDataCondition;
+    std::mutex              mMutex;
+    std::condition_variable mRoomCondition;
+
+    // ===== Chunk times ====================================================
+    // Single producer, single consumer queue parallel to the ring. The
+    // receiver thread publishes a chunk before its bytes, so the consumer
+    // always finds the time of the bytes it reads.
+    Chunk*                mChunks;
+    alignas(64) std::atomic<uint64_t> mChunkRead;
+    alignas(64) std::atomic<uint64_t> mChunkWrite;
+
+    uint64_t mRead_byte;
+
+    // ===== Forward ========================================================
+    // While the ring is full, the forwarded data goes through mOverflow.
+    // The consumer never sees it but the forwarding never stops.
+    KMS::Com::Port* mForward;
+    LatencyStats*   mForwardLatency;
+    uint8_t*        mOverflow;
+
+    // ===== Statistics =====================================================
+    std::atomic<uint64_t>     mByteCount;
+    std::atomic<uint64_t>     mChunkLostCount;
+    std::atomic<uint64_t>     mErrorCount;
+    std::atomic<uint64_t>     mFullCount;
+    std::atomic<uint64_t>     mOverflow_byte;
+    std::atomic<unsigned int> mMaxUsed_byte;
+
+};
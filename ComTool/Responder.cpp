@@ -0,0 +1,342 @@
+// Author    KMS - Martin Dubois, P. Eng.
+// Copyright (C) 2024 KMS
+// License   http://www.apache.org/licenses/LICENSE-2.0
+// Product   KMS-Tools
+// File      ComTool/Responder.cpp
+
+#include "Component.h"
+
+// ===== Local ==============================================================
+#include "File.h"
+#include "FrameT.h"
+#include "Hex.h"
+
+#include "Responder.h"
+
+using namespace KMS;
+
+// Constants
+// //////////////////////////////////////////////////////////////////////////
+
+#define TOKEN_QTY (6)
+
+// Static function declarations
+// //////////////////////////////////////////////////////////////////////////
+
+// Decode in place, return the number of bytes
+static unsigned int ParseASCII(char* aInOut, unsigned int aLine);
+
+// Return false when the token is not ASCII or Hex
+static bool ParseType(const char* aIn, bool* aHex);
+
+// aIn  Two hexadecimal digits
+static uint8_t ToByte(const char* aIn, unsigned int aLine);
+
+// Return the number of tokens
+static unsigned int Tokenize(char* aIn, char** aTokens, unsigned int aTokenQty);
+
+// Public
+// //////////////////////////////////////////////////////////////////////////
+
+Responder::Responder() {}
+
+void Responder::Load(const char* aFileName)
+{
+    assert(nullptr != aFileName);
+
+    KMS_EXCEPTION_ASSERT(mRules.empty(), RESULT_INVALID_STATE, "The rules are already loaded", aFileName);
+
+    auto lFile = File_Open(aFileName, "r");
+    KMS_EXCEPTION_ASSERT(nullptr != lFile, RESULT_OPEN_FAILED, "Cannot open the rule file", aFileName);
+
+    char         lLine[LINE_LENGTH];
+    unsigned int lLineNo = 0;
+
+    try
+    {
+        while (nullptr != fgets(lLine, sizeof(lLine), lFile))
+        {
+            lLineNo++;
+
+            ParseLine(lLine, lLineNo);
+        }
+    }
+    catch (...)
+    {
+        fclose(lFile);
+        throw;
+    }
+
+    fclose(lFile);
+
+    KMS_EXCEPTION_ASSERT(!mRules.empty(), RESULT_INVALID_CONFIG, "The rule file is empty", aFileName);
+
+    mMatcher.Compile();
+}
+
+unsigned int Responder::GetDelay_us(unsigned int aRule) const
+{
+    assert(mRules.size() > aRule);
+
+    return mRules[aRule].mDelay_us;
+}
+
+const uint8_t* Responder::GetResponse(unsigned int aRule, unsigned int* aSize_byte) const
+{
+    assert(mRules.size() > aRule);
+    assert(nullptr != aSize_byte);
+
+    auto& lRule = mRules[aRule];
+
+    *aSize_byte = static_cast<unsigned int>(lRule.mResponse.size());
+
+    return lRule.mResponse.data();
+}
+
+unsigned int Responder::GetRuleCount() const { return static_cast<unsigned int>(mRules.size()); }
+
+bool Responder::IsFrameT(unsigned int aRule) const
+{
+    assert(mRules.size() > aRule);
+
+    return mRules[aRule].mFrameT;
+}
+
+void Responder::Reset()
+{
+    mMatcher.Reset();
+
+    for (auto& lRule : mRules)
+    {
+        lRule.mCount = 0;
+    }
+}
+
+unsigned int Responder::Scan(const void* aIn, unsigned int aInSize_byte, unsigned int* aRule)
+{
+    assert(nullptr != aRule);
+
+    auto lResult_byte = mMatcher.Scan(aIn, aInSize_byte, aRule);
+
+    if (Matcher::NO_MATCH != *aRule)
+    {
+        assert(mRules.size() > *aRule);
+
+        mRules[*aRule].mCount++;
+    }
+
+    return lResult_byte;
+}
+
+void Responder::Display(std::ostream& aOut) const
+{
+    unsigned int lIndex = 0;
+
+    for (auto& lRule : mRules)
+    {
+        aOut << "    Rule " << lIndex << " (line " << lRule.mLine << ") : " << lRule.mCount << " matches, ";
+        aOut << lRule.mResponse.size() << " bytes after " << lRule.mDelay_us << " us\n";
+
+        lIndex++;
+    }
+}
+
+// Private
+// //////////////////////////////////////////////////////////////////////////
+
+void Responder::ParseLine(char* aIn, unsigned int aLine)
+{
+    assert(nullptr != aIn);
+
+    char* lTokens[TOKEN_QTY + 1];
+
+    auto lCount = Tokenize(aIn, lTokens, TOKEN_QTY + 1);
+    if ((0 == lCount) || ('#' == lTokens[0][0]))
+    {
+        return;
+    }
+
+    KMS_EXCEPTION_ASSERT((4 <= lCount) && (TOKEN_QTY >= lCount), RESULT_INVALID_CONFIG, "Invalid number of fields", aLine);
+
+    bool lPatternHex;
+    bool lResponseHex;
+
+    KMS_EXCEPTION_ASSERT(ParseType(lTokens[0], &lPatternHex ), RESULT_INVALID_CONFIG, "Invalid pattern type"   , aLine);
+    KMS_EXCEPTION_ASSERT(ParseType(lTokens[2], &lResponseHex), RESULT_INVALID_CONFIG, "Invalid response type"  , aLine);
+
+    Rule lRule;
+
+    lRule.mCount    = 0;
+    lRule.mDelay_us = 0;
+    lRule.mFrameT   = false;
+    lRule.mLine     = aLine;
+
+    for (unsigned int i = 4; i < lCount; i++)
+    {
+        if (0 == _stricmp(lTokens[i], "FRAME_T"))
+        {
+            lRule.mFrameT = true;
+        }
+        else
+        {
+            KMS_EXCEPTION_ASSERT(4 == i, RESULT_INVALID_CONFIG, "The delay comes before FRAME_T", aLine);
+
+            lRule.mDelay_us = Convert::ToUInt32(lTokens[i]);
+        }
+    }
+
+    // ===== Response =======================================================
+    std::vector<uint8_t> lData;
+
+    if (lResponseHex)
+    {
+        auto lText = lTokens[3];
+        auto lSize = static_cast<unsigned int>(strlen(lText));
+
+        KMS_EXCEPTION_ASSERT(0 == (lSize % 2), RESULT_INVALID_CONFIG, "Incomplete byte in the response", aLine);
+
+        for (unsigned int i = 0; i < lSize; i += 2)
+        {
+            lData.push_back(ToByte(lText + i, aLine));
+        }
+    }
+    else
+    {
+        auto lSize_byte = ParseASCII(lTokens[3], aLine);
+
+        lData.assign(lTokens[3], lTokens[3] + lSize_byte);
+    }
+
+    if (lRule.mFrameT)
+    {
+        lRule.mResponse.resize(lData.size() + FRAME_T_OVERHEAD_byte);
+
+        FrameT_Encode(lData.data(), static_cast<unsigned int>(lData.size()), lRule.mResponse.data(), static_cast<unsigned int>(lRule.mResponse.size()));
+    }
+    else
+    {
+        lRule.mResponse = std::move(lData);
+    }
+
+    // ===== Pattern ========================================================
+    // The Matcher gives the patterns consecutive indexes, so the pattern
+    // index is the rule index.
+    unsigned int lPattern;
+
+    if (lPatternHex)
+    {
+        lPattern = mMatcher.AddPattern_Hex(lTokens[1]);
+    }
+    else
+    {
+        auto lSize_byte = ParseASCII(lTokens[1], aLine);
+
+        lPattern = mMatcher.AddPattern(reinterpret_cast<const uint8_t*>(lTokens[1]), nullptr, lSize_byte);
+    }
+
+    assert(mRules.size() == lPattern);
+    (void)lPattern;
+
+    mRules.push_back(std::move(lRule));
+}
+
+// Static functions
+// //////////////////////////////////////////////////////////////////////////
+
+unsigned int ParseASCII(char* aInOut, unsigned int aLine)
+{
+    assert(nullptr != aInOut);
+
+    unsigned int lResult_byte = 0;
+
+    for (unsigned int i = 0; '\0' != aInOut[i]; i++)
+    {
+        char lC = aInOut[i];
+
+        if ('\\' == lC)
+        {
+            i++;
+
+            switch (aInOut[i])
+            {
+            case '\\': lC = '\\'; break;
+            case 'n' : lC = '\n'; break;
+            case 'r' : lC = '\r'; break;
+            case 't' : lC = '\t'; break;
+
+            case 'x':
+                KMS_EXCEPTION_ASSERT(('\0' != aInOut[i + 1]) && ('\0' != aInOut[i + 2]), RESULT_INVALID_CONFIG, "Incomplete \\x escape", aLine);
+                lC = static_cast<char>(ToByte(aInOut + i + 1, aLine));
+                i += 2;
+                break;
+
+            default: KMS_EXCEPTION(RESULT_INVALID_CONFIG, "Invalid escape sequence", aLine);
+            }
+        }
+
+        aInOut[lResult_byte] = lC;
+        lResult_byte++;
+    }
+
+    KMS_EXCEPTION_ASSERT(0 < lResult_byte, RESULT_INVALID_CONFIG, "Empty data", aLine);
+
+    return lResult_byte;
+}
+
+bool ParseType(const char* aIn, bool* aHex)
+{
+    assert(nullptr != aIn);
+    assert(nullptr != aHex);
+
+    if      (0 == _stricmp(aIn, "ASCII")) { *aHex = false; }
+    else if (0 == _stricmp(aIn, "Hex"  )) { *aHex = true ; }
+    else
+    {
+        return false;
+    }
+
+    return true;
+}
+
+uint8_t ToByte(const char* aIn, unsigned int aLine)
+{
+    assert(nullptr != aIn);
+
+    auto lHigh = Hex_ToDigit(aIn[0]);
+    auto lLow  = Hex_ToDigit(aIn[1]);
+
+    KMS_EXCEPTION_ASSERT((0 <= lHigh) && (0 <= lLow), RESULT_INVALID_CONFIG, "Invalid hexadecimal digit", aLine);
+
+    return static_cast<uint8_t>((lHigh << 4) | lLow);
+}
+
+unsigned int Tokenize(char* aIn, char** aTokens, unsigned int aTokenQty)
+{
+    assert(nullptr != aIn);
+    assert(nullptr != aTokens);
+
+    unsigned int lResult = 0;
+    char*        lPtr    = aIn;
+
+    for (;;)
+    {
+        while (isspace(static_cast<unsigned char>(*lPtr))) { lPtr++; }
+
+        if (('\0' == *lPtr) || (aTokenQty <= lResult))
+        {
+            break;
+        }
+
+        aTokens[lResult] = lPtr; lResult++;
+
+        while (('\0' != *lPtr) && !isspace(static_cast<unsigned char>(*lPtr))) { lPtr++; }
+
+        if ('\0' != *lPtr)
+        {
+            *lPtr = '\0';
+            lPtr++;
+        }
+    }
+
+    return lResult;
+}
@@ -0,0 +1,72 @@
+// Author    KMS - Martin Dubois, P. Eng.
+// Copyright (C) 2024 KMS
+// License   http://www.apache.org/licenses/LICENSE-2.0
+// Product   KMS-Tools
+// File      ComTool/Responder.h
+
+#pragma once
+
+// ===== C++ ================================================================
+#include <vector>
+
+// ===== Local ==============================================================
+#include "Matcher.h"
+
+// Table of rules "when this pattern is received, reply this after that
+// delay". All the patterns go into one Matcher, so the received data is
+// scanned once whatever the number of rules. The responses are prepared,
+// FRAME_T included, when the table is loaded.
+class Responder
+{
+
+public:
+
+    Responder();
+
+    // One rule per line, the empty lines and the lines starting with # are
+    // ignored.
+    //   {ASCII|Hex} {Pattern} {ASCII|Hex} {Response} [Delay_us] [FRAME_T]
+    // ASCII data supports \r, \n, \t, \\ and \xHH, so \x20 is a space. Hex
+    // data is pairs of digits without separator and the patterns may
+    // contain '?' wildcards (see Matcher::AddPattern_Hex).
+    void Load(const char* aFileName);
+
+    unsigned int GetDelay_us(unsigned int aRule) const;
+
+    const uint8_t* GetResponse(unsigned int aRule, unsigned int* aSize_byte) const;
+
+    unsigned int GetRuleCount() const;
+
+    // Return true when the response is a FRAME_T frame
+    bool IsFrameT(unsigned int aRule) const;
+
+    // Restart the search and clear the counters
+    void Reset();
+
+    // aRule   The index of the matching rule or Matcher::NO_MATCH
+    // Return  The number of bytes processed, see Matcher::Scan
+    unsigned int Scan(const void* aIn, unsigned int aInSize_byte, unsigned int* aRule);
+
+    // One line per rule: index, match count, response size and delay
+    void Display(std::ostream& aOut) const;
+
+private:
+
+    NO_COPY(Responder);
+
+    struct Rule
+    {
+        uint64_t             mCount;
+        unsigned int         mDelay_us;
+        bool                 mFrameT;
+        unsigned int         mLine;
+        std::vector<uint8_t> mResponse;
+    };
+
+    void ParseLine(char* aIn, unsigned int aLine);
+
+    Matcher mMatcher;
+
+    std::vector<Rule> mRules;
+
+};
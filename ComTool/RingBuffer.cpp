@@ -0,0 +1,161 @@
+// Author    KMS - Martin Dubois, P. Eng.
+// Copyright (C) 2024 KMS
+// License   http://www.apache.org/licenses/LICENSE-2.0
+// Product   KMS-Tools
+// File      ComTool/RingBuffer.cpp
+
+#include "Component.h"
+
+// ===== Local ==============================================================
+#include "RingBuffer.h"
+
+// Public
+// //////////////////////////////////////////////////////////////////////////
+
+RingBuffer::RingBuffer(unsigned int aSize_byte)
+    : mBuffer(new uint8_t[aSize_byte])
+    , mMask(aSize_byte - 1)
+    , mRead_byte(0)
+    , mWrite_byte(0)
+{
+    assert(0 < aSize_byte);
+    assert(0 == (aSize_byte & mMask));
+}
+
+RingBuffer::~RingBuffer()
+{
+    assert(nullptr != mBuffer);
+
+    delete[] mBuffer;
+}
+
+unsigned int RingBuffer::GetFree_byte() const { return GetSize_byte() - GetUsed_byte(); }
+unsigned int RingBuffer::GetSize_byte() const { return mMask + 1; }
+
+unsigned int RingBuffer::GetUsed_byte() const
+{
+    auto lWrite_byte = mWrite_byte.load(std::memory_order_acquire);
+    auto lRead_byte  = mRead_byte .load(std::memory_order_acquire);
+
+    return static_cast<unsigned int>(lWrite_byte - lRead_byte);
+}
+
+void RingBuffer::Reset()
+{
+    mRead_byte .store(0);
+    mWrite_byte.store(0);
+}
+
+// ===== Producer ===========================================================
+
+uint8_t* RingBuffer::Write_Begin(unsigned int* aSize_byte)
+{
+    assert(nullptr != aSize_byte);
+
+    auto lWrite_byte = mWrite_byte.load(std::memory_order_relaxed);
+    auto lRead_byte  = mRead_byte .load(std::memory_order_acquire);
+
+    auto lFree_byte  = GetSize_byte() - static_cast<unsigned int>(lWrite_byte - lRead_byte);
+    auto lIndex      = static_cast<unsigned int>(lWrite_byte) & mMask;
+    auto lToEnd_byte = GetSize_byte() - lIndex;
+
+    *aSize_byte = (lFree_byte < lToEnd_byte) ? lFree_byte : lToEnd_byte;
+
+    return mBuffer + lIndex;
+}
+
+void RingBuffer::Write_End(unsigned int aSize_byte)
+{
+    assert(GetFree_byte() >= aSize_byte);
+
+    mWrite_byte.fetch_add(aSize_byte, std::memory_order_release);
+}
+
+unsigned int RingBuffer::Write(const void* aIn, unsigned int aInSize_byte)
+{
+    assert(nullptr != aIn);
+
+    auto lIn = static_cast<const uint8_t*>(aIn);
+    unsigned int lResult_byte = 0;
+
+    while (lResult_byte < aInSize_byte)
+    {
+        unsigned int lSize_byte;
+
+        auto lOut = Write_Begin(&lSize_byte);
+        if (0 == lSize_byte)
+        {
+            break;
+        }
+
+        if (aInSize_byte - lResult_byte < lSize_byte)
+        {
+            lSize_byte = aInSize_byte - lResult_byte;
+        }
+
+        memcpy(lOut, lIn + lResult_byte, lSize_byte);
+
+        Write_End(lSize_byte);
+
+        lResult_byte += lSize_byte;
+    }
+
+    return lResult_byte;
+}
+
+// ===== Consumer ===========================================================
+
+const uint8_t* RingBuffer::Read_Begin(unsigned int* aSize_byte) const
+{
+    assert(nullptr != aSize_byte);
+
+    auto lRead_byte  = mRead_byte .load(std::memory_order_relaxed);
+    auto lWrite_byte = mWrite_byte.load(std::memory_order_acquire);
+
+    auto lUsed_byte  = static_cast<unsigned int>(lWrite_byte - lRead_byte);
+    auto lIndex      = static_cast<unsigned int>(lRead_byte) & mMask;
+    auto lToEnd_byte = GetSize_byte() - lIndex;
+
+    *aSize_byte = (lUsed_byte < lToEnd_byte) ? lUsed_byte : lToEnd_byte;
+
+    return mBuffer + lIndex;
+}
+
+void RingBuffer::Read_End(unsigned int aSize_byte)
+{
+    assert(GetUsed_byte() >= aSize_byte);
+
+    mRead_byte.fetch_add(aSize_byte, std::memory_order_release);
+}
+
+unsigned int RingBuffer::Read(void* aOut, unsigned int aOutSize_byte)
+{
+    assert(nullptr != aOut);
+
+    auto lOut = static_cast<uint8_t*>(aOut);
+    unsigned int lResult_byte = 0;
+
+    while (lResult_byte < aOutSize_byte)
+    {
+        unsigned int lSize_byte;
+
+        auto lIn = Read_Begin(&lSize_byte);
+        if (0 == lSize_byte)
+        {
+            break;
+        }
+
+        if (aOutSize_byte - lResult_byte < lSize_byte)
+        {
+            lSize_byte = aOutSize_byte - lResult_byte;
+        }
+
+        memcpy(lOut + lResult_byte, lIn, lSize_byte);
+
+        Read_End(lSize_byte);
+
+        lResult_byte += lSize_byte;
+    }
+
+    return lResult_byte;
+}
@@ -0,0 +1,62 @@
+// Author    KMS - Martin Dubois, P. Eng.
+// Copyright (C) 2024 KMS
+// License   http://www.apache.org/licenses/LICENSE-2.0
+// Product   KMS-Tools
+// File      ComTool/RingBuffer.h
+
+#pragma once
+
+// ===== C++ ================================================================
+#include <atomic>
+
+// Single producer / single consumer byte ring. The producer only calls the
+// Write methods and the consumer only calls the Read methods, so no lock is
+// needed. The counters never wrap; the index is the counter masked by the
+// size, which must be a power of 2.
+class RingBuffer
+{
+
+public:
+
+    RingBuffer(unsigned int aSize_byte);
+
+    ~RingBuffer();
+
+    unsigned int GetFree_byte() const;
+    unsigned int GetSize_byte() const;
+    unsigned int GetUsed_byte() const;
+
+    // Not thread safe, the producer and the consumer must be stopped.
+    void Reset();
+
+    // ===== Producer =======================================================
+
+    // Return the first contiguous free region. aSize_byte receives its size.
+    uint8_t* Write_Begin(unsigned int* aSize_byte);
+
+    void Write_End(unsigned int aSize_byte);
+
+    unsigned int Write(const void* aIn, unsigned int aInSize_byte);
+
+    // ===== Consumer =======================================================
+
+    // Return the first contiguous used region. aSize_byte receives its size.
+    const uint8_t* Read_Begin(unsigned int* aSize_byte) const;
+
+    void Read_End(unsigned int aSize_byte);
+
+    unsigned int Read(void* aOut, unsigned int aOutSize_byte);
+
+private:
+
+    NO_COPY(RingBuffer);
+
+    uint8_t*     mBuffer;
+    unsigned int mMask;
+
+    // Each counter lives on its own cache line to avoid false sharing
+    // between the producer and the consumer.
+    alignas(64) std::atomic<uint64_t> mRead_byte;
+    alignas(64) std::atomic<uint64_t> mWrite_byte;
+
+};
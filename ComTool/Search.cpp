@@ -0,0 +1,139 @@
+// Author    KMS - Martin Dubois, P. Eng.
+// Copyright (C) 2024 KMS
+// License   http://www.apache.org/licenses/LICENSE-2.0
+// Product   KMS-Tools
+// File      ComTool/Search.cpp
+
+#include "Component.h"
+
+// ===== C ==================================================================
+#if defined(__SSE2__) || defined(_M_X64)
+    #define SEARCH_SSE2
+
+    #include <emmintrin.h>
+#endif
+
+#ifdef _KMS_WINDOWS_
+    #include <intrin.h>
+#endif
+
+// ===== Local ==============================================================
+#include "Search.h"
+
+// Static function declarations
+// //////////////////////////////////////////////////////////////////////////
+
+static const uint8_t* Find_Scalar(const uint8_t* aIn, uint64_t aInSize_byte, const uint8_t* aPattern, unsigned int aPatternSize_byte);
+
+#ifdef SEARCH_SSE2
+    static unsigned int CountTrailingZeros(uint32_t aIn);
+#endif
+
+// Functions
+// //////////////////////////////////////////////////////////////////////////
+
+// The SSE2 version compares the first and the last byte of the pattern with
+// 16 positions at once. Only the positions where both match go to memcmp,
+// so the data is read about once whatever the pattern.
+const uint8_t* Search_Find(const uint8_t* aIn, uint64_t aInSize_byte, const uint8_t* aPattern, unsigned int aPatternSize_byte)
+{
+    assert(nullptr != aIn);
+    assert(nullptr != aPattern);
+    assert(0 < aPatternSize_byte);
+
+    if (aInSize_byte < aPatternSize_byte)
+    {
+        return nullptr;
+    }
+
+    #ifdef SEARCH_SSE2
+
+        if (1 < aPatternSize_byte)
+        {
+            auto lLast  = aPatternSize_byte - 1;
+            auto lFirst = _mm_set1_epi8(static_cast<char>(aPattern[0]));
+            auto lEnd   = _mm_set1_epi8(static_cast<char>(aPattern[lLast]));
+
+            uint64_t lPos = 0;
+
+            for (; lPos + lLast + 16 <= aInSize_byte; lPos += 16)
+            {
+                auto lA = _mm_loadu_si128(reinterpret_cast<const __m128i*>(aIn + lPos));
+                auto lB = _mm_loadu_si128(reinterpret_cast<const __m128i*>(aIn + lPos + lLast));
+
+                auto lMask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(lA, lFirst), _mm_cmpeq_epi8(lB, lEnd))));
+
+                while (0 != lMask)
+                {
+                    auto lBit = CountTrailingZeros(lMask);
+
+                    if (0 == memcmp(aIn + lPos + lBit + 1, aPattern + 1, lLast - 1))
+                    {
+                        return aIn + lPos + lBit;
+                    }
+
+                    lMask &= lMask - 1;
+                }
+            }
+
+            auto lResult = Find_Scalar(aIn + lPos, aInSize_byte - lPos, aPattern, aPatternSize_byte);
+
+            return lResult;
+        }
+
+    #endif
+
+    return Find_Scalar(aIn, aInSize_byte, aPattern, aPatternSize_byte);
+}
+
+// Static functions
+// //////////////////////////////////////////////////////////////////////////
+
+// memchr is vectorized by the C library
+const uint8_t* Find_Scalar(const uint8_t* aIn, uint64_t aInSize_byte, const uint8_t* aPattern, unsigned int aPatternSize_byte)
+{
+    if (aInSize_byte < aPatternSize_byte)
+    {
+        return nullptr;
+    }
+
+    auto lPtr = aIn;
+    auto lEnd = aIn + aInSize_byte - aPatternSize_byte + 1;
+
+    while (lPtr < lEnd)
+    {
+        lPtr = static_cast<const uint8_t*>(memchr(lPtr, aPattern[0], lEnd - lPtr));
+        if (nullptr == lPtr)
+        {
+            break;
+        }
+
+        if (0 == memcmp(lPtr + 1, aPattern + 1, aPatternSize_byte - 1))
+        {
+            return lPtr;
+        }
+
+        lPtr++;
+    }
+
+    return nullptr;
+}
+
+#ifdef SEARCH_SSE2
+
+    unsigned int CountTrailingZeros(uint32_t aIn)
+    {
+        assert(0 != aIn);
+
+        #ifdef _KMS_WINDOWS_
+            unsigned long lResult;
+
+            _BitScanForward(&lResult, aIn);
+
+            return lResult;
+        #else
+            return __builtin_ctz(aIn);
+        #endif
+    }
+
+#endif
@@ -0,0 +1,10 @@
+// Author    KMS - Martin Dubois, P. Eng.
+// Copyright (C) 2024 KMS
+// License   http://www.apache.org/licenses/LICENSE-2.0
+// Product   KMS-Tools
+// File      ComTool/Search.h
+
+#pragma once
+
+// Return  The first occurrence of the pattern in the data, or nullptr
+extern const uint8_t* Search_Find(const uint8_t* aIn, uint64_t aInSize_byte, const uint8_t* aPattern, unsigned int aPatternSize_byte);
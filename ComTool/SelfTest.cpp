@@ -0,0 +1,374 @@
+// Author    KMS - Martin Dubois, P. Eng.
+// Copyright (C) 2024 KMS
+// License   http://www.apache.org/licenses/LICENSE-2.0
+// Product   KMS-Tools
+// File      ComTool/SelfTest.cpp
+
+#include "Component.h"
+
+#ifdef _DEBUG
+
+// ===== C++ ================================================================
+#include <sstream>
+#include <string>
+#include <vector>
+
+// ===== Local ==============================================================
+#include "CRC16.h"
+#include "Deframer.h"
+#include "Detector.h"
+#include "FrameT.h"
+#include "IDetectTarget.h"
+#include "IFrameListener.h"
+
+#include "SelfTest.h"
+
+using namespace KMS;
+
+// Constants
+// //////////////////////////////////////////////////////////////////////////
+
+#define DEFRAMER_PAIR_QTY (100)
+
+#define DETECTOR_FRAME_QTY  (40)
+#define DETECTOR_SPEED_bps  (19200)
+#define DETECTOR_WINDOW_ms  (10)
+
+// Class
+// //////////////////////////////////////////////////////////////////////////
+
+class FrameRecorder final : public IFrameListener
+{
+
+public:
+
+    // ===== IFrameListener =================================================
+
+    virtual void OnFrame(const uint8_t* aIn, unsigned int aInSize_byte)
+    {
+        mEvents += 'F';
+        mPayloads.push_back(std::vector<uint8_t>(aIn, aIn + aInSize_byte));
+    }
+
+    virtual void OnFrameError(const uint8_t*, unsigned int) { mEvents += 'E'; }
+
+    std::string                       mEvents;
+    std::vector<std::vector<uint8_t>> mPayloads;
+
+};
+
+// A UART set by Detector::Sweep receives the characters sent with another
+// setting. It builds each byte from the line levels at its own bit times
+// and returns 0x00 for a character with a framing or parity error.
+class UartTarget final : public IDetectTarget
+{
+
+public:
+
+    UartTarget(const std::vector<uint8_t>& aSent, uint32_t aSpeed_bps, Com::Parity aParity)
+        : mParity(aParity), mSent(aSent), mSpeed_bps(aSpeed_bps), mPos_byte(0)
+    {}
+
+    // ===== IDetectTarget ==================================================
+
+    virtual void OnDetectBegin(uint32_t aSpeed_bps, Com::Parity aParity)
+    {
+        Resample(aSpeed_bps, aParity);
+
+        mPos_byte = 0;
+    }
+
+    virtual unsigned int OnDetectRead(uint8_t* aOut, unsigned int aOutSize_byte, unsigned int aTimeout_ms)
+    {
+        auto lResult_byte = static_cast<unsigned int>(mReceived.size()) - mPos_byte;
+        if (0 == lResult_byte)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(aTimeout_ms));
+            return 0;
+        }
+
+        if (aOutSize_byte < lResult_byte)
+        {
+            lResult_byte = aOutSize_byte;
+        }
+
+        memcpy(aOut, mReceived.data() + mPos_byte, lResult_byte);
+
+        mPos_byte += lResult_byte;
+
+        return lResult_byte;
+    }
+
+    virtual void OnDetectEnd() {}
+
+private:
+
+    static unsigned int GetCharSize_bit(Com::Parity aParity) { return (Com::Parity::NONE == aParity) ? 10 : 11; }
+
+    static unsigned int GetParityBit(uint8_t aByte, Com::Parity aParity)
+    {
+        unsigned int lOnes = 0;
+
+        for (unsigned int b = 0; b < 8; b++)
+        {
+            lOnes += (aByte >> b) & 1;
+        }
+
+        return (Com::Parity::EVEN == aParity) ? (lOnes & 1) : ((lOnes + 1) & 1);
+    }
+
+    // Line level during the bit sent aIndex, the line is idle (1) after the
+    // last stop bit
+    unsigned int GetLevel(unsigned int aIndex) const
+    {
+        auto lChar_bit = GetCharSize_bit(mParity);
+
+        if (mSent.size() * lChar_bit <= aIndex) { return 1; }
+
+        auto lBit  = aIndex % lChar_bit;
+        auto lByte = mSent[aIndex / lChar_bit];
+
+        if (0             == lBit) { return 0; }
+        if (lChar_bit - 1 == lBit) { return 1; }
+        if (9             == lBit) { return GetParityBit(lByte, mParity); }
+
+        return (lByte >> (lBit - 1)) & 1;
+    }
+
+    void Resample(uint32_t aSpeed_bps, Com::Parity aParity)
+    {
+        auto   lLine_bit = static_cast<unsigned int>(mSent.size()) * GetCharSize_bit(mParity);
+        double lRxBit_s  = 1.0 / aSpeed_bps;
+        double lTime_s   = 0.0;
+        double lTxBit_s  = 1.0 / mSpeed_bps;
+
+        mReceived.clear();
+
+        for (;;)
+        {
+            // The UART waits for the line to go low
+            auto lIndex = static_cast<unsigned int>(lTime_s / lTxBit_s);
+
+            while ((lLine_bit > lIndex) && (0 != GetLevel(lIndex))) { lIndex++; }
+
+            if (lLine_bit <= lIndex) { break; }
+
+            double lStart_s = (lTime_s > lIndex * lTxBit_s) ? lTime_s : lIndex * lTxBit_s;
+
+            // Sample each bit at its middle
+            auto lSample = [&](unsigned int aBit) { return GetLevel(static_cast<unsigned int>((lStart_s + (aBit + 0.5) * lRxBit_s) / lTxBit_s)); };
+
+            uint8_t lByte = 0;
+
+            for (unsigned int b = 0; b < 8; b++)
+            {
+                lByte |= lSample(1 + b) << b;
+            }
+
+            auto lChar_bit = GetCharSize_bit(aParity);
+            bool lError    = (0 == lSample(lChar_bit - 1));
+
+            if ((Com::Parity::NONE != aParity) && (GetParityBit(lByte, aParity) != lSample(9)))
+            {
+                lError = true;
+            }
+
+            mReceived.push_back(lError ? 0x00 : lByte);
+
+            lTime_s = lStart_s + lChar_bit * lRxBit_s;
+        }
+    }
+
+    Com::Parity                 mParity;
+    std::vector<uint8_t>        mReceived;
+    const std::vector<uint8_t>& mSent;
+    uint32_t                    mSpeed_bps;
+    unsigned int                mPos_byte;
+
+};
+
+// Static function declarations
+// //////////////////////////////////////////////////////////////////////////
+
+static bool Check(std::ostream& aOut, const char* aName, bool aPassed, const char* aDetail);
+
+// Bad, good, bad, good... frames pushed in chunks of 1 to 17 bytes
+static bool Test_Deframer(std::ostream& aOut);
+
+// Modbus RTU frames sent at DETECTOR_SPEED_bps with aParity, the AutoDetect
+// sweep must find the setting
+static bool Test_Detector(std::ostream& aOut, Com::Parity aParity, const char* aName);
+
+// Functions
+// //////////////////////////////////////////////////////////////////////////
+
+unsigned int SelfTest_Run(std::ostream& aOut)
+{
+    unsigned int lResult = 0;
+
+    if (!Test_Deframer(aOut)) { lResult++; }
+
+    if (!Test_Detector(aOut, Com::Parity::NONE, "Detector 8N1")) { lResult++; }
+    if (!Test_Detector(aOut, Com::Parity::EVEN, "Detector 8E1")) { lResult++; }
+
+    return lResult;
+}
+
+// Static functions
+// //////////////////////////////////////////////////////////////////////////
+
+bool Check(std::ostream& aOut, const char* aName, bool aPassed, const char* aDetail)
+{
+    assert(nullptr != aName);
+    assert(nullptr != aDetail);
+
+    aOut << (aPassed ? "PASSED " : "FAILED ") << aName << " - " << aDetail << "\n";
+
+    return aPassed;
+}
+
+bool Test_Deframer(std::ostream& aOut)
+{
+    FrameRecorder lRecorder;
+    Deframer      lDeframer(&lRecorder);
+
+    std::vector<uint8_t>              lStream;
+    std::vector<std::vector<uint8_t>> lExpected;
+    std::string                       lEvents;
+
+    uint8_t lFrame[64 + FRAME_T_OVERHEAD_byte];
+
+    for (unsigned int i = 0; i < 2 * DEFRAMER_PAIR_QTY; i++)
+    {
+        std::vector<uint8_t> lPayload(1 + i % 64);
+
+        for (unsigned int j = 0; j < lPayload.size(); j++)
+        {
+            lPayload[j] = static_cast<uint8_t>(i + 13 * j);
+        }
+
+        auto lSize_byte = FrameT_Encode(lPayload.data(), static_cast<unsigned int>(lPayload.size()), lFrame, sizeof(lFrame));
+
+        // A 0x7f followed by 0x7e inside a frame would split it, the test
+        // data avoids it.
+        bool lSplit = false;
+        for (unsigned int j = 1; j + 2 < lSize_byte; j++)
+        {
+            if ((0x7f == lFrame[j]) && (0x7e == lFrame[j + 1])) { lSplit = true; }
+        }
+
+        if (lSplit)
+        {
+            lPayload[0] ^= 0x01;
+            lSize_byte = FrameT_Encode(lPayload.data(), static_cast<unsigned int>(lPayload.size()), lFrame, sizeof(lFrame));
+        }
+
+        if (0 == (i % 2))
+        {
+            // Bad, one payload bit flipped
+            lFrame[FRAME_T_HEADER_byte] ^= 0x04;
+            lEvents += 'E';
+        }
+        else
+        {
+            lExpected.push_back(lPayload);
+            lEvents += 'F';
+        }
+
+        lStream.insert(lStream.end(), lFrame, lFrame + lSize_byte);
+    }
+
+    // The error of the last bad frame is only known at the next 0x7e, the
+    // last frame is good.
+    unsigned int lOffset_byte = 0;
+
+    for (unsigned int lChunk_byte = 1; lOffset_byte < lStream.size(); lChunk_byte = lChunk_byte % 17 + 1)
+    {
+        if (lChunk_byte > lStream.size() - lOffset_byte)
+        {
+            lChunk_byte = static_cast<unsigned int>(lStream.size() - lOffset_byte);
+        }
+
+        lDeframer.Push(lStream.data() + lOffset_byte, lChunk_byte);
+
+        lOffset_byte += lChunk_byte;
+    }
+
+    char lDetail[128];
+
+    sprintf_s(lDetail SizeInfo(lDetail), "frames %u / %u, errors %u / %u", static_cast<unsigned int>(lDeframer.mFrameCount), DEFRAMER_PAIR_QTY, static_cast<unsigned int>(lDeframer.mCRCErrorCount), DEFRAMER_PAIR_QTY);
+
+    auto lPassed = (DEFRAMER_PAIR_QTY == lDeframer.mFrameCount)
+                && (DEFRAMER_PAIR_QTY == lDeframer.mCRCErrorCount)
+                && (lEvents   == lRecorder.mEvents)
+                && (lExpected == lRecorder.mPayloads);
+
+    return Check(aOut, "Deframer", lPassed, lDetail);
+}
+
+bool Test_Detector(std::ostream& aOut, Com::Parity aParity, const char* aName)
+{
+    std::vector<uint8_t> lSent;
+
+    for (unsigned int i = 0; i < DETECTOR_FRAME_QTY; i++)
+    {
+        // Read holding registers, request and response
+        uint8_t      lFrame[16];
+        unsigned int lSize_byte;
+
+        lFrame[0] = static_cast<uint8_t>(1 + i % 4);
+        lFrame[1] = 0x03;
+
+        if (0 == (i % 2))
+        {
+            lFrame[2] = 0x00;
+            lFrame[3] = static_cast<uint8_t>(17 * i);
+            lFrame[4] = 0x00;
+            lFrame[5] = 0x02;
+            lSize_byte = 6;
+        }
+        else
+        {
+            lFrame[2] = 4;
+            lFrame[3] = static_cast<uint8_t>(i);
+            lFrame[4] = static_cast<uint8_t>(31 * i);
+            lFrame[5] = 0x80;
+            lFrame[6] = static_cast<uint8_t>(7 * i + 3);
+            lSize_byte = 7;
+        }
+
+        auto lCRC = CRC16_Modbus_Compute(CRC16_MODBUS_INIT, lFrame, lSize_byte);
+
+        lFrame[lSize_byte    ] = static_cast<uint8_t>(lCRC);
+        lFrame[lSize_byte + 1] = static_cast<uint8_t>(lCRC >> 8);
+
+        lSent.insert(lSent.end(), lFrame, lFrame + lSize_byte + 2);
+    }
+
+    UartTarget lTarget(lSent, DETECTOR_SPEED_bps, aParity);
+    Detector   lDetector;
+
+    // The candidate lines are not part of the check
+    std::ostringstream lTrace;
+
+    unsigned int lParity;
+    double       lScore;
+    uint32_t     lSpeed_bps;
+
+    auto lConfident = lDetector.Sweep(&lTarget, Detector::SPEEDS_bps, Detector::SPEED_QTY, DETECTOR_WINDOW_ms, lTrace, &lSpeed_bps, &lParity, &lScore);
+
+    auto lProtocol = lDetector.GetProtocol();
+
+    char lDetail[128];
+
+    sprintf_s(lDetail SizeInfo(lDetail), "%u 8%c1, score %.2f, %s", lSpeed_bps, Detector::PARITY_CHARS[lParity], lScore, (nullptr == lProtocol) ? "no protocol" : lProtocol);
+
+    auto lPassed = lConfident
+                && (DETECTOR_SPEED_bps == lSpeed_bps)
+                && (aParity == Detector::PARITIES[lParity])
+                && (nullptr != lProtocol) && (0 == strcmp("ModbusRTU", lProtocol));
+
+    return Check(aOut, aName, lPassed, lDetail);
+}
+
+#endif
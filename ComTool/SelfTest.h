@@ -0,0 +1,13 @@
+// Author    KMS - Martin Dubois, P. Eng.
+// Copyright (C) 2024 KMS
+// License   http://www.apache.org/licenses/LICENSE-2.0
+// Product   KMS-Tools
+// File      ComTool/SelfTest.h
+
+#pragma once
+
+// Check the stream decoders and the AutoDetect sweep on generated data. No
+// port is needed. Each check writes one line. Only the debug build has the
+// checks, they do not ship with the tool.
+// Return  The number of failed checks
+extern unsigned int SelfTest_Run(std::ostream& aOut);
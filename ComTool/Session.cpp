@@ -0,0 +1,341 @@
+// Author    KMS - Martin Dubois, P. Eng.
+// Copyright (C) 2024 KMS
+// License   http://www.apache.org/licenses/LICENSE-2.0
+// Product   KMS-Tools
+// File      ComTool/Session.cpp
+
+#include "Component.h"
+
+// ===== C++ ================================================================
+#include <chrono>
+
+// ===== Local ==============================================================
+#include "CaptureWriter.h"
+#include "Clock.h"
+
+#include "Session.h"
+
+using namespace KMS;
+
+// Constants
+// //////////////////////////////////////////////////////////////////////////
+
+// The index 0 is the main port in the capture records
+#define CHANNEL_QTY_MAX (0xfffe)
+
+#define IDLE_PERIOD_ms (1)
+
+// Size of the buffer receiving the data of a port while its ring is full
+#define OVERFLOW_SIZE_byte (64 * 1024)
+
+// Public
+// //////////////////////////////////////////////////////////////////////////
+
+Session::Channel::Channel(const char* aName, Com::Port* aPort, uint16_t aIndex)
+    : mIndex(aIndex)
+    , mName(aName)
+    , mPort(aPort)
+    , mReceiver(aPort, &mGaps)
+    , mOverflow_byte(0)
+{
+    assert(nullptr != aName);
+    assert(nullptr != aPort);
+}
+
+Session::Session()
+    : mCapture(nullptr)
+    , mRunning(false)
+    , mRequest(nullptr)
+    , mIdleCount(0)
+    , mSweepCount(0)
+{}
+
+Session::~Session()
+{
+    Stop();
+
+    for (auto lChannel : mChannels)
+    {
+        assert(nullptr != lChannel);
+
+        delete lChannel;
+    }
+}
+
+void Session::AddPort(const char* aName, Com::Port* aPort)
+{
+    assert(nullptr != aName);
+    assert(nullptr != aPort);
+
+    KMS_EXCEPTION_ASSERT(!mRunning, RESULT_INVALID_COMMAND, "The session is running", aName);
+    KMS_EXCEPTION_ASSERT(nullptr == FindChannel(aName), RESULT_INVALID_CONFIG, "The port name is already used", aName);
+    KMS_EXCEPTION_ASSERT(CHANNEL_QTY_MAX > mChannels.size(), RESULT_INVALID_CONFIG, "Too many ports", aName);
+
+    auto lIndex = static_cast<uint16_t>(mChannels.size() + 1);
+
+    mChannels.push_back(new Channel(aName, aPort, lIndex));
+}
+
+Session::Channel* Session::FindChannel(const char* aName)
+{
+    assert(nullptr != aName);
+
+    for (auto lChannel : mChannels)
+    {
+        assert(nullptr != lChannel);
+
+        if (0 == _stricmp(lChannel->mName.c_str(), aName))
+        {
+            return lChannel;
+        }
+    }
+
+    return nullptr;
+}
+
+unsigned int Session::GetChannelCount() const { return static_cast<unsigned int>(mChannels.size()); }
+
+bool Session::IsRunning() const { return mRunning; }
+
+void Session::Start(unsigned int aSize_byte, CaptureWriter* aCapture)
+{
+    KMS_EXCEPTION_ASSERT(!mRunning, RESULT_INVALID_COMMAND, "The session is already running", "");
+    KMS_EXCEPTION_ASSERT(!mChannels.empty(), RESULT_INVALID_CONFIG, "The session has no port", "");
+
+    for (auto lChannel : mChannels)
+    {
+        assert(nullptr != lChannel);
+
+        lChannel->mGaps.Reset();
+
+        lChannel->mOverflow_byte = 0;
+
+        lChannel->mReceiver.Start(aSize_byte, false);
+    }
+
+    mCapture = aCapture;
+
+    mIdleCount  = 0;
+    mSweepCount = 0;
+
+    mRunning = true;
+
+    mThread = std::thread(&Session::Run, this);
+}
+
+void Session::Stop()
+{
+    {
+        std::lock_guard<std::mutex> lLock(mMutex);
+
+        mRunning = false;
+    }
+
+    mCondition.notify_one();
+
+    if (mThread.joinable())
+    {
+        mThread.join();
+    }
+
+    for (auto lChannel : mChannels)
+    {
+        assert(nullptr != lChannel);
+
+        lChannel->mReceiver.Stop();
+    }
+
+    mCapture = nullptr;
+}
+
+bool Session::Write(Channel* aChannel, const void* aIn, unsigned int aInSize_byte, uint64_t* aTime_ns)
+{
+    assert(nullptr != aChannel);
+    assert(nullptr != aChannel->mPort);
+    assert(nullptr != aTime_ns);
+
+    if (!mRunning)
+    {
+        *aTime_ns = Clock_GetTime_ns();
+
+        return aChannel->mPort->Write(aIn, aInSize_byte);
+    }
+
+    Request lRequest;
+
+    lRequest.mChannel     = aChannel;
+    lRequest.mDone        = false;
+    lRequest.mIn          = aIn;
+    lRequest.mInSize_byte = aInSize_byte;
+    lRequest.mResult      = false;
+    lRequest.mTime_ns     = 0;
+
+    {
+        std::unique_lock<std::mutex> lLock(mMutex);
+
+        assert(nullptr == mRequest);
+
+        mRequest = &lRequest;
+
+        mCondition.notify_one();
+
+        mDoneCondition.wait(lLock, [&lRequest] { return lRequest.mDone; });
+    }
+
+    if (lRequest.mException)
+    {
+        std::rethrow_exception(lRequest.mException);
+    }
+
+    *aTime_ns = lRequest.mTime_ns;
+
+    return lRequest.mResult;
+}
+
+void Session::DisplayStatus(std::ostream& aOut) const
+{
+    aOut << "Session    : " << (mRunning ? "Running" : "Stopped") << ", " << mChannels.size() << " ports\n";
+    aOut << "    Sweeps : " << mSweepCount << " (" << mIdleCount << " idle)\n";
+
+    for (auto lChannel : mChannels)
+    {
+        assert(nullptr != lChannel);
+
+        aOut << "    [" << lChannel->mIndex << "] " << lChannel->mName << " : ";
+        aOut << lChannel->mReceiver.GetByteCount() << " bytes, ";
+        aOut << lChannel->mOverflow_byte << " bytes not kept for the commands\n";
+
+        lChannel->mGaps.Display(aOut, "        Byte gaps", false);
+    }
+}
+
+// Private
+// //////////////////////////////////////////////////////////////////////////
+
+// The ring is full because no command consumes the data of this port. The
+// data still goes to the capture so the capture stays complete.
+bool Session::Overflow(Channel* aChannel, uint8_t* aBuffer)
+{
+    assert(nullptr != aChannel);
+    assert(nullptr != aBuffer);
+
+    unsigned int lSize_byte;
+
+    try
+    {
+        lSize_byte = aChannel->mPort->Read(aBuffer, OVERFLOW_SIZE_byte, 0);
+    }
+    catch (...)
+    {
+        return false;
+    }
+
+    if (0 == lSize_byte)
+    {
+        return false;
+    }
+
+    auto lNow_ns = Clock_GetTime_ns();
+
+    aChannel->mGaps.Add(lNow_ns);
+
+    aChannel->mOverflow_byte += lSize_byte;
+
+    if (nullptr != mCapture)
+    {
+        mCapture->Write(mCapture->ToTime_ns(lNow_ns), CaptureFile::DIRECTION_RECEIVE, 0, aBuffer, lSize_byte, aChannel->mIndex);
+    }
+
+    return true;
+}
+
+bool Session::ProcessRequest()
+{
+    std::lock_guard<std::mutex> lLock(mMutex);
+
+    if (nullptr == mRequest)
+    {
+        return false;
+    }
+
+    auto lR = mRequest;
+
+    assert(nullptr != lR->mChannel);
+    assert(nullptr != lR->mChannel->mPort);
+
+    lR->mTime_ns = Clock_GetTime_ns();
+
+    try
+    {
+        lR->mResult = lR->mChannel->mPort->Write(lR->mIn, lR->mInSize_byte);
+
+        if (nullptr != mCapture)
+        {
+            mCapture->Write(mCapture->ToTime_ns(lR->mTime_ns), CaptureFile::DIRECTION_SEND, 0, lR->mIn, lR->mInSize_byte, lR->mChannel->mIndex);
+        }
+    }
+    catch (...)
+    {
+        lR->mException = std::current_exception();
+    }
+
+    lR->mDone = true;
+
+    mRequest = nullptr;
+
+    mDoneCondition.notify_one();
+
+    return true;
+}
+
+// Each sweep reads every port once. The loop only waits when a complete
+// sweep found nothing to do, so a busy port never waits for an idle one.
+void Session::Run()
+{
+    std::vector<uint8_t> lOverflow(OVERFLOW_SIZE_byte);
+
+    while (mRunning)
+    {
+        bool lActive = ProcessRequest();
+
+        for (auto lChannel : mChannels)
+        {
+            assert(nullptr != lChannel);
+
+            const uint8_t* lData;
+            unsigned int   lSize_byte;
+            uint64_t       lTime_ns;
+
+            // One read of each port per sweep. Poll does not read when the
+            // ring is full, the overflow read does. A port whose read failed
+            // waits for the next sweep.
+            if (lChannel->mReceiver.Poll(&lSize_byte, &lData, &lTime_ns))
+            {
+                if (0 < lSize_byte)
+                {
+                    lActive = true;
+
+                    if (nullptr != mCapture)
+                    {
+                        mCapture->Write(mCapture->ToTime_ns(lTime_ns), CaptureFile::DIRECTION_RECEIVE, 0, lData, lSize_byte, lChannel->mIndex);
+                    }
+                }
+            }
+            else if (lChannel->mReceiver.IsFull())
+            {
+                lActive |= Overflow(lChannel, lOverflow.data());
+            }
+        }
+
+        mSweepCount++;
+
+        if (!lActive)
+        {
+            mIdleCount++;
+
+            std::unique_lock<std::mutex> lLock(mMutex);
+
+            mCondition.wait_for(lLock, std::chrono::milliseconds(IDLE_PERIOD_ms), [this] { return (nullptr != mRequest) || !mRunning; });
+        }
+    }
+}
@@ -0,0 +1,133 @@
+// Author    KMS - Martin Dubois, P. Eng.
+// Copyright (C) 2024 KMS
+// License   http://www.apache.org/licenses/LICENSE-2.0
+// Product   KMS-Tools
+// File      ComTool/Session.h
+
+#pragma once
+
+// ===== C++ ================================================================
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// ===== Import/Includes ====================================================
+#include <KMS/Com/Port.h>
+
+// ===== Local ==============================================================
+#include "GapStats.h"
+#include "Receiver.h"
+
+class CaptureWriter;
+
+// A set of named ports serviced by one thread. The thread reads each port
+// in turn into its receiver and performs the writes the other threads
+// request, so all the I/O of the session goes through one loop. Because the
+// loop takes the time of each record just before writing it to the capture,
+// the capture is ordered by time across all the ports.
+//
+// The loop reads the ports without waiting, so the ports must be configured
+// to return immediately when no data is available.
+class Session
+{
+
+public:
+
+    // A named port and the objects receiving its data
+    class Channel
+    {
+
+    public:
+
+        Channel(const char* aName, KMS::Com::Port* aPort, uint16_t aIndex);
+
+        GapStats        mGaps;
+        uint16_t        mIndex;
+        std::string     mName;
+        KMS::Com::Port* mPort;
+        Receiver        mReceiver;
+
+        // Bytes the loop received while the ring was full. They go to the
+        // capture but the commands do not see them.
+        std::atomic<uint64_t> mOverflow_byte;
+
+    private:
+
+        NO_COPY(Channel);
+
+    };
+
+    Session();
+
+    ~Session();
+
+    // The caller keeps the ownership of aPort
+    void AddPort(const char* aName, KMS::Com::Port* aPort);
+
+    // Return  nullptr when no port has this name
+    Channel* FindChannel(const char* aName);
+
+    unsigned int GetChannelCount() const;
+
+    bool IsRunning() const;
+
+    // aSize_byte  Ring size of each port
+    // aCapture    Receives the records of all the ports, may be nullptr.
+    //             The caller opens it and keeps its ownership.
+    void Start(unsigned int aSize_byte, CaptureWriter* aCapture);
+
+    void Stop();
+
+    // When the session is running, the loop performs the write.
+    // aTime_ns  Clock_GetTime_ns value taken just before the write
+    bool Write(Channel* aChannel, const void* aIn, unsigned int aInSize_byte, uint64_t* aTime_ns);
+
+    void DisplayStatus(std::ostream& aOut) const;
+
+private:
+
+    NO_COPY(Session);
+
+    struct Request
+    {
+        Channel*           mChannel;
+        bool               mDone;
+        std::exception_ptr mException;
+        const void*        mIn;
+        unsigned int       mInSize_byte;
+        bool               mResult;
+        uint64_t           mTime_ns;
+    };
+
+    // aBuffer  OVERFLOW_SIZE_byte bytes
+    // Return   true when data was received
+    bool Overflow(Channel* aChannel, uint8_t* aBuffer);
+
+    // Return  true when a request was processed
+    bool ProcessRequest();
+
+    void Run();
+
+    CaptureWriter*        mCapture;
+    std::vector<Channel*> mChannels;
+    std::thread           mThread;
+
+    std::atomic<bool> mRunning;
+
+    // ===== Requests =======================================================
+    // The loop waits on mCondition while the ports are idle, so a request
+    // does not wait for the end of the poll period.
+    std::condition_variable mCondition;
+    std::condition_variable mDoneCondition;
+    std::mutex              mMutex;
+    Request*                mRequest;
+
+    // ===== Statistics =====================================================
+    std::atomic<uint64_t> mIdleCount;
+    std::atomic<uint64_t> mSweepCount;
+
+};
@@ -0,0 +1,268 @@
+// Author    KMS - Martin Dubois, P. Eng.
+// Copyright (C) 2024 KMS
+// License   http://www.apache.org/licenses/LICENSE-2.0
+// Product   KMS-Tools
+// File      ComTool/Stats.cpp
+
+#include "Component.h"
+
+// ===== Local ==============================================================
+#include "CaptureFile.h"
+#include "Clock.h"
+#include "GapStats.h"
+
+#include "Stats.h"
+
+using namespace KMS;
+
+// Constants
+// //////////////////////////////////////////////////////////////////////////
+
+// Number of seconds Status displays
+#define DISPLAY_QTY (10)
+
+static const char* DIRECTION_NAMES[2] = { "rx", "tx" };
+
+// Public
+// //////////////////////////////////////////////////////////////////////////
+
+Stats::Stats(const GapStats* aGaps) : mGaps(aGaps), mLogPeriod_ms(0), mLogRunning(false)
+{
+    Reset();
+}
+
+Stats::~Stats() { Log_Stop(); }
+
+void Stats::AddRecord(uint64_t aTime_ns, uint8_t aDirection, uint8_t aCaptureFlags, unsigned int aSize_byte)
+{
+    assert(CaptureFile::DIRECTION_SEND >= aDirection);
+
+    auto& lDirection = mDirections[aDirection];
+
+    lDirection.mByteCount  .fetch_add(aSize_byte, std::memory_order_relaxed);
+    lDirection.mRecordCount.fetch_add(1         , std::memory_order_relaxed);
+
+    if (0 != (aCaptureFlags & CaptureFile::FLAG_FRAME_ERROR  )) { mCRCErrorCount    .fetch_add(1, std::memory_order_relaxed); }
+    if (0 != (aCaptureFlags & CaptureFile::FLAG_MESSAGE_ERROR)) { mIncompleteCount  .fetch_add(1, std::memory_order_relaxed); }
+    if (0 != (aCaptureFlags & CaptureFile::FLAG_VERIFY_FAILED)) { mVerifyFailedCount.fetch_add(1, std::memory_order_relaxed); }
+    if (0 != (aCaptureFlags & CaptureFile::FLAG_VERIFY_PASSED)) { mVerifyPassedCount.fetch_add(1, std::memory_order_relaxed); }
+
+    // ===== History ========================================================
+    auto lSecond  = aTime_ns / 1000000000;
+    auto lCurrent = mSecond.load(std::memory_order_relaxed);
+
+    if (lCurrent < lSecond)
+    {
+        // Clear the seconds without traffic
+        auto lFirst = (HISTORY_QTY < lSecond - lCurrent) ? lSecond - HISTORY_QTY + 1 : lCurrent + 1;
+
+        for (auto s = lFirst; s <= lSecond; s++)
+        {
+            for (auto& lD : mDirections)
+            {
+                lD.mHistory_byte[s % HISTORY_QTY].store(0, std::memory_order_relaxed);
+            }
+        }
+
+        mSecond.store(lSecond, std::memory_order_relaxed);
+
+        lCurrent = lSecond;
+    }
+
+    // The chunks come in time order per port, but the Bridge interleaves
+    // two ports, so a record may belong to a second already started.
+    if (HISTORY_QTY > lCurrent - lSecond)
+    {
+        lDirection.mHistory_byte[lSecond % HISTORY_QTY].fetch_add(aSize_byte, std::memory_order_relaxed);
+    }
+}
+
+void Stats::AddTimeout() { mTimeoutCount.fetch_add(1, std::memory_order_relaxed); }
+
+void Stats::Reset()
+{
+    for (auto& lD : mDirections)
+    {
+        lD.mByteCount   = 0;
+        lD.mRecordCount = 0;
+
+        for (auto& lH : lD.mHistory_byte)
+        {
+            lH = 0;
+        }
+    }
+
+    mCRCErrorCount     = 0;
+    mIncompleteCount   = 0;
+    mSecond            = 0;
+    mStart_ns          = Clock_GetTime_ns();
+    mTimeoutCount      = 0;
+    mVerifyFailedCount = 0;
+    mVerifyPassedCount = 0;
+}
+
+void Stats::Log_Start(const char* aFileName, unsigned int aPeriod_ms)
+{
+    assert(nullptr != aFileName);
+
+    KMS_EXCEPTION_ASSERT(!mLogRunning, RESULT_INVALID_COMMAND, "The statistics log is already running", aFileName);
+    KMS_EXCEPTION_ASSERT(0 < aPeriod_ms, RESULT_INVALID_VALUE, "Invalid period", aPeriod_ms);
+
+    // Appending lets many soak test runs share one file
+    mLogFile.open(aFileName, std::ios::out | std::ios::app);
+    KMS_EXCEPTION_ASSERT(mLogFile.is_open(), RESULT_OPEN_FAILED, "Cannot open the statistics log", aFileName);
+
+    mLogPeriod_ms = aPeriod_ms;
+    mLogRunning   = true;
+
+    mLogThread = std::thread(&Stats::Log_Run, this);
+}
+
+void Stats::Log_Stop()
+{
+    {
+        std::lock_guard<std::mutex> lLock(mLogMutex);
+
+        mLogRunning = false;
+    }
+
+    mLogCondition.notify_all();
+
+    if (mLogThread.joinable())
+    {
+        mLogThread.join();
+    }
+
+    if (mLogFile.is_open())
+    {
+        mLogFile.close();
+    }
+}
+
+void Stats::Display(std::ostream& aOut) const
+{
+    static const char* NAMES    [2] = { "Received      ", "Sent          " };
+    static const char* RATE_NAMES[2] = { "Receive B/s   ", "Send B/s      " };
+
+    aOut << "Statistics         : " << (Clock_GetTime_ns() - mStart_ns) / 1000000 << " ms\n";
+
+    for (unsigned int d = 0; d < 2; d++)
+    {
+        auto& lD = mDirections[d];
+
+        aOut << "    " << NAMES[d] << " : " << lD.mRecordCount << " records, " << lD.mByteCount << " bytes\n";
+    }
+
+    aOut << "    Verify         : " << mVerifyPassedCount << " passed, " << mVerifyFailedCount << " failed\n";
+    aOut << "    CRC errors     : " << mCRCErrorCount   << "\n";
+    aOut << "    Incomplete     : " << mIncompleteCount << "\n";
+    aOut << "    Read timeouts  : " << mTimeoutCount    << "\n";
+
+    if (nullptr != mGaps)
+    {
+        aOut << "    Longest gap    : " << mGaps->GetMax_ns() / 1000 << " us\n";
+    }
+
+    for (unsigned int d = 0; d < 2; d++)
+    {
+        uint64_t lHistory_byte[HISTORY_QTY];
+
+        GetHistory(mDirections[d], lHistory_byte);
+
+        aOut << "    " << RATE_NAMES[d] << " :";
+
+        for (unsigned int i = HISTORY_QTY - DISPLAY_QTY; i < HISTORY_QTY; i++)
+        {
+            aOut << " " << lHistory_byte[i];
+        }
+
+        aOut << "\n";
+    }
+}
+
+void Stats::Display_JSON(std::ostream& aOut) const
+{
+    aOut << "{\"wall_ms\":"   << Clock_GetWall_ns() / 1000000;
+    aOut << ",\"uptime_ms\":" << (Clock_GetTime_ns() - mStart_ns) / 1000000;
+
+    for (unsigned int d = 0; d < 2; d++)
+    {
+        auto& lD = mDirections[d];
+
+        aOut << ",\"" << DIRECTION_NAMES[d] << "_bytes\":"   << lD.mByteCount;
+        aOut << ",\"" << DIRECTION_NAMES[d] << "_records\":" << lD.mRecordCount;
+    }
+
+    aOut << ",\"verify_passed\":" << mVerifyPassedCount;
+    aOut << ",\"verify_failed\":" << mVerifyFailedCount;
+    aOut << ",\"crc_errors\":"    << mCRCErrorCount;
+    aOut << ",\"incomplete\":"    << mIncompleteCount;
+    aOut << ",\"read_timeouts\":" << mTimeoutCount;
+
+    if (nullptr != mGaps)
+    {
+        aOut << ",\"max_gap_us\":" << mGaps->GetMax_ns() / 1000;
+    }
+
+    for (unsigned int d = 0; d < 2; d++)
+    {
+        uint64_t lHistory_byte[HISTORY_QTY];
+
+        GetHistory(mDirections[d], lHistory_byte);
+
+        aOut << ",\"" << DIRECTION_NAMES[d] << "_Bps\":[";
+
+        for (unsigned int i = 0; i < HISTORY_QTY; i++)
+        {
+            if (0 < i) { aOut << ","; }
+
+            aOut << lHistory_byte[i];
+        }
+
+        aOut << "]";
+    }
+
+    aOut << "}";
+}
+
+// Private
+// //////////////////////////////////////////////////////////////////////////
+
+void Stats::GetHistory(const Direction& aDirection, uint64_t* aOut) const
+{
+    assert(nullptr != aOut);
+
+    // The current second is not complete
+    auto lNow  = Clock_GetTime_ns() / 1000000000;
+    auto lLast = mSecond.load(std::memory_order_relaxed);
+
+    for (unsigned int i = 0; i < HISTORY_QTY; i++)
+    {
+        aOut[i] = 0;
+
+        if (HISTORY_QTY - i > lNow) { continue; }
+
+        auto lSecond = lNow - HISTORY_QTY + i;
+
+        if ((lLast >= lSecond) && (HISTORY_QTY > lLast - lSecond))
+        {
+            aOut[i] = aDirection.mHistory_byte[lSecond % HISTORY_QTY].load(std::memory_order_relaxed);
+        }
+    }
+}
+
+void Stats::Log_Run()
+{
+    std::unique_lock<std::mutex> lLock(mLogMutex);
+
+    do
+    {
+        mLogCondition.wait_for(lLock, std::chrono::milliseconds(mLogPeriod_ms), [this] { return !mLogRunning; });
+
+        // The last line goes out when the log stops
+        Display_JSON(mLogFile);
+
+        mLogFile << std::endl;
+    }
+    while (mLogRunning);
+}
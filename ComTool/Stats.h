@@ -0,0 +1,94 @@
+// Author    KMS - Martin Dubois, P. Eng.
+// Copyright (C) 2024 KMS
+// License   http://www.apache.org/licenses/LICENSE-2.0
+// Product   KMS-Tools
+// File      ComTool/Stats.h
+
+#pragma once
+
+// ===== C++ ================================================================
+#include <atomic>
+#include <condition_variable>
+#include <fstream>
+#include <mutex>
+#include <thread>
+
+class GapStats;
+
+// Running counters of the traffic the commands record. Only the command
+// thread calls AddRecord and AddTimeout. Status and the log thread read
+// the counters at any time, so a line may mix values taken a few records
+// apart.
+class Stats
+{
+
+public:
+
+    // Number of seconds in the throughput history
+    static const unsigned int HISTORY_QTY = 60;
+
+    // aGaps  The longest gap comes from it, may be nullptr
+    Stats(const GapStats* aGaps = nullptr);
+
+    ~Stats();
+
+    // aTime_ns       Clock_GetTime_ns value of the data
+    // aDirection     CaptureFile::DIRECTION_...
+    // aCaptureFlags  CaptureFile::FLAG_...
+    void AddRecord(uint64_t aTime_ns, uint8_t aDirection, uint8_t aCaptureFlags, unsigned int aSize_byte);
+
+    // A read returned nothing before its timeout
+    void AddTimeout();
+
+    void Reset();
+
+    // Append one JSON line to the file at each period
+    void Log_Start(const char* aFileName, unsigned int aPeriod_ms);
+
+    void Log_Stop();
+
+    void Display(std::ostream& aOut) const;
+
+    // One JSON object, on one line
+    void Display_JSON(std::ostream& aOut) const;
+
+private:
+
+    NO_COPY(Stats);
+
+    struct Direction
+    {
+        std::atomic<uint64_t> mByteCount;
+        std::atomic<uint64_t> mRecordCount;
+
+        // Bytes per second, indexed by second modulo HISTORY_QTY
+        std::atomic<uint64_t> mHistory_byte[HISTORY_QTY];
+    };
+
+    // aOut  Receives the bytes of the last complete seconds, the oldest
+    //       first
+    void GetHistory(const Direction& aDirection, uint64_t* aOut) const;
+
+    void Log_Run();
+
+    const GapStats* mGaps;
+
+    Direction mDirections[2];
+
+    std::atomic<uint64_t> mCRCErrorCount;
+    std::atomic<uint64_t> mIncompleteCount;
+    std::atomic<uint64_t> mSecond;
+    std::atomic<uint64_t> mStart_ns;
+    std::atomic<uint64_t> mTimeoutCount;
+    std::atomic<uint64_t> mVerifyFailedCount;
+    std::atomic<uint64_t> mVerifyPassedCount;
+
+    // ===== Log ============================================================
+    std::condition_variable mLogCondition;
+    std::ofstream           mLogFile;
+    std::mutex              mLogMutex;
+    unsigned int            mLogPeriod_ms;
+    bool                    mLogRunning;
+    std::thread             mLogThread;
+
+};
@@ -0,0 +1,83 @@
+// Author    KMS - Martin Dubois, P. Eng.
+// Copyright (C) 2024 KMS
+// License   http://www.apache.org/licenses/LICENSE-2.0
+// Product   KMS-Tools
+// File      ComTool/TimeFormatter.cpp
+
+#include "Component.h"
+
+// ===== C++ ================================================================
+#include <time.h>
+
+// ===== Local ==============================================================
+#include "Clock.h"
+
+#include "TimeFormatter.h"
+
+using namespace KMS;
+
+// Constants
+// //////////////////////////////////////////////////////////////////////////
+
+// ".nnnnnnnnn" and the '\0'
+#define FRACTION_SIZE_byte (11)
+
+#define PREFIX_INVALID (UINT64_MAX)
+
+// Public
+// //////////////////////////////////////////////////////////////////////////
+
+TimeFormatter::TimeFormatter() : mPrefix_s(PREFIX_INVALID), mPrefixSize_byte(0)
+{
+    mOffset_ns = static_cast<int64_t>(Clock_GetWall_ns() - Clock_GetTime_ns());
+
+    mPrefix[0] = '\0';
+}
+
+void TimeFormatter::Format(uint64_t aTime_ns, char* aOut, unsigned int aOutSize_byte)
+{
+    Format_Wall(aTime_ns + mOffset_ns, aOut, aOutSize_byte);
+}
+
+void TimeFormatter::Format_Wall(uint64_t aTime_ns, char* aOut, unsigned int aOutSize_byte)
+{
+    assert(nullptr != aOut);
+
+    auto lTime_s = aTime_ns / 1000000000;
+
+    if (mPrefix_s != lTime_s)
+    {
+        auto lTime = static_cast<time_t>(lTime_s);
+
+        struct tm lTM;
+
+        #ifdef _KMS_WINDOWS_
+            localtime_s(&lTM, &lTime);
+        #else
+            localtime_r(&lTime, &lTM);
+        #endif
+
+        sprintf_s(mPrefix SizeInfo(mPrefix), "%u-%u-%u %u:%u:%u",
+            lTM.tm_year + 1900, lTM.tm_mon + 1, lTM.tm_mday, lTM.tm_hour, lTM.tm_min, lTM.tm_sec);
+
+        mPrefix_s        = lTime_s;
+        mPrefixSize_byte = static_cast<unsigned int>(strlen(mPrefix));
+    }
+
+    KMS_EXCEPTION_ASSERT(mPrefixSize_byte + FRACTION_SIZE_byte <= aOutSize_byte, RESULT_OUTPUT_TOO_SHORT, "The output buffer is too short", aOutSize_byte);
+
+    memcpy(aOut, mPrefix, mPrefixSize_byte);
+
+    auto lOut = aOut + mPrefixSize_byte;
+    auto lFraction_ns = static_cast<unsigned int>(aTime_ns % 1000000000);
+
+    lOut[0] = '.';
+
+    for (unsigned int i = 9; i > 0; i--)
+    {
+        lOut[i] = '0' + lFraction_ns % 10;
+        lFraction_ns /= 10;
+    }
+
+    lOut[10] = '\0';
+}
@@ -0,0 +1,36 @@
+// Author    KMS - Martin Dubois, P. Eng.
+// Copyright (C) 2024 KMS
+// License   http://www.apache.org/licenses/LICENSE-2.0
+// Product   KMS-Tools
+// File      ComTool/TimeFormatter.h
+
+#pragma once
+
+// Format times as "Y-M-D h:m:s.nnnnnnnnn". The date and time part is
+// formatted once per second and reused, only the nanoseconds are formatted
+// for each call.
+class TimeFormatter
+{
+
+public:
+
+    TimeFormatter();
+
+    // aTime_ns  Clock_GetTime_ns value, converted to the wall clock using
+    //           the offset measured by the constructor
+    void Format(uint64_t aTime_ns, char* aOut, unsigned int aOutSize_byte);
+
+    // aTime_ns  Clock_GetWall_ns value
+    void Format_Wall(uint64_t aTime_ns, char* aOut, unsigned int aOutSize_byte);
+
+private:
+
+    NO_COPY(TimeFormatter);
+
+    int64_t mOffset_ns;
+
+    char         mPrefix[NAME_LENGTH];
+    uint64_t     mPrefix_s;
+    unsigned int mPrefixSize_byte;
+
+};
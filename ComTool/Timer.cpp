@@ -0,0 +1,98 @@
+// Author    KMS - Martin Dubois, P. Eng.
+// Copyright (C) 2024 KMS
+// License   http://www.apache.org/licenses/LICENSE-2.0
+// Product   KMS-Tools
+// File      ComTool/Timer.cpp
+
+#include "Component.h"
+
+// ===== C ==================================================================
+#ifdef _KMS_WINDOWS_
+    #include <Windows.h>
+#else
+    #include <sys/timerfd.h>
+    #include <unistd.h>
+#endif
+
+// ===== Local ==============================================================
+#include "Clock.h"
+
+#include "Timer.h"
+
+using namespace KMS;
+
+KMS_RESULT_STATIC(RESULT_TIMER_FAILED);
+
+// Public
+// //////////////////////////////////////////////////////////////////////////
+
+Timer::Timer()
+{
+    #ifdef _KMS_WINDOWS_
+
+        mHandle = CreateWaitableTimerExW(nullptr, nullptr, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+        KMS_EXCEPTION_ASSERT(nullptr != mHandle, RESULT_TIMER_FAILED, "Cannot create the timer", "");
+
+    #else
+
+        // Clock_GetTime_ns uses std::chrono::steady_clock, which is
+        // CLOCK_MONOTONIC.
+        mFD = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC);
+        KMS_EXCEPTION_ASSERT(0 <= mFD, RESULT_TIMER_FAILED, "Cannot create the timer", "");
+
+    #endif
+}
+
+Timer::~Timer()
+{
+    #ifdef _KMS_WINDOWS_
+        CloseHandle(mHandle);
+    #else
+        close(mFD);
+    #endif
+}
+
+void Timer::WaitUntil(uint64_t aTime_ns)
+{
+    auto lNow_ns = Clock_GetTime_ns();
+    if (aTime_ns <= lNow_ns)
+    {
+        return;
+    }
+
+    #ifdef _KMS_WINDOWS_
+
+        // The waitable timers use relative times in 100 ns units
+        LARGE_INTEGER lDue;
+
+        lDue.QuadPart = -static_cast<LONGLONG>((aTime_ns - lNow_ns + 99) / 100);
+
+        KMS_EXCEPTION_ASSERT(SetWaitableTimer(mHandle, &lDue, 0, nullptr, nullptr, FALSE), RESULT_TIMER_FAILED, "Cannot set the timer", "");
+
+        WaitForSingleObject(mHandle, INFINITE);
+
+    #else
+
+        itimerspec lSpec;
+
+        memset(&lSpec, 0, sizeof(lSpec));
+
+        lSpec.it_value.tv_sec  = aTime_ns / 1000000000;
+        lSpec.it_value.tv_nsec = aTime_ns % 1000000000;
+
+        KMS_EXCEPTION_ASSERT(0 == timerfd_settime(mFD, TFD_TIMER_ABSTIME, &lSpec, nullptr), RESULT_TIMER_FAILED, "Cannot set the timer", "");
+
+        uint64_t lExpirations;
+
+        // A signal may interrupt the read, the deadline is then verified
+        // again.
+        while (sizeof(lExpirations) != read(mFD, &lExpirations, sizeof(lExpirations)))
+        {
+            if (aTime_ns <= Clock_GetTime_ns())
+            {
+                break;
+            }
+        }
+
+    #endif
+}
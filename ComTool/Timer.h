@@ -0,0 +1,36 @@
+// Author    KMS - Martin Dubois, P. Eng.
+// Copyright (C) 2024 KMS
+// License   http://www.apache.org/licenses/LICENSE-2.0
+// Product   KMS-Tools
+// File      ComTool/Timer.h
+
+#pragma once
+
+// Wait for an absolute time of Clock_GetTime_ns. The thread sleeps in the
+// kernel until the deadline, without spinning, so a long run does not use
+// the processor between the deadlines. On Linux, the timer is a timerfd
+// armed with an absolute CLOCK_MONOTONIC time, so the sleep errors do not
+// accumulate. On Windows, it is a high resolution waitable timer.
+class Timer
+{
+
+public:
+
+    Timer();
+
+    ~Timer();
+
+    // Return immediately when the time is already passed
+    void WaitUntil(uint64_t aTime_ns);
+
+private:
+
+    NO_COPY(Timer);
+
+    #ifdef _KMS_WINDOWS_
+        void* mHandle;
+    #else
+        int mFD;
+    #endif
+
+};
@@ -0,0 +1,348 @@
+// Author    KMS - Martin Dubois, P. Eng.
+// Copyright (C) 2024 KMS
+// License   http://www.apache.org/licenses/LICENSE-2.0
+// Product   KMS-Tools
+// File      ComTool/Trigger.cpp
+
+#include "Component.h"
+
+// ===== C++ ================================================================
+#include <algorithm>
+
+// ===== Local ==============================================================
+#include "File.h"
+#include "Search.h"
+
+#include "Trigger.h"
+
+using namespace KMS;
+
+KMS_RESULT_STATIC(RESULT_CAPTURE_WRITE_FAILED);
+
+// Constants
+// //////////////////////////////////////////////////////////////////////////
+
+const unsigned int Trigger::CONDITION_CRC_ERROR     = 0x00000001;
+const unsigned int Trigger::CONDITION_PATTERN       = 0x00000002;
+const unsigned int Trigger::CONDITION_VERIFY_FAILED = 0x00000004;
+
+const unsigned int Trigger::SIZE_DEFAULT_byte = 16 * 1024 * 1024;
+
+// Public
+// //////////////////////////////////////////////////////////////////////////
+
+Trigger::Trigger()
+    : mConditions(0)
+    , mFile(nullptr)
+    , mIndex(0)
+    , mPost_ns(0)
+    , mPostEnd_ns(0)
+    , mPre_ns(0)
+    , mRingBegin_byte(0)
+    , mRingEnd_byte(0)
+    , mCaptureCount(0)
+    , mDropped_byte(0)
+    , mTriggerCount(0)
+    , mWritten_byte(0)
+{}
+
+Trigger::~Trigger() { Disarm(); }
+
+bool Trigger::IsArmed() const { return !mRing.empty(); }
+
+void Trigger::Arm(const char* aPrefix, unsigned int aConditions, unsigned int aPre_ms, unsigned int aPost_ms, unsigned int aSize_byte)
+{
+    assert(nullptr != aPrefix);
+
+    KMS_EXCEPTION_ASSERT(0 != aConditions, RESULT_INVALID_VALUE, "No trigger condition", "");
+    KMS_EXCEPTION_ASSERT((0 == (aConditions & CONDITION_PATTERN)) || (!mPattern.empty()), RESULT_INVALID_VALUE, "No trigger pattern", "");
+    KMS_EXCEPTION_ASSERT(sizeof(CaptureFile::RecordHeader) < aSize_byte, RESULT_INVALID_VALUE, "Invalid size", aSize_byte);
+
+    Disarm();
+
+    mConditions = aConditions;
+    mIndex      = 0;
+    mPost_ns    = static_cast<uint64_t>(aPost_ms) * 1000000;
+    mPre_ns     = static_cast<uint64_t>(aPre_ms ) * 1000000;
+    mPrefix     = aPrefix;
+
+    mRing.resize(aSize_byte);
+
+    mRingBegin_byte = 0;
+    mRingEnd_byte   = 0;
+
+    for (auto& lTail : mTails)
+    {
+        lTail.clear();
+    }
+
+    mCaptureCount = 0;
+    mDropped_byte = 0;
+    mTriggerCount = 0;
+    mWritten_byte = 0;
+}
+
+void Trigger::Disarm()
+{
+    if (nullptr != mFile)
+    {
+        Post_Stop();
+    }
+
+    mRing.clear();
+    mRing.shrink_to_fit();
+}
+
+void Trigger::SetPattern(const uint8_t* aIn, unsigned int aInSize_byte)
+{
+    assert((nullptr != aIn) || (0 == aInSize_byte));
+
+    mPattern.assign(aIn, aIn + aInSize_byte);
+
+    for (auto& lTail : mTails)
+    {
+        lTail.clear();
+    }
+}
+
+void Trigger::Tick(uint64_t aClock_ns)
+{
+    if ((nullptr != mFile) && (mPostEnd_ns < aClock_ns))
+    {
+        Post_Stop();
+    }
+}
+
+void Trigger::Write(uint64_t aClock_ns, uint8_t aDirection, uint8_t aFlags, const void* aIn, unsigned int aInSize_byte, uint16_t aPort)
+{
+    assert(nullptr != aIn);
+
+    if (!IsArmed())
+    {
+        return;
+    }
+
+    auto lTrigger = Check(aDirection, aFlags, reinterpret_cast<const uint8_t*>(aIn), aInSize_byte);
+
+    if ((nullptr != mFile) && (!lTrigger) && (mPostEnd_ns < aClock_ns))
+    {
+        Post_Stop();
+    }
+
+    if (lTrigger)
+    {
+        mTriggerCount++;
+
+        if (nullptr == mFile)
+        {
+            Post_Start(aClock_ns);
+        }
+
+        mPostEnd_ns = aClock_ns + mPost_ns;
+    }
+
+    if (nullptr != mFile)
+    {
+        mWriter.Write(mWriter.ToTime_ns(aClock_ns), aDirection, aFlags, aIn, aInSize_byte, aPort);
+        return;
+    }
+
+    CaptureFile::RecordHeader lHeader;
+
+    lHeader.mDirection = aDirection;
+    lHeader.mFlags     = aFlags;
+    lHeader.mPort      = aPort;
+    lHeader.mSize_byte = aInSize_byte;
+    lHeader.mTime_ns   = aClock_ns;
+
+    if (mRing.size() < sizeof(lHeader) + aInSize_byte)
+    {
+        // The record alone does not fit, the window before it is lost
+        mDropped_byte += aInSize_byte;
+
+        mRingBegin_byte = mRingEnd_byte;
+        return;
+    }
+
+    while (mRing.size() - (mRingEnd_byte - mRingBegin_byte) < sizeof(lHeader) + aInSize_byte)
+    {
+        Ring_Pop();
+    }
+
+    Ring_Push(&lHeader, sizeof(lHeader));
+    Ring_Push(aIn, aInSize_byte);
+}
+
+void Trigger::Display(std::ostream& aOut) const
+{
+    aOut << "Trigger            : " << mTriggerCount << " triggers, " << mCaptureCount << " captures, " << mWritten_byte << " bytes written\n";
+    aOut << "    Ring           : " << mRingEnd_byte - mRingBegin_byte << " / " << mRing.size() << " bytes, " << mDropped_byte << " bytes dropped\n";
+
+    if (nullptr != mFile)
+    {
+        aOut << "    Writing        : " << mFileName << "\n";
+    }
+}
+
+// Private
+// //////////////////////////////////////////////////////////////////////////
+
+bool Trigger::Check(uint8_t aDirection, uint8_t aFlags, const uint8_t* aIn, unsigned int aInSize_byte)
+{
+    assert(nullptr != aIn);
+
+    auto lResult = false;
+
+    if ((0 != (mConditions & CONDITION_CRC_ERROR    )) && (0 != (aFlags & CaptureFile::FLAG_FRAME_ERROR  ))) { lResult = true; }
+    if ((0 != (mConditions & CONDITION_VERIFY_FAILED)) && (0 != (aFlags & CaptureFile::FLAG_VERIFY_FAILED))) { lResult = true; }
+
+    if ((0 != (mConditions & CONDITION_PATTERN)) && (0 < aInSize_byte))
+    {
+        auto& lTail = mTails[aDirection & 1];
+
+        auto lPatternSize_byte = static_cast<unsigned int>(mPattern.size());
+        auto lTailSize_byte    = lPatternSize_byte - 1;
+
+        // A match starting in the previous records of the same direction
+        if (!lTail.empty())
+        {
+            mJoin.assign(lTail.begin(), lTail.end());
+            mJoin.insert(mJoin.end(), aIn, aIn + std::min(aInSize_byte, lTailSize_byte));
+
+            auto lPtr = Search_Find(mJoin.data(), mJoin.size(), mPattern.data(), lPatternSize_byte);
+            if ((nullptr != lPtr) && (mJoin.data() + lTail.size() > lPtr))
+            {
+                lResult = true;
+            }
+        }
+
+        if (nullptr != Search_Find(aIn, aInSize_byte, mPattern.data(), lPatternSize_byte))
+        {
+            lResult = true;
+        }
+
+        if (lTailSize_byte <= aInSize_byte)
+        {
+            lTail.assign(aIn + aInSize_byte - lTailSize_byte, aIn + aInSize_byte);
+        }
+        else
+        {
+            lTail.insert(lTail.end(), aIn, aIn + aInSize_byte);
+
+            if (lTailSize_byte < lTail.size())
+            {
+                lTail.erase(lTail.begin(), lTail.end() - lTailSize_byte);
+            }
+        }
+    }
+
+    return lResult;
+}
+
+void Trigger::Post_Start(uint64_t aClock_ns)
+{
+    assert(nullptr == mFile);
+
+    char lFileName[LINE_LENGTH];
+
+    sprintf_s(lFileName SizeInfo(lFileName), "%s_%06u.kmscap", mPrefix.c_str(), mIndex);
+
+    mFile = File_Open(lFileName, "wb");
+    KMS_EXCEPTION_ASSERT(nullptr != mFile, RESULT_CAPTURE_WRITE_FAILED, "Cannot create the trigger capture", lFileName);
+
+    mCaptureCount++;
+    mFileName = lFileName;
+    mIndex++;
+
+    // ===== Pre-trigger window =============================================
+    auto lFrom_ns = (mPre_ns < aClock_ns) ? aClock_ns - mPre_ns : 0;
+
+    CaptureFile::RecordHeader lHeader;
+
+    while (mRingEnd_byte > mRingBegin_byte)
+    {
+        Ring_Peek(mRingBegin_byte, &lHeader, sizeof(lHeader));
+
+        if (lFrom_ns <= lHeader.mTime_ns)
+        {
+            break;
+        }
+
+        Ring_Pop();
+    }
+
+    mWriter.Open(mFile, (mRingEnd_byte > mRingBegin_byte) ? lHeader.mTime_ns : aClock_ns);
+
+    while (mRingEnd_byte > mRingBegin_byte)
+    {
+        Ring_Peek(mRingBegin_byte, &lHeader, sizeof(lHeader));
+
+        mJoin.resize(lHeader.mSize_byte + 1);
+
+        Ring_Peek(mRingBegin_byte + sizeof(lHeader), mJoin.data(), lHeader.mSize_byte);
+
+        mWriter.Write(mWriter.ToTime_ns(lHeader.mTime_ns), lHeader.mDirection, lHeader.mFlags, mJoin.data(), lHeader.mSize_byte, lHeader.mPort);
+
+        mRingBegin_byte += sizeof(lHeader) + lHeader.mSize_byte;
+    }
+}
+
+void Trigger::Post_Stop()
+{
+    assert(nullptr != mFile);
+
+    mWriter.Close();
+
+    mWritten_byte += mWriter.GetSize_byte();
+
+    auto lRet = fclose(mFile);
+
+    mFile = nullptr;
+
+    KMS_EXCEPTION_ASSERT(0 == lRet, RESULT_CAPTURE_WRITE_FAILED, "Cannot write the trigger capture", mFileName.c_str());
+}
+
+// ===== Ring ===============================================================
+
+void Trigger::Ring_Peek(uint64_t aPos_byte, void* aOut, unsigned int aOutSize_byte) const
+{
+    assert(nullptr != aOut);
+
+    auto lIndex = static_cast<size_t>(aPos_byte % mRing.size());
+    auto lFirst = std::min(static_cast<size_t>(aOutSize_byte), mRing.size() - lIndex);
+
+    memcpy(aOut, mRing.data() + lIndex, lFirst);
+
+    if (aOutSize_byte > lFirst)
+    {
+        memcpy(reinterpret_cast<uint8_t*>(aOut) + lFirst, mRing.data(), aOutSize_byte - lFirst);
+    }
+}
+
+void Trigger::Ring_Pop()
+{
+    assert(mRingEnd_byte > mRingBegin_byte);
+
+    CaptureFile::RecordHeader lHeader;
+
+    Ring_Peek(mRingBegin_byte, &lHeader, sizeof(lHeader));
+
+    mRingBegin_byte += sizeof(lHeader) + lHeader.mSize_byte;
+}
+
+void Trigger::Ring_Push(const void* aIn, unsigned int aInSize_byte)
+{
+    assert(nullptr != aIn);
+
+    auto lIndex = static_cast<size_t>(mRingEnd_byte % mRing.size());
+    auto lFirst = std::min(static_cast<size_t>(aInSize_byte), mRing.size() - lIndex);
+
+    memcpy(mRing.data() + lIndex, aIn, lFirst);
+
+    if (aInSize_byte > lFirst)
+    {
+        memcpy(mRing.data(), reinterpret_cast<const uint8_t*>(aIn) + lFirst, aInSize_byte - lFirst);
+    }
+
+    mRingEnd_byte += aInSize_byte;
+}
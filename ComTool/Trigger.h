@@ -0,0 +1,110 @@
+// Author    KMS - Martin Dubois, P. Eng.
+// Copyright (C) 2024 KMS
+// License   http://www.apache.org/licenses/LICENSE-2.0
+// Product   KMS-Tools
+// File      ComTool/Trigger.h
+
+#pragma once
+
+// ===== C++ ================================================================
+#include <string>
+#include <vector>
+
+// ===== Local ==============================================================
+#include "CaptureWriter.h"
+
+// Keep the last records of both directions in memory. When a record meets
+// a condition, the records of the pre-trigger window go to a new capture
+// file, {Prefix}_{Index}.kmscap, followed by the records of the
+// post-trigger window. A trigger during the post-trigger window extends it.
+// Only the command thread calls the methods.
+class Trigger
+{
+
+public:
+
+    static const unsigned int CONDITION_CRC_ERROR;
+    static const unsigned int CONDITION_PATTERN;
+    static const unsigned int CONDITION_VERIFY_FAILED;
+
+    static const unsigned int SIZE_DEFAULT_byte;
+
+    Trigger();
+
+    ~Trigger();
+
+    bool IsArmed() const;
+
+    // aConditions  CONDITION_...
+    // aPre_ms      The records older than this at the trigger are not
+    //              written
+    // aSize_byte   Memory for the pre-trigger window, the oldest records
+    //              leave first
+    void Arm(const char* aPrefix, unsigned int aConditions, unsigned int aPre_ms, unsigned int aPost_ms, unsigned int aSize_byte = SIZE_DEFAULT_byte);
+
+    // Close the capture of the post-trigger window in progress
+    void Disarm();
+
+    // A match may span many records of the same direction
+    void SetPattern(const uint8_t* aIn, unsigned int aInSize_byte);
+
+    // Close the capture of the post-trigger window once it ends, even when
+    // no record arrives after it. The command thread calls it between
+    // commands and when a read times out.
+    // aClock_ns  Clock_GetTime_ns value
+    void Tick(uint64_t aClock_ns);
+
+    // aClock_ns   Clock_GetTime_ns value of the data
+    // aDirection  CaptureFile::DIRECTION_...
+    // aFlags      CaptureFile::FLAG_...
+    // aPort       Index of the session port, 0 for the main port
+    void Write(uint64_t aClock_ns, uint8_t aDirection, uint8_t aFlags, const void* aIn, unsigned int aInSize_byte, uint16_t aPort = 0);
+
+    void Display(std::ostream& aOut) const;
+
+private:
+
+    NO_COPY(Trigger);
+
+    // Return  true when the record meets a condition
+    bool Check(uint8_t aDirection, uint8_t aFlags, const uint8_t* aIn, unsigned int aInSize_byte);
+
+    // Open the capture file and write the pre-trigger window
+    void Post_Start(uint64_t aClock_ns);
+
+    void Post_Stop();
+
+    // ===== Ring ===========================================================
+    // Each record is a CaptureFile::RecordHeader, its mTime_ns being a
+    // Clock_GetTime_ns value, followed by the data.
+
+    void Ring_Peek(uint64_t aPos_byte, void* aOut, unsigned int aOutSize_byte) const;
+
+    void Ring_Pop();
+
+    void Ring_Push(const void* aIn, unsigned int aInSize_byte);
+
+    unsigned int         mConditions;
+    FILE*                mFile;
+    std::string          mFileName;
+    unsigned int         mIndex;
+    std::vector<uint8_t> mJoin;
+    std::vector<uint8_t> mPattern;
+    uint64_t             mPost_ns;
+    uint64_t             mPostEnd_ns;
+    uint64_t             mPre_ns;
+    std::string          mPrefix;
+    std::vector<uint8_t> mTails[2];
+    CaptureWriter        mWriter;
+
+    std::vector<uint8_t> mRing;
+    uint64_t             mRingBegin_byte;
+    uint64_t             mRingEnd_byte;
+
+    // ===== Statistics =====================================================
+    unsigned int mCaptureCount;
+    uint64_t     mDropped_byte;
+    unsigned int mTriggerCount;
+    uint64_t     mWritten_byte;
+
+};
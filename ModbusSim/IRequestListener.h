@@ -0,0 +1,21 @@
+// Author    KMS - Martin Dubois, P. Eng.
+// Copyright (C) 2024 KMS
+// License   http://www.apache.org/licenses/LICENSE-2.0
+// Product   KMS-Tools
+// File      ModbusSim/IRequestListener.h
+
+#pragma once
+
+class IRequestListener
+{
+
+public:
+
+    // The caller validated the quantity and the address range
+    // aFunction  Modbus function code
+    // aBuffer    For a read, receives the response data. For a write,
+    //            holds the value in big endian.
+    // Return     0 or a Modbus exception code
+    virtual uint8_t OnRequest(uint8_t aUnitId, uint8_t aFunction, uint16_t aStartAddr, uint16_t aQty, uint8_t* aBuffer) = 0;
+
+};
@@ -0,0 +1,381 @@
+// Author    KMS - Martin Dubois, P. Eng.
+// Copyright (C) 2024 KMS
+// License   http://www.apache.org/licenses/LICENSE-2.0
+// Product   KMS-Tools
+// File      ModbusSim/Image.cpp
+
+#include "Component.h"
+
+// ===== Local ==============================================================
+#include "Image.h"
+
+using namespace KMS;
+
+// Constants
+// //////////////////////////////////////////////////////////////////////////
+
+// The Item flags use the other bits
+#define FLAG_KNOWN (0x80)
+
+#define BITS_PER_PAGE      (4096)
+#define REGISTERS_PER_PAGE (256)
+#define WORDS_PER_PAGE     (64)
+
+const unsigned int Image::ADDRESS_QTY    = 0x10000;
+const unsigned int Image::PAGE_SIZE_byte = sizeof(Image::Page);
+
+const Image::Page Image::ZERO_PAGE = {};
+
+// Static function declarations
+// //////////////////////////////////////////////////////////////////////////
+
+static bool IsBitTable(Image::Table aTable);
+
+static unsigned int GetPageQty(Image::Table aTable);
+
+// Public
+// //////////////////////////////////////////////////////////////////////////
+
+Image::Image() : mTemplate(nullptr)
+{
+    for (auto& lT : mTables)
+    {
+        lT.mFlags.resize(ADDRESS_QTY, 0);
+    }
+}
+
+Image::Image(const Image* aTemplate) : mTemplate(aTemplate)
+{
+    assert(nullptr != aTemplate);
+}
+
+Image::~Image()
+{
+    for (auto& lT : mTables)
+    {
+        for (auto lPage : lT.mPages)
+        {
+            delete lPage;
+        }
+    }
+}
+
+unsigned int Image::GetPageCount() const
+{
+    unsigned int lResult = 0;
+
+    for (auto& lT : mTables)
+    {
+        for (auto lPage : lT.mPages)
+        {
+            if (nullptr != lPage)
+            {
+                lResult++;
+            }
+        }
+    }
+
+    return lResult;
+}
+
+bool Image::IsKnown(Table aTable, unsigned int aA) const
+{
+    if (ADDRESS_QTY <= aA)
+    {
+        return false;
+    }
+
+    return 0 != (GetInfo(aTable).mFlags[aA] & FLAG_KNOWN);
+}
+
+unsigned int Image::FindTrace(Table aTable, unsigned int aStart, unsigned int aQty, unsigned int aFlags) const
+{
+    auto lEnd = aStart + aQty;
+
+    auto lFlags = GetInfo(aTable).mFlags.data();
+    auto lMask  = static_cast<uint8_t>(FLAG_KNOWN | aFlags);
+
+    auto lA = aStart;
+
+    for (; (lA < lEnd) && (lA < ADDRESS_QTY); lA++)
+    {
+        if (0 != ((lFlags[lA] ^ FLAG_KNOWN) & lMask))
+        {
+            return lA;
+        }
+    }
+
+    // The addresses past the end have no Item
+    return lA;
+}
+
+bool Image::GetBit(Table aTable, unsigned int aA) const
+{
+    assert(IsBitTable(aTable));
+
+    return 0 != ((GetWord(aTable, aA / 64) >> (aA % 64)) & 1);
+}
+
+unsigned int Image::GetFlags(Table aTable, unsigned int aA) const
+{
+    if (ADDRESS_QTY <= aA)
+    {
+        return 0;
+    }
+
+    return GetInfo(aTable).mFlags[aA] & ~FLAG_KNOWN;
+}
+
+const char* Image::GetName(Table aTable, unsigned int aA) const
+{
+    auto& lNames = GetInfo(aTable).mNames;
+
+    auto lIt = lNames.find(aA);
+    if (lNames.end() == lIt)
+    {
+        return "";
+    }
+
+    return lIt->second.c_str();
+}
+
+Modbus::RegisterValue Image::GetRegister(Table aTable, unsigned int aA) const
+{
+    if (ADDRESS_QTY <= aA)
+    {
+        return 0;
+    }
+
+    assert(!IsBitTable(aTable));
+
+    return GetPage(aTable, aA / REGISTERS_PER_PAGE)->mRegisters[aA % REGISTERS_PER_PAGE];
+}
+
+void Image::Set(Table aTable, unsigned int aA, const char* aName, Modbus::RegisterValue aValue, unsigned int aFlags)
+{
+    assert(nullptr != aName);
+    assert(nullptr == mTemplate);
+
+    KMS_EXCEPTION_ASSERT(ADDRESS_QTY > aA, RESULT_INVALID_CONFIG, "Invalid address", aA);
+
+    auto& lT = GetTable(aTable);
+
+    lT.mFlags[aA] = FLAG_KNOWN | (aFlags & ~FLAG_KNOWN);
+    lT.mNames[aA] = aName;
+
+    if (IsBitTable(aTable))
+    {
+        SetBit(aTable, aA, 0 != aValue);
+    }
+    else
+    {
+        SetRegister(aTable, aA, aValue);
+    }
+}
+
+bool Image::SetBit(Table aTable, unsigned int aA, bool aValue)
+{
+    assert(ADDRESS_QTY > aA);
+    assert(IsBitTable(aTable));
+
+    auto lMask = static_cast<uint64_t>(1) << (aA % 64);
+    auto lOld  = GetWord(aTable, aA / 64);
+    auto lNew  = aValue ? (lOld | lMask) : (lOld & ~lMask);
+
+    // Writing the same value does not copy the page
+    if (lOld == lNew)
+    {
+        return false;
+    }
+
+    GetPage_RW(aTable, aA / BITS_PER_PAGE)->mBits[(aA / 64) % WORDS_PER_PAGE] = lNew;
+
+    return true;
+}
+
+bool Image::SetRegister(Table aTable, unsigned int aA, Modbus::RegisterValue aValue)
+{
+    assert(ADDRESS_QTY > aA);
+
+    if (GetRegister(aTable, aA) == aValue)
+    {
+        return false;
+    }
+
+    GetPage_RW(aTable, aA / REGISTERS_PER_PAGE)->mRegisters[aA % REGISTERS_PER_PAGE] = aValue;
+
+    return true;
+}
+
+void Image::ReadBits(Table aTable, unsigned int aStart, unsigned int aQty, uint8_t* aOut) const
+{
+    assert(nullptr != aOut);
+    assert(IsBitTable(aTable));
+
+    auto lOutSize_byte = (aQty + 7) / 8;
+    auto lShift        = aStart % 64;
+    auto lW            = aStart / 64;
+
+    auto lLow = GetWord(aTable, lW);
+
+    // 64 bits per iteration, the start address rarely falls on a word
+    for (unsigned int lOut_byte = 0; lOut_byte < lOutSize_byte; lOut_byte += 8)
+    {
+        auto lValue = lLow >> lShift;
+
+        lW++;
+
+        if (0 != lShift)
+        {
+            lLow = GetWord(aTable, lW);
+
+            lValue |= lLow << (64 - lShift);
+        }
+        else if (lOut_byte + 8 < lOutSize_byte)
+        {
+            lLow = GetWord(aTable, lW);
+        }
+
+        unsigned int lSize_byte = lOutSize_byte - lOut_byte;
+        if (8 < lSize_byte)
+        {
+            lSize_byte = 8;
+        }
+
+        #if defined(__x86_64__) || defined(_M_X64)
+            // Little endian, the bytes are already in the Modbus order
+            memcpy(aOut + lOut_byte, &lValue, lSize_byte);
+        #else
+            for (unsigned int i = 0; i < lSize_byte; i++)
+            {
+                aOut[lOut_byte + i] = static_cast<uint8_t>(lValue >> (8 * i));
+            }
+        #endif
+    }
+
+    // The unused bits of the last byte are 0
+    if (0 != (aQty % 8))
+    {
+        aOut[lOutSize_byte - 1] &= (1 << (aQty % 8)) - 1;
+    }
+}
+
+void Image::ReadRegisters(Table aTable, unsigned int aStart, unsigned int aQty, uint8_t* aOut) const
+{
+    assert(nullptr != aOut);
+    assert(!IsBitTable(aTable));
+
+    unsigned int lQty = (ADDRESS_QTY > aStart) ? ADDRESS_QTY - aStart : 0;
+    if (lQty > aQty)
+    {
+        lQty = aQty;
+    }
+
+    unsigned int i = 0;
+
+    // One page lookup per 256 registers
+    while (i < lQty)
+    {
+        auto lA = aStart + i;
+
+        auto lIn  = GetPage(aTable, lA / REGISTERS_PER_PAGE)->mRegisters + lA % REGISTERS_PER_PAGE;
+        auto lOut = aOut + 2 * i;
+
+        unsigned int lCount = REGISTERS_PER_PAGE - lA % REGISTERS_PER_PAGE;
+        if (lCount > lQty - i)
+        {
+            lCount = lQty - i;
+        }
+
+        for (unsigned int j = 0; j < lCount; j++)
+        {
+            lOut[2 * j    ] = static_cast<uint8_t>(lIn[j] >> 8);
+            lOut[2 * j + 1] = static_cast<uint8_t>(lIn[j]);
+        }
+
+        i += lCount;
+    }
+
+    memset(aOut + 2 * lQty, 0, 2 * (aQty - lQty));
+}
+
+// Private
+// //////////////////////////////////////////////////////////////////////////
+
+const Image::Page* Image::GetPage(Table aTable, unsigned int aP) const
+{
+    auto& lPages = GetTable(aTable).mPages;
+
+    // mPages is empty or holds all the pages of the table
+    if ((lPages.size() > aP) && (nullptr != lPages[aP]))
+    {
+        return lPages[aP];
+    }
+
+    return (nullptr == mTemplate) ? &ZERO_PAGE : mTemplate->GetPage(aTable, aP);
+}
+
+Image::Page* Image::GetPage_RW(Table aTable, unsigned int aP)
+{
+    auto& lPages = GetTable(aTable).mPages;
+
+    if (lPages.empty())
+    {
+        lPages.resize(GetPageQty(aTable), nullptr);
+    }
+
+    assert(lPages.size() > aP);
+
+    auto lResult = lPages[aP];
+    if (nullptr == lResult)
+    {
+        lResult = new Page(*GetPage(aTable, aP));
+
+        lPages[aP] = lResult;
+    }
+
+    return lResult;
+}
+
+uint64_t Image::GetWord(Table aTable, unsigned int aW) const
+{
+    // The addresses past the end read as OFF
+    if (ADDRESS_QTY / 64 <= aW)
+    {
+        return 0;
+    }
+
+    return GetPage(aTable, aW / WORDS_PER_PAGE)->mBits[aW % WORDS_PER_PAGE];
+}
+
+const Image::TableData& Image::GetInfo(Table aTable) const
+{
+    return (nullptr == mTemplate) ? GetTable(aTable) : mTemplate->GetInfo(aTable);
+}
+
+const Image::TableData& Image::GetTable(Table aTable) const
+{
+    assert(Table::QTY > aTable);
+
+    return mTables[static_cast<unsigned int>(aTable)];
+}
+
+Image::TableData& Image::GetTable(Table aTable)
+{
+    assert(Table::QTY > aTable);
+
+    return mTables[static_cast<unsigned int>(aTable)];
+}
+
+// Static functions
+// //////////////////////////////////////////////////////////////////////////
+
+bool IsBitTable(Image::Table aTable)
+{
+    return (Image::Table::COILS == aTable) || (Image::Table::DISCRETE_INPUTS == aTable);
+}
+
+unsigned int GetPageQty(Image::Table aTable)
+{
+    return Image::ADDRESS_QTY / (IsBitTable(aTable) ? BITS_PER_PAGE : REGISTERS_PER_PAGE);
+}
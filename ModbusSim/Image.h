@@ -0,0 +1,139 @@
+// Author    KMS - Martin Dubois, P. Eng.
+// Copyright (C) 2024 KMS
+// License   http://www.apache.org/licenses/LICENSE-2.0
+// Product   KMS-Tools
+// File      ModbusSim/Image.h
+
+#pragma once
+
+// ===== C++ ================================================================
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// ===== Import/Includes ====================================================
+#include <KMS/Modbus/Modbus.h>
+
+// Values of the four Modbus tables, one entry per address. The coils and
+// the discrete inputs are packed 64 per word. The values are stored in
+// pages allocated on the first write; a missing page reads as 0. The names
+// and the flags of the configured addresses live in a side table, so a
+// block read only touches the values.
+//
+// An Image built from a template shares the names, the flags and the pages
+// of the template. A write that changes a value copies the page first, so
+// a unit only costs the pages it has written.
+class Image
+{
+
+public:
+
+    enum class Table
+    {
+        COILS = 0,
+        DISCRETE_INPUTS,
+        HOLDING_REGISTERS,
+        INPUT_REGISTERS,
+
+        QTY
+    };
+
+    static const unsigned int ADDRESS_QTY;
+    static const unsigned int PAGE_SIZE_byte;
+
+    Image();
+
+    // aTemplate  Must stay valid while this Image exists. Its changes show
+    //            through the pages this Image has not written.
+    Image(const Image* aTemplate);
+
+    ~Image();
+
+    // Return  The number of pages this Image allocated
+    unsigned int GetPageCount() const;
+
+    // Return  false when the address has no Item
+    bool IsKnown(Table aTable, unsigned int aA) const;
+
+    // Return  The first address of the range with no Item or with one of
+    //         the flags, aStart + aQty when there is none
+    unsigned int FindTrace(Table aTable, unsigned int aStart, unsigned int aQty, unsigned int aFlags) const;
+
+    bool GetBit(Table aTable, unsigned int aA) const;
+
+    // Return  The flags of the Item, 0 when the address has no Item
+    unsigned int GetFlags(Table aTable, unsigned int aA) const;
+
+    // Return  "" when the address has no Item
+    const char* GetName(Table aTable, unsigned int aA) const;
+
+    KMS::Modbus::RegisterValue GetRegister(Table aTable, unsigned int aA) const;
+
+    // Declare the Item at an address. Only for an Image without template.
+    // aValue  For the coils and discrete inputs, any value other than 0 is
+    //         ON
+    void Set(Table aTable, unsigned int aA, const char* aName, KMS::Modbus::RegisterValue aValue, unsigned int aFlags);
+
+    // Return  true when the value changed
+    bool SetBit(Table aTable, unsigned int aA, bool aValue);
+
+    // Return  true when the value changed
+    bool SetRegister(Table aTable, unsigned int aA, KMS::Modbus::RegisterValue aValue);
+
+    // Pack the bits as a Modbus response does, the first one in the least
+    // significant bit of the first byte. The bits are shifted and masked a
+    // whole word at a time. The addresses past the end read as OFF.
+    // aOut  At least (aQty + 7) / 8 bytes
+    void ReadBits(Table aTable, unsigned int aStart, unsigned int aQty, uint8_t* aOut) const;
+
+    // Encode the registers in big endian. The addresses past the end read
+    // as 0.
+    // aOut  At least 2 * aQty bytes
+    void ReadRegisters(Table aTable, unsigned int aStart, unsigned int aQty, uint8_t* aOut) const;
+
+private:
+
+    NO_COPY(Image);
+
+    union Page
+    {
+        // COILS and DISCRETE_INPUTS
+        uint64_t mBits[64];
+
+        // HOLDING_REGISTERS and INPUT_REGISTERS
+        KMS::Modbus::RegisterValue mRegisters[256];
+    };
+
+    struct TableData
+    {
+        // Empty in an Image with template
+        std::vector<uint8_t> mFlags;
+
+        std::unordered_map<unsigned int, std::string> mNames;
+
+        // Empty until the first write, nullptr for a page not written
+        std::vector<Page*> mPages;
+    };
+
+    static const Page ZERO_PAGE;
+
+    // Return  The page of this Image, else the one of the template, else a
+    //         page of 0
+    const Page* GetPage(Table aTable, unsigned int aP) const;
+
+    // Copy the page on the first write
+    Page* GetPage_RW(Table aTable, unsigned int aP);
+
+    uint64_t GetWord(Table aTable, unsigned int aW) const;
+
+    // Return  The table holding the names and the flags
+    const TableData& GetInfo(Table aTable) const;
+
+    const TableData& GetTable(Table aTable) const;
+    TableData      & GetTable(Table aTable);
+
+    TableData mTables[static_cast<unsigned int>(Table::QTY)];
+
+    const Image* mTemplate;
+
+};
@@ -7,6 +7,9 @@
 
 #include "Component.h"
 
+// ===== C++ ================================================================
+#include <chrono>
+
 // ===== C ==================================================================
 #include <signal.h>
 
@@ -15,15 +18,22 @@
 #include <KMS/Cfg/MetaData.h>
 #include <KMS/Com/Port.h>
 #include <KMS/DI/Array_Sparse.h>
+#include <KMS/DI/Boolean.h>
 #include <KMS/DI/Dictionary.h>
+#include <KMS/DI/UInt.h>
 #include <KMS/Main.h>
 #include <KMS/Modbus/Slave_Cfg.h>
 #include <KMS/Modbus/Slave_IDevice.h>
+#include <KMS/Net/Socket.h>
 
 // ===== Local ==============================================================
 #include "../Common/Version.h"
 
+#include "IRequestListener.h"
+#include "Image.h"
 #include "Item.h"
+#include "TcpServer.h"
+#include "TraceLog.h"
 
 using namespace KMS;
 
@@ -35,15 +45,21 @@ using namespace KMS;
 // Class
 // //////////////////////////////////////////////////////////////////////////
 
-class Tool final : public DI::Dictionary
+class Tool final : public DI::Dictionary, public IRequestListener
 {
 
 private:
 
+    DI::UInt<uint32_t> mBenchmark;
+
     DI::Array_Sparse mCoils;
     DI::Array_Sparse mDiscreteInputs;
     DI::Array_Sparse mHoldingRegisters;
     DI::Array_Sparse mInputRegisters;
+    DI::UInt<uint8_t>  mSerialUnit;
+    DI::UInt<uint16_t> mTcpPort;
+    DI::Boolean      mTraceSummary;
+    DI::String       mUnits;
 
 public:
 
@@ -53,6 +69,14 @@ public:
 
     Tool();
 
+    ~Tool();
+
+    // Build aCount responses of each read function at its maximum size,
+    // from the unaligned address 1, and display the time per request. The
+    // addresses of these ranges without Item get a quiet one, so only the
+    // configured verbose flags add traces.
+    void Benchmark(unsigned int aCount);
+
     void InitSlave(Modbus::Slave* aSlave);
 
     // aFlags  FLAG_VERBOSE_READ, FLAG_VERBOSE_WRITE, FLAG_VERBOSE_WRITE_CHANGE
@@ -67,10 +91,16 @@ public:
     // aFlags  FLAG_VERBOSE_READ
     void AddInputRegister(const char* aN, Modbus::Address aA, Modbus::RegisterValue aValue, unsigned int aFlags = 0);
 
+    // Serve the Modbus TCP masters when TcpPort is set, else the serial
+    // master. With Units, the TCP requests are routed by unit ID and the
+    // serial master reaches SerialUnit.
     int Run();
 
     void Stop();
 
+    // ===== IRequestListener ===============================================
+    virtual uint8_t OnRequest(uint8_t aUnitId, uint8_t aFunction, uint16_t aStartAddr, uint16_t aQty, uint8_t* aBuffer);
+
 private:
 
     Callback<Tool> ON_READ_COILS;
@@ -87,6 +117,40 @@ private:
     unsigned int OnWriteSingleCoil     (void* aSender, void* aData);
     unsigned int OnWriteSingleRegister (void* aSender, void* aData);
 
+    // aUnitId  0 without Units
+    // Return   nullptr when the unit is not declared
+    Image* GetUnit(uint8_t aUnitId);
+
+    // Return  0 without Units
+    uint8_t GetSerialUnitId() const;
+
+    // Copy the Items of the configuration into mImage
+    void LoadImage();
+
+    // Create the units the configuration declares, mImage is their
+    // template
+    void LoadUnits();
+
+    unsigned int ReadBits           (Image* aImage, uint8_t aUnitId, const char* aOp, Image::Table aTable, void* aData);
+    unsigned int ReadRegisters      (Image* aImage, uint8_t aUnitId, const char* aOp, Image::Table aTable, void* aData);
+    unsigned int WriteSingleCoil    (Image* aImage, uint8_t aUnitId, void* aData);
+    unsigned int WriteSingleRegister(Image* aImage, uint8_t aUnitId, void* aData);
+
+    // With TraceSummary, one event per request instead of one per address
+    void TraceRead(const Image& aImage, uint8_t aUnitId, const char* aOp, Image::Table aTable, unsigned int aStart, unsigned int aQty);
+
+    // The Items are only the configuration front end, the callbacks use
+    // mImage or the unit images
+    Image mImage;
+
+    // Indexed by unit ID, nullptr for a unit not declared
+    Image*       mUnitImages[256];
+    unsigned int mUnitQty;
+
+    TcpServer mServer;
+
+    TraceLog mTrace;
+
     Modbus::Slave* mSlave;
 
 };
@@ -94,10 +158,15 @@ private:
 // Constants
 // //////////////////////////////////////////////////////////////////////////
 
+static const Cfg::MetaData MD_BENCHMARK        ("Benchmark = {Count}");
 static const Cfg::MetaData MD_COILS            ("Coils[{Address}] = {Name}[;{Value}][;{Flags}]");
 static const Cfg::MetaData MD_DISCRETE_INPUTS  ("DiscreteInputs[{Address}] = {Name}[;{Value}][;{Flags}]");
 static const Cfg::MetaData MD_HOLDING_REGISTERS("HoldingRegisters[{Address}] = {Name}[;{Value}][;{Flags}]");
 static const Cfg::MetaData MD_INPUT_REGISTERS  ("InputRegisters[{Address}] = {Name}[;{Value}][;{Flags}]");
+static const Cfg::MetaData MD_SERIAL_UNIT      ("SerialUnit = {UnitId}");
+static const Cfg::MetaData MD_TCP_PORT         ("TcpPort = {Port}");
+static const Cfg::MetaData MD_TRACE_SUMMARY    ("TraceSummary = false | true");
+static const Cfg::MetaData MD_UNITS            ("Units = {First}[-{Last}]");
 
 // Static variable
 // //////////////////////////////////////////////////////////////////////////
@@ -114,9 +183,7 @@ extern "C"
 
 static DI::Object* CreateItem();
 
-static void TraceKnown(const char* aOp, Modbus::Address aA, const Item& aItem, unsigned int aFlags);
-
-static void TraceUnknown(const char* aOp, Modbus::Address aA, Modbus::RegisterValue aV);
+static void LoadTable(Image* aImage, Image::Table aTable, const DI::Array_Sparse& aIn);
 
 // Entry point
 // //////////////////////////////////////////////////////////////////////////
@@ -127,6 +194,8 @@ int main(int aCount, const char** aVector)
 
     _crt_signal_t lHandler = nullptr;
 
+    Net::Thread_Startup();
+
     KMS_MAIN_BEGIN;
     {
         Com::Port             lPort;
@@ -163,6 +232,8 @@ int main(int aCount, const char** aVector)
 
     sTool = nullptr;
 
+    Net::Thread_Cleanup();
+
     KMS_MAIN_RETURN;
 }
 
@@ -174,14 +245,21 @@ const unsigned int Tool::FLAG_VERBOSE_READ   = 0x00000002;
 const unsigned int Tool::FLAG_VERBOSE_WRITE  = 0x00000004;
 
 Tool::Tool()
-    : ON_READ_COILS            (this, &Tool::OnReadCoils)
+    : mBenchmark(0)
+    , mSerialUnit(1)
+    , mTcpPort(0)
+    , ON_READ_COILS            (this, &Tool::OnReadCoils)
     , ON_READ_DISCRETE_INPUTS  (this, &Tool::OnReadDiscreteInputs)
     , ON_READ_HOLDING_REGISTERS(this, &Tool::OnReadHoldingRegisters)
     , ON_READ_INPUT_REGISTERS  (this, &Tool::OnReadInputRegisters)
     , ON_WRITE_SINGLE_COIL     (this, &Tool::OnWriteSingleCoil)
     , ON_WRITE_SINGLE_REGISTER (this, &Tool::OnWriteSingleRegister)
+    , mUnitQty(0)
+    , mServer(this)
     , mSlave(nullptr)
 {
+    memset(&mUnitImages, 0, sizeof(mUnitImages));
+
     mCoils           .SetCreator(CreateItem);
     mDiscreteInputs  .SetCreator(CreateItem);
     mHoldingRegisters.SetCreator(CreateItem);
@@ -189,10 +267,68 @@ Tool::Tool()
     
     Ptr_OF<DI::Object> lEntry;
 
+    lEntry.Set(&mBenchmark       , false); AddEntry("Benchmark"       , lEntry, &MD_BENCHMARK);
     lEntry.Set(&mCoils           , false); AddEntry("Coils"           , lEntry, &MD_COILS);
     lEntry.Set(&mDiscreteInputs  , false); AddEntry("DiscreteInputs"  , lEntry, &MD_DISCRETE_INPUTS);
     lEntry.Set(&mHoldingRegisters, false); AddEntry("HoldingRegisters", lEntry, &MD_HOLDING_REGISTERS);
     lEntry.Set(&mInputRegisters  , false); AddEntry("InputRegisters"  , lEntry, &MD_INPUT_REGISTERS);
+    lEntry.Set(&mSerialUnit      , false); AddEntry("SerialUnit"      , lEntry, &MD_SERIAL_UNIT);
+    lEntry.Set(&mTcpPort         , false); AddEntry("TcpPort"         , lEntry, &MD_TCP_PORT);
+    lEntry.Set(&mTraceSummary    , false); AddEntry("TraceSummary"    , lEntry, &MD_TRACE_SUMMARY);
+    lEntry.Set(&mUnits           , false); AddEntry("Units"           , lEntry, &MD_UNITS);
+}
+
+Tool::~Tool()
+{
+    for (auto lImage : mUnitImages)
+    {
+        delete lImage;
+    }
+}
+
+void Tool::Benchmark(unsigned int aCount)
+{
+    assert(0 < aCount);
+
+    static const Image::Table TABLES[] = { Image::Table::COILS, Image::Table::DISCRETE_INPUTS, Image::Table::HOLDING_REGISTERS, Image::Table::INPUT_REGISTERS };
+    static const char*        NAMES [] = { "Read Coils (2000)", "Read Discrete Inputs (2000)", "Read Holding Registers (125)", "Read Input Registers (125)" };
+    static const unsigned int QTY   [] = { 2000, 2000, 125, 125 };
+
+    static const Modbus::Address START = 1;
+
+    unsigned int (Tool::*lCallbacks[])(void*, void*) = { &Tool::OnReadCoils, &Tool::OnReadDiscreteInputs, &Tool::OnReadHoldingRegisters, &Tool::OnReadInputRegisters };
+
+    uint8_t lBuffer[256];
+
+    for (unsigned int t = 0; t < 4; t++)
+    {
+        for (unsigned int i = 0; i < QTY[t]; i++)
+        {
+            if (!mImage.IsKnown(TABLES[t], START + i))
+            {
+                mImage.Set(TABLES[t], START + i, "", static_cast<Modbus::RegisterValue>(i), 0);
+            }
+        }
+
+        Modbus::Slave::MsgData lData;
+
+        lData.mBuffer    = lBuffer;
+        lData.mQty       = QTY[t];
+        lData.mStartAddr = START;
+
+        auto lStart = std::chrono::steady_clock::now();
+
+        for (unsigned int i = 0; i < aCount; i++)
+        {
+            (this->*lCallbacks[t])(nullptr, &lData);
+        }
+
+        auto lDuration_ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - lStart).count();
+
+        std::cout << Console::Color::BLUE;
+        std::cout << "Benchmark " << NAMES[t] << " : " << static_cast<uint64_t>(lDuration_ns / aCount) << " ns/request";
+        std::cout << Console::Color::WHITE << std::endl;
+    }
 }
 
 void Tool::InitSlave(Modbus::Slave* aSlave)
@@ -213,210 +349,334 @@ int Tool::Run()
 {
     assert(nullptr != mSlave);
 
-    if (!mSlave->Connect())
+    LoadImage();
+    LoadUnits();
+
+    mTrace.Start();
+
+    int lResult = 0;
+
+    if (0 < mBenchmark)
+    {
+        Benchmark(mBenchmark);
+    }
+    else if (0 < mTcpPort)
     {
-        return __LINE__;
+        mServer.Run(mTcpPort);
+        mServer.Display(std::cout);
+    }
+    else if (mSlave->Connect())
+    {
+        mSlave->Run();
+    }
+    else
+    {
+        lResult = __LINE__;
     }
 
-    mSlave->Run();
+    mTrace.Stop();
 
-    return 0;
+    if (0 < mUnitQty)
+    {
+        unsigned int lPageCount = 0;
+
+        for (auto lImage : mUnitImages)
+        {
+            if (nullptr != lImage)
+            {
+                lPageCount += lImage->GetPageCount();
+            }
+        }
+
+        std::cout << "Units              : " << mUnitQty << ", " << lPageCount << " pages copied (" << lPageCount * Image::PAGE_SIZE_byte / 1024 << " KiB)\n";
+    }
+
+    return lResult;
 }
 
-void Tool::Stop() { assert(nullptr != mSlave); mSlave->Stop(); }
+void Tool::Stop()
+{
+    assert(nullptr != mSlave);
 
-// Private
-// //////////////////////////////////////////////////////////////////////////
+    if (0 < mTcpPort)
+    {
+        mServer.Stop();
+    }
+    else
+    {
+        mSlave->Stop();
+    }
+}
 
-// ===== Callbacks ==========================================================
+// ===== IRequestListener ===================================================
 
-unsigned int Tool::OnReadCoils(void*, void* aData)
+uint8_t Tool::OnRequest(uint8_t aUnitId, uint8_t aFunction, uint16_t aStartAddr, uint16_t aQty, uint8_t* aBuffer)
 {
-    assert(nullptr != aData);
+    assert(nullptr != aBuffer);
 
-    auto lData = reinterpret_cast<Modbus::Slave::MsgData*>(aData);
+    uint8_t lUnitId = (0 < mUnitQty) ? aUnitId : 0;
 
-    for (unsigned int i = 0; i < lData->mQty; i++)
+    auto lImage = GetUnit(lUnitId);
+    if (nullptr == lImage)
     {
-        auto lValue = false;
-
-        auto lObject = mCoils.GetEntry_R(lData->mStartAddr + i);
-        if (nullptr == lObject)
-        {
-            TraceUnknown("Read Coil", lData->mStartAddr + i, Modbus::OFF);
-        }
-        else
-        {
-            auto lItem = dynamic_cast<const Item*>(lObject);
-            assert(nullptr != lItem);
+        return 0x0b; // Gateway target device failed to respond
+    }
 
-            TraceKnown("Read Coil", lData->mStartAddr + i, *lItem, FLAG_VERBOSE_READ);
+    Modbus::Slave::MsgData lData;
 
-            lValue = lItem->mValue;
-        }
+    lData.mBuffer    = aBuffer;
+    lData.mQty       = aQty;
+    lData.mStartAddr = aStartAddr;
 
-        Modbus::WriteBit(lData->mBuffer, 0, i, lValue);
+    switch (aFunction)
+    {
+    case 0x01: ReadBits           (lImage, lUnitId, "Read Coil"            , Image::Table::COILS            , &lData); break;
+    case 0x02: ReadBits           (lImage, lUnitId, "Read Discrete Input"  , Image::Table::DISCRETE_INPUTS  , &lData); break;
+    case 0x03: ReadRegisters      (lImage, lUnitId, "Read Holding Register", Image::Table::HOLDING_REGISTERS, &lData); break;
+    case 0x04: ReadRegisters      (lImage, lUnitId, "Read Input Register"  , Image::Table::INPUT_REGISTERS  , &lData); break;
+    case 0x05: WriteSingleCoil    (lImage, lUnitId, &lData); break;
+    case 0x06: WriteSingleRegister(lImage, lUnitId, &lData); break;
+
+    default: return 0x01; // Illegal function
     }
 
     return 0;
 }
 
+// Private
+// //////////////////////////////////////////////////////////////////////////
+
+// ===== Callbacks ==========================================================
+
+// The serial Slave only answers its DeviceAddress and does not pass it to
+// the callbacks, SerialUnit tells which unit it is.
+
+unsigned int Tool::OnReadCoils(void*, void* aData)
+{
+    auto lUnitId = GetSerialUnitId();
+
+    return ReadBits(GetUnit(lUnitId), lUnitId, "Read Coil", Image::Table::COILS, aData);
+}
+
 unsigned int Tool::OnReadDiscreteInputs(void*, void* aData)
 {
-    assert(nullptr != aData);
+    auto lUnitId = GetSerialUnitId();
 
-    auto lData = reinterpret_cast<Modbus::Slave::MsgData*>(aData);
+    return ReadBits(GetUnit(lUnitId), lUnitId, "Read Discrete Input", Image::Table::DISCRETE_INPUTS, aData);
+}
 
-    for (unsigned int i = 0; i < lData->mQty; i++)
-    {
-        auto lValue = false;
+unsigned int Tool::OnReadHoldingRegisters(void*, void* aData)
+{
+    auto lUnitId = GetSerialUnitId();
 
-        auto lObject = mDiscreteInputs.GetEntry_R(lData->mStartAddr + i);
-        if (nullptr == lObject)
-        {
-            TraceUnknown("Read Discrete Input", lData->mStartAddr + i, Modbus::OFF);
-        }
-        else
-        {
-            auto lItem = dynamic_cast<const Item*>(lObject);
-            assert(nullptr != lItem);
+    return ReadRegisters(GetUnit(lUnitId), lUnitId, "Read Holding Register", Image::Table::HOLDING_REGISTERS, aData);
+}
 
-            TraceKnown("Read Discrete Input", lData->mStartAddr + i, *lItem, FLAG_VERBOSE_READ);
+unsigned int Tool::OnReadInputRegisters(void*, void* aData)
+{
+    auto lUnitId = GetSerialUnitId();
 
-            lValue = lItem->mValue;
-        }
+    return ReadRegisters(GetUnit(lUnitId), lUnitId, "Read Input Register", Image::Table::INPUT_REGISTERS, aData);
+}
 
-        Modbus::WriteBit(lData->mBuffer, 0, i, lValue);
-    }
+unsigned int Tool::OnWriteSingleCoil(void*, void* aData)
+{
+    auto lUnitId = GetSerialUnitId();
 
-    return 0;
+    return WriteSingleCoil(GetUnit(lUnitId), lUnitId, aData);
 }
 
-unsigned int Tool::OnReadHoldingRegisters(void*, void* aData)
+unsigned int Tool::OnWriteSingleRegister(void*, void* aData)
 {
+    auto lUnitId = GetSerialUnitId();
+
+    return WriteSingleRegister(GetUnit(lUnitId), lUnitId, aData);
+}
+
+// ===== Requests ===========================================================
+
+unsigned int Tool::ReadBits(Image* aImage, uint8_t aUnitId, const char* aOp, Image::Table aTable, void* aData)
+{
+    assert(nullptr != aImage);
     assert(nullptr != aData);
 
     auto lData = reinterpret_cast<Modbus::Slave::MsgData*>(aData);
 
-    for (unsigned int i = 0; i < lData->mQty; i++)
-    {
-        Modbus::RegisterValue lValue = 0;
+    aImage->ReadBits(aTable, lData->mStartAddr, lData->mQty, reinterpret_cast<uint8_t*>(lData->mBuffer));
 
-        auto lObject = mHoldingRegisters.GetEntry_R(lData->mStartAddr + i);
-        if (nullptr == lObject)
-        {
-            TraceUnknown("Read Holding Register", lData->mStartAddr + i, 0);
-        }
-        else
-        {
-            auto lItem = dynamic_cast<const Item*>(lObject);
-            assert(nullptr != lItem);
+    TraceRead(*aImage, aUnitId, aOp, aTable, lData->mStartAddr, lData->mQty);
 
-            TraceKnown("Read Holding Register", lData->mStartAddr + i, *lItem, FLAG_VERBOSE_READ);
+    return 0;
+}
 
-            lValue = lItem->mValue;
-        }
+unsigned int Tool::ReadRegisters(Image* aImage, uint8_t aUnitId, const char* aOp, Image::Table aTable, void* aData)
+{
+    assert(nullptr != aImage);
+    assert(nullptr != aData);
 
-        Modbus::WriteUInt16(lData->mBuffer, sizeof(Modbus::RegisterValue) * i, lValue);
-    }
+    auto lData = reinterpret_cast<Modbus::Slave::MsgData*>(aData);
+
+    aImage->ReadRegisters(aTable, lData->mStartAddr, lData->mQty, reinterpret_cast<uint8_t*>(lData->mBuffer));
+
+    TraceRead(*aImage, aUnitId, aOp, aTable, lData->mStartAddr, lData->mQty);
 
     return 0;
 }
 
-unsigned int Tool::OnReadInputRegisters(void*, void* aData)
+unsigned int Tool::WriteSingleCoil(Image* aImage, uint8_t aUnitId, void* aData)
 {
+    assert(nullptr != aImage);
     assert(nullptr != aData);
 
     auto lData = reinterpret_cast<Modbus::Slave::MsgData*>(aData);
 
-    for (unsigned int i = 0; i < lData->mQty; i++)
+    auto lValue = Modbus::ReadUInt16(lData->mBuffer, 0);
+
+    if (!aImage->IsKnown(Image::Table::COILS, lData->mStartAddr))
+    {
+        mTrace.Unknown(aUnitId, "Write Single Coil", lData->mStartAddr, lValue);
+    }
+    else
     {
-        Modbus::RegisterValue lValue = 0;
+        unsigned int lFlags = FLAG_VERBOSE_WRITE;
 
-        auto lObject = mInputRegisters.GetEntry_R(lData->mStartAddr + i);
-        if (nullptr == lObject)
+        if (aImage->SetBit(Image::Table::COILS, lData->mStartAddr, Modbus::ON == lValue))
         {
-            TraceUnknown("Read Input Register", lData->mStartAddr + i, 0);
+            lFlags |= FLAG_VERBOSE_CHANGE;
         }
-        else
-        {
-            auto lItem = dynamic_cast<const Item*>(lObject);
-            assert(nullptr != lItem);
 
-            TraceKnown("Read Input Register", lData->mStartAddr, *lItem, FLAG_VERBOSE_READ);
-
-            lValue = lItem->mValue;
+        if (0 != (aImage->GetFlags(Image::Table::COILS, lData->mStartAddr) & lFlags))
+        {
+            mTrace.Known(aUnitId, "Write Single Coil", lData->mStartAddr, aImage->GetName(Image::Table::COILS, lData->mStartAddr), aImage->GetBit(Image::Table::COILS, lData->mStartAddr));
         }
-
-        Modbus::WriteUInt16(lData->mBuffer, sizeof(Modbus::RegisterValue) * i, lValue);
     }
 
     return 0;
 }
 
-unsigned int Tool::OnWriteSingleCoil(void*, void* aData)
+unsigned int Tool::WriteSingleRegister(Image* aImage, uint8_t aUnitId, void* aData)
 {
+    assert(nullptr != aImage);
     assert(nullptr != aData);
 
     auto lData = reinterpret_cast<Modbus::Slave::MsgData*>(aData);
 
     auto lValue = Modbus::ReadUInt16(lData->mBuffer, 0);
 
-    auto lObject = mCoils.GetEntry_RW(lData->mStartAddr);
-    if (nullptr == lObject)
+    if (!aImage->IsKnown(Image::Table::HOLDING_REGISTERS, lData->mStartAddr))
     {
-        TraceUnknown("Write Single Coil", lData->mStartAddr, lValue);
+        mTrace.Unknown(aUnitId, "Write Single Register", lData->mStartAddr, lValue);
     }
     else
     {
-        auto lBool = Modbus::ON == lValue;
         unsigned int lFlags = FLAG_VERBOSE_WRITE;
 
-        auto lItem = dynamic_cast<Item*>(lObject);
-        assert(nullptr != lItem);
-
-        if ((0 != lItem->mValue) != lBool)
+        if (aImage->SetRegister(Image::Table::HOLDING_REGISTERS, lData->mStartAddr, lValue))
         {
-            lItem->mValue = lBool;
             lFlags |= FLAG_VERBOSE_CHANGE;
         }
 
-        TraceKnown("Write Single Coil", lData->mStartAddr, *lItem, lFlags);
+        if (0 != (aImage->GetFlags(Image::Table::HOLDING_REGISTERS, lData->mStartAddr) & lFlags))
+        {
+            mTrace.Known(aUnitId, "Write Single Register", lData->mStartAddr, aImage->GetName(Image::Table::HOLDING_REGISTERS, lData->mStartAddr), lValue);
+        }
     }
 
     return 0;
 }
 
-unsigned int Tool::OnWriteSingleRegister(void*, void* aData)
+// ===== Image ==============================================================
+
+Image* Tool::GetUnit(uint8_t aUnitId)
 {
-    assert(nullptr != aData);
+    return (0 < mUnitQty) ? mUnitImages[aUnitId] : &mImage;
+}
 
-    auto lData = reinterpret_cast<Modbus::Slave::MsgData*>(aData);
+uint8_t Tool::GetSerialUnitId() const { return (0 < mUnitQty) ? static_cast<uint8_t>(mSerialUnit) : 0; }
 
-    auto lValue = Modbus::ReadUInt16(lData->mBuffer, 0);
+void Tool::LoadImage()
+{
+    LoadTable(&mImage, Image::Table::COILS            , mCoils);
+    LoadTable(&mImage, Image::Table::DISCRETE_INPUTS  , mDiscreteInputs);
+    LoadTable(&mImage, Image::Table::HOLDING_REGISTERS, mHoldingRegisters);
+    LoadTable(&mImage, Image::Table::INPUT_REGISTERS  , mInputRegisters);
+}
 
-    auto lObject = mHoldingRegisters.GetEntry_RW(lData->mStartAddr);
-    if (nullptr == lObject)
+void Tool::LoadUnits()
+{
+    assert(0 == mUnitQty);
+
+    if (0 == strlen(mUnits))
     {
-        TraceUnknown("Write Single Register", lData->mStartAddr, lValue);
+        return;
     }
-    else
+
+    unsigned int lFirst;
+    unsigned int lLast;
+
+    switch (sscanf_s(mUnits, "%u-%u", &lFirst, &lLast))
     {
-        unsigned int lFlags = FLAG_VERBOSE_WRITE;
+    case 1: lLast = lFirst; break;
+    case 2: break;
 
-        auto lItem = dynamic_cast<Item*>(lObject);
-        assert(nullptr != lItem);
+    default: KMS_EXCEPTION(RESULT_INVALID_CONFIG, "Invalid unit range", mUnits.Get());
+    }
+
+    KMS_EXCEPTION_ASSERT((1 <= lFirst) && (lFirst <= lLast) && (247 >= lLast), RESULT_INVALID_CONFIG, "Invalid unit range", mUnits.Get());
+
+    for (auto lU = lFirst; lU <= lLast; lU++)
+    {
+        mUnitImages[lU] = new Image(&mImage);
+    }
+
+    mUnitQty = lLast - lFirst + 1;
 
-        if (lItem->mValue != lValue)
+    if ((0 == mTcpPort) || (0 < mBenchmark))
+    {
+        KMS_EXCEPTION_ASSERT(nullptr != mUnitImages[mSerialUnit], RESULT_INVALID_CONFIG, "The serial unit is not declared", static_cast<unsigned int>(mSerialUnit));
+    }
+}
+
+void Tool::TraceRead(const Image& aImage, uint8_t aUnitId, const char* aOp, Image::Table aTable, unsigned int aStart, unsigned int aQty)
+{
+    assert(nullptr != aOp);
+
+    auto lA   = aImage.FindTrace(aTable, aStart, aQty, FLAG_VERBOSE_READ);
+    auto lEnd = aStart + aQty;
+
+    if (lEnd <= lA)
+    {
+        return;
+    }
+
+    if (mTraceSummary)
+    {
+        unsigned int lTraceCount   = 0;
+        unsigned int lUnknownCount = 0;
+
+        for (; lA < lEnd; lA = aImage.FindTrace(aTable, lA + 1, lEnd - lA - 1, FLAG_VERBOSE_READ))
         {
-            lItem->mValue = lValue;
-            lFlags |= FLAG_VERBOSE_CHANGE;
+            if (aImage.IsKnown(aTable, lA)) { lTraceCount++; }
+            else                            { lUnknownCount++; }
         }
 
-        TraceKnown("Write Single Register", lData->mStartAddr, *lItem, lFlags);
+        mTrace.Summary(aUnitId, aOp, aStart, aQty, lUnknownCount, lTraceCount);
+        return;
     }
 
-    return 0;
+    auto lBits = (Image::Table::COILS == aTable) || (Image::Table::DISCRETE_INPUTS == aTable);
+
+    for (; lA < lEnd; lA = aImage.FindTrace(aTable, lA + 1, lEnd - lA - 1, FLAG_VERBOSE_READ))
+    {
+        if (!aImage.IsKnown(aTable, lA))
+        {
+            mTrace.Unknown(aUnitId, aOp, lA, lBits ? Modbus::OFF : 0);
+        }
+        else
+        {
+            mTrace.Known(aUnitId, aOp, lA, aImage.GetName(aTable, lA), lBits ? aImage.GetBit(aTable, lA) : aImage.GetRegister(aTable, lA));
+        }
+    }
 }
 
 // Static functions
@@ -435,21 +695,15 @@ void OnCtrlC(int aSignal)
 
 DI::Object* CreateItem() { return new Item; }
 
-void TraceKnown(const char* aOp, Modbus::Address aA, const Item& aItem, unsigned int aFlags)
+void LoadTable(Image* aImage, Image::Table aTable, const DI::Array_Sparse& aIn)
 {
-    assert(nullptr != aOp);
+    assert(nullptr != aImage);
 
-    if (0 != (aItem.mFlags & aFlags))
+    for (auto& lVT : aIn.mInternal)
     {
-        std::cout << aOp << " " << aItem.mName.c_str() << " (" << aA << ") = " << aItem.mValue << std::endl;
-    }
-}
-
-void TraceUnknown(const char* aOp, Modbus::Address aA, Modbus::RegisterValue aV)
-{
-    assert(nullptr != aOp);
+        auto lItem = dynamic_cast<const Item*>(lVT.second.Get());
+        assert(nullptr != lItem);
 
-    std::cout << Console::Color::RED;
-    std::cout << aOp << " at " << aA << " = " << aV;
-    std::cout << Console::Color::WHITE << std::endl;
+        aImage->Set(aTable, lVT.first, lItem->mName.c_str(), lItem->mValue, lItem->mFlags);
+    }
 }
@@ -0,0 +1,622 @@
+// Author    KMS - Martin Dubois, P. Eng.
+// Copyright (C) 2024 KMS
+// License   http://www.apache.org/licenses/LICENSE-2.0
+// Product   KMS-Tools
+// File      ModbusSim/TcpServer.cpp
+
+#include "Component.h"
+
+// ===== C ==================================================================
+#ifdef _KMS_WINDOWS_
+    #include <winsock2.h>
+#else
+    #include <errno.h>
+    #include <fcntl.h>
+    #include <netinet/in.h>
+    #include <netinet/tcp.h>
+    #include <sys/epoll.h>
+    #include <sys/socket.h>
+    #include <unistd.h>
+#endif
+
+// ===== Import/Includes ====================================================
+#include <KMS/Modbus/Modbus.h>
+
+// ===== Local ==============================================================
+#include "IRequestListener.h"
+
+#include "TcpServer.h"
+
+using namespace KMS;
+
+KMS_RESULT_STATIC(RESULT_LISTEN_FAILED);
+
+// Constants
+// //////////////////////////////////////////////////////////////////////////
+
+#define EVENT_QTY (256)
+
+#define EXCEPTION_ILLEGAL_FUNCTION     (0x01)
+#define EXCEPTION_ILLEGAL_DATA_ADDRESS (0x02)
+#define EXCEPTION_ILLEGAL_DATA_VALUE   (0x03)
+
+#define FUNCTION_READ_COILS             (0x01)
+#define FUNCTION_READ_DISCRETE_INPUTS   (0x02)
+#define FUNCTION_READ_HOLDING_REGISTERS (0x03)
+#define FUNCTION_READ_INPUT_REGISTERS   (0x04)
+#define FUNCTION_WRITE_SINGLE_COIL      (0x05)
+#define FUNCTION_WRITE_SINGLE_REGISTER  (0x06)
+
+// Transaction ID, protocol ID, length and unit ID
+#define MBAP_SIZE_byte (7)
+
+// Unit ID and PDU
+#define LENGTH_MAX_byte (254)
+#define LENGTH_MIN_byte (2)
+
+// A master that does not read its responses is disconnected
+#define OUT_MAX_byte (65536)
+
+#define PERIOD_ms (100)
+
+#define RECEIVE_SIZE_byte (4096)
+
+// Static function declarations
+// //////////////////////////////////////////////////////////////////////////
+
+static void CloseSocket(uintptr_t aSocket);
+
+static bool IsWouldBlock();
+
+static uint16_t ReadUInt16(const uint8_t* aIn);
+
+static void SetNonBlocking(uintptr_t aSocket);
+
+static void WriteUInt16(uint8_t* aOut, uint16_t aValue);
+
+// Public
+// //////////////////////////////////////////////////////////////////////////
+
+TcpServer::TcpServer(IRequestListener* aListener)
+    : mListener(aListener)
+    , mSocket(static_cast<Socket>(-1))
+    , mRunning(false)
+    , mAcceptCount(0)
+    , mErrorCount(0)
+    , mMaxConnectionCount(0)
+    , mRequestCount(0)
+{
+    assert(nullptr != aListener);
+
+    #ifndef _KMS_WINDOWS_
+        mEpoll = -1;
+    #endif
+}
+
+TcpServer::~TcpServer()
+{
+    assert(mConnections.empty());
+    assert(static_cast<Socket>(-1) == mSocket);
+}
+
+void TcpServer::Run(uint16_t aPort)
+{
+    // An exception out of Listen or of the event loop must not leave the
+    // sockets open
+    try
+    {
+        Listen(aPort);
+
+        std::cout << "Modbus TCP on port " << aPort << std::endl;
+
+        mRunning = true;
+
+        while (mRunning)
+        {
+            Wait();
+        }
+    }
+    catch (...)
+    {
+        mRunning = false;
+
+        CloseAll();
+        throw;
+    }
+
+    CloseAll();
+}
+
+void TcpServer::Stop() { mRunning = false; }
+
+void TcpServer::Display(std::ostream& aOut) const
+{
+    aOut << "Connections        : " << mAcceptCount << " accepted, " << mMaxConnectionCount << " at the same time, " << mErrorCount << " closed on error\n";
+    aOut << "Requests           : " << mRequestCount << "\n";
+}
+
+// Private
+// //////////////////////////////////////////////////////////////////////////
+
+void TcpServer::Accept()
+{
+    for (;;)
+    {
+        auto lSocket = accept(mSocket, nullptr, nullptr);
+        if (static_cast<Socket>(-1) == static_cast<Socket>(lSocket))
+        {
+            // The other errors are the ones of the new connection, the
+            // listening socket stays ready for the next ones.
+            if (!IsWouldBlock())
+            {
+                mErrorCount++;
+            }
+            break;
+        }
+
+        SetNonBlocking(lSocket);
+
+        int lNoDelay = 1;
+
+        setsockopt(lSocket, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>(&lNoDelay), sizeof(lNoDelay));
+
+        auto lC = new Connection;
+
+        lC->mSocket    = lSocket;
+        lC->mWriteWait = false;
+
+        #ifndef _KMS_WINDOWS_
+            epoll_event lEvent;
+
+            lEvent.data.ptr = lC;
+            lEvent.events   = EPOLLIN;
+
+            if (0 != epoll_ctl(mEpoll, EPOLL_CTL_ADD, lSocket, &lEvent))
+            {
+                CloseSocket(lSocket);
+                delete lC;
+                mErrorCount++;
+                continue;
+            }
+        #endif
+
+        mConnections[lSocket] = lC;
+
+        mAcceptCount++;
+
+        if (mMaxConnectionCount < mConnections.size())
+        {
+            mMaxConnectionCount = static_cast<unsigned int>(mConnections.size());
+        }
+    }
+}
+
+void TcpServer::Close(Connection* aC)
+{
+    assert(nullptr != aC);
+
+    // Closing the socket also removes it from the epoll set
+    CloseSocket(aC->mSocket);
+
+    mConnections.erase(aC->mSocket);
+
+    delete aC;
+}
+
+void TcpServer::CloseAll()
+{
+    while (!mConnections.empty())
+    {
+        Close(mConnections.begin()->second);
+    }
+
+    #ifndef _KMS_WINDOWS_
+        if (0 <= mEpoll)
+        {
+            close(mEpoll);
+            mEpoll = -1;
+        }
+    #endif
+
+    if (static_cast<Socket>(-1) != mSocket)
+    {
+        CloseSocket(mSocket);
+        mSocket = static_cast<Socket>(-1);
+    }
+}
+
+unsigned int TcpServer::Execute(uint8_t aUnitId, const uint8_t* aIn, unsigned int aInSize_byte, uint8_t* aOut)
+{
+    assert(nullptr != aIn);
+    assert(0 < aInSize_byte);
+    assert(nullptr != aOut);
+
+    auto lFunction = aIn[0];
+
+    uint8_t      lException = EXCEPTION_ILLEGAL_FUNCTION;
+    unsigned int lMax       = 0;
+    unsigned int lResult    = 0;
+
+    switch (lFunction)
+    {
+    case FUNCTION_READ_COILS:
+    case FUNCTION_READ_DISCRETE_INPUTS  : lMax = 2000; break;
+    case FUNCTION_READ_HOLDING_REGISTERS:
+    case FUNCTION_READ_INPUT_REGISTERS  : lMax =  125; break;
+    case FUNCTION_WRITE_SINGLE_COIL     :
+    case FUNCTION_WRITE_SINGLE_REGISTER : lMax =    1; break;
+    }
+
+    if ((0 < lMax) && (5 != aInSize_byte))
+    {
+        lException = EXCEPTION_ILLEGAL_DATA_VALUE;
+    }
+    else if (1 == lMax)
+    {
+        auto lA     = ReadUInt16(aIn + 1);
+        auto lValue = ReadUInt16(aIn + 3);
+
+        if ((FUNCTION_WRITE_SINGLE_COIL == lFunction) && (Modbus::ON != lValue) && (Modbus::OFF != lValue))
+        {
+            lException = EXCEPTION_ILLEGAL_DATA_VALUE;
+        }
+        else
+        {
+            // The response echoes the request
+            memcpy(aOut, aIn, 5);
+
+            lException = mListener->OnRequest(aUnitId, lFunction, lA, 1, aOut + 3);
+            lResult    = 5;
+        }
+    }
+    else if (0 < lMax)
+    {
+        auto lStart = ReadUInt16(aIn + 1);
+        auto lQty   = ReadUInt16(aIn + 3);
+
+        if ((0 == lQty) || (lMax < lQty))
+        {
+            lException = EXCEPTION_ILLEGAL_DATA_VALUE;
+        }
+        else if (0x10000 < static_cast<unsigned int>(lStart) + lQty)
+        {
+            lException = EXCEPTION_ILLEGAL_DATA_ADDRESS;
+        }
+        else
+        {
+            auto lData_byte = (2000 == lMax) ? (lQty + 7) / 8 : 2 * lQty;
+
+            aOut[0] = lFunction;
+            aOut[1] = static_cast<uint8_t>(lData_byte);
+
+            lException = mListener->OnRequest(aUnitId, lFunction, lStart, lQty, aOut + 2);
+            lResult    = 2 + lData_byte;
+        }
+    }
+
+    if (0 != lException)
+    {
+        aOut[0] = lFunction | 0x80;
+        aOut[1] = lException;
+
+        lResult = 2;
+    }
+
+    return lResult;
+}
+
+void TcpServer::Listen(uint16_t aPort)
+{
+    assert(static_cast<Socket>(-1) == mSocket);
+
+    auto lSocket = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    KMS_EXCEPTION_ASSERT(static_cast<Socket>(-1) != static_cast<Socket>(lSocket), RESULT_LISTEN_FAILED, "Cannot create the socket", "");
+
+    mSocket = lSocket;
+
+    int lReuse = 1;
+
+    setsockopt(mSocket, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char*>(&lReuse), sizeof(lReuse));
+
+    sockaddr_in lAddr;
+
+    memset(&lAddr, 0, sizeof(lAddr));
+
+    lAddr.sin_addr.s_addr = htonl(INADDR_ANY);
+    lAddr.sin_family      = AF_INET;
+    lAddr.sin_port        = htons(aPort);
+
+    // On failure, Run closes the sockets
+    if ((0 != bind(mSocket, reinterpret_cast<sockaddr*>(&lAddr), sizeof(lAddr))) || (0 != listen(mSocket, SOMAXCONN)))
+    {
+        KMS_EXCEPTION(RESULT_LISTEN_FAILED, "Cannot listen", aPort);
+    }
+
+    SetNonBlocking(mSocket);
+
+    #ifndef _KMS_WINDOWS_
+        mEpoll = epoll_create1(0);
+        KMS_EXCEPTION_ASSERT(0 <= mEpoll, RESULT_LISTEN_FAILED, "epoll_create1 failed", "");
+
+        epoll_event lEvent;
+
+        lEvent.data.ptr = nullptr;
+        lEvent.events   = EPOLLIN;
+
+        auto lRet = epoll_ctl(mEpoll, EPOLL_CTL_ADD, mSocket, &lEvent);
+        KMS_EXCEPTION_ASSERT(0 == lRet, RESULT_LISTEN_FAILED, "epoll_ctl failed", "");
+    #endif
+}
+
+bool TcpServer::Process(Connection* aC)
+{
+    assert(nullptr != aC);
+
+    uint8_t lResponse[MBAP_SIZE_byte + LENGTH_MAX_byte];
+
+    auto lIn = aC->mIn.data();
+
+    unsigned int lOffset_byte = 0;
+    auto         lSize_byte   = static_cast<unsigned int>(aC->mIn.size());
+
+    while (MBAP_SIZE_byte <= lSize_byte - lOffset_byte)
+    {
+        auto lFrame = lIn + lOffset_byte;
+
+        auto lLength_byte = ReadUInt16(lFrame + 4);
+
+        if ((0 != ReadUInt16(lFrame + 2)) || (LENGTH_MIN_byte > lLength_byte) || (LENGTH_MAX_byte < lLength_byte))
+        {
+            // Not Modbus TCP, the stream cannot be resynchronized
+            mErrorCount++;
+            Close(aC);
+            return false;
+        }
+
+        if (lSize_byte - lOffset_byte < 6U + lLength_byte)
+        {
+            break;
+        }
+
+        memcpy(lResponse, lFrame, MBAP_SIZE_byte);
+
+        auto lPdu_byte = Execute(lFrame[6], lFrame + MBAP_SIZE_byte, lLength_byte - 1, lResponse + MBAP_SIZE_byte);
+
+        WriteUInt16(lResponse + 4, static_cast<uint16_t>(1 + lPdu_byte));
+
+        aC->mOut.insert(aC->mOut.end(), lResponse, lResponse + MBAP_SIZE_byte + lPdu_byte);
+
+        mRequestCount++;
+
+        lOffset_byte += 6 + lLength_byte;
+    }
+
+    aC->mIn.erase(aC->mIn.begin(), aC->mIn.begin() + lOffset_byte);
+
+    return Send(aC);
+}
+
+bool TcpServer::Receive(Connection* aC)
+{
+    assert(nullptr != aC);
+
+    auto lSize_byte = aC->mIn.size();
+
+    aC->mIn.resize(lSize_byte + RECEIVE_SIZE_byte);
+
+    auto lRet = recv(aC->mSocket, reinterpret_cast<char*>(aC->mIn.data() + lSize_byte), RECEIVE_SIZE_byte, 0);
+    if (0 >= lRet)
+    {
+        aC->mIn.resize(lSize_byte);
+
+        if ((0 > lRet) && IsWouldBlock())
+        {
+            return true;
+        }
+
+        // 0 means the master closed the connection
+        if (0 > lRet)
+        {
+            mErrorCount++;
+        }
+
+        Close(aC);
+        return false;
+    }
+
+    aC->mIn.resize(lSize_byte + lRet);
+
+    return Process(aC);
+}
+
+bool TcpServer::Send(Connection* aC)
+{
+    assert(nullptr != aC);
+
+    if (!aC->mOut.empty())
+    {
+        #ifdef _KMS_WINDOWS_
+            auto lRet = send(aC->mSocket, reinterpret_cast<const char*>(aC->mOut.data()), static_cast<int>(aC->mOut.size()), 0);
+        #else
+            auto lRet = send(aC->mSocket, aC->mOut.data(), aC->mOut.size(), MSG_NOSIGNAL);
+        #endif
+
+        if (0 < lRet)
+        {
+            aC->mOut.erase(aC->mOut.begin(), aC->mOut.begin() + lRet);
+        }
+        else if (!IsWouldBlock())
+        {
+            mErrorCount++;
+            Close(aC);
+            return false;
+        }
+
+        if (OUT_MAX_byte < aC->mOut.size())
+        {
+            mErrorCount++;
+            Close(aC);
+            return false;
+        }
+    }
+
+    UpdateWriteWait(aC);
+
+    return true;
+}
+
+void TcpServer::UpdateWriteWait(Connection* aC)
+{
+    assert(nullptr != aC);
+
+    auto lWriteWait = !aC->mOut.empty();
+
+    if (aC->mWriteWait != lWriteWait)
+    {
+        aC->mWriteWait = lWriteWait;
+
+        #ifndef _KMS_WINDOWS_
+            epoll_event lEvent;
+
+            lEvent.data.ptr = aC;
+            lEvent.events   = lWriteWait ? (EPOLLIN | EPOLLOUT) : EPOLLIN;
+
+            epoll_ctl(mEpoll, EPOLL_CTL_MOD, aC->mSocket, &lEvent);
+        #endif
+    }
+}
+
+void TcpServer::Wait()
+{
+    #ifdef _KMS_WINDOWS_
+
+        std::vector<WSAPOLLFD>   lFds;
+        std::vector<Connection*> lCs;
+
+        lFds.reserve(mConnections.size() + 1);
+        lCs .reserve(mConnections.size() + 1);
+
+        WSAPOLLFD lFd;
+
+        lFd.events  = POLLRDNORM;
+        lFd.fd      = mSocket;
+        lFd.revents = 0;
+
+        lFds.push_back(lFd);
+        lCs .push_back(nullptr);
+
+        for (auto& lVT : mConnections)
+        {
+            lFd.events = lVT.second->mWriteWait ? (POLLRDNORM | POLLWRNORM) : POLLRDNORM;
+            lFd.fd     = lVT.first;
+
+            lFds.push_back(lFd);
+            lCs .push_back(lVT.second);
+        }
+
+        auto lCount = WSAPoll(lFds.data(), static_cast<ULONG>(lFds.size()), PERIOD_ms);
+
+        for (unsigned int i = 0; (0 < lCount) && (i < lFds.size()); i++)
+        {
+            auto lEvents = lFds[i].revents;
+            if (0 == lEvents)
+            {
+                continue;
+            }
+
+            auto lC = lCs[i];
+            if (nullptr == lC)
+            {
+                Accept();
+                continue;
+            }
+
+            if (0 != (lEvents & (POLLRDNORM | POLLHUP | POLLERR)))
+            {
+                if (!Receive(lC)) { continue; }
+            }
+
+            if (0 != (lEvents & POLLWRNORM))
+            {
+                Send(lC);
+            }
+        }
+
+    #else
+
+        epoll_event lEvents[EVENT_QTY];
+
+        auto lCount = epoll_wait(mEpoll, lEvents, EVENT_QTY, PERIOD_ms);
+
+        for (int i = 0; i < lCount; i++)
+        {
+            auto lC = static_cast<Connection*>(lEvents[i].data.ptr);
+            if (nullptr == lC)
+            {
+                Accept();
+                continue;
+            }
+
+            // An error or a hang up shows as a failed receive
+            if (0 != (lEvents[i].events & (EPOLLIN | EPOLLERR | EPOLLHUP)))
+            {
+                if (!Receive(lC)) { continue; }
+            }
+
+            if (0 != (lEvents[i].events & EPOLLOUT))
+            {
+                Send(lC);
+            }
+        }
+
+    #endif
+}
+
+// Static functions
+// //////////////////////////////////////////////////////////////////////////
+
+void CloseSocket(uintptr_t aSocket)
+{
+    #ifdef _KMS_WINDOWS_
+        closesocket(aSocket);
+    #else
+        close(static_cast<int>(aSocket));
+    #endif
+}
+
+bool IsWouldBlock()
+{
+    #ifdef _KMS_WINDOWS_
+        return WSAEWOULDBLOCK == WSAGetLastError();
+    #else
+        return (EAGAIN == errno) || (EWOULDBLOCK == errno) || (EINTR == errno);
+    #endif
+}
+
+uint16_t ReadUInt16(const uint8_t* aIn)
+{
+    assert(nullptr != aIn);
+
+    return static_cast<uint16_t>((aIn[0] << 8) | aIn[1]);
+}
+
+void SetNonBlocking(uintptr_t aSocket)
+{
+    #ifdef _KMS_WINDOWS_
+        u_long lMode = 1;
+
+        ioctlsocket(aSocket, FIONBIO, &lMode);
+    #else
+        auto lFlags = fcntl(static_cast<int>(aSocket), F_GETFL, 0);
+
+        fcntl(static_cast<int>(aSocket), F_SETFL, lFlags | O_NONBLOCK);
+    #endif
+}
+
+void WriteUInt16(uint8_t* aOut, uint16_t aValue)
+{
+    assert(nullptr != aOut);
+
+    aOut[0] = static_cast<uint8_t>(aValue >> 8);
+    aOut[1] = static_cast<uint8_t>(aValue);
+}
@@ -0,0 +1,99 @@
+// Author    KMS - Martin Dubois, P. Eng.
+// Copyright (C) 2024 KMS
+// License   http://www.apache.org/licenses/LICENSE-2.0
+// Product   KMS-Tools
+// File      ModbusSim/TcpServer.h
+
+#pragma once
+
+// ===== C++ ================================================================
+#include <atomic>
+#include <unordered_map>
+#include <vector>
+
+// ===== Local ==============================================================
+class IRequestListener;
+
+// Modbus TCP front end. One thread runs the event loop of the listening
+// socket and of all the connections, epoll on Linux and WSAPoll on
+// Windows, so the listener sees one request at a time and all the
+// connections share its register image. The requests a master sends
+// without waiting are answered in order, the response echoes the
+// transaction ID.
+class TcpServer
+{
+
+public:
+
+    TcpServer(IRequestListener* aListener);
+
+    ~TcpServer();
+
+    // Return when Stop is called
+    void Run(uint16_t aPort);
+
+    // Any thread, a signal handler included
+    void Stop();
+
+    void Display(std::ostream& aOut) const;
+
+private:
+
+    NO_COPY(TcpServer);
+
+    #ifdef _KMS_WINDOWS_
+        typedef uintptr_t Socket;
+    #else
+        typedef int Socket;
+    #endif
+
+    struct Connection
+    {
+        std::vector<uint8_t> mIn;
+        std::vector<uint8_t> mOut;
+        Socket               mSocket;
+        bool                 mWriteWait;
+    };
+
+    void Accept();
+
+    void Close(Connection* aC);
+
+    // Close the connections, the epoll instance and the listening socket
+    void CloseAll();
+
+    // Return  The size of the response PDU
+    unsigned int Execute(uint8_t aUnitId, const uint8_t* aIn, unsigned int aInSize_byte, uint8_t* aOut);
+
+    void Listen(uint16_t aPort);
+
+    // Return  false when the connection is closed
+    bool Process(Connection* aC);
+
+    // Return  false when the connection is closed
+    bool Receive(Connection* aC);
+
+    // Return  false when the connection is closed
+    bool Send(Connection* aC);
+
+    void UpdateWriteWait(Connection* aC);
+
+    void Wait();
+
+    std::unordered_map<Socket, Connection*> mConnections;
+
+    #ifndef _KMS_WINDOWS_
+        int mEpoll;
+    #endif
+
+    IRequestListener* mListener;
+    Socket            mSocket;
+    std::atomic<bool> mRunning;
+
+    // ===== Statistics =====================================================
+    uint64_t     mAcceptCount;
+    uint64_t     mErrorCount;
+    unsigned int mMaxConnectionCount;
+    uint64_t     mRequestCount;
+
+};
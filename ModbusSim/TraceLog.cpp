@@ -0,0 +1,240 @@
+// Author    KMS - Martin Dubois, P. Eng.
+// Copyright (C) 2024 KMS
+// License   http://www.apache.org/licenses/LICENSE-2.0
+// Product   KMS-Tools
+// File      ModbusSim/TraceLog.cpp
+
+#include "Component.h"
+
+// ===== C++ ================================================================
+#include <chrono>
+
+// ===== Local ==============================================================
+#include "TraceLog.h"
+
+using namespace KMS;
+
+// Constants
+// //////////////////////////////////////////////////////////////////////////
+
+// Must be a power of 2
+#define EVENT_QTY (65536)
+
+#define PERIOD_ms (10)
+
+#define TYPE_KNOWN   (0)
+#define TYPE_SUMMARY (1)
+#define TYPE_UNKNOWN (2)
+
+// Public
+// //////////////////////////////////////////////////////////////////////////
+
+TraceLog::TraceLog()
+    : mRed(false)
+    , mEvents(new Event[EVENT_QTY])
+    , mRunning(false)
+    , mLostCount(0)
+    , mLostReported(0)
+    , mRead(0)
+    , mWrite(0)
+{}
+
+TraceLog::~TraceLog()
+{
+    Stop();
+
+    assert(nullptr != mEvents);
+
+    delete[] mEvents;
+}
+
+void TraceLog::Start()
+{
+    assert(!mThread.joinable());
+
+    mRunning = true;
+
+    mThread = std::thread(&TraceLog::Run, this);
+}
+
+void TraceLog::Stop()
+{
+    mRunning = false;
+
+    if (mThread.joinable())
+    {
+        mThread.join();
+    }
+}
+
+// ===== Producer ===========================================================
+
+void TraceLog::Known(uint8_t aUnitId, const char* aOp, Modbus::Address aA, const char* aName, Modbus::RegisterValue aV)
+{
+    Event lE;
+
+    lE.mA      = aA;
+    lE.mName   = aName;
+    lE.mOp     = aOp;
+    lE.mType   = TYPE_KNOWN;
+    lE.mUnitId = aUnitId;
+    lE.mV      = aV;
+
+    Push(lE);
+}
+
+void TraceLog::Summary(uint8_t aUnitId, const char* aOp, Modbus::Address aStart, unsigned int aQty, unsigned int aUnknownCount, unsigned int aTraceCount)
+{
+    Event lE;
+
+    lE.mA            = aStart;
+    lE.mName         = nullptr;
+    lE.mOp           = aOp;
+    lE.mQty          = static_cast<uint16_t>(aQty);
+    lE.mTraceCount   = static_cast<uint16_t>(aTraceCount);
+    lE.mType         = TYPE_SUMMARY;
+    lE.mUnitId       = aUnitId;
+    lE.mUnknownCount = static_cast<uint16_t>(aUnknownCount);
+
+    Push(lE);
+}
+
+void TraceLog::Unknown(uint8_t aUnitId, const char* aOp, Modbus::Address aA, Modbus::RegisterValue aV)
+{
+    Event lE;
+
+    lE.mA      = aA;
+    lE.mName   = nullptr;
+    lE.mOp     = aOp;
+    lE.mType   = TYPE_UNKNOWN;
+    lE.mUnitId = aUnitId;
+    lE.mV      = aV;
+
+    Push(lE);
+}
+
+// Private
+// //////////////////////////////////////////////////////////////////////////
+
+void TraceLog::Push(const Event& aEvent)
+{
+    assert(nullptr != aEvent.mOp);
+
+    auto lWrite = mWrite.load(std::memory_order_relaxed);
+    auto lRead  = mRead .load(std::memory_order_acquire);
+
+    if (EVENT_QTY <= lWrite - lRead)
+    {
+        mLostCount.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    mEvents[lWrite & (EVENT_QTY - 1)] = aEvent;
+
+    mWrite.store(lWrite + 1, std::memory_order_release);
+}
+
+// ===== Background thread ==================================================
+
+bool TraceLog::Flush()
+{
+    auto lRead  = mRead .load(std::memory_order_relaxed);
+    auto lWrite = mWrite.load(std::memory_order_acquire);
+
+    auto lLostCount = mLostCount.load(std::memory_order_relaxed);
+
+    if ((lRead == lWrite) && (mLostReported == lLostCount))
+    {
+        return false;
+    }
+
+    // One batch, the console only sees the color changes
+    for (; lRead < lWrite; lRead++)
+    {
+        Format(mEvents[lRead & (EVENT_QTY - 1)]);
+    }
+
+    mRead.store(lRead, std::memory_order_release);
+
+    if (mLostReported != lLostCount)
+    {
+        std::cout << mLine;
+        mLine.clear();
+
+        std::cout << Console::Color::YELLOW << lLostCount - mLostReported << " trace events lost\n" << Console::Color::WHITE;
+
+        mLostReported = lLostCount;
+        mRed          = false;
+    }
+
+    std::cout << mLine;
+    mLine.clear();
+
+    if (mRed)
+    {
+        std::cout << Console::Color::WHITE;
+        mRed = false;
+    }
+
+    std::cout.flush();
+
+    return true;
+}
+
+void TraceLog::Format(const Event& aEvent)
+{
+    assert(nullptr != aEvent.mOp);
+
+    auto lRed = (TYPE_UNKNOWN == aEvent.mType) || ((TYPE_SUMMARY == aEvent.mType) && (0 < aEvent.mUnknownCount));
+    if (mRed != lRed)
+    {
+        std::cout << mLine;
+        mLine.clear();
+
+        if (lRed) { std::cout << Console::Color::RED; }
+        else      { std::cout << Console::Color::WHITE; }
+
+        mRed = lRed;
+    }
+
+    char lLine[LINE_LENGTH];
+
+    if (0 != aEvent.mUnitId)
+    {
+        sprintf_s(lLine SizeInfo(lLine), "Unit %u - ", aEvent.mUnitId);
+        mLine += lLine;
+    }
+
+    switch (aEvent.mType)
+    {
+    case TYPE_KNOWN:
+        assert(nullptr != aEvent.mName);
+        sprintf_s(lLine SizeInfo(lLine), "%s %s (%u) = %u\n", aEvent.mOp, aEvent.mName, aEvent.mA, aEvent.mV);
+        break;
+
+    case TYPE_SUMMARY:
+        sprintf_s(lLine SizeInfo(lLine), "%s %u to %u, %u unknown, %u traced\n", aEvent.mOp, aEvent.mA, aEvent.mA + aEvent.mQty - 1, aEvent.mUnknownCount, aEvent.mTraceCount);
+        break;
+
+    case TYPE_UNKNOWN:
+        sprintf_s(lLine SizeInfo(lLine), "%s at %u = %u\n", aEvent.mOp, aEvent.mA, aEvent.mV);
+        break;
+
+    default: assert(false);
+    }
+
+    mLine += lLine;
+}
+
+void TraceLog::Run()
+{
+    while (mRunning)
+    {
+        if (!Flush())
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(PERIOD_ms));
+        }
+    }
+
+    Flush();
+}
@@ -0,0 +1,95 @@
+// Author    KMS - Martin Dubois, P. Eng.
+// Copyright (C) 2024 KMS
+// License   http://www.apache.org/licenses/LICENSE-2.0
+// Product   KMS-Tools
+// File      ModbusSim/TraceLog.h
+
+#pragma once
+
+// ===== C++ ================================================================
+#include <atomic>
+#include <string>
+#include <thread>
+
+// ===== Import/Includes ====================================================
+#include <KMS/Modbus/Modbus.h>
+
+// The request path only copies a compact event into a single producer /
+// single consumer queue. A background thread formats the events and writes
+// them to the console in batches, so the response time does not depend on
+// the verbose flags. When the queue is full, the events are counted and
+// dropped, the request path never waits.
+//
+// One thread pushes the events; aOp and aName must stay valid until Stop.
+// aUnitId is 0 when the simulator serves a single unit.
+class TraceLog
+{
+
+public:
+
+    TraceLog();
+
+    ~TraceLog();
+
+    void Start();
+
+    // Write the queued events, then stop the thread
+    void Stop();
+
+    // ===== Producer =======================================================
+
+    void Known(uint8_t aUnitId, const char* aOp, KMS::Modbus::Address aA, const char* aName, KMS::Modbus::RegisterValue aV);
+
+    // aUnknownCount  Number of addresses without Item
+    // aTraceCount    Number of addresses with a verbose flag
+    void Summary(uint8_t aUnitId, const char* aOp, KMS::Modbus::Address aStart, unsigned int aQty, unsigned int aUnknownCount, unsigned int aTraceCount);
+
+    void Unknown(uint8_t aUnitId, const char* aOp, KMS::Modbus::Address aA, KMS::Modbus::RegisterValue aV);
+
+private:
+
+    NO_COPY(TraceLog);
+
+    struct Event
+    {
+        const char* mName;
+        const char* mOp;
+
+        uint16_t mA;
+        uint16_t mQty;
+        uint16_t mTraceCount;
+        uint16_t mUnknownCount;
+        uint16_t mV;
+
+        uint8_t mType;
+        uint8_t mUnitId;
+    };
+
+    void Push(const Event& aEvent);
+
+    // ===== Background thread ==============================================
+
+    // Return  false when the queue was empty
+    bool Flush();
+
+    void Format(const Event& aEvent);
+
+    void Run();
+
+    std::string mLine;
+    bool        mRed;
+
+    Event*            mEvents;
+    std::atomic<bool> mRunning;
+    std::thread       mThread;
+
+    std::atomic<uint64_t> mLostCount;
+    uint64_t              mLostReported;
+
+    // The request thread stores mWrite once per event, the trace thread
+    // stores mRead once per batch. Apart, a request does not lose the line
+    // of mWrite each time the trace thread ends a batch.
+    alignas(64) std::atomic<uint64_t> mRead;
+    alignas(64) std::atomic<uint64_t> mWrite;
+
+};